@@ -141,7 +141,12 @@ all : clearlibs builddirs prerequisites $(TARGET)
 .PHONY: clean builddirs
 
 clearlibs:
+	$(MAKE) -f Makefile.H3 clean --directory=../lib-artnet
+	$(MAKE) -f Makefile.H3 clean --directory=../lib-artnet4
+	$(MAKE) -f Makefile.H3 clean --directory=../lib-artnethandlers
 	$(MAKE) -f Makefile.H3 clean --directory=../lib-display
+	$(MAKE) -f Makefile.H3 clean --directory=../lib-displayudf
+	$(MAKE) -f Makefile.H3 clean --directory=../lib-e131
 	$(MAKE) -f Makefile.H3 clean --directory=../lib-h3
 	$(MAKE) -f Makefile.H3 clean --directory=../lib-hal
 #	$(MAKE) -f Makefile.H3 clean --directory=../lib-nextion
@@ -41,7 +41,11 @@ enum {
 };
 
 enum {
+#if defined (PIXEL_MULTI)
+	ARTNET_MAX_PAGES = 16	///< Art-Net 4, 8 outputs of 2 pages
+#else
 	ARTNET_MAX_PAGES = 4	///< Art-Net 4
+#endif
 };
 
 /**
@@ -42,6 +42,7 @@
 #include "packets.h"
 
 #include "lightset.h"
+#include "lightsetscheduler.h"
 #include "ledblink.h"
 
 #include "artnettimecode.h"
@@ -132,6 +133,8 @@ struct TGenericPort {
 struct TOutputPort {
 	uint8_t data[ARTNET_DMX_LENGTH];	///< Data sent
 	uint16_t nLength;					///< Length of sent DMX data
+	uint16_t nChangedFirst;				///< First slot changed since the last hand-off to the LightSet
+	uint16_t nChangedLast;				///< One past the last slot changed since the last hand-off to the LightSet
 	uint8_t dataA[ARTNET_DMX_LENGTH];	///< The data received from Port A
 	time_t timeA;						///< The latest time of the data received from Port A
 	uint32_t ipA;						///< The IP address for port A
@@ -140,6 +143,7 @@ struct TOutputPort {
 	uint32_t ipB;						///< The IP address for Port B
 	TMerge mergeMode;					///< \ref TMerge
 	bool IsDataPending;					///< ArtDMX received and waiting for ArtSync
+	bool IsCommitPending;				///< ArtSync received and waiting for the presentation time
 	bool bIsEnabled;					///< Is the port enabled ?
 	TGenericPort port;					///< \ref TGenericPort
 	TPortProtocol tPortProtocol;		///< Art-Net 4
@@ -189,6 +193,31 @@ public:
 		return m_bDirectUpdate;
 	}
 
+	/**
+	 * Synchronized ports are presented at (arrival of ArtSync + delay)
+	 * on the timeline of NtpClock. A delay of 0 presents them on arrival.
+	 */
+	void SetPresentationDelay(uint32_t nMicros) {
+		m_Scheduler.SetPresentationDelay(nMicros);
+	}
+	uint32_t GetPresentationDelay(void) {
+		return m_Scheduler.GetPresentationDelay();
+	}
+	const struct TLightSetSchedulerStats& GetSchedulerStats(void) {
+		return m_Scheduler.GetStats();
+	}
+
+	/**
+	 * Without ArtSync, a frame is committed when all enabled output ports have received ArtDmx,
+	 * or this time after the first data of the frame was set.
+	 */
+	void SetFrameAssemblyTimeout(uint32_t nMillis) {
+		m_nFrameAssemblyTimeout = nMillis;
+	}
+	uint32_t GetFrameAssemblyTimeout(void) {
+		return m_nFrameAssemblyTimeout;
+	}
+
 	void SetShortName(const char *);
 	const char *GetShortName(void) {
 		return (const char *) m_Node.ShortName;
@@ -244,6 +273,13 @@ public:
 		m_pArtNetTimeSync = pArtNetTimeSync;
 	}
 	void SetRdmHandler(ArtNetRdm *, bool isResponder = false);
+	/**
+	 * Incremental background RDM discovery on the enabled output ports, 0 is disabled.
+	 * Only runs with an RDM controller handler (SetRdmHandler, not a responder).
+	 */
+	void SetRdmDiscoveryInterval(uint32_t nSeconds) {
+		m_nRdmDiscoveryInterval = nSeconds * 1000;
+	}
 	void SetIpProgHandler(ArtNetIpProg *);
 	void SetArtNetStore(ArtNetStore *pArtNetStore) {
 		m_pArtNetStore = pArtNetStore;
@@ -278,9 +314,11 @@ private:
 
 	void GetType(void);
 
+	void HandlePacket(void);
 	void HandlePoll(void);
 	void HandleDmx(void);
 	void HandleSync(void);
+	void CommitSync(void);
 	void HandleAddress(void);
 	void HandleTimeCode(void);
 	void HandleTimeSync(void);
@@ -290,15 +328,20 @@ private:
 	void HandleIpProg(void);
 	void HandleDmxIn(void);
 	void HandleTrigger(void);
+	void RunRdmDiscovery(void);
 
 	uint16_t MakePortAddress(uint16_t, uint8_t nPage = 0);
 
 	bool IsMergedDmxDataChanged(uint8_t, const uint8_t *, uint16_t);
 	void CheckMergeTimeouts(uint8_t);
 	bool IsDmxDataChanged(uint8_t, const uint8_t *, uint16_t);
+	void SetChanged(uint8_t, uint16_t, uint16_t);
+	void SetLightSetData(uint8_t);
+	void SyncLightSet(void);
+	bool IsFrameComplete(void);
 
 	void SendPollRelply(bool);
-	void SendTod(uint8_t nPortId = 0);
+	void SendTod(uint8_t nPortId = 0, uint16_t nChangedFirst = 0);
 
 	void SetNetworkDataLossCondition(void);
 
@@ -334,6 +377,11 @@ private:
 	struct TInputPort m_InputPorts[ARTNET_MAX_PORTS];
 
 	bool m_bDirectUpdate;
+	LightSetScheduler m_Scheduler;
+	uint32_t m_nFrameAssemblyTimeout;
+	uint32_t m_nFrameStartMillis;
+	uint64_t m_nFramePorts;			///< Ports with ArtDmx received in the current frame
+	bool m_bIsFramePending;			///< Data set since the last LightSet::Sync
 
 	time_t m_nCurrentPacketTime;
 	time_t m_nPreviousPacketTime;
@@ -341,6 +389,11 @@ private:
 
 	bool m_IsLightSetRunning[ARTNET_MAX_PORTS * ARTNET_MAX_PAGES];
 	bool m_IsRdmResponder;
+	uint32_t m_nRdmDiscoveryPorts;		///< Ports with a discovery running
+	uint32_t m_nRdmDiscoveryLine;		///< Ports where the line is owned by the discovery
+	uint32_t m_nRdmDiscoveryFlush;		///< Ports where the discovery was started with AtcFlush
+	uint32_t m_nRdmDiscoveryInterval;
+	uint32_t m_nRdmDiscoveryMillis;
 
 	alignas(uint32_t) char m_aSysName[16];
 	alignas(uint32_t) char m_aDefaultNodeLongName[ARTNET_LONG_NAME_LENGTH];
@@ -61,6 +61,8 @@ struct TArtNetParams {
 	bool bEnableNoChangeUpdate;
 	uint8_t nDirection;
 	uint32_t nDestinationIp;
+	uint16_t nPresentationDelay;	///< milliseconds
+	uint16_t nRdmDiscoveryInterval;	///< seconds, fits in the padding: the stored size is unchanged
 };
 
 enum TArtnetParamsMask {
@@ -93,7 +95,9 @@ enum TArtnetParamsMask {
 	ARTNET_PARAMS_MASK_PROTOCOL_D = (1 << 26),
 	ARTNET_PARAMS_MASK_ENABLE_NO_CHANGE_OUTPUT = (1 << 27),
 	ARTNET_PARAMS_MASK_DIRECTION = (1 << 28),
-	ARTNET_PARAMS_MASK_DESTINATION_IP = (1 << 29)
+	ARTNET_PARAMS_MASK_DESTINATION_IP = (1 << 29),
+	ARTNET_PARAMS_MASK_PRESENTATION_DELAY = (1 << 30),
+	ARTNET_PARAMS_MASK_RDM_DISCOVERY_INTERVAL = (1U << 31)
 };
 
 class ArtNetParamsStore {
@@ -167,6 +171,10 @@ public:
 		return m_tArtNetParams.bRdmDiscovery;
 	}
 
+	uint16_t GetRdmDiscoveryInterval(void) {
+		return m_tArtNetParams.nRdmDiscoveryInterval;
+	}
+
 	uint8_t GetUniverse(uint8_t nPort, bool &IsSet);
 
 	bool IsEnableNoChangeUpdate(void) {
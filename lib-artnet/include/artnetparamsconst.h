@@ -39,6 +39,7 @@ public:
 	alignas(uint32_t) static const char TIMESYNC[];
 	alignas(uint32_t) static const char RDM[];
 	alignas(uint32_t) static const char RDM_DISCOVERY[];
+	alignas(uint32_t) static const char RDM_DISCOVERY_INTERVAL[];
 	alignas(uint32_t) static const char NODE_SHORT_NAME[];
 	alignas(uint32_t) static const char NODE_LONG_NAME[];
 	alignas(uint32_t) static const char NODE_MANUFACTURER_ID[];
@@ -36,10 +36,38 @@ public:
 	virtual ~ArtNetRdm(void);
 
 	virtual void Full(uint8_t nPort)=0;
-	virtual uint8_t GetUidCount(uint8_t nPort)=0;
-	virtual void Copy(uint8_t nPort, uint8_t *)=0;
+	virtual uint16_t GetUidCount(uint8_t nPort)=0;
+	/**
+	 * Copies at most nCount UID's of the TOD starting at nIndex, returns the number of UID's copied
+	 */
+	virtual uint16_t Copy(uint8_t nPort, uint8_t *pTod, uint16_t nIndex, uint16_t nCount)=0;
 
 	virtual const uint8_t *Handler(uint8_t nPort, const uint8_t *)=0;
+
+	/**
+	 * Non-blocking discovery, driven from ArtNetNode::Run.
+	 * The default implementation falls back to the blocking Full.
+	 */
+	virtual void DiscoveryStart(uint8_t nPort, bool bIncremental) {
+		if (!bIncremental) {
+			Full(nPort);
+		}
+	}
+	/**
+	 * Returns false when the discovery is finished.
+	 * bIsLineRequired: the DMX output of the port must be stopped.
+	 */
+	virtual bool DiscoveryRun(uint8_t nPort, bool bInterleaveDmx, bool &bIsLineRequired) {
+		bIsLineRequired = false;
+		return false;
+	}
+	/**
+	 * The TOD changed in the last discovery, the entries from nChangedFirst onwards could have been moved
+	 */
+	virtual bool IsTodChanged(uint8_t nPort, uint16_t &nChangedFirst) {
+		nChangedFirst = 0;
+		return false;
+	}
 };
 
 #endif /* ARTNETRDM_H_ */
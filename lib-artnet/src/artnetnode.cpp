@@ -36,6 +36,7 @@
 #include "packets.h"
 
 #include "lightset.h"
+#include "lightsetscheduler.h"
 
 #include "artnetrdm.h"
 #include "artnettimecode.h"
@@ -47,6 +48,7 @@
 
 #include "hardware.h"
 #include "network.h"
+#include "ntpclock.h"
 #include "ledblink.h"
 
 #include "artnetnode_internal.h"
@@ -80,6 +82,21 @@ static const uint8_t DEVICE_OEM_VALUE[] = { 0x20, 0xE0 };
 
 #define PORT_IN_STATUS_DISABLED_MASK	0x08
 
+#define ARTNET_PRIORITY_PACKETS_MAX		8	///< Upper limit for the packets handled in one Run()
+
+/*
+ * ArtSync and ArtTimeCode are time-critical, the network keeps room for them in the receive queue
+ */
+static bool IsPriority(const uint8_t *pPacket, uint16_t nSize) {
+	if (nSize < ARTNET_MIN_HEADER_SIZE) {
+		return false;
+	}
+
+	const uint16_t nOpCode = (uint16_t) (pPacket[8] | (pPacket[9] << 8));
+
+	return (nOpCode == OP_SYNC) || (nOpCode == OP_TIMECODE);
+}
+
 ArtNetNode *ArtNetNode::s_pThis = 0;
 
 ArtNetNode::ArtNetNode(uint8_t nVersion, uint8_t nPages) :
@@ -99,9 +116,18 @@ ArtNetNode::ArtNetNode(uint8_t nVersion, uint8_t nPages) :
 	m_pTodData(0),
 	m_pIpProgReply(0),
 	m_bDirectUpdate(false),
+	m_nFrameAssemblyTimeout(LIGHTSET_FRAME_ASSEMBLY_TIMEOUT_MILLIS),
+	m_nFrameStartMillis(0),
+	m_nFramePorts(0),
+	m_bIsFramePending(false),
 	m_nCurrentPacketTime(0),
 	m_nPreviousPacketTime(0),
 	m_IsRdmResponder(false),
+	m_nRdmDiscoveryPorts(0),
+	m_nRdmDiscoveryLine(0),
+	m_nRdmDiscoveryFlush(0),
+	m_nRdmDiscoveryInterval(0),
+	m_nRdmDiscoveryMillis(0),
 	m_nDestinationIp(0)
 {
 	assert(Hardware::Get() != 0);
@@ -181,6 +207,8 @@ void ArtNetNode::Start(void) {
 	m_nHandle = Network::Get()->Begin(ARTNET_UDP_PORT);
 	assert(m_nHandle != -1);
 
+	Network::Get()->SetPriority(m_nHandle, IsPriority);
+
 	m_State.status = ARTNET_ON;
 
 	if(m_nDestinationIp == 0) {
@@ -616,8 +644,6 @@ void ArtNetNode::SendPollRelply(bool bResponse) {
 }
 
 bool ArtNetNode::IsDmxDataChanged(uint8_t nPortId, const uint8_t *pData, uint16_t nLength) {
-	bool isChanged = false;
-
 	const uint8_t *src = (uint8_t *) pData;
 	uint8_t *dst = m_OutputPorts[nPortId].data;
 
@@ -628,22 +654,32 @@ bool ArtNetNode::IsDmxDataChanged(uint8_t nPortId, const uint8_t *pData, uint16_
 			*dst++ = *src++;
 		}
 
+		SetChanged(nPortId, 0, nLength);
 		return true;
 	}
 
+	uint32_t nFirst = nLength;
+	uint32_t nLast = 0;
+
 	for (uint32_t i = 0; i < nLength; i++) {
 		if (*dst != *src) {
-			isChanged = true;
+			if (i < nFirst) {
+				nFirst = i;
+			}
+			nLast = i + 1;
 		}
 		*dst++ = *src++;
 	}
 
-	return isChanged;
+	if (nLast != 0) {
+		SetChanged(nPortId, nFirst, nLast);
+		return true;
+	}
+
+	return false;
 }
 
 bool ArtNetNode::IsMergedDmxDataChanged(uint8_t nPortId, const uint8_t *pData, uint16_t nLength) {
-	bool isChanged = false;
-
 	if (!m_State.IsMergeMode) {
 		m_State.IsMergeMode = true;
 		m_State.IsChanged = true;
@@ -660,23 +696,77 @@ bool ArtNetNode::IsMergedDmxDataChanged(uint8_t nPortId, const uint8_t *pData, u
 				uint8_t data = MAX(m_OutputPorts[nPortId].dataA[i], m_OutputPorts[nPortId].dataB[i]);
 				m_OutputPorts[nPortId].data[i] = data;
 			}
+			SetChanged(nPortId, 0, nLength);
 			return true;
 		}
 
+		uint32_t nFirst = nLength;
+		uint32_t nLast = 0;
+
 		for (uint32_t i = 0; i < nLength; i++) {
 			uint8_t data = MAX(m_OutputPorts[nPortId].dataA[i], m_OutputPorts[nPortId].dataB[i]);
 			if (data != m_OutputPorts[nPortId].data[i]) {
 				m_OutputPorts[nPortId].data[i] = data;
-				isChanged = true;
+				if (i < nFirst) {
+					nFirst = i;
+				}
+				nLast = i + 1;
 			}
 		}
 
-		return isChanged;
+		if (nLast != 0) {
+			SetChanged(nPortId, nFirst, nLast);
+			return true;
+		}
+
+		return false;
 	} else {
 		return IsDmxDataChanged(nPortId, pData, nLength);
 	}
 }
 
+void ArtNetNode::SetChanged(uint8_t nPortId, uint16_t nFirst, uint16_t nLast) {
+	if (m_OutputPorts[nPortId].nChangedFirst >= m_OutputPorts[nPortId].nChangedLast) {
+		m_OutputPorts[nPortId].nChangedFirst = nFirst;
+		m_OutputPorts[nPortId].nChangedLast = nLast;
+		return;
+	}
+
+	m_OutputPorts[nPortId].nChangedFirst = MIN(m_OutputPorts[nPortId].nChangedFirst, nFirst);
+	m_OutputPorts[nPortId].nChangedLast = MAX(m_OutputPorts[nPortId].nChangedLast, nLast);
+}
+
+void ArtNetNode::SetLightSetData(uint8_t nPortId) {
+	m_pLightSet->SetDataChanged(nPortId, m_OutputPorts[nPortId].data, m_OutputPorts[nPortId].nLength, m_OutputPorts[nPortId].nChangedFirst, m_OutputPorts[nPortId].nChangedLast);
+
+	m_OutputPorts[nPortId].nChangedFirst = 0;
+	m_OutputPorts[nPortId].nChangedLast = 0;
+
+	if (!m_bIsFramePending) {
+		m_bIsFramePending = true;
+		m_nFrameStartMillis = Hardware::Get()->Millis();
+	}
+}
+
+void ArtNetNode::SyncLightSet(void) {
+	m_nFramePorts = 0;
+
+	if (m_bIsFramePending) {
+		m_bIsFramePending = false;
+		m_pLightSet->Sync();
+	}
+}
+
+bool ArtNetNode::IsFrameComplete(void) {
+	for (uint32_t i = 0; i < (ARTNET_MAX_PORTS * m_nPages); i++) {
+		if (m_OutputPorts[i].bIsEnabled && (m_OutputPorts[i].tPortProtocol == PORT_ARTNET_ARTNET) && ((m_nFramePorts & (1ULL << i)) == 0)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
 void ArtNetNode::CheckMergeTimeouts(uint8_t nPortId) {
 	const time_t timeOutA = m_nCurrentPacketTime - m_OutputPorts[nPortId].timeA;
 	const time_t timeOutB = m_nCurrentPacketTime - m_OutputPorts[nPortId].timeB;
@@ -771,6 +861,14 @@ void ArtNetNode::HandleDmx(void) {
 				}
 			}
 
+			if (__builtin_expect((m_OutputPorts[i].IsCommitPending), 0)) {
+				if ((ipA == 0) || (ipB == 0) || (ipA == m_ArtNetPacket.IPAddressFrom) || (ipB == m_ArtNetPacket.IPAddressFrom)) {
+					// New data for a port that is still waiting: the scheduled frame is presented now, out of step, before it is overwritten
+					m_Scheduler.Flush(Hardware::Get()->Micros());
+					CommitSync();
+				}
+			}
+
 			if (ipA == 0 && ipB == 0) {
 #if defined ( ENABLE_SENDDIAG )
 				SendDiag("1. first packet recv on this port", ARTNET_DP_LOW);
@@ -845,7 +943,7 @@ void ArtNetNode::HandleDmx(void) {
 #if defined ( ENABLE_SENDDIAG )
 					SendDiag("Send new data", ARTNET_DP_LOW);
 #endif
-					m_pLightSet->SetData(i, m_OutputPorts[i].data, m_OutputPorts[i].nLength);
+					SetLightSetData(i);
 
 					if(!m_IsLightSetRunning[i]) {
 						m_pLightSet->Start(i);
@@ -864,21 +962,48 @@ void ArtNetNode::HandleDmx(void) {
 #endif
 			}
 
+			m_nFramePorts |= (1ULL << i);
 			m_State.bIsReceivingDmx = true;
 		}
 	}
+
+	if (!m_State.IsSynchronousMode && IsFrameComplete()) {
+		SyncLightSet();
+	}
 }
 
 void ArtNetNode::HandleSync(void) {
 	m_State.IsSynchronousMode = true;
 	m_State.ArtSyncTime = Hardware::Get()->GetTime();
 
+	if (m_Scheduler.IsEnabled()) {
+		const uint32_t nLocalNow = Hardware::Get()->Micros();
+		const uint32_t nNow = NtpClock::ToTimelineMicros(nLocalNow);
+		const uint32_t nRecvTimestamp = Network::Get()->GetRecvTimestamp();
+
+		if (m_Scheduler.IsPending()) {
+			CommitSync();
+		}
+
+		m_Scheduler.Schedule(nRecvTimestamp == 0 ? nNow : NtpClock::ToTimelineMicros(nRecvTimestamp), nNow, nLocalNow);
+
+		for (uint32_t i = 0; i < (m_nPages * ARTNET_MAX_PORTS); i++) {
+			if  ((m_OutputPorts[i].tPortProtocol == PORT_ARTNET_ARTNET) &&  ((m_OutputPorts[i].IsDataPending) || (m_OutputPorts[i].bIsEnabled && m_bDirectUpdate) )) {
+				m_OutputPorts[i].IsCommitPending = true;
+				m_OutputPorts[i].IsDataPending = false;
+			}
+		}
+
+		m_nFramePorts = 0;
+		return;
+	}
+
 	for (uint32_t i = 0; i < (m_nPages * ARTNET_MAX_PORTS); i++) {
 		if  ((m_OutputPorts[i].tPortProtocol == PORT_ARTNET_ARTNET) &&  ((m_OutputPorts[i].IsDataPending) || (m_OutputPorts[i].bIsEnabled && m_bDirectUpdate) )) {
 #if defined ( ENABLE_SENDDIAG )
 			SendDiag("Send pending data", ARTNET_DP_LOW);
 #endif
-			m_pLightSet->SetData(i, m_OutputPorts[i].data, 	m_OutputPorts[i].nLength);
+			SetLightSetData(i);
 
 			if(!m_IsLightSetRunning[i]) {
 				m_pLightSet->Start(i);
@@ -888,6 +1013,28 @@ void ArtNetNode::HandleSync(void) {
 			m_OutputPorts[i].IsDataPending = false;
 		}
 	}
+
+	SyncLightSet();
+}
+
+void ArtNetNode::CommitSync(void) {
+	for (uint32_t i = 0; i < (m_nPages * ARTNET_MAX_PORTS); i++) {
+		if (m_OutputPorts[i].IsCommitPending) {
+#if defined ( ENABLE_SENDDIAG )
+			SendDiag("Send scheduled data", ARTNET_DP_LOW);
+#endif
+			SetLightSetData(i);
+
+			if(!m_IsLightSetRunning[i]) {
+				m_pLightSet->Start(i);
+				m_IsLightSetRunning[i] = true;
+			}
+
+			m_OutputPorts[i].IsCommitPending = false;
+		}
+	}
+
+	SyncLightSet();
 }
 
 void ArtNetNode::HandleAddress(void) {
@@ -993,8 +1140,10 @@ void ArtNetNode::HandleAddress(void) {
 			m_OutputPorts[nPort].data[i] = 0;
 		}
 		m_OutputPorts[nPort].nLength = ARTNET_DMX_LENGTH;
+		SetChanged(nPort, 0, ARTNET_DMX_LENGTH);
 		if (m_OutputPorts[nPort].tPortProtocol == PORT_ARTNET_ARTNET) {
-			m_pLightSet->SetData(nPort, m_OutputPorts[nPort].data, m_OutputPorts[nPort].nLength);
+			SetLightSetData(nPort);
+			SyncLightSet();
 		}
 		break;
 
@@ -1018,6 +1167,8 @@ void ArtNetNode::HandleAddress(void) {
 void ArtNetNode::SetNetworkDataLossCondition(void) {
 	m_State.IsMergeMode = false;
 	m_State.IsSynchronousMode = false;
+	m_bIsFramePending = false;
+	m_nFramePorts = 0;
 
 	for (uint32_t i = 0; i < (ARTNET_MAX_PORTS * m_nPages); i++) {
 		if  ((m_OutputPorts[i].tPortProtocol == PORT_ARTNET_ARTNET) && (m_IsLightSetRunning[i])) {
@@ -1026,6 +1177,7 @@ void ArtNetNode::SetNetworkDataLossCondition(void) {
 		}
 
 		m_OutputPorts[i].port.nStatus &= (~GO_DATA_IS_BEING_TRANSMITTED);
+		m_OutputPorts[i].IsCommitPending = false;
 		m_OutputPorts[i].nLength = 0;
 		m_OutputPorts[i].ipA = 0;
 		m_OutputPorts[i].ipB = 0;
@@ -1053,6 +1205,34 @@ void ArtNetNode::GetType(void) {
 }
 
 void ArtNetNode::Run(void) {
+	if (__builtin_expect((m_Scheduler.IsPending()), 0)) {
+		if (m_Scheduler.IsDue(Hardware::Get()->Micros())) {
+			CommitSync();
+		}
+	}
+
+	if (m_bIsFramePending) {
+		if ((Hardware::Get()->Millis() - m_nFrameStartMillis) >= m_nFrameAssemblyTimeout) {
+			SyncLightSet();
+		}
+	}
+
+	if (__builtin_expect((((m_nRdmDiscoveryPorts | m_nRdmDiscoveryInterval) != 0) && (m_pArtNetRdm != 0) && !m_IsRdmResponder), 0)) {
+		RunRdmDiscovery();
+	}
+
+	/*
+	 * An ArtSync or ArtTimeCode is queued: handle the packets up to it now,
+	 * instead of one per main loop. The order of the packets is kept.
+	 */
+	uint32_t nPackets = 0;
+
+	do {
+		HandlePacket();
+	} while (__builtin_expect((Network::Get()->IsPriorityPending(m_nHandle)), 0) && (++nPackets < ARTNET_PRIORITY_PACKETS_MAX));
+}
+
+void ArtNetNode::HandlePacket(void) {
 	const char *packet = (char *) &(m_ArtNetPacket.ArtPacket);
 	uint16_t nForeignPort;
 
@@ -1171,5 +1351,4 @@ void ArtNetNode::Run(void) {
 			LedBlink::Get()->SetMode(LEDBLINK_MODE_NORMAL);
 		}
 	}
-
 }
@@ -60,6 +60,8 @@ void ArtNetNode::Print(void) {
 		if (m_bDirectUpdate) {
 			printf(" Direct update : Yes\n");
 		}
+
+		m_Scheduler.Print();
 	}
 
 	if (m_State.nActiveInputPorts != 0) {
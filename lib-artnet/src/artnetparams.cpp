@@ -142,6 +142,12 @@ void ArtNetParams::callbackFunction(const char *pLine) {
 		return;
 	}
 
+	if (Sscan::Uint16(pLine, ArtNetParamsConst::RDM_DISCOVERY_INTERVAL, &value16) == SSCAN_OK) {
+		m_tArtNetParams.nRdmDiscoveryInterval = value16;
+		m_tArtNetParams.nSetList |= ARTNET_PARAMS_MASK_RDM_DISCOVERY_INTERVAL;
+		return;
+	}
+
 	len = ARTNET_SHORT_NAME_LENGTH - 1;
 	if (Sscan::Char(pLine, ArtNetParamsConst::NODE_SHORT_NAME, (char *) m_tArtNetParams.aShortName, &len) == SSCAN_OK) {
 		m_tArtNetParams.aShortName[len] = '\0';
@@ -261,6 +267,12 @@ void ArtNetParams::callbackFunction(const char *pLine) {
 		m_tArtNetParams.nSetList |= ARTNET_PARAMS_MASK_ENABLE_NO_CHANGE_OUTPUT;
 		return;
 	}
+
+	if (Sscan::Uint16(pLine, LightSetConst::PARAMS_PRESENTATION_DELAY, &value16) == SSCAN_OK) {
+		m_tArtNetParams.nPresentationDelay = value16;
+		m_tArtNetParams.nSetList |= ARTNET_PARAMS_MASK_PRESENTATION_DELAY;
+		return;
+	}
 }
 
 void ArtNetParams::Dump(void) {
@@ -298,6 +310,10 @@ void ArtNetParams::Dump(void) {
 		}
 	}
 
+	if (isMaskSet(ARTNET_PARAMS_MASK_RDM_DISCOVERY_INTERVAL)) {
+		printf(" %s=%d [s]\n", ArtNetParamsConst::RDM_DISCOVERY_INTERVAL, (int) m_tArtNetParams.nRdmDiscoveryInterval);
+	}
+
 	if(isMaskSet(ARTNET_PARAMS_MASK_TIMECODE)) {
 		printf(" %s=%d [%s]\n", ArtNetParamsConst::TIMECODE, (int) m_tArtNetParams.bUseTimeCode, BOOL2STRING(m_tArtNetParams.bUseTimeCode));
 	}
@@ -347,6 +363,10 @@ void ArtNetParams::Dump(void) {
 	if(isMaskSet(ARTNET_PARAMS_MASK_ENABLE_NO_CHANGE_OUTPUT)) {
 		printf(" %s=%d [%s]\n", LightSetConst::PARAMS_ENABLE_NO_CHANGE_UPDATE, (int) m_tArtNetParams.bEnableNoChangeUpdate, BOOL2STRING(m_tArtNetParams.bEnableNoChangeUpdate));
 	}
+
+	if(isMaskSet(ARTNET_PARAMS_MASK_PRESENTATION_DELAY)) {
+		printf(" %s=%d [ms]\n", LightSetConst::PARAMS_PRESENTATION_DELAY, (int) m_tArtNetParams.nPresentationDelay);
+	}
 #endif
 }
 
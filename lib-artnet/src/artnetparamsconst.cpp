@@ -35,6 +35,7 @@ alignas(uint32_t) const char ArtNetParamsConst::TIMECODE[] = "use_timecode";
 alignas(uint32_t) const char ArtNetParamsConst::TIMESYNC[] = "use_timesync";
 alignas(uint32_t) const char ArtNetParamsConst::RDM[] = "enable_rdm";
 alignas(uint32_t) const char ArtNetParamsConst::RDM_DISCOVERY[] = "rdm_discovery_at_startup";
+alignas(uint32_t) const char ArtNetParamsConst::RDM_DISCOVERY_INTERVAL[] = "rdm_discovery_interval";
 alignas(uint32_t) const char ArtNetParamsConst::NODE_SHORT_NAME[] = "short_name";
 alignas(uint32_t) const char ArtNetParamsConst::NODE_LONG_NAME[] = "long_name";
 alignas(uint32_t) const char ArtNetParamsConst::NODE_MANUFACTURER_ID[] = "manufacturer_id";
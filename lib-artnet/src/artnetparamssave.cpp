@@ -69,6 +69,7 @@ void ArtNetParams::Builder(const struct TArtNetParams *pArtNetParams, uint8_t *p
 	builder.AddHex16(ArtNetParamsConst::NODE_OEM_VALUE, m_tArtNetParams.aOemValue, isMaskSet(ARTNET_PARAMS_MASK_OEM_VALUE));
 
 	builder.Add(ArtNetParamsConst::RDM, m_tArtNetParams.bEnableRdm, isMaskSet(ARTNET_PARAMS_MASK_RDM));
+	builder.Add(ArtNetParamsConst::RDM_DISCOVERY_INTERVAL, (uint32_t) m_tArtNetParams.nRdmDiscoveryInterval, isMaskSet(ARTNET_PARAMS_MASK_RDM_DISCOVERY_INTERVAL));
 	builder.Add(ArtNetParamsConst::TIMECODE, m_tArtNetParams.bUseTimeCode, isMaskSet(ARTNET_PARAMS_MASK_TIMECODE));
 	builder.Add(ArtNetParamsConst::TIMESYNC, m_tArtNetParams.bUseTimeSync, isMaskSet(ARTNET_PARAMS_MASK_TIMESYNC));
 
@@ -85,6 +86,7 @@ void ArtNetParams::Builder(const struct TArtNetParams *pArtNetParams, uint8_t *p
 	builder.Add(ArtNetParamsConst::NODE_DISABLE_MERGE_TIMEOUT, m_tArtNetParams.bDisableMergeTimeout, isMaskSet(ARTNET_PARAMS_MASK_MERGE_TIMEOUT));
 
 	builder.Add(LightSetConst::PARAMS_ENABLE_NO_CHANGE_UPDATE, m_tArtNetParams.bEnableNoChangeUpdate, isMaskSet(ARTNET_PARAMS_MASK_ENABLE_NO_CHANGE_OUTPUT));
+	builder.Add(LightSetConst::PARAMS_PRESENTATION_DELAY, (uint32_t) m_tArtNetParams.nPresentationDelay, isMaskSet(ARTNET_PARAMS_MASK_PRESENTATION_DELAY));
 
 	nSize = builder.GetSize();
 
@@ -94,4 +94,12 @@ void ArtNetParams::Set(ArtNetNode *pArtNetNode) {
 	if(isMaskSet(ARTNET_PARAMS_MASK_ENABLE_NO_CHANGE_OUTPUT)) {
 		pArtNetNode->SetDirectUpdate(m_tArtNetParams.bEnableNoChangeUpdate);
 	}
+
+	if(isMaskSet(ARTNET_PARAMS_MASK_PRESENTATION_DELAY)) {
+		pArtNetNode->SetPresentationDelay((uint32_t) m_tArtNetParams.nPresentationDelay * 1000);
+	}
+
+	if(isMaskSet(ARTNET_PARAMS_MASK_RDM_DISCOVERY_INTERVAL)) {
+		pArtNetNode->SetRdmDiscoveryInterval(m_tArtNetParams.nRdmDiscoveryInterval);
+	}
 }
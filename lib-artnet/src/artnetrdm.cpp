@@ -33,6 +33,7 @@
 
 #include "artnetnode.h"
 #include "network.h"
+#include "hardware.h"
 
 #include "artnetnode_internal.h"
 
@@ -43,20 +44,75 @@ void ArtNetNode::HandleTodControl(void) {
 	for (uint32_t i = 0; i < ARTNET_MAX_PORTS; i++) {
 		if ((portAddress == m_OutputPorts[i].port.nPortAddress) && m_OutputPorts[i].bIsEnabled) {
 
-			if (m_IsLightSetRunning[i] && (!m_IsRdmResponder)) {
-				m_pLightSet->Stop(i);
+			if (packet->Command == 0x01) {	// AtcFlush
+				// The ArtTodData is sent when the discovery is finished
+				m_pArtNetRdm->DiscoveryStart(i, false);
+				m_nRdmDiscoveryPorts |= (1U << i);
+				m_nRdmDiscoveryFlush |= (1U << i);
+			} else {
+				SendTod(i);
 			}
+		}
+	}
+}
 
-			if (packet->Command == 0x01) {	// AtcFlush
-				m_pArtNetRdm->Full(i);
+void ArtNetNode::RunRdmDiscovery(void) {
+	if ((m_nRdmDiscoveryInterval != 0) && (m_nRdmDiscoveryPorts == 0)) {
+		const uint32_t nMillis = Hardware::Get()->Millis();
+
+		if ((nMillis - m_nRdmDiscoveryMillis) >= m_nRdmDiscoveryInterval) {
+			m_nRdmDiscoveryMillis = nMillis;
+
+			for (uint32_t i = 0; i < ARTNET_MAX_PORTS; i++) {
+				if (m_OutputPorts[i].bIsEnabled) {
+					m_pArtNetRdm->DiscoveryStart(i, true);
+					m_nRdmDiscoveryPorts |= (1U << i);
+				}
 			}
+		}
+	}
 
-			SendTod(i);
+	for (uint32_t i = 0; i < ARTNET_MAX_PORTS; i++) {
+		const uint32_t nMask = (1U << i);
 
-			if (m_IsLightSetRunning[i] && (!m_IsRdmResponder)) {
-				m_pLightSet->Start(i);
+		if ((m_nRdmDiscoveryPorts & nMask) == 0) {
+			continue;
+		}
+
+		const bool bIsDmxRunning = m_IsLightSetRunning[i] && (!m_IsRdmResponder);
+		bool bIsLineRequired;
+
+		const bool bIsRunning = m_pArtNetRdm->DiscoveryRun(i, bIsDmxRunning, bIsLineRequired);
+
+		if (bIsLineRequired != ((m_nRdmDiscoveryLine & nMask) != 0)) {
+			if (bIsLineRequired) {
+				m_nRdmDiscoveryLine |= nMask;
+				if (bIsDmxRunning) {
+					m_pLightSet->Stop(i);
+				}
+			} else {
+				m_nRdmDiscoveryLine &= ~nMask;
+				if (bIsDmxRunning) {
+					m_pLightSet->Start(i);
+				}
 			}
 		}
+
+		if (bIsRunning) {
+			continue;
+		}
+
+		m_nRdmDiscoveryPorts &= ~nMask;
+
+		uint16_t nChangedFirst;
+
+		if ((m_nRdmDiscoveryFlush & nMask) != 0) {
+			SendTod(i);
+		} else if (m_pArtNetRdm->IsTodChanged(i, nChangedFirst)) {
+			SendTod(i, nChangedFirst);
+		}
+
+		m_nRdmDiscoveryFlush &= ~nMask;
 	}
 }
 
@@ -71,25 +127,38 @@ void ArtNetNode::HandleTodRequest(void) {
 	}
 }
 
-void ArtNetNode::SendTod(uint8_t nPortId) {
+/**
+ * The TOD is sent in blocks of 200 UID's. Only the blocks from the one holding nChangedFirst onwards are sent,
+ * as the TOD is sorted the blocks before are the same as in the previous ArtTodData.
+ */
+void ArtNetNode::SendTod(uint8_t nPortId, uint16_t nChangedFirst) {
 	assert(nPortId < ARTNET_MAX_PORTS);
 
+	const uint32_t nBlockSize = sizeof(m_pTodData->Tod) / sizeof(m_pTodData->Tod[0]);
+	const uint16_t nDiscovered = m_pArtNetRdm->GetUidCount(nPortId);
+
+	if (nChangedFirst > nDiscovered) {
+		nChangedFirst = nDiscovered;
+	}
+
 	m_pTodData->Net = m_Node.NetSwitch[0];
 	m_pTodData->Address = m_OutputPorts[nPortId].port.nDefaultAddress;
+	m_pTodData->UidTotalHi = (uint8_t) (nDiscovered >> 8);
+	m_pTodData->UidTotalLo = (uint8_t) nDiscovered;
+	m_pTodData->Port = 1 + nPortId;
 
-	const uint8_t discovered = m_pArtNetRdm->GetUidCount(nPortId);
+	uint32_t nBlock = nChangedFirst / nBlockSize;
 
-	m_pTodData->UidTotalHi = 0;
-	m_pTodData->UidTotalLo = discovered;
-	m_pTodData->BlockCount = 0;
-	m_pTodData->UidCount = discovered;
-	m_pTodData->Port = 1 + nPortId;
+	do {
+		const uint16_t nCount = m_pArtNetRdm->Copy(nPortId, (uint8_t *) m_pTodData->Tod, (uint16_t) (nBlock * nBlockSize), (uint16_t) nBlockSize);
 
-	m_pArtNetRdm->Copy(nPortId, (uint8_t *) m_pTodData->Tod);
+		m_pTodData->BlockCount = (uint8_t) nBlock;
+		m_pTodData->UidCount = (uint8_t) nCount;
 
-	const uint16_t length = (uint16_t) sizeof(struct TArtTodData) - (uint16_t) (sizeof m_pTodData->Tod) + (uint16_t) (discovered * 6);
+		const uint16_t length = (uint16_t) sizeof(struct TArtTodData) - (uint16_t) (sizeof m_pTodData->Tod) + (uint16_t) (nCount * 6);
 
-	Network::Get()->SendTo(m_nHandle, (const uint8_t *) m_pTodData, (const uint16_t) length, m_Node.IPAddressBroadcast, (uint16_t) ARTNET_UDP_PORT);
+		Network::Get()->SendTo(m_nHandle, (const uint8_t *) m_pTodData, (const uint16_t) length, m_Node.IPAddressBroadcast, (uint16_t) ARTNET_UDP_PORT);
+	} while ((++nBlock * nBlockSize) < nDiscovered);
 }
 
 void ArtNetNode::SetRdmHandler(ArtNetRdm *pArtNetTRdm, bool IsResponder) {
@@ -147,8 +216,8 @@ void ArtNetNode::HandleRdm(void) {
 				//printf("\n==> No response <==\n");
 			}
 
-			if (m_IsLightSetRunning[i] && (!m_IsRdmResponder)) {
-				m_pLightSet->Start(i); // Start DMX if was running
+			if (m_IsLightSetRunning[i] && (!m_IsRdmResponder) && ((m_nRdmDiscoveryLine & (1U << i)) == 0)) {
+				m_pLightSet->Start(i); // Start DMX if was running, unless the line is owned by the discovery
 			}
 		}
 	}
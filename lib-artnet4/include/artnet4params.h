@@ -38,10 +38,12 @@
 struct TArtNet4Params {
 	uint32_t nSetList;
 	bool bMapUniverse0;
+	uint16_t nFrameAssemblyTimeout;	///< milliseconds
 };
 
 enum TArtNet4ParamsMask {
-	ARTNET4_PARAMS_MASK_MAP_UNIVERSE0 = (1 << 0)
+	ARTNET4_PARAMS_MASK_MAP_UNIVERSE0 = (1 << 0),
+	ARTNET4_PARAMS_MASK_FRAME_ASSEMBLY_TIMEOUT = (1 << 1)
 };
 
 class ArtNet4ParamsStore {
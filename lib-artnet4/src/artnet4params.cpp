@@ -38,6 +38,8 @@
 #include "artnet4params.h"
 #include "artnet4paramsconst.h"
 #include "artnetparamsconst.h"
+#include "lightset.h"
+#include "lightsetconst.h"
 
 #include "readconfigfile.h"
 #include "sscan.h"
@@ -56,6 +58,7 @@ ArtNet4Params::ArtNet4Params(ArtNet4ParamsStore* pArtNet4ParamsStore):
 {
 	m_tArtNet4Params.nSetList = 0;
 	m_tArtNet4Params.bMapUniverse0 = false;
+	m_tArtNet4Params.nFrameAssemblyTimeout = LIGHTSET_FRAME_ASSEMBLY_TIMEOUT_MILLIS;
 }
 
 ArtNet4Params::~ArtNet4Params(void) {
@@ -115,12 +118,19 @@ void ArtNet4Params::callbackFunction(const char* pLine) {
 	assert(pLine != 0);
 
 	uint8_t value8;
+	uint16_t value16;
 
 	if (Sscan::Uint8(pLine, ArtNet4ParamsConst::MAP_UNIVERSE0, &value8) == SSCAN_OK) {
 		m_tArtNet4Params.bMapUniverse0 = (value8 != 0);
 		m_tArtNet4Params.nSetList |= ARTNET4_PARAMS_MASK_MAP_UNIVERSE0;
 		return;
 	}
+
+	if (Sscan::Uint16(pLine, LightSetConst::PARAMS_FRAME_ASSEMBLY_TIMEOUT, &value16) == SSCAN_OK) {
+		m_tArtNet4Params.nFrameAssemblyTimeout = value16;
+		m_tArtNet4Params.nSetList |= ARTNET4_PARAMS_MASK_FRAME_ASSEMBLY_TIMEOUT;
+		return;
+	}
 }
 
 void ArtNet4Params::Dump(void) {
@@ -132,6 +142,10 @@ void ArtNet4Params::Dump(void) {
 	if(isMaskSet(ARTNET4_PARAMS_MASK_MAP_UNIVERSE0)) {
 		printf(" %s=%d [%s]\n", ArtNet4ParamsConst::MAP_UNIVERSE0, (int) m_tArtNet4Params.bMapUniverse0, BOOL2STRING(m_tArtNet4Params.bMapUniverse0));
 	}
+
+	if(isMaskSet(ARTNET4_PARAMS_MASK_FRAME_ASSEMBLY_TIMEOUT)) {
+		printf(" %s=%d [ms]\n", LightSetConst::PARAMS_FRAME_ASSEMBLY_TIMEOUT, (int) m_tArtNet4Params.nFrameAssemblyTimeout);
+	}
 #endif
 }
 
@@ -30,6 +30,7 @@
 #include "artnet4params.h"
 #include "artnet4paramsconst.h"
 #include "artnetparamsconst.h"
+#include "lightsetconst.h"
 
 #include "propertiesbuilder.h"
 
@@ -49,6 +50,7 @@ void ArtNet4Params::Builder(const struct TArtNet4Params *pArtNet4Params, uint8_t
 	PropertiesBuilder builder(ArtNetParamsConst::FILE_NAME, pBuffer, nLength);
 
 	builder.Add(ArtNet4ParamsConst::MAP_UNIVERSE0, m_tArtNet4Params.bMapUniverse0, isMaskSet(ARTNET4_PARAMS_MASK_MAP_UNIVERSE0));
+	builder.Add(LightSetConst::PARAMS_FRAME_ASSEMBLY_TIMEOUT, (uint32_t) m_tArtNet4Params.nFrameAssemblyTimeout, isMaskSet(ARTNET4_PARAMS_MASK_FRAME_ASSEMBLY_TIMEOUT));
 
 	nSize = builder.GetSize();
 
@@ -41,6 +41,10 @@ void ArtNet4Params::Set(ArtNet4Node* pArtNet4Node) {
 		pArtNet4Node->SetMapUniverse0(m_tArtNet4Params.bMapUniverse0);
 	}
 
+	if(isMaskSet(ARTNET4_PARAMS_MASK_FRAME_ASSEMBLY_TIMEOUT)) {
+		pArtNet4Node->SetFrameAssemblyTimeout(m_tArtNet4Params.nFrameAssemblyTimeout);
+	}
+
 	ArtNetParams::Set((ArtNetNode *)pArtNet4Node);
 
 	DEBUG_EXIT
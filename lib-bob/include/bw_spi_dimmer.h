@@ -30,6 +30,7 @@
 #include <stdbool.h>
 
 #include "device_info.h"
+#include "spi_batch.h"
 
 #define BW_DIMMER_SPI_SPEED_MAX_HZ		90000	///< 90 KHz
 #define BW_DIMMER_SPI_SPEED_DEFAULT_HZ	90000	///< 90 kHz
@@ -41,6 +42,8 @@ extern "C" {
 extern bool bw_spi_dimmer_start(device_info_t *);
 extern void bw_spi_dimmer_output(const device_info_t *, uint8_t);
 
+extern void bw_spi_dimmer_output_batch(spi_batch_t *, const device_info_t *, uint8_t);
+
 #ifdef __cplusplus
 }
 #endif
@@ -30,6 +30,7 @@
 #include <stdbool.h>
 
 #include "device_info.h"
+#include "spi_batch.h"
 
 #define BW_DIO_SPI_SPEED_MAX_HZ			90000	///< 90 KHz
 #define BW_DIO_SPI_SPEED_DEFAULT_HZ		90000	///< 90 kHz
@@ -42,6 +43,8 @@ extern bool bw_spi_dio_start(device_info_t *);
 extern void bw_spi_dio_fsel_mask(const device_info_t *, uint8_t);
 extern void bw_spi_dio_output(const device_info_t *, uint8_t);
 
+extern void bw_spi_dio_output_batch(spi_batch_t *, const device_info_t *, uint8_t);
+
 #ifdef __cplusplus
 }
 #endif
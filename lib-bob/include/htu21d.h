@@ -32,6 +32,8 @@
 
 #define HTU21D_I2C_DEFAULT_SLAVE_ADDRESS	0x40
 
+#define HTU21D_CONVERSION_TIME_MS		80	///< datasheet says 50ms
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -40,6 +42,15 @@ extern bool htu21d_start(device_info_t *);
 extern float htu21d_get_temperature(const device_info_t *);
 extern float htu21d_get_humidity(const device_info_t *);
 
+/*
+ * Non-blocking measurement: start the conversion, then read the result
+ * after at least HTU21D_CONVERSION_TIME_MS
+ */
+extern void htu21d_start_temperature(const device_info_t *);
+extern void htu21d_start_humidity(const device_info_t *);
+extern float htu21d_read_temperature(const device_info_t *);
+extern float htu21d_read_humidity(const device_info_t *);
+
 #ifdef __cplusplus
 }
 #endif
@@ -30,6 +30,7 @@
 #include <stdbool.h>
 
 #include "device_info.h"
+#include "spi_batch.h"
 
 #define MCP23S08_DEFAULT_SLAVE_ADDRESS	0x00
 
@@ -63,6 +64,8 @@ extern void mcp23s08_gpio_fsel(const device_info_t *, uint8_t, uint8_t);
 extern void mcp23s08_gpio_set(const device_info_t *, uint8_t);
 extern void mcp23s08_gpio_clr(const device_info_t *, uint8_t);
 
+extern void mcp23s08_reg_write_batch(spi_batch_t *, const device_info_t *, uint8_t, uint8_t);
+
 #ifdef __cplusplus
 }
 #endif
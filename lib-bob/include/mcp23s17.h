@@ -30,6 +30,7 @@
 #include <stdbool.h>
 
 #include "device_info.h"
+#include "spi_batch.h"
 
 #define MCP23S17_DEFAULT_SLAVE_ADDRESS	0x00
 
@@ -64,6 +65,8 @@ extern void mcp23s17_gpio_fsel(const device_info_t *, uint16_t, uint8_t);
 extern void mcp23s17_gpio_set(const device_info_t *, uint16_t);
 extern void mcp23s17_gpio_clr(const device_info_t *, uint16_t);
 
+extern void mcp23s17_reg_write_batch(spi_batch_t *, const device_info_t *, uint8_t, uint16_t);
+
 #ifdef __cplusplus
 }
 #endif
@@ -31,6 +31,7 @@
 #include <stdbool.h>
 
 #include "device_info.h"
+#include "spi_batch.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -42,6 +43,9 @@ extern void mcp4902_write_a(const device_info_t *, uint8_t);
 extern void mcp4902_write_b(const device_info_t *, uint8_t);
 extern void mcp4902_write_ab(const device_info_t *, uint8_t, uint8_t);
 
+extern void mcp4902_write_a_batch(spi_batch_t *, const device_info_t *, uint8_t);
+extern void mcp4902_write_b_batch(spi_batch_t *, const device_info_t *, uint8_t);
+
 #ifdef __cplusplus
 }
 #endif
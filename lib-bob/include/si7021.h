@@ -32,6 +32,8 @@
 
 #define SI7021_I2C_DEFAULT_SLAVE_ADDRESS	0x40
 
+#define SI7021_CONVERSION_TIME_MS		80	///< datasheet says 50ms
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -40,6 +42,15 @@ extern bool si7021_start(device_info_t *);
 extern float si7021_get_temperature(const device_info_t *);
 extern float si7021_get_humidity(const device_info_t *);
 
+/*
+ * Non-blocking measurement: start the conversion, then read the result
+ * after at least SI7021_CONVERSION_TIME_MS
+ */
+extern void si7021_start_temperature(const device_info_t *);
+extern void si7021_start_humidity(const device_info_t *);
+extern float si7021_read_temperature(const device_info_t *);
+extern float si7021_read_humidity(const device_info_t *);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,73 @@
+/**
+ * @file spi_batch.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SPI_BATCH_H_
+#define SPI_BATCH_H_
+
+#include <stdint.h>
+
+#include "device_info.h"
+
+#define SPI_BATCH_TRANSFERS_MAX		32
+#define SPI_BATCH_DATA_MAX			4
+
+/*
+ * A list of short SPI writes, issued back-to-back by spi_batch_flush.
+ * The bus is only set up again when the chip select or the speed changes.
+ */
+
+typedef struct spi_batch_transfer {
+	const device_info_t *device_info;
+	uint32_t length;
+	char data[SPI_BATCH_DATA_MAX];
+} spi_batch_transfer_t;
+
+typedef struct spi_batch {
+	uint32_t count;
+	uint32_t flushed;	///< Transfers written by the flushes of a full batch
+	spi_batch_transfer_t transfer[SPI_BATCH_TRANSFERS_MAX];
+} spi_batch_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern void spi_batch_init(spi_batch_t *);
+/*
+ * With batch == NULL the data is written immediately.
+ * A full batch is flushed first.
+ */
+extern void spi_batch_add(spi_batch_t *, const device_info_t *, const char *, uint32_t);
+/*
+ * Returns the number of transfers written since the previous spi_batch_flush,
+ * including those of the flushes of a full batch.
+ */
+extern uint32_t spi_batch_flush(spi_batch_t *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SPI_BATCH_H_ */
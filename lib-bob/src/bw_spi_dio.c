@@ -26,6 +26,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #include "bob.h"
 
@@ -86,20 +87,15 @@ void bw_spi_dio_fsel_mask(const device_info_t *device_info, uint8_t mask) {
 }
 
 void bw_spi_dio_output(const device_info_t *device_info, uint8_t pins) {
+	bw_spi_dio_output_batch(NULL, device_info, pins);
+}
+
+void bw_spi_dio_output_batch(spi_batch_t *batch, const device_info_t *device_info, uint8_t value) {
 	char cmd[3];
 
 	cmd[0] = (char) device_info->slave_address;
 	cmd[1] = (char) BW_PORT_WRITE_SET_ALL_OUTPUTS;
-	cmd[2] = (char) pins;
+	cmd[2] = (char) value;
 
-	if (device_info->chip_select == SPI_CS2) {
-		bcm2835_aux_spi_setClockDivider(device_info->internal.clk_div);
-		bcm2835_aux_spi_writenb(cmd, sizeof(cmd) / sizeof(cmd[0]));
-	} else {
-		FUNC_PREFIX(spi_set_speed_hz(device_info->speed_hz));
-		FUNC_PREFIX(spi_chipSelect(device_info->chip_select));
-		FUNC_PREFIX(spi_setDataMode(SPI_MODE0));
-		FUNC_PREFIX(spi_writenb(cmd, sizeof(cmd) / sizeof(cmd[0])));
-	}
+	spi_batch_add(batch, device_info, cmd, sizeof(cmd) / sizeof(cmd[0]));
 }
-
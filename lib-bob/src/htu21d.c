@@ -88,41 +88,60 @@ bool htu21d_start(device_info_t *device_info) {
 	return true;
 }
 
-static uint16_t get_raw_value(uint8_t cmd) {
+static uint16_t read_raw_value(void) {
 	char buffer[3];
 
-	i2c_write(cmd);
-
-	udelay(80 * 1000);	// datasheet says 50ms
-
 	(void) i2c_read(buffer, 3);
 
 	return (((uint16_t) buffer[0] << 8) | ((uint16_t) buffer[1])) & (uint16_t) 0xFFFC;
 }
 
-float htu21d_get_temperature(const device_info_t *device_info) {
-	uint16_t value;
-	float temp;
+static float convert_temperature(uint16_t value) {
+	const float temp = (float) value / 65536.0;
 
-	i2c_setup(device_info);
+	return -46.85 + (175.72 * temp);
+}
 
-	value = get_raw_value(HTU21D_TEMP);
+static float convert_humidity(uint16_t value) {
+	const float humid = (float) value / 65536.0;
 
-	temp = (float) value / 65536.0;
+	return -6.0 + (125.0 * humid);
+}
 
-	return -46.85 + (175.72 * temp);
+float htu21d_get_temperature(const device_info_t *device_info) {
+	htu21d_start_temperature(device_info);
+
+	udelay(HTU21D_CONVERSION_TIME_MS * 1000);
+
+	return htu21d_read_temperature(device_info);
 }
 
 float htu21d_get_humidity(const device_info_t *device_info) {
-	uint16_t value;
-	float humid;
+	htu21d_start_humidity(device_info);
 
+	udelay(HTU21D_CONVERSION_TIME_MS * 1000);
+
+	return htu21d_read_humidity(device_info);
+}
+
+void htu21d_start_temperature(const device_info_t *device_info) {
 	i2c_setup(device_info);
+	i2c_write(HTU21D_TEMP);
+}
 
-	value = get_raw_value(HTU21D_HUMID);
+void htu21d_start_humidity(const device_info_t *device_info) {
+	i2c_setup(device_info);
+	i2c_write(HTU21D_HUMID);
+}
 
-	humid = (float) value / 65536.0;
+float htu21d_read_temperature(const device_info_t *device_info) {
+	i2c_setup(device_info);
 
-	return -6.0 + (125.0 * humid);
+	return convert_temperature(read_raw_value());
 }
 
+float htu21d_read_humidity(const device_info_t *device_info) {
+	i2c_setup(device_info);
+
+	return convert_humidity(read_raw_value());
+}
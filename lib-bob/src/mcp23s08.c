@@ -25,6 +25,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #include "bob.h"
 
@@ -93,21 +94,7 @@ uint8_t mcp23s08_reg_read(const device_info_t *device_info, uint8_t reg) {
 }
 
 void mcp23s08_reg_write(const device_info_t *device_info, uint8_t reg, uint8_t value) {
-	char spiData[3];
-
-	spiData[0] = (char) MCP23S08_CMD_WRITE	| (char) ((device_info->slave_address) << 1);
-	spiData[1] = (char) reg;
-	spiData[2] = (char) value;
-
-	if (device_info->chip_select == SPI_CS2) {
-		bcm2835_aux_spi_setClockDivider(device_info->internal.clk_div);
-		bcm2835_aux_spi_writenb(spiData, 3);
-	} else {
-		FUNC_PREFIX(spi_set_speed_hz(device_info->speed_hz));
-		FUNC_PREFIX(spi_chipSelect(device_info->chip_select));
-		FUNC_PREFIX(spi_setDataMode(SPI_MODE0));
-		FUNC_PREFIX(spi_writenb(spiData, 3));
-	}
+	mcp23s08_reg_write_batch(NULL, device_info, reg, value);
 }
 
 void mcp23s08_gpio_fsel(const device_info_t *device_info, uint8_t pin, uint8_t mode) {
@@ -133,3 +120,13 @@ void mcp23s08_gpio_clr(const device_info_t *device_info, uint8_t pin) {
 	data &= (~pin);
 	mcp23s08_reg_write(device_info, MCP23S08_GPIO, data);
 }
+
+void mcp23s08_reg_write_batch(spi_batch_t *batch, const device_info_t *device_info, uint8_t reg, uint8_t value) {
+	char spiData[3];
+
+	spiData[0] = (char) MCP23S08_CMD_WRITE	| (char) ((device_info->slave_address) << 1);
+	spiData[1] = (char) reg;
+	spiData[2] = (char) value;
+
+	spi_batch_add(batch, device_info, spiData, 3);
+}
@@ -25,6 +25,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #include "bob.h"
 
@@ -78,21 +79,7 @@ uint16_t mcp23s17_reg_read(const device_info_t *device_info, uint8_t reg) {
 }
 
 void mcp23s17_reg_write(const device_info_t *device_info, uint8_t reg, uint16_t value) {
-	char spiData[4];
-
-	spiData[0] = (char) MCP23X17_CMD_WRITE | (char) ((device_info->slave_address) << 1);
-	spiData[1] = (char) reg;
-	spiData[2] = (char) value;
-	spiData[3] = (char) (value >> 8);
-
-	if (device_info->chip_select == SPI_CS2) {
-		bcm2835_aux_spi_setClockDivider(device_info->internal.clk_div);
-		bcm2835_aux_spi_writenb(spiData, 4);
-	} else {
-		FUNC_PREFIX(spi_set_speed_hz(device_info->speed_hz));
-		FUNC_PREFIX(spi_chipSelect(device_info->chip_select));
-		FUNC_PREFIX(spi_writenb(spiData, 4));
-	}
+	mcp23s17_reg_write_batch(NULL, device_info, reg, value);
 }
 
 void mcp23s17_reg_write_byte(const device_info_t *device_info, uint8_t reg, uint8_t value) {
@@ -134,3 +121,14 @@ void mcp23s17_gpio_clr(const device_info_t *device_info, uint16_t pin) {
 	data &= (~pin);
 	mcp23s17_reg_write(device_info, MCP23X17_GPIOA, data);
 }
+
+void mcp23s17_reg_write_batch(spi_batch_t *batch, const device_info_t *device_info, uint8_t reg, uint16_t value) {
+	char spiData[4];
+
+	spiData[0] = (char) MCP23X17_CMD_WRITE | (char) ((device_info->slave_address) << 1);
+	spiData[1] = (char) reg;
+	spiData[2] = (char) value;
+	spiData[3] = (char) (value >> 8);
+
+	spi_batch_add(batch, device_info, spiData, 4);
+}
@@ -29,6 +29,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #include "bob.h"
 
@@ -57,46 +58,34 @@ bool mcp4822_start(device_info_t *device_info) {
 }
 
 void mcp4822_write_a(const device_info_t *device_info, uint16_t data) {
-	data = MCP4822_DATA(data) | 0x3000 | MCP48X2_WRITE_DAC_A;
-
-	if (device_info->chip_select == SPI_CS2) {
-		bcm2835_aux_spi_setClockDivider(device_info->internal.clk_div);
-		bcm2835_aux_spi_write(data);
-	} else {
-		FUNC_PREFIX(spi_set_speed_hz(device_info->speed_hz));
-		FUNC_PREFIX(spi_chipSelect(device_info->chip_select));
-		FUNC_PREFIX(spi_write(data));
-	}
+	mcp4822_write_a_batch(NULL, device_info, data);
 }
 
 void mcp4822_write_b(const device_info_t *device_info, uint16_t data) {
-	data = MCP4822_DATA(data) | 0x3000 | MCP48X2_WRITE_DAC_B;
+	mcp4822_write_b_batch(NULL, device_info, data);
+}
 
-	if (device_info->chip_select == SPI_CS2) {
-		bcm2835_aux_spi_setClockDivider(device_info->internal.clk_div);
-		bcm2835_aux_spi_write(data);
-	} else {
-		FUNC_PREFIX(spi_set_speed_hz(device_info->speed_hz));
-		FUNC_PREFIX(spi_chipSelect(device_info->chip_select));
-		FUNC_PREFIX(spi_setDataMode(SPI_MODE0));
-		FUNC_PREFIX(spi_write(data));
-	}
+void mcp4822_write_ab(const device_info_t *device_info, uint16_t data_a, uint16_t data_b) {
+	mcp4822_write_a_batch(NULL, device_info, data_a);
+	mcp4822_write_b_batch(NULL, device_info, data_b);
+}
+
+void mcp4822_write_a_batch(spi_batch_t *batch, const device_info_t *device_info, uint16_t data) {
+	const uint16_t value = MCP4822_DATA(data) | 0x3000 | MCP48X2_WRITE_DAC_A;
+	char spiData[2];
+
+	spiData[0] = (char) (value >> 8);
+	spiData[1] = (char) value;
 
+	spi_batch_add(batch, device_info, spiData, 2);
 }
 
-void mcp4822_write_ab(const device_info_t *device_info, uint16_t data_a, uint16_t data_b) {
-	data_a = MCP4822_DATA(data_a) | 0x3000 | MCP48X2_WRITE_DAC_A;
-	data_b = MCP4822_DATA(data_b) | 0x3000 | MCP48X2_WRITE_DAC_B;
+void mcp4822_write_b_batch(spi_batch_t *batch, const device_info_t *device_info, uint16_t data) {
+	const uint16_t value = MCP4822_DATA(data) | 0x3000 | MCP48X2_WRITE_DAC_B;
+	char spiData[2];
 
-	if (device_info->chip_select == SPI_CS2) {
-		bcm2835_aux_spi_setClockDivider(device_info->internal.clk_div);
-		bcm2835_aux_spi_write(data_a);
-		bcm2835_aux_spi_write(data_b);
-	} else {
-		FUNC_PREFIX(spi_set_speed_hz(device_info->speed_hz));
-		FUNC_PREFIX(spi_chipSelect(device_info->chip_select));
-		FUNC_PREFIX(spi_write(data_a));
-		FUNC_PREFIX(spi_write(data_b));
-	}
+	spiData[0] = (char) (value >> 8);
+	spiData[1] = (char) value;
 
+	spi_batch_add(batch, device_info, spiData, 2);
 }
@@ -92,40 +92,60 @@ bool si7021_start(device_info_t *device_info) {
 	return true;
 }
 
-static const uint16_t get_raw_value(uint8_t cmd) {
+static uint16_t read_raw_value(void) {
 	char buffer[3];
 
-	i2c_write(cmd);
-
-	udelay(80 * 1000);	// datasheet says 50ms
-
 	(void) i2c_read(buffer, 3);
 
 	return (((uint16_t) buffer[0] << 8) | ((uint16_t) buffer[1])) & (uint16_t) 0xFFFC;
 }
 
-float si7021_get_temperature(const device_info_t *device_info) {
-	uint16_t value;
-	float temp;
+static float convert_temperature(uint16_t value) {
+	const float temp = (float) value / 65536.0;
 
-	i2c_setup(device_info);
+	return -46.85 + (175.72 * temp);
+}
 
-	value = get_raw_value(SI7021_TEMP);
+static float convert_humidity(uint16_t value) {
+	const float humid = (float) value / 65536.0;
 
-	temp = (float) value / 65536.0;
+	return -6.0 + (125.0 * humid);
+}
 
-	return -46.85 + (175.72 * temp);
+float si7021_get_temperature(const device_info_t *device_info) {
+	si7021_start_temperature(device_info);
+
+	udelay(SI7021_CONVERSION_TIME_MS * 1000);
+
+	return si7021_read_temperature(device_info);
 }
 
 float si7021_get_humidity(const device_info_t *device_info) {
-	uint16_t value;
-	float humid;
+	si7021_start_humidity(device_info);
 
+	udelay(SI7021_CONVERSION_TIME_MS * 1000);
+
+	return si7021_read_humidity(device_info);
+}
+
+void si7021_start_temperature(const device_info_t *device_info) {
+	i2c_setup(device_info);
+	i2c_write(SI7021_TEMP);
+}
+
+void si7021_start_humidity(const device_info_t *device_info) {
+	i2c_setup(device_info);
+	i2c_write(SI7021_HUMID);
+}
+
+float si7021_read_temperature(const device_info_t *device_info) {
 	i2c_setup(device_info);
 
-	value = get_raw_value(SI7021_HUMID);
+	return convert_temperature(read_raw_value());
+}
 
-	humid = (float) value / 65536.0;
+float si7021_read_humidity(const device_info_t *device_info) {
+	i2c_setup(device_info);
 
-	return -6.0 + (125.0 * humid);
+	return convert_humidity(read_raw_value());
 }
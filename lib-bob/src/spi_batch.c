@@ -0,0 +1,135 @@
+/**
+ * @file spi_batch.c
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <assert.h>
+
+#include "bob.h"
+
+#include "spi_batch.h"
+
+static void write_direct(const device_info_t *device_info, const char *data, uint32_t length) {
+	if (device_info->chip_select == SPI_CS2) {
+		bcm2835_aux_spi_setClockDivider(device_info->internal.clk_div);
+		bcm2835_aux_spi_writenb(data, length);
+	} else {
+		FUNC_PREFIX(spi_set_speed_hz(device_info->speed_hz));
+		FUNC_PREFIX(spi_chipSelect(device_info->chip_select));
+		FUNC_PREFIX(spi_setDataMode(SPI_MODE0));
+		FUNC_PREFIX(spi_writenb(data, length));
+	}
+}
+
+static uint32_t write_batch(spi_batch_t *);
+
+void spi_batch_init(spi_batch_t *batch) {
+	assert(batch != NULL);
+
+	batch->count = 0;
+	batch->flushed = 0;
+}
+
+void spi_batch_add(spi_batch_t *batch, const device_info_t *device_info, const char *data, uint32_t length) {
+	uint32_t i;
+	spi_batch_transfer_t *transfer;
+
+	assert(device_info != NULL);
+	assert(length <= SPI_BATCH_DATA_MAX);
+
+	if (batch == NULL) {
+		write_direct(device_info, data, length);
+		return;
+	}
+
+	if (batch->count == SPI_BATCH_TRANSFERS_MAX) {
+		batch->flushed += write_batch(batch);
+	}
+
+	transfer = &batch->transfer[batch->count++];
+
+	transfer->device_info = device_info;
+	transfer->length = length;
+
+	for (i = 0; i < length; i++) {
+		transfer->data[i] = data[i];
+	}
+}
+
+static uint32_t write_batch(spi_batch_t *batch) {
+	const uint32_t count = batch->count;
+	uint32_t i;
+	bool is_setup = false;
+	bool is_aux_setup = false;
+	spi_cs_t chip_select = SPI_CS0;
+	uint32_t speed_hz = 0;
+	uint16_t clk_div = 0;
+
+	for (i = 0; i < count; i++) {
+		const spi_batch_transfer_t *transfer = &batch->transfer[i];
+		const device_info_t *device_info = transfer->device_info;
+
+		if (device_info->chip_select == SPI_CS2) {
+			if (!is_aux_setup || (device_info->internal.clk_div != clk_div)) {
+				clk_div = device_info->internal.clk_div;
+				bcm2835_aux_spi_setClockDivider(clk_div);
+				is_aux_setup = true;
+			}
+
+			bcm2835_aux_spi_writenb(transfer->data, transfer->length);
+		} else {
+			if (!is_setup) {
+				FUNC_PREFIX(spi_setDataMode(SPI_MODE0));
+			}
+
+			if (!is_setup || (device_info->speed_hz != speed_hz)) {
+				speed_hz = device_info->speed_hz;
+				FUNC_PREFIX(spi_set_speed_hz(speed_hz));
+			}
+
+			if (!is_setup || (device_info->chip_select != chip_select)) {
+				chip_select = device_info->chip_select;
+				FUNC_PREFIX(spi_chipSelect(chip_select));
+			}
+
+			is_setup = true;
+
+			FUNC_PREFIX(spi_writenb(transfer->data, transfer->length));
+		}
+	}
+
+	batch->count = 0;
+
+	return count;
+}
+
+uint32_t spi_batch_flush(spi_batch_t *batch) {
+	const uint32_t count = batch->flushed + write_batch(batch);
+
+	batch->flushed = 0;
+
+	return count;
+}
@@ -49,11 +49,16 @@ enum TDisplayUdfLabels {
 	DISPLAY_UDF_LABEL_UNIVERSE_PORT_D,
 	DISPLAY_UDF_LABEL_NETMASK,
 	DISPLAY_UDF_LABEL_DMX_START_ADDRESS,
+	DISPLAY_UDF_LABEL_DMX_STATISTICS,
 	DISPLAY_UDF_LABEL_UNKNOWN
 };
 
 #define DISPLAY_LABEL_MAX_ROWS		6
 
+#if defined (H3)
+class DmxSet;
+#endif
+
 class DisplayUdf: public Display {
 public:
 	DisplayUdf(void);
@@ -70,6 +75,11 @@ public:
 	// LightSet
 	void ShowDmxStartAddress(void);
 
+#if defined (H3)
+	// DMX line statistics, refreshed once a second
+	void ShowDmxStatistics(DmxSet *pDmxSet);
+#endif
+
 	// Network
 	void ShowIpAddress(void);
 	void ShowNetmask(void);
@@ -86,6 +96,9 @@ public:
 private:
 	uint8_t m_aTitle[32];
 	uint8_t m_aLabels[DISPLAY_UDF_LABEL_UNKNOWN];
+#if defined (H3)
+	uint32_t m_nDmxStatisticsMillis;
+#endif
 
 	static DisplayUdf *s_pThis;
 };
@@ -49,6 +49,7 @@ enum TDisplayUdfParamsMask {
 	DISPLAY_UDF_PARAMS_MASK_LABEL_NODE_NAME = (1 << DISPLAY_UDF_LABEL_NODE_NAME),
 	DISPLAY_UDF_PARAMS_MASK_LABEL_NETMASK = (1 << DISPLAY_UDF_LABEL_NETMASK),
 	DISPLAY_UDF_PARAMS_MASK_LABEL_DMX_START_ADDRESS = (1 << DISPLAY_UDF_LABEL_DMX_START_ADDRESS),
+	DISPLAY_UDF_PARAMS_MASK_LABEL_DMX_STATISTICS = (1 << DISPLAY_UDF_LABEL_DMX_STATISTICS),
 	DISPLAY_UDF_PARAMS_MASK_SLEEP_TIMEOUT = (1 << 28)
 }; // Not used
 
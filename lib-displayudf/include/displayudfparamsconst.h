@@ -36,6 +36,7 @@ public:
 	alignas(uint32_t) static const char BOARD_NAME[];
 	alignas(uint32_t) static const char VERSION[];
 	alignas(uint32_t) static const char ACTIVE_PORTS[];
+	alignas(uint32_t) static const char DMX_STATISTICS[];
 };
 
 #endif /* DISPLAYUDFPARAMSCONST_H_ */
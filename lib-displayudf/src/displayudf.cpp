@@ -38,7 +38,11 @@
 
 DisplayUdf *DisplayUdf::s_pThis = 0;
 
-DisplayUdf::DisplayUdf(void): Display(DISPLAY_SSD1306) {
+DisplayUdf::DisplayUdf(void): Display(DISPLAY_SSD1306)
+#if defined (H3)
+	, m_nDmxStatisticsMillis(0)
+#endif
+{
 	DEBUG_ENTRY
 
 	s_pThis = this;
@@ -33,3 +33,4 @@ alignas(uint32_t) const char DisplayUdfParamsConst::TITLE[] = "title";
 alignas(uint32_t) const char DisplayUdfParamsConst::BOARD_NAME[] = "board_name";
 alignas(uint32_t) const char DisplayUdfParamsConst::VERSION[] = "version";
 alignas(uint32_t) const char DisplayUdfParamsConst::ACTIVE_PORTS[] = "active_ports";
+alignas(uint32_t) const char DisplayUdfParamsConst::DMX_STATISTICS[] = "dmx_statistics";
@@ -0,0 +1,85 @@
+/**
+ * @file displayudfshowdmx.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#if defined (H3)
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "displayudf.h"
+
+#include "dmx.h"
+
+#include "hardware.h"
+
+#include "debug.h"
+
+/**
+ * Single port: "DMX 44Hz E:0", multi port: the rate of each port, then the errors
+ */
+void DisplayUdf::ShowDmxStatistics(DmxSet *pDmxSet) {
+	const uint8_t nLine = m_aLabels[DISPLAY_UDF_LABEL_DMX_STATISTICS];
+
+	if (__builtin_expect(((nLine == 0) || (nLine > DISPLAY_LABEL_MAX_ROWS) || (pDmxSet == 0)), 1)) {
+		return;
+	}
+
+	const uint32_t nMillis = Hardware::Get()->Millis();
+
+	if (nMillis - m_nDmxStatisticsMillis < 1000) {
+		return;
+	}
+
+	m_nDmxStatisticsMillis = nMillis;
+
+	char aText[32];
+	uint32_t nLength = 0;
+	uint32_t nErrors = 0;
+	uint32_t nPorts = 0;
+	uint32_t nUpdatesPerSecond = 0;
+
+	for (uint32_t nPort = 0; nPort < DMX_MAX_OUT; nPort++) {
+		const struct _dmx_port_statistics *p = pDmxSet->GetPortStatistics(nPort);
+
+		if (p == 0) {
+			break;
+		}
+
+		nUpdatesPerSecond = p->updates_per_second;
+		nLength += snprintf(&aText[nLength], sizeof(aText) - nLength, "%d ", (int) nUpdatesPerSecond);
+		nErrors += p->framing_errors + p->overrun_errors;
+		nPorts++;
+	}
+
+	if (nPorts == 1) {
+		Printf(nLine, "DMX %3dHz E:%d", (int) nUpdatesPerSecond, (int) nErrors);
+	} else {
+		snprintf(&aText[nLength], sizeof(aText) - nLength, "E:%d", (int) nErrors);
+		ClearLine(nLine);
+		Write(nLine, aText);
+	}
+}
+
+#endif
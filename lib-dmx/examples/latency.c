@@ -0,0 +1,160 @@
+/**
+ * @file latency.c
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "dmx_multi_schedule.h"
+#include "dmx_latency.h"
+
+#define SIMULATION_MICROS	10000000
+#define SLOTS				513
+
+/*
+ * One 512 slot port receiving ArtDmx at a jittered ~33 Hz, starting just
+ * before the counter wraps at 2^32. The latency is from the arrival of the
+ * data until the BREAK of the packet carrying it.
+ */
+static void simulate(_dmx_output_mode mode) {
+	struct _dmx_multi_schedule s;
+	struct _dmx_multi_schedule_actions actions;
+	struct _dmx_latency latency;
+	uint32_t i;
+
+	dmx_latency_reset(&latency);
+	dmx_multi_schedule_init(&s);
+	dmx_multi_schedule_set_mode(&s, 0, mode);
+	dmx_multi_schedule_set_length(&s, 0, SLOTS);
+
+	uint32_t now = 0xFFF00000;
+	const uint32_t start = now;
+	uint32_t wakeup = now;
+	uint32_t break_micros = 0;
+	uint32_t frames = 0;
+	uint32_t violations = 0;
+	uint32_t b2b_min = UINT32_MAX;
+
+	uint32_t new_data = now + 1000;
+	uint32_t received = 0;
+	int pending = 0;
+
+	dmx_multi_schedule_start(&s, 0, now);
+	srand(1);
+
+	while ((uint32_t) (now - start) < SIMULATION_MICROS) {
+		if ((int32_t) (new_data - wakeup) < 0) {
+			const uint32_t delay = dmx_multi_schedule_new_data(&s, 0, new_data);
+
+			if (!pending) {
+				received = new_data;
+				pending = 1;
+			}
+
+			if (delay != 0) {
+				wakeup = new_data + delay;
+			}
+
+			new_data += 15000 + (uint32_t) (rand() % 30000);
+			continue;
+		}
+
+		now = wakeup;
+
+		const uint32_t delay = dmx_multi_schedule_run(&s, now, 0, &actions);
+
+		if (actions.break_start & 1) {
+			if (frames != 0) {
+				const uint32_t b2b = now - break_micros;
+
+				if (b2b < s.port[0].period_min) {
+					violations++;
+				}
+
+				if (b2b < b2b_min) {
+					b2b_min = b2b;
+				}
+			}
+
+			break_micros = now;
+			frames++;
+
+			if (pending) {
+				dmx_latency_add(&latency, now - received);
+				pending = 0;
+			}
+		}
+
+		wakeup = now + delay;
+	}
+
+	printf("%-12s: %u packets/s, break to break min %u us, violations %u, latency average %u us, max %u us\n",
+			mode == DMX_OUTPUT_MODE_ON_NEW_DATA ? "On new data" : "Continuous", frames * 1000000 / SIMULATION_MICROS, b2b_min, violations, dmx_latency_average(&latency), latency.max);
+
+	for (i = 0; i < DMX_LATENCY_BUCKETS; i++) {
+		printf(" <%u:%u", dmx_latency_bucket_limit(i), latency.bucket[i]);
+	}
+
+	printf("\n");
+}
+
+int main(int argc, char **argv) {
+	const uint32_t micros[] = { 0, 63, 64, 127, 128, 65535, 65536, 1000000 };
+	struct _dmx_latency latency;
+	uint32_t i;
+	int failed = 0;
+
+	dmx_latency_reset(&latency);
+
+	for (i = 0; i < sizeof(micros) / sizeof(micros[0]); i++) {
+		dmx_latency_add(&latency, micros[i]);
+	}
+
+	printf("Buckets:");
+
+	for (i = 0; i < DMX_LATENCY_BUCKETS; i++) {
+		printf(" %u", latency.bucket[i]);
+	}
+
+	printf("\n");
+
+	/*
+	 * The receive timestamp is used once, and only when it is recent.
+	 */
+	uint32_t received_last = 0;
+	const uint32_t now = 0x00000100;	// Just after the wrap
+
+	failed |= (dmx_latency_received(0xFFFFFF00, &received_last, now) != 0xFFFFFF00);
+	failed |= (dmx_latency_received(0xFFFFFF00, &received_last, now) != now);
+	failed |= (dmx_latency_received(now - DMX_LATENCY_RECEIVED_MAX - 1, &received_last, now) != now);
+	failed |= (dmx_latency_received(now + 10, &received_last, now) != now);
+
+	printf("dmx_latency_received: %s\n", failed ? "failed" : "OK");
+
+	simulate(DMX_OUTPUT_MODE_CONTINUOUS);
+	simulate(DMX_OUTPUT_MODE_ON_NEW_DATA);
+
+	return failed ? -1 : 0;
+}
@@ -0,0 +1,175 @@
+/**
+ * @file schedule.c
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "dmx_multi_schedule.h"
+
+#define PORTS				4
+#define SIMULATION_MICROS	2000000
+#define IRQ_LATENCY			1
+#define NEW_DATA_INTERVAL	10000	///< 100 Hz on the port capped at 40 Hz
+#define CAPPED_PORT			2
+
+/*
+ * Four ports on the scheduler, starting just before the counter wraps at 2^32.
+ * Checks that break, MAB and break to break are never below their minimums,
+ * and measures how fast new data on a capped port starts a packet.
+ */
+int main(int argc, char **argv) {
+	const uint32_t length[PORTS] = { 25, 513, 101, 101 };
+	struct _dmx_multi_schedule s;
+	struct _dmx_multi_schedule_actions actions;
+	uint32_t i;
+
+	dmx_multi_schedule_init(&s);
+	dmx_multi_schedule_set_period(&s, CAPPED_PORT, 25000);
+	dmx_multi_schedule_set_break_time(&s, 3, 176);
+
+	for (i = 0; i < PORTS; i++) {
+		dmx_multi_schedule_set_length(&s, i, length[i]);
+	}
+
+	uint32_t now = 0xFFFF0000;
+	const uint32_t start = now;
+	uint32_t wakeup = now;
+
+	uint32_t break_micros[PORTS] = { 0 };
+	uint32_t mab_micros[PORTS] = { 0 };
+	uint32_t frames[PORTS] = { 0 };
+	uint32_t b2b_min[PORTS] = { UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX };
+	uint32_t b2b_max[PORTS] = { 0 };
+	uint32_t violations = 0;
+
+	uint32_t new_data = now + NEW_DATA_INTERVAL;
+	uint32_t new_data_micros = 0;
+	uint32_t latency_sum = 0;
+	uint32_t latency_count = 0;
+	uint32_t latency_max = 0;
+	int pending = 0;
+
+	for (i = 0; i < PORTS; i++) {
+		dmx_multi_schedule_start(&s, i, now);
+	}
+
+	while ((uint32_t) (now - start) < SIMULATION_MICROS) {
+		if ((int32_t) (new_data - wakeup) < 0) {
+			const uint32_t t = ((int32_t) (new_data - now) < 0) ? now : new_data;
+			const uint32_t delay = dmx_multi_schedule_new_data(&s, CAPPED_PORT, t);
+
+			if (delay != 0) {
+				wakeup = t + delay;
+			}
+
+			new_data_micros = t;
+			pending = 1;
+			new_data += NEW_DATA_INTERVAL;
+			continue;
+		}
+
+		now = wakeup + IRQ_LATENCY;
+
+		const uint32_t delay = dmx_multi_schedule_run(&s, now, 0, &actions);
+
+		for (i = 0; i < PORTS; i++) {
+			const uint32_t mask = 1U << i;
+
+			if (actions.break_start & mask) {
+				if (frames[i] != 0) {
+					const uint32_t b2b = now - break_micros[i];
+
+					if (b2b < b2b_min[i]) {
+						b2b_min[i] = b2b;
+					}
+
+					if (b2b > b2b_max[i]) {
+						b2b_max[i] = b2b;
+					}
+
+					if (b2b < s.port[i].period_min) {
+						violations++;
+					}
+				}
+
+				break_micros[i] = now;
+				frames[i]++;
+
+				if ((i == CAPPED_PORT) && pending) {
+					const uint32_t latency = now - new_data_micros;
+
+					latency_sum += latency;
+					latency_count++;
+
+					if (latency > latency_max) {
+						latency_max = latency;
+					}
+
+					pending = 0;
+				}
+			}
+
+			if (actions.mab_start & mask) {
+				mab_micros[i] = now;
+
+				if ((now - break_micros[i]) < s.port[i].break_time) {
+					violations++;
+				}
+			}
+
+			if ((actions.data_start & mask) && ((now - mab_micros[i]) < s.port[i].mab_time)) {
+				violations++;
+			}
+		}
+
+		wakeup = now + delay;
+	}
+
+	for (i = 0; i < PORTS; i++) {
+		printf("Port %u: %3u slots, %4u packets/s, break to break %u..%u us, period %u us\n", i, length[i], frames[i] * 1000000 / SIMULATION_MICROS, b2b_min[i], b2b_max[i], s.port[i].period);
+	}
+
+	printf("Capped port new data to break: average %u us, max %u us\n", latency_count != 0 ? latency_sum / latency_count : 0, latency_max);
+	printf("Violations: %u\n", violations);
+
+	struct timespec t0, t1;
+	uint32_t sum = 0;
+
+	now = 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+
+	for (i = 0; i < 10000000; i++) {
+		now += 7;
+		sum += dmx_multi_schedule_run(&s, now, 0, &actions);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+
+	printf("dmx_multi_schedule_run: %.1f ns (%u)\n", ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / 1e7, sum & 1);
+
+	return violations == 0 ? 0 : -1;
+}
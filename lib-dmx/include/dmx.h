@@ -29,12 +29,17 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "dmx_latency.h"
+#include "dmx_port_statistics.h"
+
 #define DMX_MAX_OUT		4
 
 #define DMX_DATA_BUFFER_SIZE					516									///< including SC, aligned 4
 #define DMX_DATA_BUFFER_INDEX_ENTRIES			(1 << 1)							///<
 #define DMX_DATA_BUFFER_INDEX_MASK 				(DMX_DATA_BUFFER_INDEX_ENTRIES - 1)	///<
 
+#include "dmx_changed.h"
+
 #define DMX_TRANSMIT_BREAK_TIME_MIN				92		///< 92 us
 #define DMX_TRANSMIT_BREAK_TIME_TYPICAL			176		///< 176 us
 #define DMX_TRANSMIT_MAB_TIME_MIN				12		///< 12 us
@@ -42,6 +47,7 @@
 #define DMX_TRANSMIT_REFRESH_RATE_DEFAULT		40		///< 40 Hz
 #define DMX_TRANSMIT_PERIOD_DEFAULT				(uint32_t)(1E6 / DMX_TRANSMIT_REFRESH_RATE_DEFAULT)	///< 25000 us
 #define DMX_TRANSMIT_BREAK_TO_BREAK_TIME_MIN	1204	///< us
+#define DMX_TRANSMIT_KEEP_ALIVE_PERIOD_DEFAULT	500000	///< us, on new data output mode
 
 #define DMX_MIN_SLOT_VALUE 						0		///< The minimum value a DMX512 slot can take.
 #define DMX_MAX_SLOT_VALUE 						255		///< The maximum value a DMX512 slot can take.
@@ -56,6 +62,11 @@ typedef enum {
 	DMX_PORT_DIRECTION_INP
 } _dmx_port_direction;
 
+typedef enum {
+	DMX_OUTPUT_MODE_CONTINUOUS,		///< Packets are sent at the output period
+	DMX_OUTPUT_MODE_ON_NEW_DATA		///< A packet starts as soon as new data is queued, the output period is a keep-alive
+} _dmx_output_mode;
+
 struct _dmx_statistics {
 	uint32_t mark_after_break;
 	uint32_t slots_in_packet;
@@ -66,6 +77,7 @@ struct _dmx_statistics {
 struct _dmx_data {
 	uint8_t data[DMX_DATA_BUFFER_SIZE];
 	struct _dmx_statistics statistics;
+	struct _dmx_changed changed;
 };
 
 struct _total_statistics {
@@ -102,6 +114,16 @@ extern void dmx_set_output_period(uint32_t);
 extern /*@shared@*/const /*@null@*/uint8_t *rdm_get_available(void) __attribute__((assume_aligned(4)));
 extern /*@shared@*/const uint8_t *rdm_get_current_data(void) __attribute__((assume_aligned(4)));
 extern uint32_t rdm_get_data_receive_end(void);
+#if defined (H3)
+extern void dmx_set_send_data_without_sc_received(const uint8_t *, uint16_t, uint32_t);
+extern void dmx_set_output_mode(_dmx_output_mode);
+extern _dmx_output_mode dmx_get_output_mode(void);
+extern /*@shared@*/const struct _dmx_latency *dmx_get_output_latency(void);
+extern void dmx_reset_output_latency(void);
+extern /*@shared@*/const struct _dmx_port_statistics *dmx_get_port_statistics(void);
+extern void dmx_reset_port_statistics(void);
+extern void dmx_add_rdm_transaction(bool, uint32_t);
+#endif
 
 #ifdef __cplusplus
 }
@@ -127,9 +149,17 @@ struct TDmxStatistics {
 	uint32_t SlotToSlot;
 };
 
+struct TDmxChanged {
+	uint32_t Bitmap[DMX_CHANGED_BITMAP_WORDS];
+	uint32_t Frame;
+	uint16_t First;
+	uint16_t Last;
+};
+
 struct TDmxData {
 	uint8_t Data[DMX_DATA_BUFFER_SIZE];
 	struct TDmxStatistics Statistics;
+	struct TDmxChanged Changed;
 };
 
 #if defined (H3)
@@ -145,6 +175,18 @@ public:
 	virtual const uint8_t *RdmReceive(uint8_t nPort)=0;
 	virtual const uint8_t *RdmReceiveTimeOut(uint8_t nPort, uint32_t nTimeOut)=0;
 
+	/**
+	 * @return The next received packet (struct TDmxData) when any slot changed, otherwise 0.
+	 * TDmxData::Changed holds the changed slots.
+	 */
+	virtual const uint8_t *GetDmxChanged(uint8_t nPort)=0;
+
+	/**
+	 * @return 0 when the port does not exist
+	 */
+	virtual const struct _dmx_port_statistics *GetPortStatistics(uint8_t nPort)=0;
+	virtual void ResetPortStatistics(uint8_t nPort)=0;
+
 public:
 	inline static DmxSet* Get(void) {
 		return s_pThis;
@@ -165,6 +207,11 @@ public:
 
 	const uint8_t *RdmReceive(uint8_t nPort);
 	const uint8_t *RdmReceiveTimeOut(uint8_t nPort, uint32_t nTimeOut);
+
+	const uint8_t *GetDmxChanged(uint8_t nPort);
+
+	const struct _dmx_port_statistics *GetPortStatistics(uint8_t nPort);
+	void ResetPortStatistics(uint8_t nPort);
 #else
 class Dmx {
 public:
@@ -174,6 +221,10 @@ public:
 	inline void SetPortDirection(uint8_t nPort, TDmxRdmPortDirection tPortDirection, bool bEnableData = false) {
 		dmx_set_port_direction((_dmx_port_direction)tPortDirection, bEnableData);
 	}
+
+	inline const uint8_t *GetDmxChanged(uint8_t nPort) {
+		return dmx_is_data_changed();
+	}
 #endif
 public: // DMX
 	void Init(void);
@@ -214,6 +265,20 @@ public: // DMX
 		return dmx_get_output_period();
 	}
 
+#if defined (H3)
+	inline void SetDmxOutputMode(_dmx_output_mode tOutputMode) {
+		dmx_set_output_mode(tOutputMode);
+	}
+
+	inline _dmx_output_mode GetDmxOutputMode(void) {
+		return dmx_get_output_mode();
+	}
+
+	inline const struct _dmx_latency *GetDmxOutputLatency(void) {
+		return dmx_get_output_latency();
+	}
+#endif
+
 private:
 	bool m_IsInitDone;
 };
@@ -0,0 +1,98 @@
+/**
+ * @file dmx_changed.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef DMX_CHANGED_H_
+#define DMX_CHANGED_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Slots of a received DMX packet that differ from the previous packet.
+ *
+ * Bit n of the bitmap is set when slot n changed, n = 0 is the START Code.
+ * Slots [first, last) hold all the changes, first >= last when nothing changed.
+ * The receiver fills this in as the slots arrive, so nobody has to compare
+ * the complete buffer afterwards.
+ */
+
+#ifndef DMX_DATA_BUFFER_SIZE
+# error Include dmx.h
+#endif
+
+#define DMX_CHANGED_BITMAP_WORDS	((DMX_DATA_BUFFER_SIZE + 31) / 32)
+
+struct _dmx_changed {
+	uint32_t bitmap[DMX_CHANGED_BITMAP_WORDS];
+	uint32_t frame;		///< Packet number, a gap means packets were skipped by the reader
+	uint16_t first;
+	uint16_t last;
+};
+
+inline static void dmx_changed_reset(struct _dmx_changed *c, uint32_t frame) {
+	uint32_t i;
+
+	for (i = 0; i < DMX_CHANGED_BITMAP_WORDS; i++) {
+		c->bitmap[i] = 0;
+	}
+
+	c->frame = frame;
+	c->first = 0;
+	c->last = 0;
+}
+
+/**
+ * Slots are received in order, so only the first change sets first.
+ */
+inline static void dmx_changed_set(struct _dmx_changed *c, uint32_t slot) {
+	c->bitmap[slot >> 5] |= (uint32_t) 1 << (slot & 31);
+
+	if (c->last == 0) {
+		c->first = (uint16_t) slot;
+	}
+
+	c->last = (uint16_t) (slot + 1);
+}
+
+inline static void dmx_changed_set_all(struct _dmx_changed *c, uint32_t slots) {
+	uint32_t i;
+
+	for (i = 0; i < DMX_CHANGED_BITMAP_WORDS; i++) {
+		c->bitmap[i] = 0xFFFFFFFF;
+	}
+
+	c->first = 1;
+	c->last = (uint16_t) (slots + 1);
+}
+
+inline static bool dmx_changed_is_set(const struct _dmx_changed *c, uint32_t slot) {
+	return (c->bitmap[slot >> 5] & ((uint32_t) 1 << (slot & 31))) != 0;
+}
+
+inline static bool dmx_changed_is_empty(const struct _dmx_changed *c) {
+	return c->first >= c->last;
+}
+
+#endif /* DMX_CHANGED_H_ */
@@ -0,0 +1,113 @@
+/**
+ * @file dmx_latency.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef DMX_LATENCY_H_
+#define DMX_LATENCY_H_
+
+#include <stdint.h>
+
+/*
+ * Network-to-wire latency: from the arrival of the packet until the
+ * BREAK of the DMX packet carrying its data.
+ *
+ * Bucket 0 counts latencies below 64 us, bucket n below (64 << n) us,
+ * the last bucket everything from 65536 us.
+ */
+
+#define DMX_LATENCY_BUCKETS		12
+#define DMX_LATENCY_BUCKET_SHIFT	6
+#define DMX_LATENCY_RECEIVED_MAX	1000000	///< An older receive timestamp is not from the packet carrying the data
+
+struct _dmx_latency {
+	uint32_t bucket[DMX_LATENCY_BUCKETS];
+	uint32_t count;
+	uint32_t max;
+	uint64_t total;
+};
+
+inline static void dmx_latency_reset(struct _dmx_latency *l) {
+	uint32_t i;
+
+	for (i = 0; i < DMX_LATENCY_BUCKETS; i++) {
+		l->bucket[i] = 0;
+	}
+
+	l->count = 0;
+	l->max = 0;
+	l->total = 0;
+}
+
+inline static uint32_t dmx_latency_bucket_limit(uint32_t bucket) {
+	return (uint32_t) 1 << (bucket + DMX_LATENCY_BUCKET_SHIFT);
+}
+
+inline static void dmx_latency_add(struct _dmx_latency *l, uint32_t micros) {
+	const uint32_t v = micros >> DMX_LATENCY_BUCKET_SHIFT;
+	uint32_t bucket = 0;
+
+	if (v != 0) {
+		bucket = 32 - (uint32_t) __builtin_clz(v);
+
+		if (bucket >= DMX_LATENCY_BUCKETS) {
+			bucket = DMX_LATENCY_BUCKETS - 1;
+		}
+	}
+
+	l->bucket[bucket]++;
+	l->count++;
+	l->total += micros;
+
+	if (micros > l->max) {
+		l->max = micros;
+	}
+}
+
+/*
+ * The receive timestamp of the network is only valid for data that came with
+ * a new packet. Data from another source (a show file, a merge timeout) gets
+ * now: its timestamp is the one already used, or not within the last
+ * DMX_LATENCY_RECEIVED_MAX us. All times are on a counter that wraps at 2^32.
+ */
+inline static uint32_t dmx_latency_received(uint32_t received, uint32_t *received_last, uint32_t now) {
+	const uint32_t age = now - received;
+
+	if ((received == *received_last) || (age > DMX_LATENCY_RECEIVED_MAX)) {
+		return now;
+	}
+
+	*received_last = received;
+
+	return received;
+}
+
+inline static uint32_t dmx_latency_average(const struct _dmx_latency *l) {
+	if (l->count == 0) {
+		return 0;
+	}
+
+	return (uint32_t) (l->total / l->count);
+}
+
+#endif /* DMX_LATENCY_H_ */
@@ -0,0 +1,127 @@
+/**
+ * @file dmx_multi_schedule.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef DMX_MULTI_SCHEDULE_H_
+#define DMX_MULTI_SCHEDULE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "dmx.h"
+
+/*
+ * Per port DMX output scheduler.
+ *
+ * Each port runs its own BREAK -> MAB -> DATA -> INTER cycle. All times are
+ * in microseconds on a free running 32-bit counter that wraps at 2^32, on the
+ * H3 this is AVS_CNT1 (the HS timer does not). The scheduler has no hardware
+ * dependencies: the driver calls dmx_multi_schedule_run from a single one-shot
+ * timer, performs the returned actions and re-arms the timer with the
+ * returned delay.
+ */
+
+#define DMX_MULTI_SCHEDULE_SLOT_TIME	44		///< 11 bits at 250 kbaud
+#define DMX_MULTI_SCHEDULE_POLL			1000	///< Timer interval when no port is sending
+
+typedef enum {
+	DMX_MULTI_SCHEDULE_IDLE = 0,	///< Port is not sending
+	DMX_MULTI_SCHEDULE_INTER,		///< Mark between packets, waiting for the next break
+	DMX_MULTI_SCHEDULE_BREAK,
+	DMX_MULTI_SCHEDULE_MAB,
+	DMX_MULTI_SCHEDULE_DATA			///< Slots are clocked out
+} _dmx_multi_schedule_state;
+
+struct _dmx_multi_schedule_port {
+	uint32_t break_time;
+	uint32_t mab_time;
+	uint32_t length;				///< Slots including the START Code
+	uint32_t period_requested;		///< 0 is as fast as the slot count allows, or the default keep-alive
+	uint32_t period_min;
+	uint32_t period;
+	uint32_t break_micros;			///< Start of the current packet
+	uint32_t due;					///< Time of the next event
+	_dmx_output_mode mode;
+	volatile _dmx_multi_schedule_state state;
+	volatile bool new_data;
+};
+
+struct _dmx_multi_schedule {
+	struct _dmx_multi_schedule_port port[DMX_MAX_OUT];
+	uint32_t wakeup;				///< Time the timer is armed for
+};
+
+/**
+ * Bit n is set when port n needs the action.
+ */
+struct _dmx_multi_schedule_actions {
+	uint32_t break_start;			///< Set the break condition, take the next data buffer
+	uint32_t mab_start;				///< Clear the break condition
+	uint32_t data_start;			///< Start clocking out the slots
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern void dmx_multi_schedule_init(struct _dmx_multi_schedule *s);
+
+extern void dmx_multi_schedule_set_break_time(struct _dmx_multi_schedule *s, uint32_t port, uint32_t break_time);
+extern void dmx_multi_schedule_set_mab_time(struct _dmx_multi_schedule *s, uint32_t port, uint32_t mab_time);
+extern void dmx_multi_schedule_set_period(struct _dmx_multi_schedule *s, uint32_t port, uint32_t period);
+extern void dmx_multi_schedule_set_length(struct _dmx_multi_schedule *s, uint32_t port, uint32_t length);
+extern void dmx_multi_schedule_set_mode(struct _dmx_multi_schedule *s, uint32_t port, _dmx_output_mode mode);
+
+/*
+ * The functions below return the delay the timer must be re-armed with,
+ * or 0 when the timer is already armed early enough.
+ */
+extern uint32_t dmx_multi_schedule_start(struct _dmx_multi_schedule *s, uint32_t port, uint32_t now);
+extern uint32_t dmx_multi_schedule_new_data(struct _dmx_multi_schedule *s, uint32_t port, uint32_t now);
+
+extern void dmx_multi_schedule_stop(struct _dmx_multi_schedule *s, uint32_t port);
+
+/**
+ * @param busy Bit n is set when port n is still clocking out the previous packet
+ * @return The delay until the next event
+ */
+extern uint32_t dmx_multi_schedule_run(struct _dmx_multi_schedule *s, uint32_t now, uint32_t busy, struct _dmx_multi_schedule_actions *actions);
+
+inline static uint32_t dmx_multi_schedule_get_period(const struct _dmx_multi_schedule *s, uint32_t port) {
+	return s->port[port].period;
+}
+
+inline static _dmx_output_mode dmx_multi_schedule_get_mode(const struct _dmx_multi_schedule *s, uint32_t port) {
+	return s->port[port].mode;
+}
+
+inline static _dmx_multi_schedule_state dmx_multi_schedule_get_state(const struct _dmx_multi_schedule *s, uint32_t port) {
+	return s->port[port].state;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DMX_MULTI_SCHEDULE_H_ */
@@ -0,0 +1,160 @@
+/**
+ * @file dmx_port_statistics.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef DMX_PORT_STATISTICS_H_
+#define DMX_PORT_STATISTICS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "dmx_latency.h"
+
+/*
+ * Line statistics per DMX port, collected by the driver.
+ *
+ * The interrupt handlers only do counter increments and a bucket
+ * index; rates are calculated when the statistics are read.
+ *
+ * Jitter bucket 0 counts break to break changes below 8 us,
+ * bucket n below (8 << n) us, the last bucket everything above.
+ * Slots bucket n counts packets with 64 * n + 1 .. 64 * (n + 1) slots.
+ */
+
+#define DMX_PORT_STATISTICS_JITTER_BUCKETS		10
+#define DMX_PORT_STATISTICS_JITTER_SHIFT		3
+#define DMX_PORT_STATISTICS_SLOTS_BUCKETS		8
+#define DMX_PORT_STATISTICS_SLOTS_SHIFT			6
+
+struct _dmx_port_statistics {
+	uint32_t dmx_packets;		///< Received on an input, sent on an output
+	uint32_t rdm_packets;		///< Received
+	uint32_t updates_per_second;
+	uint32_t framing_errors;
+	uint32_t overrun_errors;
+	uint32_t break_mab;			///< us, latest, input only. From the BREAK detection until the START Code: BREAK + MAB
+	uint32_t break_to_break;	///< us, latest
+	uint32_t jitter[DMX_PORT_STATISTICS_JITTER_BUCKETS];
+	uint32_t slots[DMX_PORT_STATISTICS_SLOTS_BUCKETS];
+	uint32_t rdm_requests;
+	uint32_t rdm_timeouts;
+	struct _dmx_latency rdm_latency;	///< End of the request until the response is received
+	uint32_t rate_packets;
+	uint32_t rate_micros;
+};
+
+inline static void dmx_port_statistics_reset(struct _dmx_port_statistics *s) {
+	uint32_t i;
+
+	s->dmx_packets = 0;
+	s->rdm_packets = 0;
+	s->updates_per_second = 0;
+	s->framing_errors = 0;
+	s->overrun_errors = 0;
+	s->break_mab = 0;
+	s->break_to_break = 0;
+
+	for (i = 0; i < DMX_PORT_STATISTICS_JITTER_BUCKETS; i++) {
+		s->jitter[i] = 0;
+	}
+
+	for (i = 0; i < DMX_PORT_STATISTICS_SLOTS_BUCKETS; i++) {
+		s->slots[i] = 0;
+	}
+
+	s->rdm_requests = 0;
+	s->rdm_timeouts = 0;
+	dmx_latency_reset(&s->rdm_latency);
+	s->rate_packets = 0;
+	s->rate_micros = 0;
+}
+
+inline static uint32_t dmx_port_statistics_jitter_limit(uint32_t bucket) {
+	return (uint32_t) 1 << (bucket + DMX_PORT_STATISTICS_JITTER_SHIFT);
+}
+
+/**
+ * Called with each new break to break time
+ */
+inline static void dmx_port_statistics_add_break_to_break(struct _dmx_port_statistics *s, uint32_t break_to_break) {
+	const uint32_t previous = s->break_to_break;
+	const uint32_t jitter = (break_to_break > previous ? break_to_break - previous : previous - break_to_break) >> DMX_PORT_STATISTICS_JITTER_SHIFT;
+	uint32_t bucket = 0;
+
+	s->break_to_break = break_to_break;
+
+	if (__builtin_expect((previous == 0), 0)) {
+		return;
+	}
+
+	if (jitter != 0) {
+		bucket = 32 - (uint32_t) __builtin_clz(jitter);
+
+		if (bucket >= DMX_PORT_STATISTICS_JITTER_BUCKETS) {
+			bucket = DMX_PORT_STATISTICS_JITTER_BUCKETS - 1;
+		}
+	}
+
+	s->jitter[bucket]++;
+}
+
+inline static void dmx_port_statistics_add_slots(struct _dmx_port_statistics *s, uint32_t slots) {
+	if (__builtin_expect((slots == 0), 0)) {
+		return;
+	}
+
+	s->slots[(slots - 1) >> DMX_PORT_STATISTICS_SLOTS_SHIFT]++;
+}
+
+inline static void dmx_port_statistics_add_rdm(struct _dmx_port_statistics *s, bool has_response, uint32_t latency) {
+	s->rdm_requests++;
+
+	if (has_response) {
+		dmx_latency_add(&s->rdm_latency, latency);
+	} else {
+		s->rdm_timeouts++;
+	}
+}
+
+/**
+ * For the ports without a one second timer; updated when read
+ * @param micros A counter that wraps at 2^32, on the H3 AVS_CNT1
+ */
+inline static void dmx_port_statistics_update_rate(struct _dmx_port_statistics *s, uint32_t micros) {
+	const uint32_t elapsed = micros - s->rate_micros;
+
+	if (__builtin_expect((s->rate_micros == 0), 0)) {
+		s->rate_packets = s->dmx_packets;
+		s->rate_micros = micros;
+		return;
+	}
+
+	if (elapsed >= 1000000) {
+		s->updates_per_second = (uint32_t) (((uint64_t) (s->dmx_packets - s->rate_packets) * 1000000) / elapsed);
+		s->rate_packets = s->dmx_packets;
+		s->rate_micros = micros;
+	}
+}
+
+#endif /* DMX_PORT_STATISTICS_H_ */
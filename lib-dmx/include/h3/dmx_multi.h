@@ -38,13 +38,29 @@ extern void dmx_multi_init(void);
 extern void dmx_multi_init_set_gpiopin(uint8_t port, uint8_t gpio_pin);
 extern void dmx_multi_set_port_direction(uint8_t port, _dmx_port_direction port_direction, bool enable_data);
 extern void dmx_multi_set_port_send_data_without_sc(uint8_t uart, const uint8_t *data, uint16_t length);
+extern void dmx_multi_set_port_send_data_without_sc_received(uint8_t port, const uint8_t *data, uint16_t length, uint32_t received);
 
 extern uint32_t dmx_multi_get_output_break_time(void);
 extern void dmx_multi_set_output_break_time(uint32_t);
 extern uint32_t dmx_multi_get_output_mab_time(void);
 extern void dmx_multi_set_output_mab_time(uint32_t);
+extern void dmx_multi_set_output_period(uint32_t);
 extern uint32_t dmx_multi_get_output_period(void);
 
+extern void dmx_multi_set_port_output_break_time(uint8_t port, uint32_t break_time);
+extern void dmx_multi_set_port_output_mab_time(uint8_t port, uint32_t mab_time);
+extern void dmx_multi_set_port_output_period(uint8_t port, uint32_t period);
+extern uint32_t dmx_multi_get_port_output_period(uint8_t port);
+extern void dmx_multi_set_port_output_mode(uint8_t port, _dmx_output_mode mode);
+extern _dmx_output_mode dmx_multi_get_port_output_mode(uint8_t port);
+
+extern const struct _dmx_latency *dmx_multi_get_port_output_latency(uint8_t port);
+extern void dmx_multi_reset_port_output_latency(uint8_t port);
+
+extern const struct _dmx_port_statistics *dmx_multi_get_port_statistics(uint8_t port);
+extern void dmx_multi_reset_port_statistics(uint8_t port);
+extern void dmx_multi_add_port_rdm_transaction(uint8_t port, bool has_response, uint32_t latency);
+
 extern const uint8_t *dmx_multi_rdm_get_available(uint8_t uart);
 
 #ifdef __cplusplus
@@ -52,15 +52,71 @@ public:
 		return dmx_multi_get_output_mab_time();
 	}
 
+	/**
+	 * @param nPeriod 0 is the maximum refresh the slot count allows
+	 */
+	inline void SetDmxPeriodTime(uint32_t nPeriod) {
+		dmx_multi_set_output_period(nPeriod);
+	}
+
 	inline uint32_t GetDmxPeriodTime(void) {
 		return dmx_multi_get_output_period();
 	}
 
+	inline void SetDmxBreakTime(uint8_t nPort, uint32_t nBreakTime) {
+		dmx_multi_set_port_output_break_time(nPort, nBreakTime);
+	}
+
+	inline void SetDmxMabTime(uint8_t nPort, uint32_t nMabTime) {
+		dmx_multi_set_port_output_mab_time(nPort, nMabTime);
+	}
+
+	inline void SetDmxPeriodTime(uint8_t nPort, uint32_t nPeriod) {
+		dmx_multi_set_port_output_period(nPort, nPeriod);
+	}
+
+	inline uint32_t GetDmxPeriodTime(uint8_t nPort) {
+		return dmx_multi_get_port_output_period(nPort);
+	}
+
+	inline void SetDmxOutputMode(uint8_t nPort, _dmx_output_mode tOutputMode) {
+		dmx_multi_set_port_output_mode(nPort, tOutputMode);
+	}
+
+	inline _dmx_output_mode GetDmxOutputMode(uint8_t nPort) {
+		return dmx_multi_get_port_output_mode(nPort);
+	}
+
+	inline const struct _dmx_latency *GetDmxOutputLatency(uint8_t nPort) {
+		return dmx_multi_get_port_output_latency(nPort);
+	}
+
 	void RdmSendRaw(uint8_t nPort, const uint8_t *pRdmData, uint16_t nLength);
 
 	const uint8_t *RdmReceive(uint8_t nPort);
 	const uint8_t *RdmReceiveTimeOut(uint8_t nPort, uint32_t nTimeOut);
 
+	/**
+	 * The ports are output only
+	 */
+	const uint8_t *GetDmxChanged(uint8_t nPort) {
+		return 0;
+	}
+
+	const struct _dmx_port_statistics *GetPortStatistics(uint8_t nPort) {
+		if (nPort >= DMX_MAX_OUT) {
+			return 0;
+		}
+
+		return dmx_multi_get_port_statistics(nPort);
+	}
+
+	void ResetPortStatistics(uint8_t nPort) {
+		if (nPort < DMX_MAX_OUT) {
+			dmx_multi_reset_port_statistics(nPort);
+		}
+	}
+
 private:
 };
 
@@ -0,0 +1,249 @@
+/**
+ * @file dmx_multi_schedule.c
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include "dmx_multi_schedule.h"
+
+#include "dmx.h"
+
+#ifndef MAX
+ #define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+/*
+ * Wrap safe: true when time a is at or before time b.
+ */
+#define IS_BEFORE_OR_AT(a, b)	((int32_t)((a) - (b)) <= 0)
+
+static void update_period(struct _dmx_multi_schedule_port *p) {
+	const uint32_t package_length_us = p->break_time + p->mab_time + (p->length * DMX_MULTI_SCHEDULE_SLOT_TIME);
+
+	p->period_min = MAX((uint32_t) DMX_TRANSMIT_BREAK_TO_BREAK_TIME_MIN, package_length_us + DMX_MULTI_SCHEDULE_SLOT_TIME);
+
+	if ((p->period_requested == 0) && (p->mode == DMX_OUTPUT_MODE_ON_NEW_DATA)) {
+		// Keep-alive only
+		p->period = MAX(p->period_min, (uint32_t) DMX_TRANSMIT_KEEP_ALIVE_PERIOD_DEFAULT);
+	} else {
+		p->period = MAX(p->period_min, p->period_requested);
+	}
+}
+
+/*
+ * Break to break target for the next packet. New data may start the
+ * packet as soon as the slot count allows.
+ */
+static uint32_t next_break(const struct _dmx_multi_schedule_port *p, uint32_t now) {
+	const uint32_t target = p->break_micros + (p->new_data ? p->period_min : p->period);
+
+	return IS_BEFORE_OR_AT(target, now) ? now : target;
+}
+
+static uint32_t rearm(struct _dmx_multi_schedule *s, uint32_t due, uint32_t now) {
+	if (IS_BEFORE_OR_AT(s->wakeup, due)) {
+		return 0;
+	}
+
+	s->wakeup = due;
+
+	const int32_t delay = (int32_t) (due - now);
+
+	return delay > 0 ? (uint32_t) delay : 1;
+}
+
+void dmx_multi_schedule_init(struct _dmx_multi_schedule *s) {
+	uint32_t i;
+
+	assert(s != 0);
+
+	for (i = 0; i < DMX_MAX_OUT; i++) {
+		struct _dmx_multi_schedule_port *p = &s->port[i];
+
+		p->break_time = DMX_TRANSMIT_BREAK_TIME_MIN;
+		p->mab_time = DMX_TRANSMIT_MAB_TIME_MIN;
+		p->length = 513; // Including START Code
+		p->period_requested = 0;
+		p->break_micros = 0;
+		p->due = 0;
+		p->mode = DMX_OUTPUT_MODE_CONTINUOUS;
+		p->state = DMX_MULTI_SCHEDULE_IDLE;
+		p->new_data = false;
+
+		update_period(p);
+	}
+
+	s->wakeup = 0;
+}
+
+void dmx_multi_schedule_set_break_time(struct _dmx_multi_schedule *s, uint32_t port, uint32_t break_time) {
+	assert(port < DMX_MAX_OUT);
+
+	s->port[port].break_time = MAX((uint32_t) DMX_TRANSMIT_BREAK_TIME_MIN, break_time);
+	update_period(&s->port[port]);
+}
+
+void dmx_multi_schedule_set_mab_time(struct _dmx_multi_schedule *s, uint32_t port, uint32_t mab_time) {
+	assert(port < DMX_MAX_OUT);
+
+	s->port[port].mab_time = MAX((uint32_t) DMX_TRANSMIT_MAB_TIME_MIN, mab_time);
+	update_period(&s->port[port]);
+}
+
+void dmx_multi_schedule_set_period(struct _dmx_multi_schedule *s, uint32_t port, uint32_t period) {
+	assert(port < DMX_MAX_OUT);
+
+	s->port[port].period_requested = period;
+	update_period(&s->port[port]);
+}
+
+void dmx_multi_schedule_set_length(struct _dmx_multi_schedule *s, uint32_t port, uint32_t length) {
+	assert(port < DMX_MAX_OUT);
+	assert(length <= DMX_DATA_BUFFER_SIZE);
+
+	if (s->port[port].length != length) {
+		s->port[port].length = length;
+		update_period(&s->port[port]);
+	}
+}
+
+void dmx_multi_schedule_set_mode(struct _dmx_multi_schedule *s, uint32_t port, _dmx_output_mode mode) {
+	assert(port < DMX_MAX_OUT);
+
+	s->port[port].mode = mode;
+	update_period(&s->port[port]);
+}
+
+uint32_t dmx_multi_schedule_start(struct _dmx_multi_schedule *s, uint32_t port, uint32_t now) {
+	assert(port < DMX_MAX_OUT);
+
+	struct _dmx_multi_schedule_port *p = &s->port[port];
+
+	if (p->state != DMX_MULTI_SCHEDULE_IDLE) {
+		return 0;
+	}
+
+	p->new_data = false;
+	p->due = now;
+	p->state = DMX_MULTI_SCHEDULE_INTER;
+
+	return rearm(s, now, now);
+}
+
+uint32_t dmx_multi_schedule_new_data(struct _dmx_multi_schedule *s, uint32_t port, uint32_t now) {
+	assert(port < DMX_MAX_OUT);
+
+	struct _dmx_multi_schedule_port *p = &s->port[port];
+
+	p->new_data = true;
+
+	if (p->state != DMX_MULTI_SCHEDULE_INTER) {
+		// The packet in progress picks up the flag when it ends
+		return 0;
+	}
+
+	const uint32_t due = next_break(p, now);
+
+	if (IS_BEFORE_OR_AT(p->due, due)) {
+		return 0;
+	}
+
+	p->due = due;
+
+	return rearm(s, due, now);
+}
+
+void dmx_multi_schedule_stop(struct _dmx_multi_schedule *s, uint32_t port) {
+	assert(port < DMX_MAX_OUT);
+
+	s->port[port].state = DMX_MULTI_SCHEDULE_IDLE;
+}
+
+uint32_t dmx_multi_schedule_run(struct _dmx_multi_schedule *s, uint32_t now, uint32_t busy, struct _dmx_multi_schedule_actions *actions) {
+	uint32_t i;
+	int32_t delay = DMX_MULTI_SCHEDULE_POLL;
+
+	actions->break_start = 0;
+	actions->mab_start = 0;
+	actions->data_start = 0;
+
+	for (i = 0; i < DMX_MAX_OUT; i++) {
+		struct _dmx_multi_schedule_port *p = &s->port[i];
+		const uint32_t mask = 1U << i;
+
+		if (p->state == DMX_MULTI_SCHEDULE_IDLE) {
+			continue;
+		}
+
+		while (IS_BEFORE_OR_AT(p->due, now)) {
+			switch (p->state) {
+			case DMX_MULTI_SCHEDULE_INTER:
+				if (busy & mask) {
+					// Previous packet still in the FIFO; try again one slot later
+					p->due = now + DMX_MULTI_SCHEDULE_SLOT_TIME;
+					break;
+				}
+				actions->break_start |= mask;
+				p->new_data = false;
+				p->break_micros = now;
+				p->due = now + p->break_time;
+				p->state = DMX_MULTI_SCHEDULE_BREAK;
+				break;
+			case DMX_MULTI_SCHEDULE_BREAK:
+				actions->mab_start |= mask;
+				p->due = now + p->mab_time;
+				p->state = DMX_MULTI_SCHEDULE_MAB;
+				break;
+			case DMX_MULTI_SCHEDULE_MAB:
+				actions->data_start |= mask;
+				p->due = now + (p->length * DMX_MULTI_SCHEDULE_SLOT_TIME);
+				p->state = DMX_MULTI_SCHEDULE_DATA;
+				break;
+			case DMX_MULTI_SCHEDULE_DATA:
+				p->due = next_break(p, now);
+				p->state = DMX_MULTI_SCHEDULE_INTER;
+				break;
+			default:
+				assert(0);
+				break;
+			}
+		}
+
+		const int32_t d = (int32_t) (p->due - now);
+
+		if (d < delay) {
+			delay = d;
+		}
+	}
+
+	if (delay <= 0) {
+		delay = 1;
+	}
+
+	s->wakeup = now + (uint32_t) delay;
+
+	return (uint32_t) delay;
+}
@@ -33,6 +33,8 @@
 
 #include "debug.h"
 
+static uint32_t s_nRdmRequestEnd;
+
 void Dmx::SetPortDirection(uint8_t nPort, TDmxRdmPortDirection tPortDirection, bool bEnableData) {
 	assert(nPort == 0);
 
@@ -43,6 +45,7 @@ void Dmx::RdmSendRaw(uint8_t nPort, const uint8_t *pRdmData, uint16_t nLength) {
 	assert(nPort == 0);
 
 	rdm_send_data((const uint8_t *) pRdmData, nLength);
+	s_nRdmRequestEnd = h3_hs_timer_lo_us();
 }
 
 const uint8_t *Dmx::RdmReceive(uint8_t nPort) {
@@ -60,9 +63,32 @@ const uint8_t *Dmx::RdmReceiveTimeOut(uint8_t nPort, uint32_t nTimeOut) {
 
 	do {
 		if ((p = (uint8_t *) rdm_get_available()) != 0) {
+			dmx_add_rdm_transaction(true, rdm_get_data_receive_end() - s_nRdmRequestEnd);
 			return (const uint8_t *) p;
 		}
 	} while (h3_hs_timer_lo_us() < nMicros);
 
+	dmx_add_rdm_transaction(false, 0);
+
 	return (const uint8_t *) p;
 }
+
+const uint8_t *Dmx::GetDmxChanged(uint8_t nPort) {
+	assert(nPort == 0);
+
+	return dmx_is_data_changed();
+}
+
+const struct _dmx_port_statistics *Dmx::GetPortStatistics(uint8_t nPort) {
+	if (nPort != 0) {
+		return 0;
+	}
+
+	return dmx_get_port_statistics();
+}
+
+void Dmx::ResetPortStatistics(uint8_t nPort) {
+	assert(nPort == 0);
+
+	dmx_reset_port_statistics();
+}
@@ -88,6 +88,8 @@ static uint32_t dmx_output_break_time = (uint32_t) DMX_TRANSMIT_BREAK_TIME_MIN;
 static uint32_t dmx_output_mab_time = (uint32_t) DMX_TRANSMIT_MAB_TIME_MIN;
 static uint32_t dmx_output_period = (uint32_t) DMX_TRANSMIT_PERIOD_DEFAULT;
 static uint32_t dmx_output_period_requested = (uint32_t) DMX_TRANSMIT_PERIOD_DEFAULT;
+static uint32_t dmx_output_period_min = (uint32_t) DMX_TRANSMIT_BREAK_TO_BREAK_TIME_MIN;
+static volatile _dmx_output_mode dmx_output_mode = DMX_OUTPUT_MODE_CONTINUOUS;
 
 static uint32_t dmx_output_break_time_intv = (uint32_t) (DMX_TRANSMIT_BREAK_TIME_MIN * 12);
 static uint32_t dmx_output_mab_time_intv = (uint32_t) (DMX_TRANSMIT_MAB_TIME_MIN * 12);
@@ -101,10 +103,17 @@ static volatile bool dmx_is_previous_break_dmx = false;
 static volatile uint32_t dmx_break_to_break_latest = 0;
 static volatile uint32_t dmx_break_to_break_previous = 0;
 static volatile uint32_t dmx_slots_in_packet_previous = 0;
+static uint32_t dmx_changed_frame_previous = 0;
 static volatile _dmx_state dmx_send_state = IDLE;
 static volatile bool dmx_send_always = false;
 static volatile uint32_t dmx_send_break_micros = 0;
 static volatile uint32_t dmx_send_current_slot = 0;
+static volatile uint32_t dmx_send_data_received = 0;
+static uint32_t dmx_send_data_received_last = 0;
+static volatile bool dmx_send_data_pending = false;
+static struct _dmx_latency dmx_send_latency ALIGNED;
+static struct _dmx_port_statistics dmx_port_statistics ALIGNED;
+static volatile uint32_t dmx_send_packets = 0;
 static bool is_stopped = true;
 
 static volatile uint32_t rdm_data_buffer_index_head = 0;
@@ -132,20 +141,97 @@ void dmx_set_output_period(const uint32_t period) {
 	const uint32_t package_length_us = dmx_output_break_time + dmx_output_mab_time + (dmx_send_data_length * 44);
 
 	dmx_output_period_requested = period;
+	dmx_output_period_min = (uint32_t) MAX(DMX_TRANSMIT_BREAK_TO_BREAK_TIME_MIN, package_length_us + 44);
 
 	if (period != 0) {
 		if (period < package_length_us) {
-			dmx_output_period = (uint32_t) MAX(DMX_TRANSMIT_BREAK_TO_BREAK_TIME_MIN, package_length_us + 44);
+			dmx_output_period = dmx_output_period_min;
 		} else {
 			dmx_output_period = period;
 		}
+	} else if (dmx_output_mode == DMX_OUTPUT_MODE_ON_NEW_DATA) {
+		// Keep-alive only
+		dmx_output_period = MAX(dmx_output_period_min, (uint32_t) DMX_TRANSMIT_KEEP_ALIVE_PERIOD_DEFAULT);
 	} else {
-		dmx_output_period = (uint32_t) MAX(DMX_TRANSMIT_BREAK_TO_BREAK_TIME_MIN, package_length_us + 44);
+		dmx_output_period = dmx_output_period_min;
 	}
 
 	dmx_output_period_intv = (dmx_output_period * 12) - dmx_output_break_time_intv - dmx_output_mab_time_intv;
 }
 
+void dmx_set_output_mode(_dmx_output_mode mode) {
+	dmx_output_mode = mode;
+	dmx_set_output_period(dmx_output_period_requested);
+}
+
+_dmx_output_mode dmx_get_output_mode(void) {
+	return dmx_output_mode;
+}
+
+const struct _dmx_latency *dmx_get_output_latency(void) {
+	return &dmx_send_latency;
+}
+
+void dmx_reset_output_latency(void) {
+	dmx_latency_reset(&dmx_send_latency);
+}
+
+/**
+ * The DMX and RDM packet counters are shared with dmx_get_total_statistics
+ */
+const struct _dmx_port_statistics *dmx_get_port_statistics(void) {
+	dmx_port_statistics.rdm_packets = total_statistics.rdm_packets;
+
+	if (dmx_port_direction == DMX_PORT_DIRECTION_INP) {
+		dmx_port_statistics.dmx_packets = total_statistics.dmx_packets;
+		dmx_port_statistics.updates_per_second = dmx_updates_per_seconde;
+	} else {
+		dmx_port_statistics.dmx_packets = dmx_send_packets;
+		dmx_port_statistics_update_rate(&dmx_port_statistics, H3_TIMER->AVS_CNT1);
+	}
+
+	return &dmx_port_statistics;
+}
+
+void dmx_reset_port_statistics(void) {
+	__disable_fiq();
+	__disable_irq();
+
+	dmx_port_statistics_reset(&dmx_port_statistics);
+	dmx_reset_total_statistics();
+	dmx_packets_previous = 0;
+	dmx_send_packets = 0;
+
+	__enable_irq();
+	__enable_fiq();
+}
+
+void dmx_add_rdm_transaction(bool has_response, uint32_t latency) {
+	dmx_port_statistics_add_rdm(&dmx_port_statistics, has_response, latency);
+}
+
+/*
+ * In between packets the BREAK is moved forward to the earliest moment
+ * the previous packet allows.
+ */
+static void dmx_send_on_new_data(void) {
+	__disable_irq();
+
+	if (dmx_send_state == DMXINTER) {
+		const uint32_t elapsed = H3_TIMER->AVS_CNT1 - dmx_send_break_micros;
+		uint32_t delay = 4;
+
+		if (elapsed < dmx_output_period_min) {
+			delay = dmx_output_period_min - elapsed;
+		}
+
+		H3_TIMER->TMR0_INTV = delay * 12;
+		H3_TIMER->TMR0_CTRL |= (TIMER_CTRL_EN_START | TIMER_CTRL_RELOAD); // 0x3;
+	}
+
+	__enable_irq();
+}
+
 void dmx_set_send_data(const uint8_t *data, uint16_t length) {
 	do {
 		dmb();
@@ -155,9 +241,13 @@ void dmx_set_send_data(const uint8_t *data, uint16_t length) {
 	memcpy(dmx_data[0].data, data, (size_t)length);
 
 	dmx_set_send_data_length(length);
+
+	if (dmx_output_mode == DMX_OUTPUT_MODE_ON_NEW_DATA) {
+		dmx_send_on_new_data();
+	}
 }
 
-void dmx_set_send_data_without_sc(const uint8_t *data, uint16_t length) {
+void dmx_set_send_data_without_sc_received(const uint8_t *data, uint16_t length, uint32_t received) {
 	do {
 		dmb();
 	} while (dmx_send_state != IDLE && dmx_send_state != DMXINTER);
@@ -168,6 +258,20 @@ void dmx_set_send_data_without_sc(const uint8_t *data, uint16_t length) {
 	memcpy(&dmx_data[0].data[1], data, (size_t) length);
 
 	dmx_set_send_data_length(length + 1);
+
+	if (!dmx_send_data_pending) {
+		dmx_send_data_received = dmx_latency_received(received, &dmx_send_data_received_last, H3_TIMER->AVS_CNT1);
+		dmb();
+		dmx_send_data_pending = true;
+	}
+
+	if (dmx_output_mode == DMX_OUTPUT_MODE_ON_NEW_DATA) {
+		dmx_send_on_new_data();
+	}
+}
+
+void dmx_set_send_data_without_sc(const uint8_t *data, uint16_t length) {
+	dmx_set_send_data_without_sc_received(data, length, H3_TIMER->AVS_CNT1);
 }
 
 void dmx_clear_data(void) {
@@ -223,38 +327,29 @@ volatile uint8_t dmx_get_receive_state(void) {
 }
 
 const uint8_t *dmx_is_data_changed(void) {
-	uint32_t i;
-	uint8_t const *p = (uint8_t *)dmx_get_available();
-	uint32_t *src = (uint32_t *)p;
-	uint32_t *dst = (uint32_t *)dmx_data_previous;
-	bool is_changed = false;
+	const uint8_t *p = dmx_get_available();
 
-	if (src == NULL) {
+	if (p == NULL) {
 		return NULL;
 	}
 
-	const struct _dmx_data *dmx_statistics = (struct _dmx_data *)p;
+	struct _dmx_data *dmx = (struct _dmx_data *)p;
+	const uint32_t slots_in_packet = dmx->statistics.slots_in_packet;
+	const uint32_t frame_previous = dmx_changed_frame_previous;
 
-	if (dmx_statistics->statistics.slots_in_packet != dmx_slots_in_packet_previous) {
-		dmx_slots_in_packet_previous = dmx_statistics->statistics.slots_in_packet;
-		for (i = 0; i < DMX_DATA_BUFFER_SIZE / 4; i++) {
-			*dst= *src;
-			dst++;
-			src++;
-		}
-		return p;
-	}
+	dmx_changed_frame_previous = dmx->changed.frame;
 
-	for (i = 0; i < DMX_DATA_BUFFER_SIZE / 4; i++) {
-		if (*dst != *src) {
-			*dst = *src;
-			is_changed = true;
-		}
-		dst++;
-		src++;
+	/*
+	 * The receiver records the changes against the previous packet only.
+	 * When packets were skipped, or the length is different, all slots are changed.
+	 */
+	if ((slots_in_packet != dmx_slots_in_packet_previous) || (dmx->changed.frame != frame_previous + 1)) {
+		dmx_slots_in_packet_previous = slots_in_packet;
+		dmx_changed_set_all(&dmx->changed, slots_in_packet);
+		return p;
 	}
 
-	return (is_changed ? p : NULL);
+	return (dmx_changed_is_empty(&dmx->changed) ? NULL : p);
 }
 
 _dmx_port_direction dmx_get_port_direction(void) {
@@ -302,7 +397,9 @@ const volatile struct _total_statistics *dmx_get_total_statistics(void) {
 static void fiq_dmx_in_handler(void) {
 	dmx_fiq_micros_current = h3_hs_timer_lo_us();
 
-	if (EXT_UART->LSR & UART_LSR_BI) {
+	const uint32_t lsr = EXT_UART->LSR;
+
+	if (lsr & UART_LSR_BI) {
 #ifdef LOCIG_ANALYZER
 		h3_gpio_set(11); //BREAK
 #endif
@@ -316,6 +413,11 @@ static void fiq_dmx_in_handler(void) {
 
 		const uint8_t data = EXT_UART->O00.RBR;
 
+		if (__builtin_expect(((lsr & (UART_LSR_FE | UART_LSR_OE)) != 0), 0)) {
+			dmx_port_statistics.framing_errors += (lsr & UART_LSR_FE) >> 3;
+			dmx_port_statistics.overrun_errors += (lsr & UART_LSR_OE) >> 1;
+		}
+
 		switch (dmx_receive_state) {
 		case IDLE:
 #ifdef LOCIG_ANALYZER
@@ -337,10 +439,13 @@ static void fiq_dmx_in_handler(void) {
 				dmx_data[dmx_data_buffer_index_head].data[0] = DMX512_START_CODE;
 				dmx_data_index = 1;
 				total_statistics.dmx_packets = total_statistics.dmx_packets + 1;
+				dmx_changed_reset(&dmx_data[dmx_data_buffer_index_head].changed, total_statistics.dmx_packets);
+				dmx_port_statistics.break_mab = dmx_fiq_micros_current - dmx_break_to_break_latest;
 
 				if (dmx_is_previous_break_dmx) {
 					dmx_data[dmx_data_buffer_index_head].statistics.break_to_break = dmx_break_to_break_latest - dmx_break_to_break_previous;
 					dmx_break_to_break_previous = dmx_break_to_break_latest;
+					dmx_port_statistics_add_break_to_break(&dmx_port_statistics, dmx_data[dmx_data_buffer_index_head].statistics.break_to_break);
 
 				} else {
 					dmx_is_previous_break_dmx = true;
@@ -371,6 +476,10 @@ static void fiq_dmx_in_handler(void) {
 			h3_gpio_set(16);
 #endif
 			dmx_data[dmx_data_buffer_index_head].statistics.slot_to_slot = dmx_fiq_micros_current - dmx_fiq_micros_previous;
+			if (dmx_data_previous[dmx_data_index] != data) {
+				dmx_data_previous[dmx_data_index] = data;
+				dmx_changed_set(&dmx_data[dmx_data_buffer_index_head].changed, dmx_data_index);
+			}
 			dmx_data[dmx_data_buffer_index_head].data[dmx_data_index++] = data;
 
 			H3_TIMER->TMR0_INTV = (dmx_data[0].statistics.slot_to_slot + (uint32_t) 12) * 12;
@@ -382,6 +491,7 @@ static void fiq_dmx_in_handler(void) {
 #endif
 				dmx_receive_state = IDLE;
 				dmx_data[dmx_data_buffer_index_head].statistics.slots_in_packet = DMX_MAX_CHANNELS;
+				dmx_port_statistics.slots[DMX_PORT_STATISTICS_SLOTS_BUCKETS - 1]++;
 				dmx_data_buffer_index_head = (dmx_data_buffer_index_head + 1) & DMX_DATA_BUFFER_INDEX_MASK;
 				dmb();
 			}
@@ -470,6 +580,7 @@ static void irq_timer0_dmx_receive(uint32_t clo) {
 			dmb();
 			dmx_receive_state = IDLE;
 			dmx_data[dmx_data_buffer_index_head].statistics.slots_in_packet = dmx_data_index - 1;
+			dmx_port_statistics_add_slots(&dmx_port_statistics, dmx_data_index - 1);
 			dmx_data_buffer_index_head = (dmx_data_buffer_index_head + 1) & DMX_DATA_BUFFER_INDEX_MASK;
 #ifdef LOCIG_ANALYZER
 			h3_gpio_clr(16);
@@ -495,6 +606,9 @@ static void irq_timer1_dmx_receive(uint32_t clo) {
  * Timer 0 interrupt DMX Sender
  */
 static void irq_timer0_dmx_sender(uint32_t clo) {
+	// The network receive timestamps are AVS_CNT1, clo is the HS timer
+	const uint32_t now = H3_TIMER->AVS_CNT1;
+
 	switch (dmx_send_state) {
 	case IDLE:
 	case DMXINTER:
@@ -502,7 +616,20 @@ static void irq_timer0_dmx_sender(uint32_t clo) {
 		H3_TIMER->TMR0_CTRL |= (TIMER_CTRL_EN_START | TIMER_CTRL_RELOAD); // 0x3;
 
 		EXT_UART->LCR = UART_LCR_8_N_2 | UART_LCR_BC;
-		dmx_send_break_micros = clo;
+
+		if (dmx_send_packets != 0) {
+			dmx_port_statistics_add_break_to_break(&dmx_port_statistics, now - dmx_send_break_micros);
+		}
+
+		dmx_send_break_micros = now;
+		dmx_send_packets++;
+		dmx_port_statistics_add_slots(&dmx_port_statistics, dmx_send_data_length - 1);
+
+		if (dmx_send_data_pending) {
+			dmx_latency_add(&dmx_send_latency, now - dmx_send_data_received);
+			dmx_send_data_pending = false;
+		}
+
 		dmb();
 		dmx_send_state = BREAK;
 		break;
@@ -610,15 +737,16 @@ static void dmx_start_data(void) {
 	case DMX_PORT_DIRECTION_OUTP:
 		dmx_send_always = true;
 		dmx_send_state = IDLE;
+		dmx_send_data_pending = false;
 
 		uart_enable_fifo();
 		__enable_fiq();
 
 		irq_timer_set(IRQ_TIMER_0, irq_timer0_dmx_sender);
 
-		const uint32_t clo = h3_hs_timer_lo_us();
+		const uint32_t now = H3_TIMER->AVS_CNT1;
 
-		if (clo - dmx_send_break_micros > dmx_output_period) {
+		if (now - dmx_send_break_micros > dmx_output_period) {
 			H3_TIMER->TMR0_CTRL |= TIMER_CTRL_SINGLE_MODE;
 			H3_TIMER->TMR0_INTV = 4 * 12;
 			H3_TIMER->TMR0_CTRL |= (TIMER_CTRL_EN_START | TIMER_CTRL_RELOAD); // 0x3;
@@ -789,6 +917,8 @@ void dmx_init(void) {
 
 	dmx_send_state = IDLE;
 	dmx_send_always = false;
+	dmx_latency_reset(&dmx_send_latency);
+	dmx_port_statistics_reset(&dmx_port_statistics);
 
 	irq_timer_init();
 
@@ -28,6 +28,7 @@
 #include <assert.h>
 
 #include "dmx_multi_internal.h"
+#include "dmx_multi_schedule.h"
 
 #include "dmx.h"
 #include "rdm.h"
@@ -43,7 +44,6 @@
 #include "h3_ccu.h"
 #include "h3_gpio.h"
 #include "h3_timer.h"
-#include "h3_hs_timer.h"
 
 #include "irq_timer.h"
 
@@ -57,10 +57,18 @@
  #define MAX(a, b) ((a) > (b) ? (a) : (b))
 #endif
 
-extern int console_error(const char *);
-
 #define DMX_DATA_OUT_INDEX	(1 << 2)
 
+#if defined (ORANGE_PI_ONE)
+ #ifndef DO_NOT_USE_UART0
+  #define DMX_MULTI_UARTS	((1 << 0) | (1 << 1) | (1 << 2) | (1 << 3))
+ #else
+  #define DMX_MULTI_UARTS	((1 << 1) | (1 << 2) | (1 << 3))
+ #endif
+#else
+ #define DMX_MULTI_UARTS	((1 << 1) | (1 << 2))
+#endif
+
 typedef enum {
 	IDLE = 0,
 	PRE_BREAK,
@@ -105,13 +113,14 @@ static volatile uint32_t dmx_data_read_index[DMX_MAX_OUT] ALIGNED = { 0, };
 
 static uint32_t dmx_output_break_time = DMX_TRANSMIT_BREAK_TIME_MIN;
 static uint32_t dmx_output_mab_time = DMX_TRANSMIT_MAB_TIME_MIN;
-static uint32_t dmx_output_period = DMX_TRANSMIT_PERIOD_DEFAULT;
 
-static uint32_t dmx_output_break_time_intv = DMX_TRANSMIT_BREAK_TIME_MIN * 12;
-static uint32_t dmx_output_mab_time_intv = DMX_TRANSMIT_MAB_TIME_MIN * 12;
-static uint32_t dmx_output_period_intv = (DMX_TRANSMIT_PERIOD_DEFAULT * 12) - (DMX_TRANSMIT_MAB_TIME_MIN * 12) - (DMX_TRANSMIT_BREAK_TIME_MIN * 12);
+static struct _dmx_multi_schedule dmx_schedule;
 
-static volatile _tx_rx_state dmx_send_state = IDLE;
+static uint32_t dmx_data_received[DMX_MAX_OUT][DMX_DATA_OUT_INDEX] ALIGNED;
+static uint32_t dmx_data_received_last[DMX_MAX_OUT] ALIGNED;
+static struct _dmx_latency dmx_output_latency[DMX_MAX_OUT] ALIGNED;
+static struct _dmx_port_statistics dmx_port_statistics[DMX_MAX_OUT] ALIGNED;
+static uint32_t dmx_break_micros[DMX_MAX_OUT] ALIGNED;
 
 static _dmx_port_direction dmx_port_direction[DMX_MAX_OUT] ALIGNED;
 static uint8_t dmx_data_direction_gpio_pin[DMX_MAX_OUT] ALIGNED;
@@ -125,9 +134,6 @@ static volatile uint32_t rdm_data_read_index[DMX_MAX_OUT] ALIGNED = { 0, };
 static volatile _uart_state uart_state[DMX_MAX_OUT] ALIGNED;
 static volatile uint32_t uarts_sending = 0;
 
-static char CONSOLE_ERROR[] ALIGNED = "DMXDATA %\n";
-#define CONSOLE_ERROR_LENGTH (sizeof(CONSOLE_ERROR) / sizeof(CONSOLE_ERROR[0]))
-
 static void dmx_multi_clear_data(uint8_t uart) {
 	uint32_t i, j;
 
@@ -144,155 +150,74 @@ static void dmx_multi_clear_data(uint8_t uart) {
 	}
 }
 
+static void timer0_rearm(uint32_t delay) {
+	if (delay != 0) {
+		H3_TIMER->TMR0_INTV = delay * 12;
+		H3_TIMER->TMR0_CTRL |= (TIMER_CTRL_EN_START | TIMER_CTRL_RELOAD); // 0x3;
+	}
+}
+
 static void irq_timer0_dmx_multi_sender(uint32_t clo) {
 #ifdef LOGIC_ANALYZER
 	h3_gpio_set(6);
 #endif
+	// The scheduler and the network receive timestamps need a counter that wraps at 2^32, clo is the HS timer
+	const uint32_t now = H3_TIMER->AVS_CNT1;
+	struct _dmx_multi_schedule_actions actions;
+	uint32_t uart;
 
-	switch (dmx_send_state) {
-	case IDLE:
-	case DMXINTER:
-		H3_TIMER->TMR0_INTV = dmx_output_break_time_intv;
-		H3_TIMER->TMR0_CTRL |= (TIMER_CTRL_EN_START | TIMER_CTRL_RELOAD); // 0x3;
-
-		if (uart_state[1] == UART_STATE_TX) {
-			H3_UART1->LCR = UART_LCR_8_N_2 | UART_LCR_BC;
-		}
-
-		if (uart_state[2] == UART_STATE_TX) {
-			H3_UART2->LCR = UART_LCR_8_N_2 | UART_LCR_BC;
-		}
-#if defined (ORANGE_PI_ONE)
-		if (uart_state[3] == UART_STATE_TX) {
-			H3_UART3->LCR = UART_LCR_8_N_2 | UART_LCR_BC;
-		}
- #ifndef DO_NOT_USE_UART0
-		if (uart_state[0] == UART_STATE_TX) {
-			H3_UART0->LCR = UART_LCR_8_N_2 | UART_LCR_BC;
-		}
- #endif
-#endif
+	timer0_rearm(dmx_multi_schedule_run(&dmx_schedule, now, uarts_sending, &actions));
 
-		if (dmx_data_write_index[1] != dmx_data_read_index[1]) {
-			dmx_data_read_index[1] = (dmx_data_read_index[1] + 1) & (DMX_DATA_OUT_INDEX - 1);
+	for (uart = 0; uart < DMX_MAX_OUT; uart++) {
+		const uint32_t mask = 1U << uart;
 
-			p_coherent_region->lli[1].src = (uint32_t) &p_coherent_region->dmx_data[1][dmx_data_read_index[1]].data[0];
-			p_coherent_region->lli[1].len = p_coherent_region->dmx_data[1][dmx_data_read_index[1]].length;
-		}
+		if (actions.break_start & mask) {
+			_get_uart(uart)->LCR = UART_LCR_8_N_2 | UART_LCR_BC;
 
-		if (dmx_data_write_index[2] != dmx_data_read_index[2]) {
-			dmx_data_read_index[2] = (dmx_data_read_index[2] + 1) & (DMX_DATA_OUT_INDEX - 1);
+			if (dmx_data_write_index[uart] != dmx_data_read_index[uart]) {
+				if (dmx_multi_schedule_get_mode(&dmx_schedule, uart) == DMX_OUTPUT_MODE_ON_NEW_DATA) {
+					// Skip stale buffers
+					dmx_data_read_index[uart] = dmx_data_write_index[uart];
+				} else {
+					dmx_data_read_index[uart] = (dmx_data_read_index[uart] + 1) & (DMX_DATA_OUT_INDEX - 1);
+				}
 
-			p_coherent_region->lli[2].src = (uint32_t) &p_coherent_region->dmx_data[2][dmx_data_read_index[2]].data[0];
-			p_coherent_region->lli[2].len = p_coherent_region->dmx_data[2][dmx_data_read_index[2]].length;
-		}
-#if defined (ORANGE_PI_ONE)
-		if (dmx_data_write_index[3] != dmx_data_read_index[3]) {
-			dmx_data_read_index[3] = (dmx_data_read_index[3] + 1) & (DMX_DATA_OUT_INDEX - 1);
+				dmx_latency_add(&dmx_output_latency[uart], now - dmx_data_received[uart][dmx_data_read_index[uart]]);
 
-			p_coherent_region->lli[3].src = (uint32_t) &p_coherent_region->dmx_data[3][dmx_data_read_index[3]].data[0];
-			p_coherent_region->lli[3].len = p_coherent_region->dmx_data[3][dmx_data_read_index[3]].length;
-		}
- #ifndef DO_NOT_USE_UART0
-		if (dmx_data_write_index[0] != dmx_data_read_index[0]) {
-			dmx_data_read_index[0] = (dmx_data_read_index[0] + 1) & (DMX_DATA_OUT_INDEX - 1);
+				p_coherent_region->lli[uart].src = (uint32_t) &p_coherent_region->dmx_data[uart][dmx_data_read_index[uart]].data[0];
+				p_coherent_region->lli[uart].len = p_coherent_region->dmx_data[uart][dmx_data_read_index[uart]].length;
+			}
 
-			p_coherent_region->lli[0].src = (uint32_t) &p_coherent_region->dmx_data[0][dmx_data_read_index[0]].data[0];
-			p_coherent_region->lli[0].len = p_coherent_region->dmx_data[0][dmx_data_read_index[0]].length;
-		}
- #endif
-#endif
+			dmx_multi_schedule_set_length(&dmx_schedule, uart, p_coherent_region->lli[uart].len);
 
-		dmb();
-		dmx_send_state = BREAK;
-		break;
-	case BREAK:
-		H3_TIMER->TMR0_INTV = dmx_output_mab_time_intv;
-		H3_TIMER->TMR0_CTRL |= (TIMER_CTRL_EN_START | TIMER_CTRL_RELOAD); // 0x3;
+			if (dmx_port_statistics[uart].dmx_packets != 0) {
+				dmx_port_statistics_add_break_to_break(&dmx_port_statistics[uart], now - dmx_break_micros[uart]);
+			}
 
-		if (uart_state[1] == UART_STATE_TX) {
-			H3_UART1->LCR = UART_LCR_8_N_2;
+			dmx_break_micros[uart] = now;
+			dmx_port_statistics[uart].dmx_packets++;
+			dmx_port_statistics_add_slots(&dmx_port_statistics[uart], p_coherent_region->lli[uart].len - 1);
 		}
 
-		if (uart_state[2] == UART_STATE_TX) {
-			H3_UART2->LCR = UART_LCR_8_N_2;
-		}
-#if defined (ORANGE_PI_ONE)
-		if (uart_state[3] == UART_STATE_TX) {
-			H3_UART3->LCR = UART_LCR_8_N_2;
-		}
- #ifndef DO_NOT_USE_UART0
-		if (uart_state[0] == UART_STATE_TX) {
-			H3_UART0->LCR = UART_LCR_8_N_2;
+		if (actions.mab_start & mask) {
+			_get_uart(uart)->LCR = UART_LCR_8_N_2;
 		}
- #endif
-#endif
 
-		dmb();
-		dmx_send_state = MAB;
-		break;
-	case MAB:
-		H3_TIMER->TMR0_INTV = dmx_output_period_intv;
-		H3_TIMER->TMR0_CTRL |= (TIMER_CTRL_EN_START | TIMER_CTRL_RELOAD); // 0x3;
+		if (actions.data_start & mask) {
+			H3_DMA_CHL_TypeDef *dma = _get_dma_channel(uart);
 
-		if (uart_state[1] == UART_STATE_TX) {
-			H3_DMA_CHL1->DESC_ADDR = (uint32_t) &p_coherent_region->lli[1];
-			H3_DMA_CHL1->EN = DMA_CHAN_ENABLE_START;
-			uarts_sending |= (1 << 1);
-		}
+			// The FIQ clears the bit when the DMA has finished
+			__disable_fiq();
+			uarts_sending |= mask;
+			__enable_fiq();
 
-		if (uart_state[2] == UART_STATE_TX) {
-			H3_DMA_CHL2->DESC_ADDR = (uint32_t) &p_coherent_region->lli[2];
-			H3_DMA_CHL2->EN = DMA_CHAN_ENABLE_START;
-			uarts_sending |= (1 << 2);
-		}
-#if defined (ORANGE_PI_ONE)
-		if (uart_state[3] == UART_STATE_TX) {
-			H3_DMA_CHL3->DESC_ADDR = (uint32_t) &p_coherent_region->lli[3];
-			H3_DMA_CHL3->EN = DMA_CHAN_ENABLE_START;
-			uarts_sending |= (1 << 3);
+			dma->DESC_ADDR = (uint32_t) &p_coherent_region->lli[uart];
+			dma->EN = DMA_CHAN_ENABLE_START;
 		}
- #ifndef DO_NOT_USE_UART0
-		if (uart_state[0] == UART_STATE_TX) {
-			H3_DMA_CHL0->DESC_ADDR = (uint32_t) &p_coherent_region->lli[0];
-			H3_DMA_CHL0->EN = DMA_CHAN_ENABLE_START;
-			uarts_sending |= (1 << 0);
-		}
- #endif
-#endif
-		isb();
-
-		if (uarts_sending == 0) {
-			dmb();
-			dmx_send_state = DMXINTER;
-		} else {
-			dmb();
-			dmx_send_state = DMXDATA;
-		}
-		break;
-	case DMXDATA:
-		assert(0);
-#ifdef LOGIC_ANALYZER
-		h3_gpio_set(20);
-#endif		
-		CONSOLE_ERROR[CONSOLE_ERROR_LENGTH - 3] = '0' + (char) uarts_sending;
-		console_error(CONSOLE_ERROR);
-#ifdef LOGIC_ANALYZER
-		h3_gpio_clr(20);
-#endif		
-		// Recover from this internal error.
-		uarts_sending = 0;
-		dmb();
-		dmx_send_state = DMXINTER;
-
-		H3_TIMER->TMR0_INTV = 12;
-		H3_TIMER->TMR0_CTRL |= (TIMER_CTRL_EN_START | TIMER_CTRL_RELOAD); // 0x3;
-		break;
-	default:
-		assert(0);
-		break;
 	}
 
+	isb();
+
 #ifdef LOGIC_ANALYZER
 	h3_gpio_clr(6);
 #endif
@@ -303,11 +228,18 @@ static void fiq_rdm_in_handler(uint8_t uart, const H3_UART_TypeDef *u) {
 
 	isb();
 
-	if (u->LSR & UART_LSR_BI) {
+	const uint32_t lsr = u->LSR;
+
+	if (lsr & UART_LSR_BI) {
 		rdm_receive_state[uart] = PRE_BREAK;
 	} else {
 		const uint8_t data = u->O00.RBR;
 
+		if (__builtin_expect(((lsr & (UART_LSR_FE | UART_LSR_OE)) != 0), 0)) {
+			dmx_port_statistics[uart].framing_errors += (lsr & UART_LSR_FE) >> 3;
+			dmx_port_statistics[uart].overrun_errors += (lsr & UART_LSR_OE) >> 1;
+		}
+
 		switch (rdm_receive_state[uart]) {
 		case IDLE:
 			if (data == 0xFE) {
@@ -370,6 +302,7 @@ static void fiq_rdm_in_handler(uint8_t uart, const H3_UART_TypeDef *u) {
 			const struct _rdm_command *p = (struct _rdm_command *)(&rdm_data[uart][rdm_data_write_index[uart]].data[0]);
 
 			if ((rdm_data[uart][rdm_data_write_index[uart]].checksum == 0) && (p->sub_start_code == E120_SC_SUB_MESSAGE)) {
+				dmx_port_statistics[uart].rdm_packets++;
 				rdm_data_write_index[uart] = (rdm_data_write_index[uart] + 1) & RDM_DATA_BUFFER_INDEX_MASK;
 				dmb();
 				rdm_data_current[uart] = &rdm_data[uart][rdm_data_write_index[uart]];
@@ -409,6 +342,7 @@ static void fiq_rdm_in_handler(uint8_t uart, const H3_UART_TypeDef *u) {
 			rdm_data_current[uart]->disc_index++;
 
 			if (rdm_data_current[uart]->disc_index == 4) {
+				dmx_port_statistics[uart].rdm_packets++;
 				rdm_data_write_index[uart] = (rdm_data_write_index[uart] + 1) & RDM_DATA_BUFFER_INDEX_MASK;
 				dmb();
 				rdm_data_current[uart] = &rdm_data[uart][rdm_data_write_index[uart]];
@@ -458,11 +392,6 @@ static void __attribute__((interrupt("FIQ"))) fiq_dmx_multi(void) {
 		H3_GIC_CPUIF->EOI = H3_DMA_IRQn;
 		gic_unpend(H3_DMA_IRQn);
 		isb();
-		
-		if (uarts_sending == 0) {
-			dmb();
-			dmx_send_state = DMXINTER;
-		}
 	}
 
 	// Single 'threaded', there is just a single RDM process
@@ -597,6 +526,12 @@ static void dmx_multi_start_data(uint8_t uart) {
 		uart_enable_fifo(uart);
 		dmb();
 		uart_state[uart] = UART_STATE_TX;
+
+		if (DMX_MULTI_UARTS & (1U << uart)) {
+			__disable_irq();
+			timer0_rearm(dmx_multi_schedule_start(&dmx_schedule, uart, H3_TIMER->AVS_CNT1));
+			__enable_irq();
+		}
 		break;
 	case DMX_PORT_DIRECTION_INP:
 		rdm_receive_state[uart] = IDLE;
@@ -629,21 +564,29 @@ static void dmx_multi_stop_data(uint8_t uart) {
 		H3_UART_TypeDef *p = _get_uart(uart);
 		bool is_idle = false;
 
+		// Only a port in between packets can be stopped
 		do {
-			dmb();
-			if (dmx_send_state == DMXINTER) {
-				while ((p->USR & UART_USR_BUSY) == UART_USR_BUSY)
-					;
+			__disable_irq();
+
+			const _dmx_multi_schedule_state state = dmx_multi_schedule_get_state(&dmx_schedule, uart);
+
+			if ((state == DMX_MULTI_SCHEDULE_INTER) || (state == DMX_MULTI_SCHEDULE_IDLE)) {
+				dmx_multi_schedule_stop(&dmx_schedule, uart);
 				is_idle = true;
 			}
+
+			__enable_irq();
 		} while (!is_idle);
+
+		while ((p->USR & UART_USR_BUSY) == UART_USR_BUSY)
+			;
 	}
 
 	dmb();
 	uart_state[uart] = UART_STATE_IDLE;
 }
 
-void dmx_multi_set_port_send_data_without_sc(uint8_t port, const uint8_t *data, uint16_t length) {
+void dmx_multi_set_port_send_data_without_sc_received(uint8_t port, const uint8_t *data, uint16_t length, uint32_t received) {
 	assert(data != 0);
 	assert(length != 0);
 
@@ -659,7 +602,17 @@ void dmx_multi_set_port_send_data_without_sc(uint8_t port, const uint8_t *data,
 	__builtin_prefetch(data);
 	memcpy(&dst[1], data, (size_t) length);
 
+	dmx_data_received[uart][next] = dmx_latency_received(received, &dmx_data_received_last[uart], H3_TIMER->AVS_CNT1);
 	dmx_data_write_index[uart] = next;
+
+	// A capped port starts its next packet early
+	__disable_irq();
+	timer0_rearm(dmx_multi_schedule_new_data(&dmx_schedule, uart, H3_TIMER->AVS_CNT1));
+	__enable_irq();
+}
+
+void dmx_multi_set_port_send_data_without_sc(uint8_t port, const uint8_t *data, uint16_t length) {
+	dmx_multi_set_port_send_data_without_sc_received(port, data, length, H3_TIMER->AVS_CNT1);
 }
 
 void dmx_multi_set_port_direction(uint8_t port, _dmx_port_direction port_direction, bool enable_data) {
@@ -706,9 +659,13 @@ uint32_t dmx_multi_get_output_break_time(void) {
 }
 
 void dmx_multi_set_output_break_time(uint32_t break_time) {
+	uint32_t uart;
+
 	dmx_output_break_time = MAX((uint32_t)DMX_TRANSMIT_BREAK_TIME_MIN, break_time);
-	dmx_output_break_time_intv = dmx_output_break_time * 12;
-	dmx_output_period_intv = (DMX_TRANSMIT_PERIOD_DEFAULT * 12) - dmx_output_break_time_intv - dmx_output_mab_time_intv;
+
+	for (uart = 0; uart < DMX_MAX_OUT; uart++) {
+		dmx_multi_schedule_set_break_time(&dmx_schedule, uart, dmx_output_break_time);
+	}
 }
 
 uint32_t dmx_multi_get_output_mab_time(void) {
@@ -716,13 +673,91 @@ uint32_t dmx_multi_get_output_mab_time(void) {
 }
 
 void dmx_multi_set_output_mab_time(uint32_t mab_time) {
+	uint32_t uart;
+
 	dmx_output_mab_time = MAX((uint32_t)DMX_TRANSMIT_MAB_TIME_MIN, mab_time);
-	dmx_output_mab_time_intv = dmx_output_mab_time * 12;
-	dmx_output_period_intv = (DMX_TRANSMIT_PERIOD_DEFAULT * 12) - dmx_output_break_time_intv - dmx_output_mab_time_intv;
+
+	for (uart = 0; uart < DMX_MAX_OUT; uart++) {
+		dmx_multi_schedule_set_mab_time(&dmx_schedule, uart, dmx_output_mab_time);
+	}
+}
+
+void dmx_multi_set_output_period(uint32_t period) {
+	uint32_t uart;
+
+	for (uart = 0; uart < DMX_MAX_OUT; uart++) {
+		dmx_multi_schedule_set_period(&dmx_schedule, uart, period);
+	}
 }
 
+/*
+ * The node refreshes each port at its own rate; report the slowest one.
+ */
 uint32_t dmx_multi_get_output_period(void) {
-	return dmx_output_period;
+	uint32_t uart;
+	uint32_t period = 0;
+
+	for (uart = 0; uart < DMX_MAX_OUT; uart++) {
+		if (DMX_MULTI_UARTS & (1U << uart)) {
+			period = MAX(period, dmx_multi_schedule_get_period(&dmx_schedule, uart));
+		}
+	}
+
+	return period;
+}
+
+void dmx_multi_set_port_output_break_time(uint8_t port, uint32_t break_time) {
+	dmx_multi_schedule_set_break_time(&dmx_schedule, _port_to_uart(port), break_time);
+}
+
+void dmx_multi_set_port_output_mab_time(uint8_t port, uint32_t mab_time) {
+	dmx_multi_schedule_set_mab_time(&dmx_schedule, _port_to_uart(port), mab_time);
+}
+
+void dmx_multi_set_port_output_period(uint8_t port, uint32_t period) {
+	dmx_multi_schedule_set_period(&dmx_schedule, _port_to_uart(port), period);
+}
+
+uint32_t dmx_multi_get_port_output_period(uint8_t port) {
+	return dmx_multi_schedule_get_period(&dmx_schedule, _port_to_uart(port));
+}
+
+void dmx_multi_set_port_output_mode(uint8_t port, _dmx_output_mode mode) {
+	dmx_multi_schedule_set_mode(&dmx_schedule, _port_to_uart(port), mode);
+}
+
+_dmx_output_mode dmx_multi_get_port_output_mode(uint8_t port) {
+	return dmx_multi_schedule_get_mode(&dmx_schedule, _port_to_uart(port));
+}
+
+const struct _dmx_latency *dmx_multi_get_port_output_latency(uint8_t port) {
+	return &dmx_output_latency[_port_to_uart(port)];
+}
+
+void dmx_multi_reset_port_output_latency(uint8_t port) {
+	dmx_latency_reset(&dmx_output_latency[_port_to_uart(port)]);
+}
+
+const struct _dmx_port_statistics *dmx_multi_get_port_statistics(uint8_t port) {
+	struct _dmx_port_statistics *s = &dmx_port_statistics[_port_to_uart(port)];
+
+	dmx_port_statistics_update_rate(s, H3_TIMER->AVS_CNT1);
+
+	return s;
+}
+
+void dmx_multi_reset_port_statistics(uint8_t port) {
+	__disable_fiq();
+	__disable_irq();
+
+	dmx_port_statistics_reset(&dmx_port_statistics[_port_to_uart(port)]);
+
+	__enable_irq();
+	__enable_fiq();
+}
+
+void dmx_multi_add_port_rdm_transaction(uint8_t port, bool has_response, uint32_t latency) {
+	dmx_port_statistics_add_rdm(&dmx_port_statistics[_port_to_uart(port)], has_response, latency);
 }
 
 void dmx_multi_init_set_gpiopin(uint8_t port, uint8_t gpio_pin) {
@@ -746,6 +781,8 @@ void dmx_multi_init(void) {
 		dmx_multi_clear_data(i);
 		dmx_data_write_index[i] = 0;
 		dmx_data_read_index[i] = 0;
+		dmx_latency_reset(&dmx_output_latency[i]);
+		dmx_port_statistics_reset(&dmx_port_statistics[i]);
 		// DMA UART TX
 		struct sunxi_dma_lli *lli = &p_coherent_region->lli[i];
 		H3_UART_TypeDef *p = _get_uart(i);
@@ -822,7 +859,7 @@ void dmx_multi_init(void) {
  #endif
 #endif
 
-	dmx_send_state = IDLE;
+	dmx_multi_schedule_init(&dmx_schedule);
 
 	uart_enable_fifo(1);
 	uart_enable_fifo(2);
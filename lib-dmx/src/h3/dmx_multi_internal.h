@@ -72,4 +72,13 @@ inline static H3_UART_TypeDef * _get_uart(uint8_t uart) {
 	return 0;
 }
 
+/*
+ * DMA channel n serves UARTn TX
+ */
+inline static H3_DMA_CHL_TypeDef * _get_dma_channel(uint8_t uart) {
+	assert(uart < DMX_MAX_OUT);
+
+	return (H3_DMA_CHL_TypeDef *) (H3_DMA_CHL0_BASE + (uart * 0x40));
+}
+
 #endif /* DMX_MULTI_INTERNAL_H_ */
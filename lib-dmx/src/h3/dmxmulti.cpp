@@ -40,6 +40,8 @@
 
 #include "debug.h"
 
+static uint32_t s_nRdmRequestEnd[DMX_MAX_OUT];
+
 DmxMulti::DmxMulti(void) {
 	DEBUG_ENTRY
 
@@ -84,6 +86,8 @@ void DmxMulti::RdmSendRaw(uint8_t nPort, const uint8_t* pRdmData, uint16_t nLeng
 	while ((p->USR & UART_USR_BUSY) == UART_USR_BUSY) {
 		(void) p->O00.RBR;
 	}
+
+	s_nRdmRequestEnd[nPort] = h3_hs_timer_lo_us();
 }
 
 const uint8_t* DmxMulti::RdmReceive(uint8_t nPort) {
@@ -101,9 +105,12 @@ const uint8_t* DmxMulti::RdmReceiveTimeOut(uint8_t nPort, uint32_t nTimeOut) {
 
 	do {
 		if ((p = (uint8_t *) dmx_multi_rdm_get_available(_port_to_uart(nPort))) != 0) {
+			dmx_multi_add_port_rdm_transaction(nPort, true, h3_hs_timer_lo_us() - s_nRdmRequestEnd[nPort]);
 			return (const uint8_t *) p;
 		}
 	} while (h3_hs_timer_lo_us() < nMicros);
 
+	dmx_multi_add_port_rdm_transaction(nPort, false, 0);
+
 	return (const uint8_t *) p;
 }
@@ -93,6 +93,7 @@ static volatile bool dmx_is_previous_break_dmx = false;							///< Is the previo
 static volatile uint32_t dmx_break_to_break_latest = (uint32_t) 0;				///<
 static volatile uint32_t dmx_break_to_break_previous = (uint32_t) 0;			///<
 static volatile uint32_t dmx_slots_in_packet_previous = (uint32_t) 0;			///<
+static uint32_t dmx_changed_frame_previous = (uint32_t) 0;						///<
 static volatile uint8_t dmx_send_state = IDLE;									///<
 static volatile bool dmx_send_always = false;									///<
 static volatile uint32_t dmx_send_break_micros = (uint32_t) 0;					///<
@@ -211,43 +212,35 @@ volatile uint8_t dmx_get_receive_state(void) {
  * @ingroup dmx
  *
  * The DMX data is changed when slots in packets is changed,
- * or when the data itself is changed.
+ * or when the data itself is changed. The receiver records the
+ * changed slots in struct _dmx_changed while the packet arrives.
  *
  * @return
  */
 const uint8_t *dmx_is_data_changed(void) {
-	uint16_t i;
-	uint8_t const *p = (uint8_t *)dmx_get_available();
-	uint32_t *src = (uint32_t *)p;
-	uint32_t *dst = (uint32_t *)dmx_data_previous;
-	bool is_changed = false;
+	const uint8_t *p = dmx_get_available();
 
-	if (src == NULL) {
+	if (p == NULL) {
 		return NULL;
 	}
 
-	const struct _dmx_data *dmx_statistics = (struct _dmx_data *)p;
+	struct _dmx_data *dmx = (struct _dmx_data *)p;
+	const uint32_t slots_in_packet = dmx->statistics.slots_in_packet;
+	const uint32_t frame_previous = dmx_changed_frame_previous;
 
-	if (dmx_statistics->statistics.slots_in_packet != dmx_slots_in_packet_previous) {
-		dmx_slots_in_packet_previous = dmx_statistics->statistics.slots_in_packet;
-		for (i = 0; i < DMX_DATA_BUFFER_SIZE / 4; i++) {
-			*dst= *src;
-			dst++;
-			src++;
-		}
-		return p;
-	}
+	dmx_changed_frame_previous = dmx->changed.frame;
 
-	for (i = 0; i < DMX_DATA_BUFFER_SIZE / 4; i++) {
-		if (*dst != *src) {
-			*dst = *src;
-			is_changed = true;
-		}
-		dst++;
-		src++;
+	/*
+	 * The receiver records the changes against the previous packet only.
+	 * When packets were skipped, or the length is different, all slots are changed.
+	 */
+	if ((slots_in_packet != dmx_slots_in_packet_previous) || (dmx->changed.frame != frame_previous + 1)) {
+		dmx_slots_in_packet_previous = slots_in_packet;
+		dmx_changed_set_all(&dmx->changed, slots_in_packet);
+		return p;
 	}
 
-	return (is_changed ? p : NULL);
+	return (dmx_changed_is_empty(&dmx->changed) ? NULL : p);
 }
 
 _dmx_port_direction dmx_get_port_direction(void) {
@@ -327,6 +320,7 @@ static void fiq_dmx_in_handler(void) {
 				dmx_data[dmx_data_buffer_index_head].data[0] = DMX512_START_CODE;
 				dmx_data_index = 1;
 				total_statistics.dmx_packets = total_statistics.dmx_packets + 1;
+				dmx_changed_reset(&dmx_data[dmx_data_buffer_index_head].changed, total_statistics.dmx_packets);
 				if (dmx_is_previous_break_dmx) {
 					dmx_data[dmx_data_buffer_index_head].statistics.break_to_break = dmx_break_to_break_latest - dmx_break_to_break_previous;
 					dmx_break_to_break_previous = dmx_break_to_break_latest;
@@ -367,6 +361,10 @@ static void fiq_dmx_in_handler(void) {
 			if (dmx_data[dmx_data_buffer_index_head].statistics.slot_to_slot < 44) { // Broadcom BUG ? FIQ is late
 				dmx_data[dmx_data_buffer_index_head].statistics.slot_to_slot = (uint32_t)44;
 			}
+			if (dmx_data_previous[dmx_data_index] != data) {
+				dmx_data_previous[dmx_data_index] = data;
+				dmx_changed_set(&dmx_data[dmx_data_buffer_index_head].changed, dmx_data_index);
+			}
 			dmx_data[dmx_data_buffer_index_head].data[dmx_data_index++] = data;
 		    BCM2835_ST->C1 = dmx_fiq_micros_current + dmx_data[0].statistics.slot_to_slot + (uint32_t)12;
 			if (dmx_data_index > DMX_MAX_CHANNELS) {
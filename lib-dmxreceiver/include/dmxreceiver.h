@@ -47,14 +47,9 @@ public:
 
 	void Print(void);
 
-private:
-	bool IsDmxDataChanged(const uint8_t *pData, uint16_t nLength);
-
 private:
 	LightSet *m_pLightSet;
 	bool m_IsActive;
-	alignas(uint32_t) uint8_t m_Data[DMX_DATA_BUFFER_SIZE]; // With DMX Start Code
-	uint16_t m_nLength;
 };
 
 #endif /* DMXCONTROLLER_H_ */
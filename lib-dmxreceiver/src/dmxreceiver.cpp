@@ -34,17 +34,9 @@
 DMXReceiver::DMXReceiver(uint8_t nGpioPin) :
 	Dmx(nGpioPin, false),
 	m_pLightSet(0),
-	m_IsActive(false),
-	m_nLength(0)
+	m_IsActive(false)
 {
 	DEBUG1_ENTRY
-
-	uint32_t *p = (uint32_t *)m_Data;
-
-	for (uint32_t i = 0; i < (sizeof m_Data) / 4; i ++) {
-		*p++ = 0;
-	}
-
 	DEBUG1_EXIT
 }
 
@@ -86,32 +78,6 @@ void DMXReceiver::Stop(void) {
 	DEBUG1_EXIT
 }
 
-bool DMXReceiver::IsDmxDataChanged(const uint8_t *pData, uint16_t nLength) {
-	bool isChanged = false;
-
-	const uint8_t *src = pData;
-	uint8_t *dst = (uint8_t *) m_Data;
-
-	if (nLength != m_nLength) {
-		m_nLength = nLength;
-
-		for (uint32_t i = 0; i < nLength; i++) {
-			*dst++ = *src++;
-		}
-
-		return true;
-	}
-
-	for (uint32_t i = 0; i < nLength; i++) {
-		if (*dst != *src) {
-			isChanged = true;
-		}
-		*dst++ = *src++;
-	}
-
-	return isChanged;
-}
-
 const uint8_t* DMXReceiver::Run(int16_t &nLength) {
 	uint8_t* p = 0;
 
@@ -124,25 +90,26 @@ const uint8_t* DMXReceiver::Run(int16_t &nLength) {
 		nLength = -1;
 		return 0;
 	} else {
-		const uint8_t *pDmx = GetDmxAvailable();
+		const uint8_t *pDmx = GetDmxChanged(0);
 
 		if (pDmx != 0) {
-			const struct TDmxData *dmx_statistics = (struct TDmxData *) pDmx;
-			nLength = (uint16_t) (dmx_statistics->Statistics.SlotsInPacket);
-
-			if (IsDmxDataChanged(++pDmx, nLength)) {  // Skip DMX START CODE
+			const struct TDmxData *pDmxData = (struct TDmxData *) pDmx;
+			nLength = (uint16_t) (pDmxData->Statistics.SlotsInPacket);
 
-				DEBUG_PRINTF("\tDMX Data Changed", __FILE__, __FUNCTION__, __LINE__);
+			DEBUG_PRINTF("\tDMX Data Changed [%d, %d)", (int) pDmxData->Changed.First, (int) pDmxData->Changed.Last);
 
-				m_pLightSet->SetData(0, pDmx, nLength);
-				p = (uint8_t*) pDmx;
-			}
+			// Skip DMX START CODE, the changed slots are relative to it
+			m_pLightSet->SetDataChanged(0, ++pDmx, nLength, pDmxData->Changed.First - 1, pDmxData->Changed.Last - 1);
+			m_pLightSet->Sync();
+			p = (uint8_t*) pDmx;
+		}
 
-			if (!m_IsActive) {
-				m_pLightSet->Start(0);
-				m_IsActive = true;
-			}
+		if (!m_IsActive) {
+			m_pLightSet->Start(0);
+			m_IsActive = true;
+		}
 
+		if (p != 0) {
 			return p;
 		}
 	}
@@ -42,12 +42,14 @@ struct TDMXParams {
 	uint8_t nBreakTime;		///< DMX output break time in 10.67 microsecond units. Valid range is 9 to 127.
 	uint8_t nMabTime;		///< DMX output Mark After Break time in 10.67 microsecond units. Valid range is 1 to 127.
 	uint8_t nRefreshRate;	///< DMX output rate in packets per second. Valid range is 1 to 40.
+	bool bOnNewData;		///< Send a packet as soon as new data arrives, the refresh rate is a keep-alive
 };
 
 enum TDmxSendParamsMask {
 	DMX_SEND_PARAMS_MASK_BREAK_TIME = (1 << 0),
 	DMX_SEND_PARAMS_MASK_MAB_TIME = (1 << 1),
-	DMX_SEND_PARAMS_MASK_REFRESH_RATE = (1 << 2)
+	DMX_SEND_PARAMS_MASK_REFRESH_RATE = (1 << 2),
+	DMX_SEND_PARAMS_MASK_ON_NEW_DATA = (1 << 3)
 };
 
 class DMXParamsStore {
@@ -88,6 +90,10 @@ public:
 		return m_tDMXParams.nRefreshRate;
 	}
 
+	bool IsOnNewData(void) {
+		return m_tDMXParams.bOnNewData;
+	}
+
 public:
     static void staticCallbackFunction(void *p, const char *s);
 
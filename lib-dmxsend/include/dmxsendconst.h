@@ -35,6 +35,7 @@ public:
 	alignas(uint32_t) static const char PARAMS_BREAK_TIME[];
 	alignas(uint32_t) static const char PARAMS_MAB_TIME[];
 	alignas(uint32_t) static const char PARAMS_REFRESH_RATE[];
+	alignas(uint32_t) static const char PARAMS_ON_NEW_DATA[];
 };
 
 #endif /* DMXSENDCONST_H_ */
@@ -29,6 +29,9 @@
 #include "dmxsend.h"
 
 #include "dmx.h"
+#if defined (H3)
+ #include "network.h"
+#endif
 
 #include "debug.h"
 
@@ -74,7 +77,11 @@ void DMXSend::SetData(uint8_t nPortId, const uint8_t *pData, uint16_t nLength) {
 		return;
 	}
 
+#if defined (H3)
+	dmx_set_send_data_without_sc_received(pData, nLength, Network::Get()->GetRecvTimestamp());
+#else
 	dmx_set_send_data_without_sc(pData, nLength);
+#endif
 
 	DEBUG_EXIT
 }
@@ -32,3 +32,4 @@ alignas(uint32_t) const char DMXSendConst::PARAMS_FILE_NAME[] = "params.txt";
 alignas(uint32_t) const char DMXSendConst::PARAMS_BREAK_TIME[] = "dmxsend_break_time";
 alignas(uint32_t) const char DMXSendConst::PARAMS_MAB_TIME[] = "dmxsend_mab_time";
 alignas(uint32_t) const char DMXSendConst::PARAMS_REFRESH_RATE[] = "dmxsend_refresh_rate";
+alignas(uint32_t) const char DMXSendConst::PARAMS_ON_NEW_DATA[] = "dmxsend_on_new_data";
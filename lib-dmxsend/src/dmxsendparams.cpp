@@ -56,6 +56,7 @@ DMXParams::DMXParams(DMXParamsStore *pDMXParamsStore) : m_pDMXParamsStore(pDMXPa
 	m_tDMXParams.nBreakTime = DMX_PARAMS_DEFAULT_BREAK_TIME;
 	m_tDMXParams.nMabTime = DMX_PARAMS_DEFAULT_MAB_TIME;
 	m_tDMXParams.nRefreshRate = DMX_PARAMS_DEFAULT_REFRESH_RATE;
+	m_tDMXParams.bOnNewData = false;
 }
 
 DMXParams::~DMXParams(void) {
@@ -117,6 +118,9 @@ void DMXParams::callbackFunction(const char *pLine) {
 	} else if (Sscan::Uint8(pLine, DMXSendConst::PARAMS_REFRESH_RATE, &value8) == SSCAN_OK) {
 		m_tDMXParams.nRefreshRate = value8;
 		m_tDMXParams.nSetList |= DMX_SEND_PARAMS_MASK_REFRESH_RATE;
+	} else if (Sscan::Uint8(pLine, DMXSendConst::PARAMS_ON_NEW_DATA, &value8) == SSCAN_OK) {
+		m_tDMXParams.bOnNewData = (value8 != 0);
+		m_tDMXParams.nSetList |= DMX_SEND_PARAMS_MASK_ON_NEW_DATA;
 	}
 }
 
@@ -139,6 +143,10 @@ void DMXParams::Dump(void) {
 	if (isMaskSet(DMX_SEND_PARAMS_MASK_REFRESH_RATE)) {
 		printf(" %s=%d\n", DMXSendConst::PARAMS_REFRESH_RATE, (int) m_tDMXParams.nRefreshRate);
 	}
+
+	if (isMaskSet(DMX_SEND_PARAMS_MASK_ON_NEW_DATA)) {
+		printf(" %s=%d\n", DMXSendConst::PARAMS_ON_NEW_DATA, (int) m_tDMXParams.bOnNewData);
+	}
 #endif
 }
 
@@ -50,6 +50,7 @@ bool DMXParams::Builder(const struct TDMXParams *ptDMXParams, uint8_t *pBuffer,
 	bool isAdded = builder.Add(DMXSendConst::PARAMS_BREAK_TIME, m_tDMXParams.nBreakTime, isMaskSet(DMX_SEND_PARAMS_MASK_BREAK_TIME));
 	isAdded &= builder.Add(DMXSendConst::PARAMS_MAB_TIME, m_tDMXParams.nMabTime, isMaskSet(DMX_SEND_PARAMS_MASK_MAB_TIME));
 	isAdded &= builder.Add(DMXSendConst::PARAMS_REFRESH_RATE, m_tDMXParams.nRefreshRate, isMaskSet(DMX_SEND_PARAMS_MASK_REFRESH_RATE));
+	isAdded &= builder.Add(DMXSendConst::PARAMS_ON_NEW_DATA, m_tDMXParams.bOnNewData, isMaskSet(DMX_SEND_PARAMS_MASK_ON_NEW_DATA));
 
 	nSize = builder.GetSize();
 
@@ -46,6 +46,16 @@ void DMXParams::Set(DMXSend *pDMXSend) {
 		}
 		pDMXSend->SetDmxPeriodTime(period);
 	}
+
+#if defined (H3)
+	if (isMaskSet(DMX_SEND_PARAMS_MASK_ON_NEW_DATA)) {
+		pDMXSend->SetDmxOutputMode(m_tDMXParams.bOnNewData ? DMX_OUTPUT_MODE_ON_NEW_DATA : DMX_OUTPUT_MODE_CONTINUOUS);
+
+		if (m_tDMXParams.bOnNewData && !isMaskSet(DMX_SEND_PARAMS_MASK_REFRESH_RATE)) {
+			pDMXSend->SetDmxPeriodTime(0);	// Default keep-alive
+		}
+	}
+#endif
 }
 
 #if defined (H3)
@@ -59,5 +69,25 @@ void DMXParams::Set(DMXSendMulti *pDMXSendMulti) {
 	if (isMaskSet(DMX_SEND_PARAMS_MASK_MAB_TIME)) {
 		pDMXSendMulti->SetDmxMabTime(m_tDMXParams.nMabTime);
 	}
+
+	if (isMaskSet(DMX_SEND_PARAMS_MASK_REFRESH_RATE)) {
+		uint32_t period = (uint32_t) 0;
+		if (m_tDMXParams.nRefreshRate != (uint8_t) 0) {
+			period = (uint32_t) (1000000 / m_tDMXParams.nRefreshRate);
+		}
+		pDMXSendMulti->SetDmxPeriodTime(period);
+	}
+
+	if (isMaskSet(DMX_SEND_PARAMS_MASK_ON_NEW_DATA)) {
+		const _dmx_output_mode tOutputMode = m_tDMXParams.bOnNewData ? DMX_OUTPUT_MODE_ON_NEW_DATA : DMX_OUTPUT_MODE_CONTINUOUS;
+
+		for (uint32_t nPort = 0; nPort < DMX_MAX_OUT; nPort++) {
+			pDMXSendMulti->SetDmxOutputMode(nPort, tOutputMode);
+		}
+
+		if (m_tDMXParams.bOnNewData && !isMaskSet(DMX_SEND_PARAMS_MASK_REFRESH_RATE)) {
+			pDMXSendMulti->SetDmxPeriodTime(0);	// Default keep-alive
+		}
+	}
 }
 #endif
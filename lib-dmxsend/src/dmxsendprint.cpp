@@ -36,4 +36,13 @@ void DMXSend::Print(void) {
 	printf(" Break time   : %d\n", (int) GetDmxBreakTime());
 	printf(" MAB time     : %d\n", (int) GetDmxMabTime());
 	printf(" Refresh rate : %d\n", (int) ((float) 1000000 / GetDmxPeriodTime()));
+#if defined (H3)
+	const struct _dmx_latency *pLatency = GetDmxOutputLatency();
+
+	printf(" Output mode  : %s\n", GetDmxOutputMode() == DMX_OUTPUT_MODE_ON_NEW_DATA ? "On new data" : "Continuous");
+
+	if (pLatency->count != 0) {
+		printf(" Latency      : avg %d us, max %d us (%d)\n", (int) dmx_latency_average(pLatency), (int) pLatency->max, (int) pLatency->count);
+	}
+#endif
 }
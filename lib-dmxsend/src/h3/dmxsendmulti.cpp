@@ -29,6 +29,8 @@
 #include "h3/dmxsendmulti.h"
 #include "h3/dmx_multi.h"
 
+#include "network.h"
+
 #include "debug.h"
 
 #define MAX_PORTS (sizeof(m_bIsStarted) / sizeof(m_bIsStarted[0]))
@@ -99,7 +101,7 @@ void DMXSendMulti::SetData(uint8_t nPort, const uint8_t *pData, uint16_t nLength
 		return;
 	}
 
-	dmx_multi_set_port_send_data_without_sc(nPort, pData, nLength);
+	dmx_multi_set_port_send_data_without_sc_received(nPort, pData, nLength, Network::Get()->GetRecvTimestamp());
 
 	DEBUG_EXIT
 }
@@ -32,4 +32,29 @@ void DMXSendMulti::Print(void) {
 	printf(" Break time   : %d\n", (int) GetDmxBreakTime());
 	printf(" MAB time     : %d\n", (int) GetDmxMabTime());
 	printf(" Refresh rate : %d\n", (int) (1000000 / GetDmxPeriodTime()));
+
+	for (uint32_t i = 0; i < (sizeof(m_bIsStarted) / sizeof(m_bIsStarted[0])); i++) {
+		if (!m_bIsStarted[i]) {
+			continue;
+		}
+
+		const struct _dmx_latency *pLatency = GetDmxOutputLatency((uint8_t) i);
+
+		printf("  Port %d     : %d Hz%s\n", (int) i, (int) (1000000 / GetDmxPeriodTime((uint8_t) i)), GetDmxOutputMode((uint8_t) i) == DMX_OUTPUT_MODE_ON_NEW_DATA ? " keep-alive, on new data" : "");
+
+		if (pLatency->count == 0) {
+			continue;
+		}
+
+		printf("   Latency    : avg %d us, max %d us (%d)\n", (int) dmx_latency_average(pLatency), (int) pLatency->max, (int) pLatency->count);
+		printf("   <us");
+
+		for (uint32_t nBucket = 0; nBucket < DMX_LATENCY_BUCKETS; nBucket++) {
+			if (pLatency->bucket[nBucket] != 0) {
+				printf(" %d:%d", (int) dmx_latency_bucket_limit(nBucket), (int) pLatency->bucket[nBucket]);
+			}
+		}
+
+		printf("\n");
+	}
 }
@@ -30,7 +30,11 @@
 #include <stdint.h>
 
 enum {
+#if defined (PIXEL_MULTI)
+	E131_MAX_PORTS = 64	///< 8 outputs of 6 universes, also the 16 Art-Net 4 pages
+#else
 	E131_MAX_PORTS = 16
+#endif
 };
 
 enum TE131PortDir {
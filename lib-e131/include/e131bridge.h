@@ -35,6 +35,7 @@
 #include "e131dmx.h"
 
 #include "lightset.h"
+#include "lightsetscheduler.h"
 
 enum {
 	E131_MAX_UARTS = 4
@@ -72,9 +73,12 @@ struct TSource {
 struct TE131OutputPort {
 	uint8_t data[E131_DMX_LENGTH];
 	uint16_t length;
+	uint16_t nChangedFirst;	///< First slot changed since the last hand-off to the LightSet
+	uint16_t nChangedLast;	///< One past the last slot changed since the last hand-off to the LightSet
 	uint16_t nUniverse;
 	TE131Merge mergeMode;
 	bool IsDataPending;
+	bool IsCommitPending;
 	bool bIsEnabled;
 	bool IsTransmitting;
 	bool IsMerging;
@@ -123,6 +127,31 @@ public:
 		return m_bDirectUpdate;
 	}
 
+	/**
+	 * Synchronized universes are presented at (arrival of the synchronization packet + delay)
+	 * on the timeline of NtpClock. A delay of 0 presents them on arrival.
+	 */
+	void SetPresentationDelay(uint32_t nMicros) {
+		m_Scheduler.SetPresentationDelay(nMicros);
+	}
+	uint32_t GetPresentationDelay(void) {
+		return m_Scheduler.GetPresentationDelay();
+	}
+	const struct TLightSetSchedulerStats& GetSchedulerStats(void) {
+		return m_Scheduler.GetStats();
+	}
+
+	/**
+	 * Without synchronization, a frame is committed when all enabled output ports have received data,
+	 * or this time after the first data of the frame was set.
+	 */
+	void SetFrameAssemblyTimeout(uint32_t nMillis) {
+		m_nFrameAssemblyTimeout = nMillis;
+	}
+	uint32_t GetFrameAssemblyTimeout(void) {
+		return m_nFrameAssemblyTimeout;
+	}
+
 	bool IsTransmitting(uint8_t nPortIndex) const;
 	bool IsMerging(uint8_t nPortIndex) const;
 	bool IsStatusChanged(void);
@@ -194,9 +223,15 @@ private:
 	bool isIpCidMatch(const struct TSource *);
 	bool IsDmxDataChanged(uint8_t nPortIndex, const uint8_t *pData, uint16_t nLength);
 	bool IsMergedDmxDataChanged(uint8_t nPortIndex, const uint8_t *pData, uint16_t nLength);
+	void SetChanged(uint8_t nPortIndex, uint16_t nFirst, uint16_t nLast);
+	void SetLightSetData(uint8_t nPortIndex);
+	void SyncLightSet(void);
+	bool IsFrameComplete(void);
 
+	void HandlePacket(void);
 	void HandleDmx(void);
 	void HandleSynchronization(void);
+	void CommitSynchronization(void);
 
 	uint32_t UniverseToMulticastIp(uint16_t nUniverse) const;
 	void LeaveUniverse(uint8_t nPortIndex, uint16_t nUniverse);
@@ -213,6 +248,11 @@ private:
 	LightSet *m_pLightSet;
 
 	bool m_bDirectUpdate;
+	LightSetScheduler m_Scheduler;
+	uint32_t m_nFrameAssemblyTimeout;
+	uint32_t m_nFrameStartMillis;
+	uint64_t m_nFramePorts;		///< Ports with data received in the current frame
+	bool m_bIsFramePending;		///< Data set since the last LightSet::Sync
 	bool m_bEnableDataIndicator;
 
 	uint32_t m_nCurrentPacketMillis;
@@ -53,6 +53,8 @@ struct TE131Params {
 	bool bEnableNoChangeUpdate;
 	uint8_t nDirection;
 	uint8_t nPriority;
+	uint16_t nPresentationDelay;	///< milliseconds
+	uint16_t nFrameAssemblyTimeout;	///< milliseconds
 };
 
 enum TE131ParamsMask {
@@ -72,7 +74,9 @@ enum TE131ParamsMask {
 	E131_PARAMS_MASK_MERGE_TIMEOUT = (1 << 13),
 	E131_PARAMS_MASK_ENABLE_NO_CHANGE_OUTPUT = (1 << 14),
 	E131_PARAMS_MASK_DIRECTION = (1 << 15),
-	E131_PARAMS_MASK_PRIORITY = (1 << 16)
+	E131_PARAMS_MASK_PRIORITY = (1 << 16),
+	E131_PARAMS_MASK_PRESENTATION_DELAY = (1 << 17),
+	E131_PARAMS_MASK_FRAME_ASSEMBLY_TIMEOUT = (1 << 18)
 };
 
 class E131ParamsStore {
@@ -44,18 +44,40 @@
 #include "e131uuid.h"
 
 #include "lightset.h"
+#include "lightsetscheduler.h"
 
 #include "hardware.h"
 #include "network.h"
+#include "ntpclock.h"
 #include "ledblink.h"
 
 static const uint8_t DEVICE_SOFTWARE_VERSION[] = { 1, 13 };
 static const uint8_t ACN_PACKET_IDENTIFIER[E131_PACKET_IDENTIFIER_LENGTH] = { 0x41, 0x53, 0x43, 0x2d, 0x45, 0x31, 0x2e, 0x31, 0x37, 0x00, 0x00, 0x00 }; ///< 5.3 ACN Packet Identifier
 
+#define E131_PRIORITY_PACKETS_MAX	8	///< Upper limit for the packets handled in one Run()
+
+/*
+ * The E1.31 Synchronization Packet is time-critical, the network keeps room for it in the receive queue
+ */
+static bool IsPriority(const uint8_t *pPacket, uint16_t nSize) {
+	if (nSize < sizeof(struct TE131SynchronizationPacket)) {
+		return false;
+	}
+
+	const struct TE131RawPacket *pRaw = reinterpret_cast<const struct TE131RawPacket *>(pPacket);
+
+	return (__builtin_bswap32(pRaw->RootLayer.Vector) == E131_VECTOR_ROOT_EXTENDED)
+			&& (__builtin_bswap32(pRaw->FrameLayer.Vector) == E131_VECTOR_EXTENDED_SYNCHRONIZATION);
+}
+
 E131Bridge::E131Bridge(void) :
 	m_nHandle(-1),
 	m_pLightSet(0),
 	m_bDirectUpdate(false),
+	m_nFrameAssemblyTimeout(LIGHTSET_FRAME_ASSEMBLY_TIMEOUT_MILLIS),
+	m_nFrameStartMillis(0),
+	m_nFramePorts(0),
+	m_bIsFramePending(false),
 	m_bEnableDataIndicator(true),
 	m_nCurrentPacketMillis(0),
 	m_nPreviousPacketMillis(0),
@@ -90,6 +112,8 @@ E131Bridge::E131Bridge(void) :
 	m_nHandle = Network::Get()->Begin(E131_DEFAULT_PORT); 	// This must be here (and not in Start) for Mac OS and Linux
 	assert(m_nHandle != -1);								// ToDO Rewrite SetUniverse
 
+	Network::Get()->SetPriority(m_nHandle, IsPriority);
+
 	E131Uuid e131UUID;
 	e131UUID.GetHardwareUuid(m_Cid);
 }
@@ -313,8 +337,6 @@ bool E131Bridge::IsDmxDataChanged(uint8_t nPortIndex, const uint8_t *pData, uint
 	assert(nPortIndex < E131_MAX_PORTS);
 	assert(pData != 0);
 
-	bool isChanged = false;
-
 	uint8_t *src = (uint8_t *)pData;
 	uint8_t *dst = (uint8_t *)m_OutputPort[nPortIndex].data;
 
@@ -323,27 +345,37 @@ bool E131Bridge::IsDmxDataChanged(uint8_t nPortIndex, const uint8_t *pData, uint
 		for (unsigned i = 0 ; i < E131_DMX_LENGTH; i++) {
 			*dst++ = *src++;
 		}
+		SetChanged(nPortIndex, 0, nLength);
 		return true;
 	}
 
+	unsigned nFirst = E131_DMX_LENGTH;
+	unsigned nLast = 0;
+
 	for (unsigned i = 0; i < E131_DMX_LENGTH; i++) {
 		if (*dst != *src) {
 			*dst = *src;
-			isChanged = true;
+			if (i < nFirst) {
+				nFirst = i;
+			}
+			nLast = i + 1;
 		}
 		dst++;
 		src++;
 	}
 
-	return isChanged;
+	if (nLast != 0) {
+		SetChanged(nPortIndex, nFirst, MIN(nLast, nLength));
+		return true;
+	}
+
+	return false;
 }
 
 bool E131Bridge::IsMergedDmxDataChanged(uint8_t nPortIndex, const uint8_t *pData, uint16_t nLength) {
 	assert(nPortIndex < E131_MAX_PORTS);
 	assert(pData != 0);
 
-	bool isChanged = false;
-
 	if (!m_State.IsMergeMode) {
 		m_State.IsMergeMode = true;
 		m_State.IsChanged = true;
@@ -359,23 +391,81 @@ bool E131Bridge::IsMergedDmxDataChanged(uint8_t nPortIndex, const uint8_t *pData
 				uint8_t data = MAX(m_OutputPort[nPortIndex].sourceA.data[i], m_OutputPort[nPortIndex].sourceB.data[i]);
 				m_OutputPort[nPortIndex].data[i] = data;
 			}
+			SetChanged(nPortIndex, 0, nLength);
 			return true;
 		}
 
+		unsigned nFirst = nLength;
+		unsigned nLast = 0;
+
 		for (unsigned i = 0; i < nLength; i++) {
 			uint8_t data = MAX(m_OutputPort[nPortIndex].sourceA.data[i], m_OutputPort[nPortIndex].sourceB.data[i]);
 			if (data != m_OutputPort[nPortIndex].data[i]) {
 				m_OutputPort[nPortIndex].data[i] = data;
-				isChanged = true;
+				if (i < nFirst) {
+					nFirst = i;
+				}
+				nLast = i + 1;
 			}
 		}
 
-		return isChanged;
+		if (nLast != 0) {
+			SetChanged(nPortIndex, nFirst, nLast);
+			return true;
+		}
+
+		return false;
 	} else {
 		return IsDmxDataChanged(nPortIndex, pData, nLength);
 	}
 }
 
+void E131Bridge::SetChanged(uint8_t nPortIndex, uint16_t nFirst, uint16_t nLast) {
+	assert(nPortIndex < E131_MAX_PORTS);
+
+	if (m_OutputPort[nPortIndex].nChangedFirst >= m_OutputPort[nPortIndex].nChangedLast) {
+		m_OutputPort[nPortIndex].nChangedFirst = nFirst;
+		m_OutputPort[nPortIndex].nChangedLast = nLast;
+		return;
+	}
+
+	m_OutputPort[nPortIndex].nChangedFirst = MIN(m_OutputPort[nPortIndex].nChangedFirst, nFirst);
+	m_OutputPort[nPortIndex].nChangedLast = MAX(m_OutputPort[nPortIndex].nChangedLast, nLast);
+}
+
+void E131Bridge::SetLightSetData(uint8_t nPortIndex) {
+	assert(nPortIndex < E131_MAX_PORTS);
+
+	m_pLightSet->SetDataChanged(nPortIndex, m_OutputPort[nPortIndex].data, m_OutputPort[nPortIndex].length, m_OutputPort[nPortIndex].nChangedFirst, m_OutputPort[nPortIndex].nChangedLast);
+
+	m_OutputPort[nPortIndex].nChangedFirst = 0;
+	m_OutputPort[nPortIndex].nChangedLast = 0;
+
+	if (!m_bIsFramePending) {
+		m_bIsFramePending = true;
+		m_nFrameStartMillis = Hardware::Get()->Millis();
+	}
+}
+
+void E131Bridge::SyncLightSet(void) {
+	m_nFramePorts = 0;
+
+	if (m_bIsFramePending) {
+		m_bIsFramePending = false;
+		m_pLightSet->Sync();
+	}
+}
+
+bool E131Bridge::IsFrameComplete(void) {
+	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
+		if (m_OutputPort[i].bIsEnabled && ((m_nFramePorts & (1ULL << i)) == 0)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
 void E131Bridge::CheckMergeTimeouts(uint8_t nPortIndex) {
 	assert(nPortIndex < E131_MAX_PORTS);
 
@@ -523,6 +613,14 @@ void E131Bridge::HandleDmx(void) {
 			m_State.nPriority = m_E131.E131Packet.Data.FrameLayer.Priority;
 		}
 
+		if (__builtin_expect((m_OutputPort[i].IsCommitPending), 0)) {
+			if ((ipA == 0) || (ipB == 0) || isSourceA || isSourceB) {
+				// New data for a port that is still waiting: the scheduled frame is presented now, out of step, before it is overwritten
+				m_Scheduler.Flush(Hardware::Get()->Micros());
+				CommitSynchronization();
+			}
+		}
+
 		if ((ipA == 0) && (ipB == 0)) {
 			//printf("1. First package from Source\n");
 			pSourceA->ip = m_E131.IPAddressFrom;
@@ -623,7 +721,7 @@ void E131Bridge::HandleDmx(void) {
 		if (sendNewData || m_bDirectUpdate) {
 			if (!m_State.IsSynchronized) {
 
-				m_pLightSet->SetData(i, m_OutputPort[i].data, m_OutputPort[i].length);
+				SetLightSetData(i);
 
 				if (!m_OutputPort[i].IsTransmitting) {
 					m_pLightSet->Start(i);
@@ -636,8 +734,13 @@ void E131Bridge::HandleDmx(void) {
 
 		}
 
+		m_nFramePorts |= (1ULL << i);
 		m_State.bIsReceivingDmx = true;
 	}
+
+	if (!m_State.IsSynchronized && IsFrameComplete()) {
+		SyncLightSet();
+	}
 }
 
 void E131Bridge::HandleSynchronization(void) {
@@ -657,10 +760,32 @@ void E131Bridge::HandleSynchronization(void) {
 
 	m_State.SynchronizationTime = m_nCurrentPacketMillis;
 
+	if (m_Scheduler.IsEnabled()) {
+		const uint32_t nLocalNow = Hardware::Get()->Micros();
+		const uint32_t nNow = NtpClock::ToTimelineMicros(nLocalNow);
+		const uint32_t nRecvTimestamp = Network::Get()->GetRecvTimestamp();
+
+		if (m_Scheduler.IsPending()) {
+			CommitSynchronization();
+		}
+
+		m_Scheduler.Schedule(nRecvTimestamp == 0 ? nNow : NtpClock::ToTimelineMicros(nRecvTimestamp), nNow, nLocalNow);
+
+		for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
+			if ((m_OutputPort[i].IsDataPending) || (m_OutputPort[i].bIsEnabled && m_bDirectUpdate)) {
+				m_OutputPort[i].IsCommitPending = true;
+				m_OutputPort[i].IsDataPending = false;
+			}
+		}
+
+		m_nFramePorts = 0;
+		return;
+	}
+
 	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
 		if ((m_OutputPort[i].IsDataPending) || (m_OutputPort[i].bIsEnabled && m_bDirectUpdate)){
 
-			m_pLightSet->SetData(i, m_OutputPort[i].data, m_OutputPort[i].length);
+			SetLightSetData(i);
 
 			if (!m_OutputPort[i].IsTransmitting) {
 				m_pLightSet->Start(i);
@@ -670,6 +795,25 @@ void E131Bridge::HandleSynchronization(void) {
 			m_OutputPort[i].IsDataPending = false;
 		}
 	}
+
+	SyncLightSet();
+}
+
+void E131Bridge::CommitSynchronization(void) {
+	for (uint32_t i = 0; i < E131_MAX_PORTS; i++) {
+		if (m_OutputPort[i].IsCommitPending) {
+			SetLightSetData(i);
+
+			if (!m_OutputPort[i].IsTransmitting) {
+				m_pLightSet->Start(i);
+				m_OutputPort[i].IsTransmitting = true;
+			}
+
+			m_OutputPort[i].IsCommitPending = false;
+		}
+	}
+
+	SyncLightSet();
 }
 
 void E131Bridge::SetNetworkDataLossCondition(bool bSourceA, bool bSourceB) {
@@ -679,6 +823,9 @@ void E131Bridge::SetNetworkDataLossCondition(bool bSourceA, bool bSourceB) {
 	m_State.IsChanged = true;
 
 	if (bSourceA && bSourceB) {
+		m_bIsFramePending = false;
+		m_nFramePorts = 0;
+
 		m_State.IsNetworkDataLoss = true;
 		m_State.IsMergeMode = false;
 		m_State.IsSynchronized = false;
@@ -694,6 +841,7 @@ void E131Bridge::SetNetworkDataLossCondition(bool bSourceA, bool bSourceB) {
 				memset(m_OutputPort[i].sourceB.cid, 0, E131_CID_LENGTH);
 				m_OutputPort[i].length = 0;
 				m_OutputPort[i].IsDataPending = false;
+				m_OutputPort[i].IsCommitPending = false;
 				m_OutputPort[i].IsTransmitting = false;
 				m_OutputPort[i].IsMerging = false;
 			}
@@ -719,6 +867,7 @@ void E131Bridge::SetNetworkDataLossCondition(bool bSourceA, bool bSourceB) {
 					m_pLightSet->Stop(i);
 					m_OutputPort[i].length = 0;
 					m_OutputPort[i].IsDataPending = false;
+					m_OutputPort[i].IsCommitPending = false;
 					m_OutputPort[i].IsTransmitting = false;
 				}
 			}
@@ -758,7 +907,9 @@ void E131Bridge::Clear(uint8_t nPortIndex) {
 
 	m_OutputPort[nPortIndex].length = E131_DMX_LENGTH;
 
-	m_pLightSet->SetData(nPortIndex, m_OutputPort[nPortIndex].data, m_OutputPort[nPortIndex].length);
+	SetChanged(nPortIndex, 0, E131_DMX_LENGTH);
+	SetLightSetData(nPortIndex);
+	SyncLightSet();
 
 	if (m_OutputPort[nPortIndex].bIsEnabled && !m_OutputPort[nPortIndex].IsTransmitting) {
 		m_pLightSet->Start(nPortIndex);
@@ -814,6 +965,30 @@ bool E131Bridge::IsValidDataPacket(void) {
 }
 
 void E131Bridge::Run(void) {
+	if (__builtin_expect((m_Scheduler.IsPending()), 0)) {
+		if (m_Scheduler.IsDue(Hardware::Get()->Micros())) {
+			CommitSynchronization();
+		}
+	}
+
+	if (m_bIsFramePending) {
+		if ((Hardware::Get()->Millis() - m_nFrameStartMillis) >= m_nFrameAssemblyTimeout) {
+			SyncLightSet();
+		}
+	}
+
+	/*
+	 * A Synchronization Packet is queued: handle the packets up to it now,
+	 * instead of one per main loop. The order of the packets is kept.
+	 */
+	uint32_t nPackets = 0;
+
+	do {
+		HandlePacket();
+	} while (__builtin_expect((Network::Get()->IsPriorityPending(m_nHandle)), 0) && (++nPackets < E131_PRIORITY_PACKETS_MAX));
+}
+
+void E131Bridge::HandlePacket(void) {
 	const char *packet = (char *) &(m_E131.E131Packet);
 	uint16_t nForeignPort;
 
@@ -887,6 +1062,4 @@ void E131Bridge::Run(void) {
 			LedBlink::Get()->SetMode(LEDBLINK_MODE_NORMAL);
 		}
 	}
-
-	return;
 }
@@ -67,4 +67,6 @@ void E131Bridge::Print(void) {
 	if (m_bDirectUpdate) {
 		printf(" Direct update : Yes\n");
 	}
+
+	m_Scheduler.Print();
 }
@@ -54,6 +54,7 @@ E131Params::E131Params(E131ParamsStore *pE131ParamsStore):m_pE131ParamsStore(pE1
 	m_tE131Params.nUniverse = E131_UNIVERSE_DEFAULT;
 	m_tE131Params.nNetworkTimeout = E131_NETWORK_DATA_LOSS_TIMEOUT_SECONDS;
 	m_tE131Params.nPriority = E131_PRIORITY_DEFAULT;
+	m_tE131Params.nFrameAssemblyTimeout = LIGHTSET_FRAME_ASSEMBLY_TIMEOUT_MILLIS;
 }
 
 E131Params::~E131Params(void) {
@@ -193,6 +194,18 @@ void E131Params::callbackFunction(const char *pLine) {
 		return;
 	}
 
+	if (Sscan::Uint16(pLine, LightSetConst::PARAMS_PRESENTATION_DELAY, &value16) == SSCAN_OK) {
+		m_tE131Params.nPresentationDelay = value16;
+		m_tE131Params.nSetList |= E131_PARAMS_MASK_PRESENTATION_DELAY;
+		return;
+	}
+
+	if (Sscan::Uint16(pLine, LightSetConst::PARAMS_FRAME_ASSEMBLY_TIMEOUT, &value16) == SSCAN_OK) {
+		m_tE131Params.nFrameAssemblyTimeout = value16;
+		m_tE131Params.nSetList |= E131_PARAMS_MASK_FRAME_ASSEMBLY_TIMEOUT;
+		return;
+	}
+
 }
 
 void E131Params::Dump(void) {
@@ -238,6 +251,14 @@ void E131Params::Dump(void) {
 	if (isMaskSet(E131_PARAMS_MASK_PRIORITY)) {
 		printf(" %s=%d\n", E131ParamsConst::PARAMS_PRIORITY, m_tE131Params.nPriority);
 	}
+
+	if (isMaskSet(E131_PARAMS_MASK_PRESENTATION_DELAY)) {
+		printf(" %s=%d [ms]\n", LightSetConst::PARAMS_PRESENTATION_DELAY, (int) m_tE131Params.nPresentationDelay);
+	}
+
+	if (isMaskSet(E131_PARAMS_MASK_FRAME_ASSEMBLY_TIMEOUT)) {
+		printf(" %s=%d [ms]\n", LightSetConst::PARAMS_FRAME_ASSEMBLY_TIMEOUT, (int) m_tE131Params.nFrameAssemblyTimeout);
+	}
 #endif
 }
 
@@ -62,6 +62,8 @@ void E131Params::Builder(const struct TE131Params *ptE131Params, uint8_t *pBuffe
 	builder.Add(E131ParamsConst::PARAMS_DISABLE_MERGE_TIMEOUT, (uint32_t) m_tE131Params.bDisableMergeTimeout, isMaskSet(E131_PARAMS_MASK_MERGE_TIMEOUT));
 
 	builder.Add(LightSetConst::PARAMS_ENABLE_NO_CHANGE_UPDATE, (uint32_t) m_tE131Params.bEnableNoChangeUpdate, isMaskSet(E131_PARAMS_MASK_ENABLE_NO_CHANGE_OUTPUT));
+	builder.Add(LightSetConst::PARAMS_PRESENTATION_DELAY, (uint32_t) m_tE131Params.nPresentationDelay, isMaskSet(E131_PARAMS_MASK_PRESENTATION_DELAY));
+	builder.Add(LightSetConst::PARAMS_FRAME_ASSEMBLY_TIMEOUT, (uint32_t) m_tE131Params.nFrameAssemblyTimeout, isMaskSet(E131_PARAMS_MASK_FRAME_ASSEMBLY_TIMEOUT));
 
 	nSize = builder.GetSize();
 
@@ -59,4 +59,12 @@ void E131Params::Set(E131Bridge *pE131Bridge) {
 	if (isMaskSet(E131_PARAMS_MASK_PRIORITY)) {
 		pE131Bridge->SetPriority(m_tE131Params.nPriority);
 	}
+
+	if (isMaskSet(E131_PARAMS_MASK_PRESENTATION_DELAY)) {
+		pE131Bridge->SetPresentationDelay((uint32_t) m_tE131Params.nPresentationDelay * 1000);
+	}
+
+	if (isMaskSet(E131_PARAMS_MASK_FRAME_ASSEMBLY_TIMEOUT)) {
+		pE131Bridge->SetFrameAssemblyTimeout(m_tE131Params.nFrameAssemblyTimeout);
+	}
 }
@@ -58,6 +58,9 @@
 
 #define RX_FRM_FLT_RX_ALL_MULTICAST	(1 << 16)
 
+#define INT_STA_RX_INT				(1 << 8)
+#define INT_EN_RX_INT_EN			(1 << 8)
+
 #define	ARM_DMA_ALIGN	64
 
 #define CONFIG_TX_DESCR_NUM	32
@@ -328,6 +331,23 @@ void emac_free_pkt(void) {
 	p_coherent_region->rx_currdescnum = desc_num;
 }
 
+/*
+ * Interrupt driven receive
+ */
+
+void emac_rx_irq_enable(void) {
+	H3_EMAC->INT_STA = INT_STA_RX_INT;
+	H3_EMAC->INT_EN |= INT_EN_RX_INT_EN;
+}
+
+void emac_rx_irq_disable(void) {
+	H3_EMAC->INT_EN &= ~INT_EN_RX_INT_EN;
+}
+
+void emac_rx_irq_clear(void) {
+	H3_EMAC->INT_STA = INT_STA_RX_INT;
+}
+
 void _autonegotiation(void) {
 	uint32_t value;
 
@@ -27,6 +27,7 @@
 #define IRQ_TIMER_H_
 
 #include <stdint.h>
+#include <stdbool.h>
 
 typedef enum irq_timers {
 	IRQ_TIMER_0,
@@ -42,6 +43,9 @@ extern "C" {
 extern void irq_timer_set(_irq_timers, thunk_irq_timer_t);
 extern void irq_timer_init(void);
 
+extern void irq_timer_emac_set(thunk_irq_timer_t);
+extern bool irq_timer_emac_handle(uint32_t);
+
 #ifdef __cplusplus
 }
 #endif
@@ -51,6 +51,9 @@ extern "C" {
 extern void net_init(const uint8_t *, struct ip_info *, const uint8_t *, bool *);
 extern void net_handle(void);
 //
+extern void net_set_rx_irq(bool);
+extern bool net_is_rx_irq(void);
+//
 extern void net_set_hostname(const char *name);
 //
 extern void net_set_ip(uint32_t);
@@ -60,6 +63,10 @@ extern bool net_set_dhcp(struct ip_info *);
 extern int udp_bind(uint16_t);
 extern int udp_unbind(uint16_t);
 extern uint16_t udp_recv(uint8_t, uint8_t *, uint16_t, uint32_t *, uint16_t *);
+extern uint16_t udp_recv_timestamp(uint8_t, uint8_t *, uint16_t, uint32_t *, uint16_t *, uint32_t *);
+typedef bool (*udp_priority_t)(const uint8_t *, uint16_t);
+extern void udp_set_priority(uint8_t, udp_priority_t);
+extern bool udp_is_priority_pending(uint8_t);
 extern int udp_send(uint8_t, const uint8_t *, uint16_t, uint32_t, uint16_t);
 //
 extern int igmp_join(uint32_t);
@@ -29,11 +29,17 @@
 
 #include "net/net.h"
 
+#include "h3.h"
+#include "irq_timer.h"
+
 #include "net_packets.h"
 #include "net_debug.h"
 
 extern int emac_eth_recv(uint8_t **);
 extern void emac_free_pkt(void);
+extern void emac_rx_irq_enable(void);
+extern void emac_rx_irq_disable(void);
+extern void emac_rx_irq_clear(void);
 
 extern void net_timers_init(void);
 extern void net_timers_run(void);
@@ -45,6 +51,8 @@ extern void ip_init(const uint8_t *, const struct ip_info  *);
 extern void ip_set_ip(const struct ip_info  *);
 extern void ip_handle(struct t_ip4 *);
 
+extern void udp_handle_timestamp(struct t_udp *, uint32_t);
+
 extern int dhcp_client(const uint8_t *, struct ip_info *, const uint8_t *);
 
 static struct ip_info s_ip_info;
@@ -52,6 +60,7 @@ static uint8_t s_mac_address[ETH_ADDR_LEN] __attribute__ ((aligned (4)));
 static char s_hostname[HOST_NAME_MAX] __attribute__ ((aligned (4))); /* including a terminating null byte. */;
 
 static uint8_t *s_p;
+static volatile bool s_rx_irq;
 
 #ifndef MIN
  #define MIN(a, b) ((a) < (b) ? (a) : (b))
@@ -96,7 +105,57 @@ void net_init(const uint8_t *mac_address, struct ip_info *p_ip_info, const uint8
 	}
 }
 
+/*
+ * Runs from the IRQ handler. UDP frames are stamped with the arrival time
+ * (AVS counter 1, the Hardware::Micros time base) and queued at once. Any other frame can lead to a transmit (ARP reply,
+ * ICMP echo, IGMP report), so it stops the loop and is left for net_handle.
+ */
+static void net_rx_irq(const uint32_t micros) {
+	uint8_t *p;
+
+	emac_rx_irq_clear();
+
+	while (emac_eth_recv(&p) > 0) {
+		struct t_udp *p_udp = (struct t_udp *) p;
+
+		if ((p_udp->ether.type != __builtin_bswap16(ETHER_TYPE_IPv4))
+				|| (p_udp->ip4.ver_ihl != 0x45)
+				|| (p_udp->ip4.proto != IPv4_PROTO_UDP)) {
+			break;
+		}
+
+		udp_handle_timestamp(p_udp, micros);
+		emac_free_pkt();
+	}
+}
+
+void net_set_rx_irq(bool enable) {
+	if (enable == s_rx_irq) {
+		return;
+	}
+
+	if (enable) {
+		irq_timer_init();
+		irq_timer_emac_set(net_rx_irq);
+		emac_rx_irq_clear();
+		s_rx_irq = true;
+		emac_rx_irq_enable();
+	} else {
+		emac_rx_irq_disable();
+		s_rx_irq = false;
+		irq_timer_emac_set(NULL);
+	}
+}
+
+bool net_is_rx_irq(void) {
+	return s_rx_irq;
+}
+
 void net_handle(void) {
+	if (s_rx_irq) {
+		emac_rx_irq_disable();
+	}
+
 	const int length = emac_eth_recv(&s_p);
 
 	if (__builtin_expect((length > 0), 0)) {
@@ -113,6 +172,11 @@ void net_handle(void) {
 		emac_free_pkt();
 	}
 
+	if (s_rx_irq) {
+		net_rx_irq(H3_TIMER->AVS_CNT1);
+		emac_rx_irq_enable();
+	}
+
 	net_timers_run();
 }
 
@@ -60,13 +60,19 @@ extern uint16_t net_chksum(void *, uint32_t);
 struct queue_entry {
 	uint8_t data[FRAME_BUFFER_SIZE];
 	uint32_t from_ip;
+	uint32_t timestamp;
 	uint16_t from_port;
 	uint16_t size;
+	bool is_priority;
 }ALIGNED;
 
+/*
+ * The head is written by udp_handle (possibly from the EMAC IRQ),
+ * the tail by udp_recv.
+ */
 struct queue {
-	uint32_t queue_head;
-	uint32_t queue_tail;
+	volatile uint32_t queue_head;
+	volatile uint32_t queue_tail;
 	struct queue_entry entries[MAX_ENTRIES] ALIGNED;
 }ALIGNED;
 
@@ -75,7 +81,19 @@ typedef union pcast32 {
 	uint8_t u8[4];
 } _pcast32;
 
+/*
+ * Time-critical frames (ArtSync, E1.31 Synchronization, timecode) are
+ * classified when queued. The last free entry is kept for them, and the
+ * number queued and not yet received tells the consumer to catch up.
+ */
+struct priority {
+	udp_priority_t is_priority;
+	volatile uint32_t queued;	///< Written by udp_handle
+	volatile uint32_t received;	///< Written by udp_recv
+};
+
 static uint32_t s_ports_allowed[MAX_PORTS_ALLOWED];
+static struct priority s_priority[MAX_PORTS_ALLOWED];
 static uint32_t s_ports_used_index;
 static struct queue s_recv_queue[MAX_PORTS_ALLOWED] ALIGNED;
 static struct t_udp s_send_packet ALIGNED;
@@ -97,6 +115,9 @@ void udp_init(const uint8_t *mac_address, const struct ip_info  *p_ip_info) {
 		s_ports_allowed[i] = 0;
 		s_recv_queue[i].queue_head = 0;
 		s_recv_queue[i].queue_tail = 0;
+		s_priority[i].is_priority = NULL;
+		s_priority[i].queued = 0;
+		s_priority[i].received = 0;
 	}
 
 	s_ports_used_index = 0;
@@ -116,7 +137,7 @@ void udp_init(const uint8_t *mac_address, const struct ip_info  *p_ip_info) {
 	s_send_packet.udp.checksum = 0;
 }
 
-void udp_handle(struct t_udp *p_udp) {
+void udp_handle_timestamp(struct t_udp *p_udp, uint32_t timestamp) {
 	uint32_t port_index;
 	_pcast32 src;
 	uint32_t i;
@@ -142,23 +163,54 @@ void udp_handle(struct t_udp *p_udp) {
 		return;
 	}
 
-	const uint32_t entry = s_recv_queue[port_index].queue_tail;
-	struct queue_entry *p_queue_entry = &s_recv_queue[port_index].entries[entry];
-
 	const uint32_t data_length = __builtin_bswap16(p_udp->udp.len) - UDP_HEADER_SIZE;
 
 	// debug_dump(p_udp->udp.data, data_length);
 
 	i = MIN(FRAME_BUFFER_SIZE, data_length);
 
+	const uint32_t entry = s_recv_queue[port_index].queue_head;
+	const uint32_t next = (entry + 1) & MAX_ENTRIES_MASK;
+	const uint32_t tail = s_recv_queue[port_index].queue_tail;
+
+	if (__builtin_expect ((next == tail), 0)) {
+		DEBUG_PRINTF("Queue full -> %d", dest_port);
+		return;
+	}
+
+	bool is_priority = false;
+
+	if (s_priority[port_index].is_priority != NULL) {
+		is_priority = s_priority[port_index].is_priority(p_udp->udp.data, i);
+
+		if (__builtin_expect ((!is_priority && (((next + 1) & MAX_ENTRIES_MASK) == tail)), 0)) {
+			DEBUG_PRINTF("Queue full (priority reserved) -> %d", dest_port);
+			return;
+		}
+	}
+
+	struct queue_entry *p_queue_entry = &s_recv_queue[port_index].entries[entry];
+
 	h3_memcpy(p_queue_entry->data, p_udp->udp.data, i);
 
 	memcpy(src.u8, p_udp->ip4.src, IPv4_ADDR_LEN);
 	p_queue_entry->from_ip = src.u32;
 	p_queue_entry->from_port = __builtin_bswap16(p_udp->udp.source_port);
 	p_queue_entry->size = i;
+	p_queue_entry->timestamp = timestamp;
+	p_queue_entry->is_priority = is_priority;
+
+	__sync_synchronize();
+
+	s_recv_queue[port_index].queue_head = next;
 
-	s_recv_queue[port_index].queue_head = (s_recv_queue[port_index].queue_head + 1) & MAX_ENTRIES_MASK;
+	if (is_priority) {
+		s_priority[port_index].queued++;
+	}
+}
+
+void udp_handle(struct t_udp *p_udp) {
+	udp_handle_timestamp(p_udp, H3_TIMER->AVS_CNT1);
 }
 
 // -->
@@ -198,6 +250,9 @@ int udp_unbind(uint16_t local_port) {
 		s_ports_allowed[s_ports_used_index - 1] = 0;
 		s_recv_queue[s_ports_used_index - 1].queue_head = 0;
 		s_recv_queue[s_ports_used_index - 1].queue_tail = 0;
+		s_priority[s_ports_used_index - 1].is_priority = NULL;
+		s_priority[s_ports_used_index - 1].queued = 0;
+		s_priority[s_ports_used_index - 1].received = 0;
 		s_ports_used_index--;
 		return 0;
 	}
@@ -205,7 +260,7 @@ int udp_unbind(uint16_t local_port) {
 	return -2;
 }
 
-uint16_t udp_recv(uint8_t idx, uint8_t *packet, uint16_t size, uint32_t *from_ip, uint16_t *from_port) {
+uint16_t udp_recv_timestamp(uint8_t idx, uint8_t *packet, uint16_t size, uint32_t *from_ip, uint16_t *from_port, uint32_t *timestamp) {
 	assert(idx < MAX_PORTS_ALLOWED);
 
 	if (s_recv_queue[idx].queue_head == s_recv_queue[idx].queue_tail) {
@@ -221,6 +276,11 @@ uint16_t udp_recv(uint8_t idx, uint8_t *packet, uint16_t size, uint32_t *from_ip
 
 	*from_ip = p_queue_entry->from_ip;
 	*from_port = p_queue_entry->from_port;
+	*timestamp = p_queue_entry->timestamp;
+
+	if (p_queue_entry->is_priority) {
+		s_priority[idx].received++;
+	}
 
 	s_recv_queue[idx].queue_tail = (s_recv_queue[idx].queue_tail + 1) & MAX_ENTRIES_MASK;
 
@@ -229,6 +289,24 @@ uint16_t udp_recv(uint8_t idx, uint8_t *packet, uint16_t size, uint32_t *from_ip
 	return i;
 }
 
+uint16_t udp_recv(uint8_t idx, uint8_t *packet, uint16_t size, uint32_t *from_ip, uint16_t *from_port) {
+	uint32_t timestamp;
+
+	return udp_recv_timestamp(idx, packet, size, from_ip, from_port, &timestamp);
+}
+
+void udp_set_priority(uint8_t idx, udp_priority_t is_priority) {
+	assert(idx < MAX_PORTS_ALLOWED);
+
+	s_priority[idx].is_priority = is_priority;
+}
+
+bool udp_is_priority_pending(uint8_t idx) {
+	assert(idx < MAX_PORTS_ALLOWED);
+
+	return s_priority[idx].queued != s_priority[idx].received;
+}
+
 int udp_send(uint8_t idx, const uint8_t *packet, uint16_t size, uint32_t to_ip, uint16_t remote_port) {
 	assert(idx < MAX_PORTS_ALLOWED);
 
@@ -38,6 +38,7 @@
 
 static /*@null@*/ thunk_irq_timer_t timer0_func = NULL;
 static /*@null@*/ thunk_irq_timer_t timer1_func = NULL;
+static /*@null@*/ thunk_irq_timer_t emac_func = NULL;
 
 static void __attribute__((interrupt("IRQ"))) irq_timer_handler(void) {
 	dmb();
@@ -55,6 +56,8 @@ static void __attribute__((interrupt("IRQ"))) irq_timer_handler(void) {
 		timer1_func(irq_timer_micros);
 		H3_GIC_CPUIF->AEOI = H3_TIMER1_IRQn;
 		H3_GIC_DIST->ICPEND[H3_TIMER1_IRQn / 32] = 1 << (H3_TIMER1_IRQn % 32);
+	} else {
+		irq_timer_emac_handle(irq);
 	}
 
 	dmb();
@@ -83,6 +86,33 @@ void irq_timer_set(_irq_timers timer, thunk_irq_timer_t func) {
 	isb();
 }
 
+/*
+ * The EMAC shares the IRQ vector with the timers. The frames are stamped
+ * with AVS counter 1, which is the Hardware::Micros time base.
+ * An IRQ handler installed instead of irq_timer_handler (lib-midi) must
+ * forward the interrupt with irq_timer_emac_handle.
+ */
+bool irq_timer_emac_handle(uint32_t irq) {
+	if ((emac_func != NULL) && (irq == H3_EMAC_IRQn)) {
+		emac_func(H3_TIMER->AVS_CNT1);	/* The handler clears the EMAC interrupt status */
+		H3_GIC_CPUIF->AEOI = H3_EMAC_IRQn;
+		H3_GIC_DIST->ICPEND[H3_EMAC_IRQn / 32] = 1 << (H3_EMAC_IRQn % 32);
+		return true;
+	}
+
+	return false;
+}
+
+void irq_timer_emac_set(thunk_irq_timer_t func) {
+	emac_func = func;
+
+	if (func != NULL) {
+		gic_irq_config(H3_EMAC_IRQn, GIC_CORE0);
+	}
+
+	isb();
+}
+
 void irq_timer_init(void) {
 	arm_install_handler((unsigned) irq_timer_handler, ARM_VECTOR(ARM_VECTOR_IRQ));
 
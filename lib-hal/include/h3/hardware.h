@@ -106,8 +106,12 @@ public:
 		return hardware_uptime_seconds();
 	}
 
+	/**
+	 * AVS counter 1 runs at 1 MHz and wraps around at 2^32.
+	 * The low 32 bits of the high-speed timer do not.
+	 */
 	uint32_t Micros(void) {
-		return h3_hs_timer_lo_us();
+		return H3_TIMER->AVS_CNT1;
 	}
 
 	uint32_t Millis(void) {
@@ -366,10 +366,13 @@ bool Hardware::ExecCmd(const char *pCmd, char *Result, int nResultSize) {
 	return true;
 }
 
+/**
+ * The monotonic clock does not jump when the system time is set
+ */
 uint32_t Hardware::Micros(void) {
-	struct timeval tv;
-	gettimeofday(&tv, NULL);
-	return (tv.tv_sec * 1000000) + tv.tv_usec;
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t) ((ts.tv_sec * 1000000) + (ts.tv_nsec / 1000));
 }
 
 uint32_t Hardware::Millis(void) {
@@ -43,6 +43,8 @@ enum TLightSetDmx {
 	DMX_UNIVERSE_SIZE = 512
 };
 
+#define LIGHTSET_FRAME_ASSEMBLY_TIMEOUT_MILLIS	25	///< A frame with missing ports is committed after this time
+
 enum TLightSetOutputType {
 	LIGHTSET_OUTPUT_TYPE_DMX,
 	LIGHTSET_OUTPUT_TYPE_SPI,
@@ -60,6 +62,21 @@ public:
 
 	virtual void SetData(uint8_t nPort, const uint8_t *pData, uint16_t nLength)= 0;
 
+	/**
+	 * pData is the complete frame; only the slots [nChangedFirst, nChangedLast) differ from
+	 * the previous frame handed to this port. An empty range means nothing changed.
+	 * Outputs can override this to encode only the affected channels.
+	 * The default passes the complete frame to SetData.
+	 */
+	virtual void SetDataChanged(uint8_t nPort, const uint8_t *pData, uint16_t nLength, uint16_t nChangedFirst, uint16_t nChangedLast);
+
+	/**
+	 * Commits the frame: the data set for all ports since the previous Sync is output at once.
+	 * Called by the receiver after each complete frame. The default does nothing,
+	 * outputs updating per SetData are unaffected.
+	 */
+	virtual void Sync(void);
+
 	virtual void Print(void);
 
 	void SetLightSetDisplay(LightSetDisplay *pLightSetDisplay) {
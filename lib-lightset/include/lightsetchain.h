@@ -46,6 +46,8 @@ public:
 	void Stop(uint8_t nPort);
 
 	void SetData(uint8_t nPort, const uint8_t *, uint16_t);
+	void SetDataChanged(uint8_t nPort, const uint8_t *, uint16_t, uint16_t, uint16_t);
+	void Sync(void);
 
 	void Print(void);
 
@@ -32,6 +32,8 @@ public:
 	alignas(uint32_t) static const char PARAMS_UNIVERSE[];
 
 	alignas(uint32_t) static const char PARAMS_ENABLE_NO_CHANGE_UPDATE[];
+	alignas(uint32_t) static const char PARAMS_PRESENTATION_DELAY[];
+	alignas(uint32_t) static const char PARAMS_FRAME_ASSEMBLY_TIMEOUT[];
 
 	alignas(uint32_t) static const char PARAMS_DMX_START_ADDRESS[];
 	alignas(uint32_t) static const char PARAMS_DMX_SLOT_INFO[];
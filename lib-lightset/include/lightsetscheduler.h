@@ -0,0 +1,120 @@
+/**
+ * @file lightsetscheduler.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef LIGHTSETSCHEDULER_H_
+#define LIGHTSETSCHEDULER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define LIGHTSETSCHEDULER_TOLERANCE_US	1000	///< A commit later than this is counted as missed
+
+struct TLightSetSchedulerStats {
+	uint32_t nScheduled;	///< Sync packets scheduled
+	uint32_t nCommitted;	///< Frames presented
+	uint32_t nMissed;		///< Frames presented before the deadline, or after deadline + tolerance
+	uint32_t nFlushed;		///< Frames presented before the deadline, new data arrived for a waiting port
+	uint32_t nOverruns;		///< Sync received while a commit was still pending
+	uint32_t nLateMax;		///< micro seconds
+};
+
+/**
+ * Schedules the commit of synchronized frames at (arrival time + presentation delay).
+ *
+ * The deadline is computed on a shared timeline (see NtpClock::GetTimelineMicros).
+ * When the nodes share the timeline, they present the same frame at the same moment,
+ * independent of their network and processing latency.
+ * The deadline is kept on the local Hardware::Micros() base, so that it is not affected
+ * when the timeline changes base (the NTP clock is stepped or gets (un)synchronized).
+ * With a presentation delay of 0 the scheduler is disabled and the caller commits immediately.
+ */
+class LightSetScheduler {
+public:
+	LightSetScheduler(void);
+	~LightSetScheduler(void);
+
+	void SetPresentationDelay(uint32_t nMicros) {
+		m_nPresentationDelay = nMicros;
+	}
+
+	uint32_t GetPresentationDelay(void) {
+		return m_nPresentationDelay;
+	}
+
+	bool IsEnabled(void) {
+		return m_nPresentationDelay != 0;
+	}
+
+	bool IsPending(void) {
+		return m_bPending;
+	}
+
+	/**
+	 * @param nArrival Arrival time of the sync packet, timeline
+	 * @param nNow Current time, timeline
+	 * @param nLocalNow Current time, Hardware::Micros()
+	 */
+	void Schedule(uint32_t nArrival, uint32_t nNow, uint32_t nLocalNow);
+
+	/**
+	 * Returns true once, when the pending commit is due
+	 * @param nNow Hardware::Micros()
+	 */
+	bool IsDue(uint32_t nNow) {
+		if (__builtin_expect((!m_bPending), 1)) {
+			return false;
+		}
+
+		if (static_cast<int32_t>(nNow - m_nDeadline) < 0) {
+			return false;
+		}
+
+		Committed(nNow);
+		return true;
+	}
+
+	/**
+	 * The pending commit is forced now, e.g. new data arrived for a pending port
+	 * @param nNow Hardware::Micros()
+	 */
+	void Flush(uint32_t nNow);
+
+	const struct TLightSetSchedulerStats& GetStats(void) {
+		return m_tStats;
+	}
+
+	void Print(void);
+
+private:
+	void Committed(uint32_t nNow);
+
+private:
+	uint32_t m_nPresentationDelay;
+	uint32_t m_nDeadline;	///< Hardware::Micros()
+	bool m_bPending;
+	struct TLightSetSchedulerStats m_tStats;
+};
+
+#endif /* LIGHTSETSCHEDULER_H_ */
@@ -34,6 +34,14 @@ LightSet::LightSet(void): m_pLightSetDisplay(0) {
 LightSet::~LightSet(void) {
 }
 
+void LightSet::SetDataChanged(uint8_t nPort, const uint8_t *pData, uint16_t nLength, uint16_t nChangedFirst, uint16_t nChangedLast) {
+	SetData(nPort, pData, nLength);
+}
+
+void LightSet::Sync(void) {
+	// override
+}
+
 void LightSet::Print(void) {
 	// override
 }
@@ -76,6 +76,20 @@ void LightSetChain::SetData(uint8_t nPort, const uint8_t *pData, uint16_t nSize)
 	}
 }
 
+void LightSetChain::SetDataChanged(uint8_t nPort, const uint8_t *pData, uint16_t nSize, uint16_t nChangedFirst, uint16_t nChangedLast) {
+	assert(pData != 0);
+
+	for (unsigned i = 0; i < m_nSize; i++) {
+		m_pTable[i].pLightSet->SetDataChanged(nPort, pData, nSize, nChangedFirst, nChangedLast);
+	}
+}
+
+void LightSetChain::Sync(void) {
+	for (unsigned i = 0; i < m_nSize; i++) {
+		m_pTable[i].pLightSet->Sync();
+	}
+}
+
 void LightSetChain::Print(void) {
 	for (unsigned i = 0; i < m_nSize; i++) {
 		m_pTable[i].pLightSet->Print();
@@ -31,6 +31,8 @@ alignas(uint32_t) const char LightSetConst::PARAMS_OUTPUT[] = "output";
 alignas(uint32_t) const char LightSetConst::PARAMS_UNIVERSE[] = "universe";
 
 alignas(uint32_t) const char LightSetConst::PARAMS_ENABLE_NO_CHANGE_UPDATE[] = "enable_no_change_update";
+alignas(uint32_t) const char LightSetConst::PARAMS_PRESENTATION_DELAY[] = "presentation_delay";
+alignas(uint32_t) const char LightSetConst::PARAMS_FRAME_ASSEMBLY_TIMEOUT[] = "frame_assembly_timeout";
 
 alignas(uint32_t) const char LightSetConst::PARAMS_DMX_START_ADDRESS[] = "dmx_start_address";
 alignas(uint32_t) const char LightSetConst::PARAMS_DMX_SLOT_INFO[] = "dmx_slot_info";
@@ -0,0 +1,88 @@
+/**
+ * @file lightsetscheduler.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "lightsetscheduler.h"
+
+LightSetScheduler::LightSetScheduler(void): m_nPresentationDelay(0), m_nDeadline(0), m_bPending(false) {
+	memset(&m_tStats, 0, sizeof(struct TLightSetSchedulerStats));
+}
+
+LightSetScheduler::~LightSetScheduler(void) {
+}
+
+void LightSetScheduler::Schedule(uint32_t nArrival, uint32_t nNow, uint32_t nLocalNow) {
+	if (m_bPending) {
+		m_tStats.nOverruns++;
+		Committed(nLocalNow);
+	}
+
+	m_tStats.nScheduled++;
+	m_nDeadline = nLocalNow + static_cast<int32_t>(nArrival + m_nPresentationDelay - nNow);
+	m_bPending = true;
+}
+
+void LightSetScheduler::Flush(uint32_t nNow) {
+	if (!m_bPending) {
+		return;
+	}
+
+	// Presented before the deadline, so the nodes are out of step for this frame
+	if (static_cast<int32_t>(nNow - m_nDeadline) < 0) {
+		m_tStats.nFlushed++;
+	}
+
+	Committed(nNow);
+}
+
+void LightSetScheduler::Committed(uint32_t nNow) {
+	m_bPending = false;
+	m_tStats.nCommitted++;
+
+	const int32_t nLate = static_cast<int32_t>(nNow - m_nDeadline);
+
+	// Presented before the deadline (flushed or overrun) is a miss as well
+	if (nLate < 0) {
+		m_tStats.nMissed++;
+	} else if (nLate > LIGHTSETSCHEDULER_TOLERANCE_US) {
+		m_tStats.nMissed++;
+
+		if (static_cast<uint32_t>(nLate) > m_tStats.nLateMax) {
+			m_tStats.nLateMax = static_cast<uint32_t>(nLate);
+		}
+	}
+}
+
+void LightSetScheduler::Print(void) {
+	if (!IsEnabled()) {
+		return;
+	}
+
+	printf(" Presentation delay : %u us\n", (unsigned) m_nPresentationDelay);
+	printf("  Scheduled %u, committed %u, missed %u (max late %u us), flushed %u, overruns %u\n", (unsigned) m_tStats.nScheduled, (unsigned) m_tStats.nCommitted, (unsigned) m_tStats.nMissed, (unsigned) m_tStats.nLateMax, (unsigned) m_tStats.nFlushed, (unsigned) m_tStats.nOverruns);
+}
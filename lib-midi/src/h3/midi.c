@@ -544,6 +544,8 @@ static void __attribute__((interrupt("IRQ"))) irq_midi_in_handler(void) {
 
 		H3_GIC_CPUIF->AEOI = H3_TIMER1_IRQn;
 		gic_unpend(H3_TIMER1_IRQn);
+	} else {
+		irq_timer_emac_handle(irq);	// This handler replaces irq_timer_handler
 	}
 
 	dmb();
@@ -0,0 +1,178 @@
+/**
+ * @file ntpclock.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * NtpClock fed with synthetic NTP replies: a known initial offset, a local
+ * oscillator with a frequency error (drift) and a random network delay (jitter).
+ * The poll interval adapts like in the NtpClient. After the convergence time,
+ * the error of the system clock against the server time is measured every second.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "ntpclock.h"
+
+#include "hardware.h"
+
+#define SERVER_EPOCH_MICROS		(1600000000ULL * 1000000)	///< The server time, whole seconds
+#define SERVER_PROCESSING_MICROS	20
+#define STEP_MICROS				1000	///< NtpClock::Run() interval
+#define CONVERGENCE_SECONDS		(30 * 60)
+#define DURATION_SECONDS		(4 * 60 * 60)
+
+// As in the NtpClient
+#define POLL_MIN				4		// 2ˆ4 = 16 seconds
+#define POLL_MAX				10		// 2ˆ10 = 1024 seconds
+#define POLL_INCREASE_MICROS	500
+#define POLL_DECREASE_MICROS	4000
+
+uint32_t g_nMicros;
+uint32_t g_nSeconds;
+
+struct TScenario {
+	int32_t nOffsetMillis;	///< Of the system clock at start, against the server
+	int32_t nDriftPpm;		///< Of the local oscillator
+	uint32_t nDelayMicros;	///< One way, minimum
+	uint32_t nJitterMicros;	///< One way, random added to the delay
+};
+
+static const struct TScenario s_Scenarios[] = {
+		{    50,    0,  200,    0 },
+		{  -300,   20,  200,   50 },
+		{  1500,  -50,  500,  200 },
+		{    10,  100, 1000, 1000 },
+		{ -2000, -200,  300, 5000 },
+};
+
+static int64_t s_nTrueMicros;	///< Simulated time, the server runs on it
+static double s_fRate;			///< Local oscillator ticks per micro second
+static double s_fLocal;
+
+static void advance(uint32_t nMicros) {
+	s_nTrueMicros += nMicros;
+	s_fLocal += nMicros * s_fRate;
+	g_nMicros = static_cast<uint32_t>(static_cast<uint64_t>(s_fLocal));
+}
+
+static uint32_t delay(const struct TScenario &tScenario) {
+	return tScenario.nDelayMicros + (tScenario.nJitterMicros == 0 ? 0 : static_cast<uint32_t>(rand()) % tScenario.nJitterMicros);
+}
+
+static uint64_t server(void) {
+	return SERVER_EPOCH_MICROS + s_nTrueMicros;
+}
+
+static void run(const struct TScenario &tScenario, uint32_t nDuration) {
+	// The start is chosen such that the system clock starts at a whole second (Hardware::GetTime)
+	s_nTrueMicros = 1000000 - (tScenario.nOffsetMillis % 1000) * 1000;
+	s_fRate = 1.0 + tScenario.nDriftPpm / 1e6;
+	s_fLocal = 0;
+	advance(0);
+	g_nSeconds = static_cast<uint32_t>((server() + tScenario.nOffsetMillis * 1000LL) / 1000000);
+
+	NtpClock ntpClock;
+
+	uint32_t nPoll = POLL_MIN;
+	int64_t nNextPoll = s_nTrueMicros;
+	int64_t nNextMeasure = s_nTrueMicros + CONVERGENCE_SECONDS * 1000000LL;
+	const int64_t nEnd = s_nTrueMicros + nDuration * 1000000LL;
+
+	uint32_t nSamples = 0;
+	uint32_t nMeasurements = 0;
+	double fSum = 0;
+	double fSumSquares = 0;
+	int64_t nMax = 0;
+
+	while (s_nTrueMicros < nEnd) {
+		if (s_nTrueMicros >= nNextPoll) {
+			const uint64_t t1 = ntpClock.GetMicros();
+			advance(delay(tScenario));
+			const uint64_t t2 = server();
+			advance(SERVER_PROCESSING_MICROS);
+			const uint64_t t3 = server();
+			advance(delay(tScenario));
+			const uint64_t t4 = ntpClock.GetMicros();
+
+			ntpClock.Sample(t1, t2, t3, t4);
+			nSamples++;
+
+			const int64_t nOffset = ntpClock.GetOffset();
+
+			if (!ntpClock.IsSynchronized() || (llabs(nOffset) > POLL_DECREASE_MICROS)) {
+				nPoll = POLL_MIN;
+			} else if ((llabs(nOffset) < POLL_INCREASE_MICROS) && (nPoll < POLL_MAX)) {
+				nPoll++;
+			}
+
+			nNextPoll = s_nTrueMicros + (1LL << nPoll) * 1000000;
+		}
+
+		if (s_nTrueMicros >= nNextMeasure) {
+			const int64_t nError = static_cast<int64_t>(ntpClock.GetMicros() - server());
+			fSum += nError;
+			fSumSquares += static_cast<double>(nError) * nError;
+			if (llabs(nError) > nMax) {
+				nMax = llabs(nError);
+			}
+			nMeasurements++;
+			nNextMeasure += 1000000;
+		}
+
+		advance(STEP_MICROS);
+		ntpClock.Run();
+	}
+
+	const double fMean = fSum / nMeasurements;
+	const double fRms = sqrt(fSumSquares / nMeasurements);
+
+	printf("%7d %6d %6u %6u | %6u %5u %8d %9d | %8.1f %8.1f %8d\n",
+			tScenario.nOffsetMillis, tScenario.nDriftPpm, tScenario.nDelayMicros, tScenario.nJitterMicros,
+			nSamples, ntpClock.GetSteps(), ntpClock.GetFrequency(), ntpClock.GetFrequency() + tScenario.nDriftPpm * 1000,
+			fMean, fRms, static_cast<int>(nMax));
+}
+
+int main(int argc, char **argv) {
+	const uint32_t nDuration = (argc > 1) ? static_cast<uint32_t>(atoi(argv[1])) : DURATION_SECONDS;
+
+	if (nDuration <= CONVERGENCE_SECONDS) {
+		printf("Usage: %s [seconds > %u]\n", argv[0], CONVERGENCE_SECONDS);
+		return 1;
+	}
+
+	srand(1);
+
+	printf("Residual error after %u s of convergence, %u s measured\n", CONVERGENCE_SECONDS, nDuration - CONVERGENCE_SECONDS);
+	printf("     Scenario                 | NtpClock                            | Error (us)\n");
+	printf("offs ms   ppm  delay jitter | samples steps freq ppb  error ppb |     mean      rms      max\n");
+
+	for (uint32_t i = 0; i < sizeof(s_Scenarios) / sizeof(s_Scenarios[0]); i++) {
+		run(s_Scenarios[i], nDuration);
+	}
+
+	return 0;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file hardware.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * The simulated clock for the examples: the local oscillator and the time of day
+ */
+
+#ifndef HARDWARE_H_
+#define HARDWARE_H_
+
+#include <stdint.h>
+#include <time.h>
+
+extern uint32_t g_nMicros;
+extern uint32_t g_nSeconds;
+
+class Hardware {
+public:
+	static Hardware *Get(void) {
+		static Hardware s_Hardware;
+		return &s_Hardware;
+	}
+
+	uint32_t Micros(void) {
+		return g_nMicros;
+	}
+
+	uint32_t Millis(void) {
+		return g_nMicros / 1000;
+	}
+
+	time_t GetTime(void) {
+		return static_cast<time_t>(g_nSeconds);
+	}
+};
+
+#endif /* HARDWARE_H_ */
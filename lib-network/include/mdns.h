@@ -41,6 +41,14 @@ struct TmDNSFlags {
 	uint32_t rcode;
 } ;
 
+enum TMDNSRecordIndex {
+	MDNS_RECORD_SRV,
+	MDNS_RECORD_TXT,
+	MDNS_RECORD_DNSSD,
+	MDNS_RECORD_PTR,
+	MDNS_RECORD_INDEXES
+};
+
 struct TMDNSServiceRecord {
 	uint16_t nPort;
 	uint8_t *pName;
@@ -50,10 +58,22 @@ struct TMDNSServiceRecord {
 
 struct TMDNSRecordData {
 	uint32_t nSize;
+	uint16_t aOffset[MDNS_RECORD_INDEXES + 1];	///< Serialized records in aBuffer, aOffset[MDNS_RECORD_INDEXES] is the end
 	uint8_t aBuffer[512];
 };
 
-#define SERVICE_RECORDS_MAX		4
+struct TMDNSStats {
+	uint32_t nPacketsReceived;
+	uint32_t nPacketsSent;
+	uint32_t nQuestions;
+	uint32_t nAnswersSent;
+	uint32_t nKnownAnswersSuppressed;
+	uint32_t nResponsesDeferred;
+};
+
+#ifndef SERVICE_RECORDS_MAX
+ #define SERVICE_RECORDS_MAX		4
+#endif
 
 class MDNS {
 public:
@@ -71,11 +91,23 @@ public:
 
 	bool AddServiceRecord(const char* pName, const char *pServName, uint16_t nPort, const char* pTextContent = 0);
 
+	const struct TMDNSStats *GetStats(void) {
+		return &m_tStats;
+	}
+
 private:
 	void Parse(void);
-	void HandleRequest(uint16_t nQuestions);
+	uint32_t HandleRequest(uint16_t nQuestions, bool bTruncated);
+	void HandleKnownAnswers(uint32_t nOffset, uint16_t nAnswers);
+	bool IsInstanceName(uint32_t nIndex, const char *pDnsName);
+
+	void SetPending(uint32_t nIndex, uint32_t nRecord, bool bUnicast);
+	void Defer(uint32_t nMillis, bool &bDeferred, uint32_t &nDeferredMillis);
+
+	void SendResponse(bool bUnicast);
+	void SendMessage(uint32_t nLength, uint32_t nAnswers, uint32_t nAdditionals, uint32_t nToIp, uint16_t nToPort);
 
-	uint32_t DecodeDNSNameNotation(const char *pDNSNameNotation, char *pString);
+	uint32_t DecodeDNSNameNotation(uint32_t nOffset, char *pString);
 
 	uint32_t WriteDnsName(const char *pSource, char *pDestination, bool bNullTerminated = true);
 	uint8_t* FindFirstDotFromRight(const uint8_t* pString);
@@ -107,6 +139,27 @@ private:
 	TMDNSRecordData m_aServiceRecordsData[SERVICE_RECORDS_MAX];
 	uint32_t m_nDNSServiceRecords;
 	TMDNSRecordData m_tAnswerLocalIp;
+	// Pending response, aggregated over the questions received until m_nPendingMillis
+	uint8_t m_aPending[SERVICE_RECORDS_MAX];
+	bool m_bPendingLocalIp;
+	bool m_bPending;
+	uint32_t m_nPendingMillis;
+	// Answers to QU questions, sent with unicast right after the message is parsed
+	uint8_t m_aPendingUnicast[SERVICE_RECORDS_MAX];
+	bool m_bPendingUnicastLocalIp;
+	bool m_bPendingUnicast;
+	// The answers made pending by the questions of the last querier, for the Known-Answer Suppression
+	uint8_t m_aQueried[SERVICE_RECORDS_MAX];
+	uint8_t m_aQueriedUnicast[SERVICE_RECORDS_MAX];
+	uint32_t m_nQuerierIp;
+	uint16_t m_nQuerierPort;
+	uint32_t m_aLastSentMillis[SERVICE_RECORDS_MAX][MDNS_RECORD_INDEXES];
+	uint32_t m_nLocalIpLastSentMillis;
+	TMDNSStats m_tStats;
+	// Counters at the previous Print, for the rates
+	uint32_t m_nPrintMillis;
+	uint32_t m_nPrintPacketsReceived;
+	uint32_t m_nPrintPacketsSent;
 };
 
 #endif /* MDNS_H_ */
@@ -72,6 +72,19 @@ public:
 	virtual uint16_t RecvFrom(uint32_t nHandle, uint8_t *pPacket, uint16_t nSize, uint32_t *pFromIp, uint16_t *pFromPort)=0;
 	virtual void SendTo(uint32_t nHandle, const uint8_t *pPacket, uint16_t nSize, uint32_t nToIp, uint16_t nRemotePort)=0;
 
+	/**
+	 * Arrival time (Hardware::Micros) of the packet returned by the last RecvFrom.
+	 * Without receive timestamps it is the current time.
+	 */
+	virtual uint32_t GetRecvTimestamp(void);
+
+	/**
+	 * Frames on nHandle for which pIsPriority returns true are time-critical (ArtSync, E1.31 Synchronization, timecode).
+	 * When supported, the receive queue keeps room for them and IsPriorityPending is true until they are received.
+	 */
+	virtual void SetPriority(uint32_t nHandle, bool (*pIsPriority)(const uint8_t *pPacket, uint16_t nSize));
+	virtual bool IsPriorityPending(uint32_t nHandle);
+
 	virtual void SetIp(uint32_t nIp)=0;
 	uint32_t GetIp(void) {
 		return m_nLocalIp;
@@ -163,6 +176,7 @@ protected:
 	uint32_t m_nIfIndex;
 	uint32_t m_nNtpServerIp;
 	float m_fNtpUtcOffset;
+	uint32_t m_nRecvTimestamp;
 
 	NetworkDisplay *m_pNetworkDisplay;
 	NetworkStore *m_pNetworkStore;
@@ -58,6 +58,30 @@ public:
 
 	bool EnableDhcp(void);
 
+	uint32_t GetRecvTimestamp(void) {
+		return m_nRecvTimestamp;
+	}
+
+	void SetPriority(uint32_t nHandle, bool (*pIsPriority)(const uint8_t *pPacket, uint16_t nSize)) {
+		udp_set_priority(nHandle, pIsPriority);
+	}
+
+	bool IsPriorityPending(uint32_t nHandle) {
+		return udp_is_priority_pending(nHandle);
+	}
+
+	/**
+	 * Must be called before a driver installs its own IRQ handler (midi_init),
+	 * such a handler forwards the EMAC interrupt with irq_timer_emac_handle.
+	 */
+	void SetRxIrq(bool bEnable) {
+		net_set_rx_irq(bEnable);
+	}
+
+	bool IsRxIrq(void) {
+		return net_is_rx_irq();
+	}
+
 	void Run(void) {
 		net_handle();
 	}
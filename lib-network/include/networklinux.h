@@ -53,6 +53,10 @@ public:
 	uint16_t RecvFrom(uint32_t nHandle, uint8_t *pPacket, uint16_t nSize, uint32_t *pFromIp, uint16_t *pFromPort);
 	void SendTo(uint32_t nHandle, const uint8_t *pPacket, uint16_t nSize, uint32_t nToIp, uint16_t nRemotePort);
 
+	uint32_t GetRecvTimestamp(void) {
+		return m_nRecvTimestamp;
+	}
+
 private:
 	bool IsDhclient(const char *pIfName);
 	int IfGetByAddress(const char *pIp, char *pName, size_t nLength);
@@ -30,6 +30,7 @@
 #include <time.h>
 
 #include "ntp.h"
+#include "ntpclock.h"
 
 enum TNtpClientStatus {
 	NTP_CLIENT_STATUS_STOPPED,
@@ -55,8 +56,14 @@ public:
 		return s_pThis;
 	}
 
+	NtpClock *GetClock(void) {
+		return &m_NtpClock;
+	}
+
 private:
 	void SetUtcOffset(float fUtcOffset);
+	void Send(void);
+	bool Receive(void);
 
 private:
 	static NtpClient *s_pThis;
@@ -71,6 +78,9 @@ private:
 	time_t m_InitTime;
 	uint32_t m_MillisRequest;
 	uint32_t m_MillisLastPoll;
+	uint32_t m_nPollSeconds;
+	uint64_t m_nRequestMicros;
+	NtpClock m_NtpClock;
 };
 
 #endif /* NTPCLIENT_H_ */
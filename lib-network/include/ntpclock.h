@@ -0,0 +1,136 @@
+/**
+ * @file ntpclock.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NTPCLOCK_H_
+#define NTPCLOCK_H_
+
+#include <stdint.h>
+
+#define NTPCLOCK_FILTER_SIZE	8
+
+struct TNtpClockSample {
+	int64_t nOffset;	///< micro seconds
+	uint32_t nDelay;	///< micro seconds
+	uint64_t nMicros;	///< System clock at the sample
+};
+
+/**
+ * A 64-bit micro seconds system clock (UTC, since 1970), disciplined by NTP samples.
+ *
+ * The clock runs on Hardware::Micros(). Small offsets are slewed with a maximum of
+ * 500 ppm, large offsets are stepped. The frequency error of the local oscillator
+ * is estimated from the offsets remaining between the samples.
+ */
+class NtpClock {
+public:
+	NtpClock(void);
+	~NtpClock(void);
+
+	/**
+	 * Must be called more often than Hardware::Micros() wraps around at 2^32 (~71.6 minutes)
+	 */
+	void Run(void);
+
+	/**
+	 * @param t1 Originate timestamp, system clock
+	 * @param t2 Receive timestamp, server
+	 * @param t3 Transmit timestamp, server
+	 * @param t4 Destination timestamp, system clock
+	 */
+	void Sample(uint64_t t1, uint64_t t2, uint64_t t3, uint64_t t4);
+
+	uint64_t GetMicros(void) {
+		Run();
+		return m_nSystemMicros;
+	}
+
+	/**
+	 * Converts a recent Hardware::Micros() timestamp into system clock time
+	 */
+	uint64_t ToSystemMicros(uint32_t nLocalMicros) {
+		Run();
+		return m_nSystemMicros - (m_nLocalMicros - nLocalMicros);
+	}
+
+	bool IsSynchronized(void) {
+		return m_bIsSynchronized;
+	}
+
+	int64_t GetOffset(void) {
+		return m_nOffset;
+	}
+
+	uint32_t GetDelay(void) {
+		return m_nDelay;
+	}
+
+	uint32_t GetJitter(void) {
+		return m_nJitter;
+	}
+
+	int32_t GetFrequency(void) {
+		return m_nFrequency;
+	}
+
+	uint32_t GetSteps(void) {
+		return m_nSteps;
+	}
+
+	void Print(void);
+
+	/**
+	 * The shared timeline for scheduling: the low 32 bits of the system clock when synchronized,
+	 * Hardware::Micros() otherwise
+	 */
+	static uint32_t GetTimelineMicros(void);
+	static uint32_t ToTimelineMicros(uint32_t nLocalMicros);
+
+	static NtpClock *Get(void) {
+		return s_pThis;
+	}
+
+private:
+	void Step(int64_t nOffset);
+
+private:
+	uint32_t m_nLocalMicros;
+	uint64_t m_nSystemMicros;
+	int64_t m_nFractionNanos;
+	int64_t m_nSlewNanos;
+	int32_t m_nFrequency;	///< ppb
+	uint64_t m_nLastSampleMicros;
+	TNtpClockSample m_aFilter[NTPCLOCK_FILTER_SIZE];
+	uint32_t m_nFilterIndex;
+	uint32_t m_nFilterEntries;
+	int64_t m_nOffset;
+	uint32_t m_nDelay;
+	uint32_t m_nJitter;
+	uint32_t m_nSteps;
+	bool m_bIsSynchronized;
+
+	static NtpClock *s_pThis;
+};
+
+#endif /* NTPCLOCK_H_ */
@@ -167,7 +167,7 @@ void NetworkH3emac::LeaveGroup(uint32_t nHandle, uint32_t nIp) {
 }
 
 uint16_t NetworkH3emac::RecvFrom(uint32_t nHandle, uint8_t* packet, uint16_t size, uint32_t* from_ip, uint16_t* from_port) {
-	return udp_recv(nHandle, packet, size, from_ip, from_port);
+	return udp_recv_timestamp(nHandle, packet, size, from_ip, from_port, &m_nRecvTimestamp);
 }
 
 void NetworkH3emac::SendTo(uint32_t nHandle, const uint8_t* packet, uint16_t size, uint32_t to_ip, uint16_t remote_port) {
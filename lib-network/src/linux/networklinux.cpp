@@ -37,6 +37,8 @@
 
 #include "networklinux.h"
 
+#include "hardware.h"
+
 #include "debug.h"
 
 /**
@@ -325,6 +327,7 @@ uint16_t NetworkLinux::RecvFrom(uint32_t nHandle, uint8_t* pPacket, uint16_t nSi
 
 	*pFromIp = si_other.sin_addr.s_addr;
 	*pFromPort = ntohs(si_other.sin_port);
+	m_nRecvTimestamp = Hardware::Get()->Micros();
 
 	return recv_len;
 }
@@ -45,6 +45,21 @@
 
 #define BUFFER_SIZE				1024
 
+/*
+ * RFC 6762, 6. Responding
+ */
+#define RESPONSE_DELAY_MIN_MILLIS		20		///< Shared records
+#define RESPONSE_DELAY_RANGE_MILLIS		100
+#define RESPONSE_DELAY_TC_MILLIS		400		///< More known answers will follow
+#define RESPONSE_RATE_LIMIT_MILLIS		1000	///< Per record multicast
+#define RESPONSE_UNICAST_MILLIS			(MDNS_RESPONSE_TTL * 1000 / 4)	///< 5.4. QU answered with multicast when not multicast for this long
+#define LAST_SENT_NEVER					(-(MDNS_RESPONSE_TTL * 1000))
+
+#define DNS_NAME_MAX					255		///< Including the terminating null byte
+#define DNS_POINTERS_MAX				16		///< Compression pointers followed in one name
+#define DNS_CLASS_MASK					0x7FFF
+#define DNS_QUESTION_UNICAST			0x8000	///< QU bit in the question class
+
 enum TDNSClasses {
 	DNSClassInternet = 1
 };
@@ -53,7 +68,8 @@ enum TDNSRecordTypes {
 	DNSRecordTypeA = 1,		///< 0x01
 	DNSRecordTypePTR = 12,	///< 0x0c
 	DNSRecordTypeTXT = 16,	///< 0x10
-	DNSRecordTypeSRV = 33	///< 0x21
+	DNSRecordTypeSRV = 33,	///< 0x21
+	DNSRecordTypeANY = 255	///< 0xff
 };
 
 enum TDNSCacheFlush {
@@ -86,7 +102,18 @@ MDNS::MDNS(void):
 	m_nBytesReceived(0),
 	m_pName(0),
 	m_nLastAnnounceMillis(0),
-	m_nDNSServiceRecords(0)
+	m_nDNSServiceRecords(0),
+	m_bPendingLocalIp(false),
+	m_bPending(false),
+	m_nPendingMillis(0),
+	m_bPendingUnicastLocalIp(false),
+	m_bPendingUnicast(false),
+	m_nQuerierIp(0),
+	m_nQuerierPort(0),
+	m_nLocalIpLastSentMillis(LAST_SENT_NEVER),
+	m_nPrintMillis(0),
+	m_nPrintPacketsReceived(0),
+	m_nPrintPacketsSent(0)
 {
 	struct in_addr group_ip;
 	(void) inet_aton(MDNS_MULTICAST_ADDRESS, &group_ip);
@@ -99,6 +126,17 @@ MDNS::MDNS(void):
 	assert(m_pOutBuffer != 0);
 
 	memset(&m_aServiceRecords, 0, sizeof(m_aServiceRecords));
+	memset(&m_aPending, 0, sizeof(m_aPending));
+	memset(&m_aPendingUnicast, 0, sizeof(m_aPendingUnicast));
+	memset(&m_aQueried, 0, sizeof(m_aQueried));
+	memset(&m_aQueriedUnicast, 0, sizeof(m_aQueriedUnicast));
+	memset(&m_tStats, 0, sizeof(m_tStats));
+
+	for (uint32_t i = 0; i < SERVICE_RECORDS_MAX; i++) {
+		for (uint32_t j = 0; j < MDNS_RECORD_INDEXES; j++) {
+			m_aLastSentMillis[i][j] = LAST_SENT_NEVER;
+		}
+	}
 }
 
 MDNS::~MDNS(void) {
@@ -125,6 +163,17 @@ void MDNS::Start(void) {
 void MDNS::Stop(void) {
 	Network::Get()->End(MDNS_PORT);
 	m_nHandle = -1;
+
+	memset(&m_aPending, 0, sizeof(m_aPending));
+	memset(&m_aPendingUnicast, 0, sizeof(m_aPendingUnicast));
+	memset(&m_aQueried, 0, sizeof(m_aQueried));
+	memset(&m_aQueriedUnicast, 0, sizeof(m_aQueriedUnicast));
+	m_nQuerierIp = 0;
+	m_nQuerierPort = 0;
+	m_bPendingLocalIp = false;
+	m_bPending = false;
+	m_bPendingUnicastLocalIp = false;
+	m_bPendingUnicast = false;
 }
 
 void MDNS::SetName(const char *pName) {
@@ -151,15 +200,24 @@ void MDNS::CreateMDNSMessage(uint32_t nIndex) {
 	pHeader->nFlags = __builtin_bswap16(0x8400);
 	pHeader->queryCount = 0;
 	pHeader->answerCount = __builtin_bswap16(4);
-	pHeader->authorityCount = __builtin_bswap16(1);
-	pHeader->additionalCount = __builtin_bswap16(0);
+	pHeader->authorityCount = __builtin_bswap16(0);
+	pHeader->additionalCount = __builtin_bswap16(1);
 
 	uint8_t *pData = (uint8_t *)&m_aServiceRecordsData[nIndex].aBuffer + sizeof(struct TmDNSHeader);
+	uint16_t *pOffset = m_aServiceRecordsData[nIndex].aOffset;
 
+	/*
+	 * The records are kept serialized, so that the responses are assembled with memcpy only.
+	 */
+	pOffset[MDNS_RECORD_SRV] = pData - (uint8_t *)pHeader;
 	pData += CreateAnswerServiceSrv(nIndex, pData);
+	pOffset[MDNS_RECORD_TXT] = pData - (uint8_t *)pHeader;
 	pData += CreateAnswerServiceTxt(nIndex, pData);
+	pOffset[MDNS_RECORD_DNSSD] = pData - (uint8_t *)pHeader;
 	pData += CreateAnswerServiceDnsSd(nIndex, pData);
+	pOffset[MDNS_RECORD_PTR] = pData - (uint8_t *)pHeader;
 	pData += CreateAnswerServicePtr(nIndex, pData);
+	pOffset[MDNS_RECORD_INDEXES] = pData - (uint8_t *)pHeader;
 
 	memcpy(pData, &m_tAnswerLocalIp.aBuffer[sizeof (struct TmDNSHeader)], m_tAnswerLocalIp.nSize - sizeof (struct TmDNSHeader));
 	pData += (m_tAnswerLocalIp.nSize - sizeof (struct TmDNSHeader));
@@ -171,61 +229,75 @@ void MDNS::CreateMDNSMessage(uint32_t nIndex) {
 	DEBUG1_EXIT
 }
 
-uint32_t MDNS::DecodeDNSNameNotation(const char *pDNSNameNotation, char *pString) {
+/*
+ * Decodes the name at nOffset of the received message into pString (DNS_NAME_MAX bytes).
+ * Returns the size of the name in the message, 0 when the name is malformed:
+ * a label or a compression pointer outside the message, a pointer that does not point
+ * backwards, too many pointers, or a name that does not fit.
+ */
+uint32_t MDNS::DecodeDNSNameNotation(uint32_t nOffset, char *pString) {
 	DEBUG_ENTRY
 
-	char *pDst = (char *)pString;
-	char *pSrc = (char *)pDNSNameNotation;
-
-	uint32_t nLenght = 0;
 	uint32_t nSize = 0;
-	bool isCompressed = false;
-
-	while (*pSrc != 0) {
-		nLenght = (uint8_t )*pSrc++;
-//		DEBUG_PRINTF("nLenght=%.2x", (int) nLenght);
-
-		if (nLenght > 63) {
-			if (!isCompressed) {
-				nSize += 1;
-			}
-
-			isCompressed = true;
-			const uint32_t nCompressedOffset = (((uint8_t)nLenght & ~(0xC0)) << 8) | ((*pSrc & 0xFF));
-			nLenght =  m_pBuffer[nCompressedOffset];
+	uint32_t nLength = 0;
+	uint32_t nPointers = 0;
+	const uint32_t nStart = nOffset;
+
+	for (;;) {
+		if (nOffset >= m_nBytesReceived) {
+			DEBUG_EXIT
+			return 0;
+		}
 
-//			DEBUG_PRINTF("--> nCompressedOffset=%.4x", (int) nCompressedOffset);
+		const uint32_t nLabel = m_pBuffer[nOffset];
 
-			pSrc = (char *)&m_pBuffer[nCompressedOffset + 1];
+		if (nLabel == 0) {
+			break;
+		}
 
-			for (uint32_t i = 0; i < nLenght; i++) {
-				*pDst = *pSrc;
-				pDst++;
-				pSrc++;
+		if ((nLabel & 0xC0) == 0xC0) {
+			if (((nOffset + 1) >= m_nBytesReceived) || (++nPointers > DNS_POINTERS_MAX)) {
+				DEBUG_EXIT
+				return 0;
 			}
 
-		} else if (nLenght > 0) {
+			const uint32_t nPointer = ((nLabel & 0x3F) << 8) | m_pBuffer[nOffset + 1];
 
-			for (uint32_t i = 0; i < nLenght; i++) {
-				*pDst = *pSrc;
-				pDst++;
-				pSrc++;
+			if (nPointer >= nOffset) {
+				DEBUG_EXIT
+				return 0;
 			}
 
-			if (!isCompressed) {
-				nSize += (nLenght + 1);
+			if (nPointers == 1) {
+				nSize = nOffset + 2 - nStart;
 			}
+
+			nOffset = nPointer;
+			continue;
+		}
+
+		if ((nLabel > 63) || ((nOffset + 1 + nLabel) > m_nBytesReceived) || ((nLength + 1 + nLabel) >= DNS_NAME_MAX)) {
+			DEBUG_EXIT
+			return 0;
 		}
 
-		if (*pSrc != 0) {
-			*pDst++ = '.';
+		if (nLength != 0) {
+			pString[nLength++] = '.';
 		}
+
+		memcpy(&pString[nLength], &m_pBuffer[nOffset + 1], nLabel);
+		nLength += nLabel;
+		nOffset += 1 + nLabel;
 	}
 
-	*pDst = '\0';
+	pString[nLength] = '\0';
+
+	if (nPointers == 0) {
+		nSize = nOffset + 1 - nStart;
+	}
 
 	DEBUG_EXIT
-	return 1 + nSize;
+	return nSize;
 }
 
 bool MDNS::AddServiceRecord(const char *pName, const char *pServName, uint16_t nPort, const char *pTextContent) {
@@ -286,6 +358,7 @@ bool MDNS::AddServiceRecord(const char *pName, const char *pServName, uint16_t n
 	CreateMDNSMessage(i);
 
 	Network::Get()->SendTo(m_nHandle, (uint8_t *)&m_aServiceRecordsData[i].aBuffer, m_aServiceRecordsData[i].nSize, m_nMulticastIp, MDNS_PORT);
+	m_tStats.nPacketsSent++;
 
 	DEBUG1_EXIT
 	return true;
@@ -462,45 +535,372 @@ uint32_t MDNS::CreateAnswerServiceDnsSd(uint32_t nIndex, uint8_t *pDestination)
 	return (pDst - pDestination);
 }
 
-void MDNS::HandleRequest(uint16_t nQuestions) {
+bool MDNS::IsInstanceName(uint32_t nIndex, const char *pDnsName) {
+	const char *pName = (const char *) m_aServiceRecords[nIndex].pName;
+	const size_t nLength = strlen(pName);
+
+	return (strncmp(pName, pDnsName, nLength) == 0) && (strcmp(&pDnsName[nLength], "._udp" MDNS_TLD) == 0);
+}
+
+/*
+ * RFC 6762, 5.4. A QU question is answered with unicast, unless the record
+ * has not been multicast within a quarter of its TTL.
+ */
+void MDNS::SetPending(uint32_t nIndex, uint32_t nRecord, bool bUnicast) {
+	const uint8_t nBit = (1 << nRecord);
+
+	if (bUnicast && ((Hardware::Get()->Millis() - m_aLastSentMillis[nIndex][nRecord]) < RESPONSE_UNICAST_MILLIS)) {
+		m_aQueriedUnicast[nIndex] |= nBit & ~m_aPendingUnicast[nIndex];
+		m_aPendingUnicast[nIndex] |= nBit;
+		m_bPendingUnicast = true;
+	} else {
+		m_aQueried[nIndex] |= nBit & ~m_aPending[nIndex];
+		m_aPending[nIndex] |= nBit;
+	}
+}
+
+uint32_t MDNS::HandleRequest(uint16_t nQuestions, bool bTruncated) {
 	DEBUG_ENTRY
 
-	char DnsName[255];
+	char DnsName[DNS_NAME_MAX];
 
 	uint32_t nOffset = sizeof(struct TmDNSHeader);
+	bool bShared = false;
+	bool bUnique = false;
 
 	for (uint32_t i = 0; i < nQuestions; i++) {
-		nOffset += DecodeDNSNameNotation((const char *)&m_pBuffer[nOffset], DnsName);
+		const uint32_t nSize = DecodeDNSNameNotation(nOffset, DnsName);
+
+		if ((nSize == 0) || ((nOffset + nSize + 4) > m_nBytesReceived)) {
+			DEBUG_PUTS("Malformed question");
+			nOffset = m_nBytesReceived;
+			break;
+		}
+
+		nOffset += nSize;
 
 		const uint16_t nType = __builtin_bswap16(*(uint16_t *)&m_pBuffer[nOffset]);
 		nOffset += 2;
 
-		const uint16_t nClass = __builtin_bswap16(*(uint16_t *)&m_pBuffer[nOffset]) & 0x7F;
+		const uint16_t nClass = __builtin_bswap16(*(uint16_t *)&m_pBuffer[nOffset]);
 		nOffset += 2;
 
-		DEBUG_PRINTF("%s ==> Type : %d, Class: %d", DnsName, (int) nType, (int) nClass);
+		const bool bUnicast = ((nClass & DNS_QUESTION_UNICAST) == DNS_QUESTION_UNICAST);
+
+		DEBUG_PRINTF("%s ==> Type : %d, Class: %d, QU: %d", DnsName, (int) nType, (int) (nClass & DNS_CLASS_MASK), (int) bUnicast);
+
+		m_tStats.nQuestions++;
+
+		if ((nClass & DNS_CLASS_MASK) != DNSClassInternet) {
+			continue;
+		}
+
+		const bool isAny = (nType == DNSRecordTypeANY);
 
-		if (nClass == DNSClassInternet) {
-			if ((strcmp((const char *)m_pName, DnsName) == 0) && (nType == DNSRecordTypeA)) {
-				Network::Get()->SendTo(m_nHandle, m_tAnswerLocalIp.aBuffer, m_tAnswerLocalIp.nSize, m_nMulticastIp, MDNS_PORT);
+		if ((isAny || (nType == DNSRecordTypeA)) && (strcmp((const char *)m_pName, DnsName) == 0)) {
+			if (bUnicast && ((Hardware::Get()->Millis() - m_nLocalIpLastSentMillis) < RESPONSE_UNICAST_MILLIS)) {
+				m_bPendingUnicastLocalIp = true;
+				m_bPendingUnicast = true;
+			} else {
+				m_bPendingLocalIp = true;
+				bUnique = true;
 			}
+		}
+
+		const bool isDnsDs = (strcmp(DNS_SD_SERVICE, DnsName) == 0);
 
+		for (uint32_t j = 0; j < SERVICE_RECORDS_MAX; j++) {
+			if (m_aServiceRecords[j].pName == 0) {
+				continue;
+			}
+
+			if (isAny || (nType == DNSRecordTypePTR)) {
+				if (isDnsDs) {
+					SetPending(j, MDNS_RECORD_DNSSD, bUnicast);
+					bShared = true;
+				} else if (strcmp((const char *)m_aServiceRecords[j].pServName, DnsName) == 0) {
+					SetPending(j, MDNS_RECORD_PTR, bUnicast);
+					bShared = true;
+				}
+			}
+
+			if ((isAny || (nType == DNSRecordTypeSRV) || (nType == DNSRecordTypeTXT)) && IsInstanceName(j, DnsName)) {
+				if (nType != DNSRecordTypeTXT) {
+					SetPending(j, MDNS_RECORD_SRV, bUnicast);
+				}
+				if (nType != DNSRecordTypeSRV) {
+					SetPending(j, MDNS_RECORD_TXT, bUnicast);
+				}
+				bUnique = true;
+			}
+		}
+	}
+
+	bool bMulticast = m_bPendingLocalIp;
+
+	for (uint32_t j = 0; j < SERVICE_RECORDS_MAX; j++) {
+		bMulticast |= (m_aPending[j] != 0);
+	}
+
+	if (bMulticast && (bShared || bUnique)) {
+		/*
+		 * Unique records are answered at once, shared records are delayed 20-120ms,
+		 * so that the answers of other responders and queriers can be aggregated.
+		 */
+		uint32_t nDelay = 0;
+
+		if (bTruncated) {
+			nDelay = RESPONSE_DELAY_TC_MILLIS + (Hardware::Get()->Micros() % RESPONSE_DELAY_RANGE_MILLIS);
+		} else if (bShared) {
+			nDelay = RESPONSE_DELAY_MIN_MILLIS + (Hardware::Get()->Micros() % RESPONSE_DELAY_RANGE_MILLIS);
+		}
+
+		const uint32_t nDeadline = Hardware::Get()->Millis() + nDelay;
+
+		if (!m_bPending || ((int32_t)(nDeadline - m_nPendingMillis) < 0)) {
+			m_nPendingMillis = nDeadline;
+		}
+
+		m_bPending = true;
+	}
+
+	DEBUG_EXIT
+	return nOffset;
+}
+
+/*
+ * RFC 6762, 7.1. Known-Answer Suppression
+ */
+void MDNS::HandleKnownAnswers(uint32_t nOffset, uint16_t nAnswers) {
+	DEBUG_ENTRY
+
+	char DnsName[DNS_NAME_MAX];
+	char DnsTarget[DNS_NAME_MAX];
+
+	for (uint32_t i = 0; i < nAnswers; i++) {
+		const uint32_t nSize = DecodeDNSNameNotation(nOffset, DnsName);
+
+		if ((nSize == 0) || ((nOffset + nSize + 10) > m_nBytesReceived)) {
+			break;
+		}
+
+		nOffset += nSize;
+
+		const uint16_t nType = __builtin_bswap16(*(uint16_t *)&m_pBuffer[nOffset]);
+		nOffset += 4; // Type, Class
+		const uint32_t nTTL = __builtin_bswap32(*(uint32_t *)&m_pBuffer[nOffset]);
+		nOffset += 4;
+		const uint16_t nLength = __builtin_bswap16(*(uint16_t *)&m_pBuffer[nOffset]);
+		nOffset += 2;
+
+		if ((nOffset + nLength) > m_nBytesReceived) {
+			break;
+		}
+
+		if ((nType == DNSRecordTypePTR) && (nTTL >= (MDNS_RESPONSE_TTL / 2)) && (DecodeDNSNameNotation(nOffset, DnsTarget) != 0)) {
 			const bool isDnsDs = (strcmp(DNS_SD_SERVICE, DnsName) == 0);
 
-			for (uint32_t i = 0; i < SERVICE_RECORDS_MAX; i++) {
-				if (m_aServiceRecords[i].pName != 0) {
-					if ((isDnsDs || (strcmp((const char *)m_aServiceRecords[i].pServName, DnsName) == 0)) && (nType == DNSRecordTypePTR) ) {
-						Network::Get()->SendTo(m_nHandle, (uint8_t *)&m_aServiceRecordsData[i].aBuffer, m_aServiceRecordsData[i].nSize, m_nMulticastIp, MDNS_PORT);
-					}
+			for (uint32_t j = 0; j < SERVICE_RECORDS_MAX; j++) {
+				if (m_aServiceRecords[j].pName == 0) {
+					continue;
+				}
+
+				uint32_t nRecord;
+
+				if (isDnsDs && (strcmp((const char *)m_aServiceRecords[j].pServName, DnsTarget) == 0)) {
+					nRecord = MDNS_RECORD_DNSSD;
+				} else if (!isDnsDs && (strcmp((const char *)m_aServiceRecords[j].pServName, DnsName) == 0) && IsInstanceName(j, DnsTarget)) {
+					nRecord = MDNS_RECORD_PTR;
+				} else {
+					continue;
+				}
+
+				// Only the answers pending for the questions of this querier are suppressed
+				const uint8_t nBit = (1 << nRecord) & (m_aQueried[j] | m_aQueriedUnicast[j]);
+
+				if (nBit != 0) {
+					m_aPending[j] &= ~(nBit & m_aQueried[j]);
+					m_aPendingUnicast[j] &= ~(nBit & m_aQueriedUnicast[j]);
+					m_aQueried[j] &= ~nBit;
+					m_aQueriedUnicast[j] &= ~nBit;
+					m_tStats.nKnownAnswersSuppressed++;
 				}
 			}
 		}
 
+		nOffset += nLength;
 	}
 
 	DEBUG_EXIT
 }
 
+void MDNS::Defer(uint32_t nMillis, bool &bDeferred, uint32_t &nDeferredMillis) {
+	if (!bDeferred || ((int32_t)(nMillis - nDeferredMillis) < 0)) {
+		nDeferredMillis = nMillis;
+	}
+
+	bDeferred = true;
+}
+
+void MDNS::SendMessage(uint32_t nLength, uint32_t nAnswers, uint32_t nAdditionals, uint32_t nToIp, uint16_t nToPort) {
+	struct TmDNSHeader *pHeader = (struct TmDNSHeader*) m_pOutBuffer;
+
+	pHeader->xid = 0;
+	pHeader->nFlags = __builtin_bswap16(0x8400);
+	pHeader->queryCount = 0;
+	pHeader->answerCount = __builtin_bswap16(nAnswers);
+	pHeader->authorityCount = 0;
+	pHeader->additionalCount = __builtin_bswap16(nAdditionals);
+
+	debug_dump((void *)m_pOutBuffer, nLength);
+
+	Network::Get()->SendTo(m_nHandle, m_pOutBuffer, nLength, nToIp, nToPort);
+
+	m_tStats.nPacketsSent++;
+	m_tStats.nAnswersSent += nAnswers;
+}
+
+/*
+ * All the answers pending are sent in as few messages as possible.
+ * A PTR answer carries the SRV, TXT and A records as additional records.
+ * Multicast answers are rate limited per record; an answer that is too early
+ * stays pending and the response is rescheduled for when it is allowed.
+ * Unicast answers (QU questions) are sent at once to the querier.
+ */
+void MDNS::SendResponse(bool bUnicast) {
+	DEBUG_ENTRY
+
+	const uint32_t nNow = Hardware::Get()->Millis();
+	const uint32_t nToIp = bUnicast ? m_nRemoteIp : m_nMulticastIp;
+	const uint16_t nToPort = bUnicast ? m_nRemotePort : MDNS_PORT;
+	uint8_t *pPending = bUnicast ? m_aPendingUnicast : m_aPending;
+	bool &bPendingLocalIp = bUnicast ? m_bPendingUnicastLocalIp : m_bPendingLocalIp;
+
+	bool bDeferred = false;
+	uint32_t nDeferredMillis = 0;
+	const uint32_t nLocalIpSize = m_tAnswerLocalIp.nSize - sizeof(struct TmDNSHeader);
+	const uint8_t *pLocalIp = &m_tAnswerLocalIp.aBuffer[sizeof(struct TmDNSHeader)];
+
+	uint8_t aAdditional[SERVICE_RECORDS_MAX];
+	bool bAdditionalLocalIp = false;
+	uint32_t nLength = sizeof(struct TmDNSHeader);
+	uint32_t nAnswers = 0;
+
+	for (uint32_t i = 0; i < SERVICE_RECORDS_MAX; i++) {
+		aAdditional[i] = 0;
+
+		if (pPending[i] == 0) {
+			continue;
+		}
+
+		const uint16_t *pOffset = m_aServiceRecordsData[i].aOffset;
+		uint8_t nDeferred = 0;
+
+		for (uint32_t j = 0; j < MDNS_RECORD_INDEXES; j++) {
+			if ((pPending[i] & (1 << j)) == 0) {
+				continue;
+			}
+
+			if (!bUnicast && ((nNow - m_aLastSentMillis[i][j]) < RESPONSE_RATE_LIMIT_MILLIS)) {
+				Defer(m_aLastSentMillis[i][j] + RESPONSE_RATE_LIMIT_MILLIS, bDeferred, nDeferredMillis);
+				nDeferred |= (1 << j);
+				continue;
+			}
+
+			const uint32_t nSize = pOffset[j + 1] - pOffset[j];
+
+			if ((nLength + nSize) > BUFFER_SIZE) {
+				SendMessage(nLength, nAnswers, 0, nToIp, nToPort);
+				nLength = sizeof(struct TmDNSHeader);
+				nAnswers = 0;
+			}
+
+			memcpy(&m_pOutBuffer[nLength], &m_aServiceRecordsData[i].aBuffer[pOffset[j]], nSize);
+			nLength += nSize;
+			nAnswers++;
+
+			if (!bUnicast) {
+				m_aLastSentMillis[i][j] = nNow;
+			}
+
+			if (j == MDNS_RECORD_PTR) {
+				aAdditional[i] = ((1 << MDNS_RECORD_SRV) | (1 << MDNS_RECORD_TXT)) & ~pPending[i];
+				bAdditionalLocalIp = true;
+			}
+		}
+
+		pPending[i] = nDeferred;
+	}
+
+	if (bPendingLocalIp && !bUnicast && ((nNow - m_nLocalIpLastSentMillis) < RESPONSE_RATE_LIMIT_MILLIS)) {
+		Defer(m_nLocalIpLastSentMillis + RESPONSE_RATE_LIMIT_MILLIS, bDeferred, nDeferredMillis);
+	} else if (bPendingLocalIp) {
+		if ((nLength + nLocalIpSize) > BUFFER_SIZE) {
+			SendMessage(nLength, nAnswers, 0, nToIp, nToPort);
+			nLength = sizeof(struct TmDNSHeader);
+			nAnswers = 0;
+		}
+
+		memcpy(&m_pOutBuffer[nLength], pLocalIp, nLocalIpSize);
+		nLength += nLocalIpSize;
+		nAnswers++;
+
+		if (!bUnicast) {
+			m_nLocalIpLastSentMillis = nNow;
+		}
+
+		bPendingLocalIp = false;
+		bAdditionalLocalIp = false;
+	}
+
+	if (bUnicast) {
+		m_bPendingUnicast = false;
+	} else {
+		m_bPending = bDeferred;
+		m_nPendingMillis = nDeferredMillis;
+	}
+
+	if (bDeferred) {
+		m_tStats.nResponsesDeferred++;
+	}
+
+	if (nAnswers == 0) {
+		DEBUG_EXIT
+		return;
+	}
+
+	// Additional records are optional, these are only added when there is room left
+	uint32_t nAdditionals = 0;
+
+	for (uint32_t i = 0; i < SERVICE_RECORDS_MAX; i++) {
+		const uint16_t *pOffset = m_aServiceRecordsData[i].aOffset;
+
+		for (uint32_t j = 0; j < MDNS_RECORD_INDEXES; j++) {
+			if ((aAdditional[i] & (1 << j)) == 0) {
+				continue;
+			}
+
+			const uint32_t nSize = pOffset[j + 1] - pOffset[j];
+
+			if ((nLength + nSize) <= BUFFER_SIZE) {
+				memcpy(&m_pOutBuffer[nLength], &m_aServiceRecordsData[i].aBuffer[pOffset[j]], nSize);
+				nLength += nSize;
+				nAdditionals++;
+			}
+		}
+	}
+
+	if (bAdditionalLocalIp && ((nLength + nLocalIpSize) <= BUFFER_SIZE)) {
+		memcpy(&m_pOutBuffer[nLength], pLocalIp, nLocalIpSize);
+		nLength += nLocalIpSize;
+		nAdditionals++;
+	}
+
+	SendMessage(nLength, nAnswers, nAdditionals, nToIp, nToPort);
+
+	DEBUG_EXIT
+}
+
 void MDNS::Parse(void) {
 	DEBUG_ENTRY
 
@@ -512,8 +912,31 @@ void MDNS::Parse(void) {
 #endif
 
 	if ((((nFlags >> 15) & 1) == 0) && (((nFlags >> 14) & 0xf) == DNSOpQuery)) {
+		uint32_t nOffset = sizeof(struct TmDNSHeader);
+
+		/*
+		 * The answers queried are tracked per querier, so that the known answers of
+		 * one querier do not suppress the answers to the questions of another one.
+		 * Packets with known answers only, from the same querier, continue a truncated query.
+		 */
+		if ((pmDNSHeader->queryCount != 0) || (m_nRemoteIp != m_nQuerierIp) || (m_nRemotePort != m_nQuerierPort)) {
+			memset(&m_aQueried, 0, sizeof(m_aQueried));
+			memset(&m_aQueriedUnicast, 0, sizeof(m_aQueriedUnicast));
+			m_nQuerierIp = m_nRemoteIp;
+			m_nQuerierPort = m_nRemotePort;
+		}
+
 		if (pmDNSHeader->queryCount != 0) {
-			HandleRequest((uint16_t)__builtin_bswap16(pmDNSHeader->queryCount));
+			nOffset = HandleRequest((uint16_t)__builtin_bswap16(pmDNSHeader->queryCount), ((nFlags >> 9) & 1) == 1);
+		}
+
+		// A truncated query can be followed by packets with known answers only
+		if ((m_bPending || m_bPendingUnicast) && (pmDNSHeader->answerCount != 0)) {
+			HandleKnownAnswers(nOffset, (uint16_t)__builtin_bswap16(pmDNSHeader->answerCount));
+		}
+
+		if (m_bPendingUnicast) {
+			SendResponse(true);
 		}
 	}
 
@@ -530,6 +953,8 @@ void MDNS::Run(void) {
 	if ((m_nRemotePort == MDNS_PORT) && (m_nBytesReceived > sizeof(struct TmDNSHeader))) {
 		debug_dump((void*) m_pBuffer, m_nBytesReceived);
 
+		m_tStats.nPacketsReceived++;
+
 		if (m_nBytesReceived < BUFFER_SIZE) {
 			Parse();
 		} else {
@@ -538,6 +963,10 @@ void MDNS::Run(void) {
 
 	}
 
+	if (m_bPending && ((int32_t)(Hardware::Get()->Millis() - m_nPendingMillis) >= 0)) {
+		SendResponse(false);
+	}
+
 #if 0
 	if (__builtin_expect(((nNow - m_nLastAnnounceMillis) > 1000 * ANNOUNCE_TIMEOUT), 0)) {
 		DEBUG_PUTS("> Announce <");
@@ -28,6 +28,8 @@
 
 #include "mdns.h"
 
+#include "hardware.h"
+
 void MDNS::Print(void) {
 	printf("mDNS\n");
 	if (m_nHandle == -1) {
@@ -40,4 +42,19 @@ void MDNS::Print(void) {
 			printf(" %s %d %s\n", m_aServiceRecords[i].pServName, m_aServiceRecords[i].nPort, m_aServiceRecords[i].pTextContent == 0 ? "" : (char *)m_aServiceRecords[i].pTextContent);
 		}
 	}
+	printf(" Received %u, Sent %u, Questions %u, Answers %u, Suppressed %u, Deferred %u\n", (unsigned) m_tStats.nPacketsReceived, (unsigned) m_tStats.nPacketsSent, (unsigned) m_tStats.nQuestions, (unsigned) m_tStats.nAnswersSent, (unsigned) m_tStats.nKnownAnswersSuppressed, (unsigned) m_tStats.nResponsesDeferred);
+
+	// The rates are computed over the interval since the previous Print
+	const uint32_t nNow = Hardware::Get()->Millis();
+	const uint32_t nInterval = nNow - m_nPrintMillis;
+
+	if ((m_nPrintMillis != 0) && (nInterval != 0)) {
+		const uint32_t nReceived = m_tStats.nPacketsReceived - m_nPrintPacketsReceived;
+		const uint32_t nSent = m_tStats.nPacketsSent - m_nPrintPacketsSent;
+		printf(" Handled %u/s, Sent %u/s (%u ms)\n", (unsigned) ((1000ULL * nReceived) / nInterval), (unsigned) ((1000ULL * nSent) / nInterval), (unsigned) nInterval);
+	}
+
+	m_nPrintMillis = nNow;
+	m_nPrintPacketsReceived = m_tStats.nPacketsReceived;
+	m_nPrintPacketsSent = m_tStats.nPacketsSent;
 }
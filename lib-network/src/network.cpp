@@ -29,6 +29,8 @@
 
 #include "network.h"
 
+#include "hardware.h"
+
 #include "debug.h"
 
 Network *Network::s_pThis = 0;
@@ -42,6 +44,7 @@ Network::Network(void) :
 	m_IsDhcpUsed(false),
 	m_nIfIndex(1),
 	m_fNtpUtcOffset(0),
+	m_nRecvTimestamp(0),
 	m_pNetworkDisplay(0),
 	m_pNetworkStore(0),
 	m_nQueuedLocalIp(0),
@@ -58,6 +61,18 @@ Network::~Network(void) {
 	s_pThis = 0;
 }
 
+uint32_t Network::GetRecvTimestamp(void) {
+	return Hardware::Get()->Micros();
+}
+
+void Network::SetPriority(uint32_t nHandle, bool (*pIsPriority)(const uint8_t *pPacket, uint16_t nSize)) {
+	// override
+}
+
+bool Network::IsPriorityPending(uint32_t nHandle) {
+	return false;
+}
+
 bool Network::SetStaticIp(bool bQueueing, uint32_t nLocalIp, uint32_t nNetmask) {
 	DEBUG_PRINTF("bQueueing=%d, nLocalIp=" IPSTR ", nNetmask=" IPSTR, (int) bQueueing, IP2STR(nLocalIp), IP2STR(nNetmask));
 
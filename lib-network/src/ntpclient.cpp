@@ -46,17 +46,27 @@
 
 #define RETRIES			3
 #define TIMEOUT_MILLIS	3000 	// 3 seconds
-#define POLL_SECONDS	1024	// 2ˆ10
+#define POLL_MAX		10		// 2ˆ10 = 1024 seconds
+
+#define POLL_INCREASE_MICROS	500		///< |offset| below, the poll interval is doubled
+#define POLL_DECREASE_MICROS	4000	///< |offset| above, the poll interval is reset to the minimum
 
 NtpClient *NtpClient::s_pThis = 0;
 
+static uint64_t ntp_to_micros(uint32_t nSeconds, uint32_t nFraction) {
+	const uint64_t nMicros = ((uint64_t) __builtin_bswap32(nFraction) * 1000000) >> 32;
+	return ((uint64_t) (__builtin_bswap32(nSeconds) - (uint32_t) NTP_TIMESTAMP_DELTA) * 1000000) + nMicros;
+}
+
 NtpClient::NtpClient(uint32_t nServerIp):
 	m_nServerIp(nServerIp),
 	m_nHandle(-1),
 	m_tStatus(NTP_CLIENT_STATUS_STOPPED),
 	m_InitTime(0),
 	m_MillisRequest(0),
-	m_MillisLastPoll(0)
+	m_MillisLastPoll(0),
+	m_nPollSeconds(1 << NTP_MINPOLL),
+	m_nRequestMicros(0)
 {
 	DEBUG_ENTRY
 
@@ -69,7 +79,7 @@ NtpClient::NtpClient(uint32_t nServerIp):
 	memset(&m_Request, 0, sizeof m_Request);
 
 	m_Request.LiVnMode = NTP_VERSION | NTP_MODE_CLIENT;
-	m_Request.Poll = 10; // Poll: 1024 seconds
+	m_Request.Poll = NTP_MINPOLL;
 
 	memset(&m_Reply, 0, sizeof m_Reply);
 
@@ -84,6 +94,56 @@ void NtpClient::SetUtcOffset(float fUtcOffset) {
 	m_nUtcOffset = Utc::Validate(fUtcOffset);
 }
 
+void NtpClient::Send(void) {
+	m_nRequestMicros = m_NtpClock.GetMicros();
+
+	const uint64_t nSeconds = m_nRequestMicros / 1000000;
+	const uint64_t nMicros = m_nRequestMicros - (nSeconds * 1000000);
+
+	m_Request.TransmitTimestamp_s = __builtin_bswap32((uint32_t) (nSeconds + NTP_TIMESTAMP_DELTA));
+	m_Request.TransmitTimestamp_f = __builtin_bswap32((uint32_t) ((nMicros << 32) / 1000000));
+
+	Network::Get()->SendTo(m_nHandle, (const uint8_t *)&m_Request, sizeof m_Request, m_nServerIp, NTP_UDP_PORT);
+}
+
+/*
+ * Feeds the reply into the clock discipline and adapts the poll interval.
+ */
+bool NtpClient::Receive(void) {
+	const uint64_t t4 = m_NtpClock.ToSystemMicros(Network::Get()->GetRecvTimestamp());
+
+	debug_dump((void *)&m_Reply, sizeof m_Reply);
+
+	if (__builtin_expect(((m_Reply.LiVnMode & NTP_MODE_SERVER) != NTP_MODE_SERVER), 0)) {
+		DEBUG_PUTS("!>> Invalid reply <<!");
+		return false;
+	}
+
+	if (__builtin_expect(((m_Reply.OriginTimestamp_s != m_Request.TransmitTimestamp_s) || (m_Reply.OriginTimestamp_f != m_Request.TransmitTimestamp_f)), 0)) {
+		DEBUG_PUTS("!>> Bogus reply <<!");
+		return false;
+	}
+
+	const uint64_t t2 = ntp_to_micros(m_Reply.ReceiveTimestamp_s, m_Reply.ReceiveTimestamp_f);
+	const uint64_t t3 = ntp_to_micros(m_Reply.TransmitTimestamp_s, m_Reply.TransmitTimestamp_f);
+
+	m_NtpClock.Sample(m_nRequestMicros, t2, t3, t4);
+
+	const int64_t nOffset = m_NtpClock.GetOffset();
+
+	if (!m_NtpClock.IsSynchronized() || (nOffset > POLL_DECREASE_MICROS) || (nOffset < -POLL_DECREASE_MICROS)) {
+		m_Request.Poll = NTP_MINPOLL;
+	} else if ((nOffset < POLL_INCREASE_MICROS) && (nOffset > -POLL_INCREASE_MICROS) && (m_Request.Poll < POLL_MAX)) {
+		m_Request.Poll++;
+	}
+
+	m_nPollSeconds = 1U << m_Request.Poll;
+
+	DEBUG_PRINTF("nOffset=%d, m_nPollSeconds=%u", (int) nOffset, (unsigned) m_nPollSeconds);
+
+	return true;
+}
+
 void NtpClient::Init(void) {
 	DEBUG_ENTRY
 
@@ -104,7 +164,7 @@ void NtpClient::Init(void) {
 	uint16_t nBytesReceived;
 
 	for (nRetries = 0; nRetries < RETRIES; nRetries++) {
-		Network::Get()->SendTo(m_nHandle, (const uint8_t *)&m_Request, sizeof m_Request, m_nServerIp, NTP_UDP_PORT);
+		Send();
 
 		uint32_t nFromIp;
 		uint16_t nFromPort;
@@ -124,10 +184,8 @@ void NtpClient::Init(void) {
 				continue;
 			}
 
-			debug_dump((void *)&m_Reply, sizeof m_Reply);
-
-			if ((m_Reply.LiVnMode & NTP_MODE_SERVER) == NTP_MODE_SERVER) {
-				m_InitTime = (time_t)(__builtin_bswap32(m_Reply.ReceiveTimestamp_s) - NTP_TIMESTAMP_DELTA + m_nUtcOffset);
+			if (Receive()) {
+				m_InitTime = (time_t)((m_NtpClock.GetMicros() / 1000000) + m_nUtcOffset);
 				DEBUG_PRINTF("m_InitTime=%u", (unsigned) m_InitTime);
 
 				struct tm *pLocalTime = localtime(&m_InitTime);
@@ -140,9 +198,6 @@ void NtpClient::Init(void) {
 					m_MillisLastPoll = Hardware::Get()->Millis();
 					m_tStatus = NTP_CLIENT_STATUS_IDLE;
 				}
-
-			} else {
-				DEBUG_PUTS("!>> Invalid reply <<!");
 			}
 			break;
 		}
@@ -163,9 +218,11 @@ void NtpClient::Run(void) {
 		return;
 	}
 
+	m_NtpClock.Run();
+
 	if (m_tStatus == NTP_CLIENT_STATUS_IDLE) {
-		if (__builtin_expect(((Hardware::Get()->Millis() - m_MillisLastPoll) > (1000 * POLL_SECONDS)), 0)) {
-			Network::Get()->SendTo(m_nHandle, (const uint8_t *)&m_Request, sizeof m_Request, m_nServerIp, NTP_UDP_PORT);
+		if (__builtin_expect(((Hardware::Get()->Millis() - m_MillisLastPoll) > (1000 * m_nPollSeconds)), 0)) {
+			Send();
 			m_MillisRequest = Hardware::Get()->Millis();
 			m_tStatus = NTP_CLIENT_STATUS_WAITING;
 			DEBUG_PUTS("NTP_CLIENT_STATUS_WAITING");
@@ -194,10 +251,8 @@ void NtpClient::Run(void) {
 			return;
 		}
 
-		debug_dump((void *)&m_Reply, sizeof m_Reply);
-
-		if (__builtin_expect(((m_Reply.LiVnMode & NTP_MODE_SERVER) == NTP_MODE_SERVER), 1)) {
-			const time_t nTime = (time_t)(__builtin_bswap32(m_Reply.ReceiveTimestamp_s) - NTP_TIMESTAMP_DELTA + m_nUtcOffset);
+		if (__builtin_expect(Receive(), 1)) {
+			const time_t nTime = (time_t)((m_NtpClock.GetMicros() / 1000000) + m_nUtcOffset);
 			Hardware::Get()->SetSysTime(nTime);
 			m_MillisLastPoll = Hardware::Get()->Millis();
 
@@ -208,8 +263,6 @@ void NtpClient::Run(void) {
 			memcpy(&hwTime, pLocalTime, sizeof (struct THardwareTime));
 			DEBUG_PRINTF("%.4d/%.2d/%.2d %.2d:%.2d:%.2d", pLocalTime->tm_year, pLocalTime->tm_mon, pLocalTime->tm_mday, pLocalTime->tm_hour, pLocalTime->tm_min, pLocalTime->tm_sec);
 #endif
-		} else {
-			DEBUG_PUTS("!>> Invalid reply <<!");
 		}
 
 		m_tStatus = NTP_CLIENT_STATUS_IDLE;
@@ -228,4 +281,6 @@ void NtpClient::Print(void) {
 	printf(" Status : %d%c\n", (int) m_tStatus, m_tStatus == NTP_CLIENT_STATUS_STOPPED ? '!' : ' ');
 	printf(" Time : %s", asctime(localtime((const time_t *) &m_InitTime)));
 	printf(" UTC offset : %d (seconds)\n", m_nUtcOffset);
+	printf(" Poll : %u (seconds)\n", (unsigned) m_nPollSeconds);
+	m_NtpClock.Print();
 }
@@ -0,0 +1,250 @@
+/**
+ * @file ntpclock.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#include "ntpclock.h"
+
+#include "hardware.h"
+
+#include "debug.h"
+
+#define STEP_THRESHOLD_MICROS	128000	///< NTP step threshold
+#define SLEW_MAX_PPM			500
+#define FREQUENCY_MAX_PPB		(SLEW_MAX_PPM * 1000)
+#define FREQUENCY_GAIN			4		///< Part of the measured frequency error corrected per sample
+#define FREQUENCY_MIN_INTERVAL	1000000	///< micro seconds
+#define DISPERSION_PPM			15		///< NTP PHI, the age of a sample adds to its delay for the selection
+
+NtpClock *NtpClock::s_pThis = 0;
+
+NtpClock::NtpClock(void):
+	m_nFractionNanos(0),
+	m_nSlewNanos(0),
+	m_nFrequency(0),
+	m_nLastSampleMicros(0),
+	m_nFilterIndex(0),
+	m_nFilterEntries(0),
+	m_nOffset(0),
+	m_nDelay(0),
+	m_nJitter(0),
+	m_nSteps(0),
+	m_bIsSynchronized(false)
+{
+	DEBUG_ENTRY
+
+	s_pThis = this;
+
+	m_nLocalMicros = Hardware::Get()->Micros();
+	m_nSystemMicros = (uint64_t) Hardware::Get()->GetTime() * 1000000;
+
+	memset(m_aFilter, 0, sizeof(m_aFilter));
+
+	DEBUG_EXIT
+}
+
+NtpClock::~NtpClock(void) {
+	s_pThis = 0;
+}
+
+void NtpClock::Run(void) {
+	const uint32_t nNow = Hardware::Get()->Micros();
+	const uint32_t nElapsed = nNow - m_nLocalMicros;
+
+	if (nElapsed == 0) {
+		return;
+	}
+
+	m_nLocalMicros = nNow;
+
+	// Frequency correction and slew, both in nano seconds
+	int64_t nAdjust = ((int64_t) nElapsed * m_nFrequency) / 1000000;
+
+	const int64_t nSlewMax = ((int64_t) nElapsed * SLEW_MAX_PPM) / 1000;
+	int64_t nSlew = m_nSlewNanos;
+
+	if (nSlew > nSlewMax) {
+		nSlew = nSlewMax;
+	} else if (nSlew < -nSlewMax) {
+		nSlew = -nSlewMax;
+	}
+
+	m_nSlewNanos -= nSlew;
+
+	nAdjust += nSlew + m_nFractionNanos;
+
+	const int64_t nAdjustMicros = nAdjust / 1000;
+	m_nFractionNanos = nAdjust - (nAdjustMicros * 1000);
+
+	m_nSystemMicros += nElapsed + nAdjustMicros;
+}
+
+void NtpClock::Step(int64_t nOffset) {
+	m_nSystemMicros += nOffset;
+	m_nSlewNanos = 0;
+	m_nFractionNanos = 0;
+	// The samples kept are relative to the clock before the step
+	memset(m_aFilter, 0, sizeof(m_aFilter));
+	m_nFilterIndex = 0;
+	m_nFilterEntries = 0;
+	m_nLastSampleMicros = 0;
+	m_nSteps++;
+
+	DEBUG_PRINTF("Step %d", (int) nOffset);
+}
+
+void NtpClock::Sample(uint64_t t1, uint64_t t2, uint64_t t3, uint64_t t4) {
+	DEBUG_ENTRY
+
+	Run();
+
+	const int64_t nOffset = (((int64_t) (t2 - t1)) + ((int64_t) (t3 - t4))) / 2;
+	int64_t nDelay = ((int64_t) (t4 - t1)) - ((int64_t) (t3 - t2));
+
+	if (nDelay < 0) {
+		nDelay = 0;
+	}
+
+	DEBUG_PRINTF("nOffset=%d, nDelay=%d", (int) nOffset, (int) nDelay);
+
+	if ((m_nSteps == 0) || (nOffset > STEP_THRESHOLD_MICROS) || (nOffset < -STEP_THRESHOLD_MICROS)) {
+		Step(nOffset);
+		m_nOffset = 0;
+		m_nDelay = nDelay;
+		m_bIsSynchronized = false;
+		DEBUG_EXIT
+		return;
+	}
+
+	/*
+	 * Clock filter: the sample with the lowest delay has the least asymmetric queuing.
+	 */
+	const uint64_t nNow = m_nSystemMicros;
+
+	m_aFilter[m_nFilterIndex].nOffset = nOffset;
+	m_aFilter[m_nFilterIndex].nDelay = (uint32_t) nDelay;
+	m_aFilter[m_nFilterIndex].nMicros = nNow;
+	m_nFilterIndex = (m_nFilterIndex + 1) & (NTPCLOCK_FILTER_SIZE - 1);
+
+	if (m_nFilterEntries < NTPCLOCK_FILTER_SIZE) {
+		m_nFilterEntries++;
+	}
+
+	/*
+	 * An older sample does not include the drift since, so its delay is increased with its age.
+	 */
+	uint32_t nSelected = 0;
+	uint64_t nSelectedDelay = UINT64_MAX;
+
+	for (uint32_t i = 0; i < m_nFilterEntries; i++) {
+		const uint64_t nDistance = m_aFilter[i].nDelay + ((nNow - m_aFilter[i].nMicros) * DISPERSION_PPM) / 1000000;
+
+		if (nDistance < nSelectedDelay) {
+			nSelectedDelay = nDistance;
+			nSelected = i;
+		}
+	}
+
+	const int64_t nFilteredOffset = m_aFilter[nSelected].nOffset;
+
+	uint64_t nJitter = 0;
+
+	for (uint32_t i = 0; i < m_nFilterEntries; i++) {
+		const int64_t nDiff = m_aFilter[i].nOffset - nFilteredOffset;
+		nJitter += (nDiff < 0) ? -nDiff : nDiff;
+	}
+
+	m_nJitter = nJitter / m_nFilterEntries;
+
+	/*
+	 * A sample not newer than the one used last has been corrected for already (RFC 5905, clock filter).
+	 */
+	const uint64_t nSampleMicros = m_aFilter[nSelected].nMicros;
+
+	if ((m_nLastSampleMicros != 0) && (nSampleMicros <= m_nLastSampleMicros)) {
+		DEBUG_EXIT
+		return;
+	}
+
+	/*
+	 * What is left of the offset after the slew still pending is caused by the frequency error.
+	 */
+	if (m_nLastSampleMicros != 0) {
+		const int64_t nInterval = nSampleMicros - m_nLastSampleMicros;
+
+		if (nInterval >= FREQUENCY_MIN_INTERVAL) {
+			const int64_t nResidual = nFilteredOffset - (m_nSlewNanos / 1000);
+			int64_t nFrequency = m_nFrequency + ((nResidual * 1000000000) / nInterval) / FREQUENCY_GAIN;
+
+			if (nFrequency > FREQUENCY_MAX_PPB) {
+				nFrequency = FREQUENCY_MAX_PPB;
+			} else if (nFrequency < -FREQUENCY_MAX_PPB) {
+				nFrequency = -FREQUENCY_MAX_PPB;
+			}
+
+			m_nFrequency = (int32_t) nFrequency;
+		}
+	}
+
+	m_nLastSampleMicros = nSampleMicros;
+
+	m_nSlewNanos = nFilteredOffset * 1000;
+
+	// The samples kept are now relative to the corrected clock
+	for (uint32_t i = 0; i < m_nFilterEntries; i++) {
+		m_aFilter[i].nOffset -= nFilteredOffset;
+	}
+
+	m_nOffset = nFilteredOffset;
+	m_nDelay = m_aFilter[nSelected].nDelay;
+	m_bIsSynchronized = true;
+
+	DEBUG_EXIT
+}
+
+uint32_t NtpClock::GetTimelineMicros(void) {
+	return ToTimelineMicros(Hardware::Get()->Micros());
+}
+
+uint32_t NtpClock::ToTimelineMicros(uint32_t nLocalMicros) {
+	if ((s_pThis != 0) && s_pThis->IsSynchronized()) {
+		return static_cast<uint32_t>(s_pThis->ToSystemMicros(nLocalMicros));
+	}
+
+	return nLocalMicros;
+}
+
+void NtpClock::Print(void) {
+	printf("NTP Clock\n");
+	printf(" Synchronized : %s\n", m_bIsSynchronized ? "Yes" : "No");
+	printf(" Offset : %d us\n", (int) m_nOffset);
+	printf(" Delay : %u us\n", (unsigned) m_nDelay);
+	printf(" Jitter : %u us\n", (unsigned) m_nJitter);
+	printf(" Frequency : %d ppb\n", (int) m_nFrequency);
+	printf(" Steps : %u\n", (unsigned) m_nSteps);
+}
@@ -346,6 +346,7 @@ int OscServer::Run(void) {
 							m_nLastChannel = size > m_nLastChannel ? size : m_nLastChannel;
 							m_pLightSet->SetData(0, m_pData, m_nLastChannel);
 						}
+						m_pLightSet->Sync();
 					}
 				} else {
 					DEBUG_PUTS("Too many channels");
@@ -382,6 +383,7 @@ int OscServer::Run(void) {
 						m_nLastChannel = nChannel > m_nLastChannel ? nChannel : m_nLastChannel;
 						m_pLightSet->SetData(0, m_pData, m_nLastChannel);
 					}
+					m_pLightSet->Sync();
 				}
 			}
 		} else if (OSC::isMatch((const char*) m_pBuffer, m_aPathSecond)) {
@@ -414,6 +416,7 @@ int OscServer::Run(void) {
 							m_nLastChannel = nChannel > m_nLastChannel ? nChannel : m_nLastChannel;
 							m_pLightSet->SetData(0, m_pData, m_nLastChannel);
 						}
+						m_pLightSet->Sync();
 					}
 				} else {
 					return -1;
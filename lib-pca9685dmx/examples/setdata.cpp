@@ -0,0 +1,112 @@
+/**
+ * @file setdata.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "bcm2835.h"
+
+#include "pca9685dmxled.h"
+
+#define BOARD_INSTANCES	4
+#define FRAMES			1000
+#define DMX_LENGTH		512
+
+static uint64_t nanos(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t) ts.tv_sec * 1000000000) + (uint64_t) ts.tv_nsec;
+}
+
+/*
+ * A full frame where one slot changes per frame: SetData compares the complete
+ * footprint, SetDataChanged only the changed slot. Both write the one changed channel.
+ */
+int main(int argc, char **argv) {
+	if (getuid() != 0) {
+		fprintf(stderr, "Program is not started as \'root\' (sudo)\n");
+		return -1;
+	}
+
+	if (bcm2835_init() == 0) {
+		fprintf(stderr, "Function bcm2835_init() failed\n");
+		return -2;
+	}
+
+	PCA9685DmxLed pwmled;
+	pwmled.SetBoardInstances(BOARD_INSTANCES);
+	pwmled.Start();
+
+	const uint32_t nFootprint = pwmled.GetDmxFootprint();
+	uint8_t aDmxData[DMX_LENGTH];
+	memset(aDmxData, 0, sizeof(aDmxData));
+
+	pwmled.SetData(0, aDmxData, DMX_LENGTH);
+
+	printf("%d boards, %d channels, %d frames\n", BOARD_INSTANCES, (int) nFootprint, FRAMES);
+	printf("Function         us/frame\n");
+
+	uint64_t nStart = nanos();
+
+	for (uint32_t nFrame = 0; nFrame < FRAMES; nFrame++) {
+		const uint32_t nSlot = nFrame % nFootprint;
+		aDmxData[nSlot]++;
+		pwmled.SetData(0, aDmxData, DMX_LENGTH);
+	}
+
+	printf("SetData          %8.2f\n", (double) (nanos() - nStart) / 1000 / FRAMES);
+
+	nStart = nanos();
+
+	for (uint32_t nFrame = 0; nFrame < FRAMES; nFrame++) {
+		const uint32_t nSlot = nFrame % nFootprint;
+		aDmxData[nSlot]++;
+		pwmled.SetDataChanged(0, aDmxData, DMX_LENGTH, nSlot, nSlot + 1);
+	}
+
+	printf("SetDataChanged   %8.2f\n", (double) (nanos() - nStart) / 1000 / FRAMES);
+
+	/*
+	 * After a start address change, the first update must compare the complete footprint,
+	 * although only one slot is reported as changed.
+	 */
+	for (uint32_t i = 0; i < DMX_LENGTH; i++) {
+		aDmxData[i] = (uint8_t) i;
+	}
+
+	pwmled.SetData(0, aDmxData, DMX_LENGTH);
+	pwmled.SetDmxStartAddress(2);
+
+	nStart = nanos();
+	pwmled.SetDataChanged(0, aDmxData, DMX_LENGTH, 0, 1);
+	printf("Start address    %8.2f (complete update)\n", (double) (nanos() - nStart) / 1000);
+
+	pwmled.Stop();
+
+	return 0;
+}
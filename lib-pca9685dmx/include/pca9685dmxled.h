@@ -41,6 +41,7 @@ public:
 	void Stop(uint8_t nPort = 0);
 
 	void SetData(uint8_t nPort, const uint8_t *pDmxData, uint16_t nLength);
+	void SetDataChanged(uint8_t nPort, const uint8_t *pDmxData, uint16_t nLength, uint16_t nChangedFirst, uint16_t nChangedLast);
 
 public: // RDM
 	bool SetDmxStartAddress(uint16_t nDmxStartAddress);
@@ -91,6 +92,7 @@ private:
 	bool m_bOutputInvert;
 	bool m_bOutputDriver;
 	bool m_bIsStarted;
+	bool m_bUpdateAll;
 	PCA9685PWMLed **m_pPWMLed;
 	uint8_t *m_pDmxData;
 	char *m_pSlotInfoRaw;
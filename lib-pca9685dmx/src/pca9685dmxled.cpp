@@ -53,6 +53,7 @@ PCA9685DmxLed::PCA9685DmxLed(void):
 	m_bOutputInvert(false), // Output logic state not inverted. Value to use when external driver used.
 	m_bOutputDriver(true),	// The 16 LEDn outputs are configured with a totem pole structure.
 	m_bIsStarted(false),
+	m_bUpdateAll(true),
 	m_pPWMLed(0),
 	m_pDmxData(0),
 	m_pSlotInfoRaw(0),
@@ -130,11 +131,61 @@ void PCA9685DmxLed::SetData(uint8_t nPort, const uint8_t* pDmxData, uint16_t nLe
 	}
 }
 
+void PCA9685DmxLed::SetDataChanged(uint8_t nPort, const uint8_t* pDmxData, uint16_t nLength, uint16_t nChangedFirst, uint16_t nChangedLast) {
+	assert(pDmxData != 0);
+	assert(nLength <= DMX_MAX_CHANNELS);
+
+	if (__builtin_expect((m_pPWMLed == 0), 0)) {
+		Start();
+	}
+
+	// The slots outside the range are not the ones last written to the outputs
+	if (__builtin_expect(m_bUpdateAll, 0)) {
+		m_bUpdateAll = false;
+		nChangedFirst = 0;
+		nChangedLast = nLength;
+	}
+
+	// Only the changed slots within the footprint are compared
+	const uint32_t nOffset = m_nDmxStartAddress - 1;
+	const uint32_t nFirst = (nChangedFirst > nOffset) ? (nChangedFirst - nOffset) : 0;
+	uint32_t nLast = (nChangedLast > nOffset) ? (nChangedLast - nOffset) : 0;
+
+	if (nLast > m_nDmxFootprint) {
+		nLast = m_nDmxFootprint;
+	}
+
+	if (nLast > (m_nBoardInstances * PCA9685_PWM_CHANNELS)) {
+		nLast = m_nBoardInstances * PCA9685_PWM_CHANNELS;
+	}
+
+	for (uint32_t nSlot = nFirst; nSlot < nLast; nSlot++) {
+		if (nOffset + nSlot >= nLength) {
+			break;
+		}
+
+		const uint8_t value = pDmxData[nOffset + nSlot];
+
+		if (value != m_pDmxData[nSlot]) {
+			const uint32_t j = nSlot / PCA9685_PWM_CHANNELS;
+			const uint32_t i = nSlot - (j * PCA9685_PWM_CHANNELS);
+#ifndef NDEBUG
+			printf("m_pPWMLed[%d]->SetDmx(CHANNEL(%d), %d)\n", (int) j, (int) i, (int) value);
+#endif
+			m_pPWMLed[j]->Set(CHANNEL(i), value);
+			m_pDmxData[nSlot] = value;
+		}
+	}
+}
+
 bool PCA9685DmxLed::SetDmxStartAddress(uint16_t nDmxStartAddress) {
 	assert((nDmxStartAddress != 0) && (nDmxStartAddress <= DMX_MAX_CHANNELS));
 
 	if ((nDmxStartAddress != 0) && (nDmxStartAddress <= DMX_MAX_CHANNELS)) {
-		m_nDmxStartAddress = nDmxStartAddress;
+		if (nDmxStartAddress != m_nDmxStartAddress) {
+			m_nDmxStartAddress = nDmxStartAddress;
+			m_bUpdateAll = true;
+		}
 		return true;
 	}
 
@@ -168,6 +219,7 @@ void PCA9685DmxLed::SetBoardInstances(uint8_t nBoardInstances) {
 	if ((nBoardInstances != 0) && (nBoardInstances <= BOARD_INSTANCES_MAX)) {
 		m_nBoardInstances = nBoardInstances;
 		m_nDmxFootprint = nBoardInstances * PCA9685_PWM_CHANNELS;
+		m_bUpdateAll = true;
 	}
 }
 
@@ -194,6 +246,7 @@ void PCA9685DmxLed::SetOutDriver(bool bOutputDriver) {
 void PCA9685DmxLed::SetDmxFootprint(uint16_t nDmxFootprint) {
 	m_nDmxFootprint = nDmxFootprint;
 	m_nBoardInstances = (uint16_t) ceil((float) nDmxFootprint / PCA9685_PWM_CHANNELS);
+	m_bUpdateAll = true;
 }
 
 void PCA9685DmxLed::Initialize(void) {
@@ -46,6 +46,14 @@ public:
 
 	alignas(uint32_t) static const char ACTIVE_OUT[];
 	alignas(uint32_t) static const char USE_SI5351A[];
+
+	alignas(uint32_t) static const char INPUT_16BIT[];
+	alignas(uint32_t) static const char GAMMA[];
+	alignas(uint32_t) static const char CORRECTION_RED[];
+	alignas(uint32_t) static const char CORRECTION_GREEN[];
+	alignas(uint32_t) static const char CORRECTION_BLUE[];
+	alignas(uint32_t) static const char CORRECTION_WHITE[];
+	alignas(uint32_t) static const char DITHER[];
 };
 
 #endif /* DEVICESPARAMSCONST_H_ */
@@ -43,3 +43,11 @@ alignas(uint32_t) const char DevicesParamsConst::GLOBAL_BRIGHTNESS[] = "global_b
 
 alignas(uint32_t) const char DevicesParamsConst::ACTIVE_OUT[] = "active_out";
 alignas(uint32_t) const char DevicesParamsConst::USE_SI5351A[] = "use_si5351A";
+
+alignas(uint32_t) const char DevicesParamsConst::INPUT_16BIT[] = "input_16bit";
+alignas(uint32_t) const char DevicesParamsConst::GAMMA[] = "gamma";
+alignas(uint32_t) const char DevicesParamsConst::CORRECTION_RED[] = "correction_red";
+alignas(uint32_t) const char DevicesParamsConst::CORRECTION_GREEN[] = "correction_green";
+alignas(uint32_t) const char DevicesParamsConst::CORRECTION_BLUE[] = "correction_blue";
+alignas(uint32_t) const char DevicesParamsConst::CORRECTION_WHITE[] = "correction_white";
+alignas(uint32_t) const char DevicesParamsConst::DITHER[] = "dither";
@@ -0,0 +1,228 @@
+/**
+ * @file pidlookup.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * RDMHandler PID dispatch: every PID of SUPPORTED_PARAMETERS must be found by the
+ * binary search, the list must be sorted. The GET's are timed through HandleData.
+ * The lookup on its own, linear against binary, is timed on the same list.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "hardware.h"
+#include "networklinux.h"
+
+#include "rdm.h"
+#include "rdm_e120.h"
+#include "rdmhandler.h"
+#include "rdmdeviceresponder.h"
+#include "rdmpersonality.h"
+#include "rdmsoftwareversion.h"
+#include "rdmidentify.h"
+
+#include "lightsetdebug.h"
+
+#define ITERATIONS		200000
+
+static const char SOFTWARE_VERSION[] = "1.0";
+
+const char *RDMSoftwareVersion::GetVersion(void) {
+	return SOFTWARE_VERSION;
+}
+
+const uint8_t RDMSoftwareVersion::GetVersionLength(void) {
+	return (uint8_t) sizeof(SOFTWARE_VERSION) / sizeof(SOFTWARE_VERSION[0]) - 1;
+}
+
+const uint32_t RDMSoftwareVersion::GetVersionId(void) {
+	return 0;
+}
+
+class Identify: public RDMIdentify {
+public:
+	void SetMode(TRdmIdentifyMode nMode) {
+		m_nMode = nMode;
+	}
+};
+
+static uint64_t nanos(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static struct TRdmMessageNoSc s_Request;
+static uint8_t s_Response[sizeof(struct TRdmMessage)];
+
+static void get(RDMHandler& handler, uint16_t nPid) {
+	s_Request.transaction_number++;
+	s_Request.param_id[0] = (uint8_t) (nPid >> 8);
+	s_Request.param_id[1] = (uint8_t) nPid;
+
+	handler.HandleData((const uint8_t *) &s_Request, s_Response);
+}
+
+static bool is_unknown_pid(void) {
+	const struct TRdmMessage *pResponse = (const struct TRdmMessage *) s_Response;
+
+	return (pResponse->slot16.response_type == E120_RESPONSE_TYPE_NACK_REASON)
+			&& (pResponse->param_data[0] == (E120_NR_UNKNOWN_PID >> 8)) && (pResponse->param_data[1] == (E120_NR_UNKNOWN_PID & 0xFF));
+}
+
+static uint16_t s_Pids[128];
+static uint32_t s_nPids;
+
+static int linear(uint16_t nPid) {
+	int nIndex = -1;
+
+	// The old lookup did not stop at the first match
+	for (uint32_t i = 0; i < s_nPids; i++) {
+		if (s_Pids[i] == nPid) {
+			nIndex = (int) i;
+		}
+	}
+
+	return nIndex;
+}
+
+static int binary(uint16_t nPid) {
+	uint32_t nLower = 0;
+	uint32_t nUpper = s_nPids;
+
+	while (nLower < nUpper) {
+		const uint32_t nMiddle = (nLower + nUpper) / 2;
+
+		if (s_Pids[nMiddle] < nPid) {
+			nLower = nMiddle + 1;
+		} else {
+			nUpper = nMiddle;
+		}
+	}
+
+	return ((nLower < s_nPids) && (s_Pids[nLower] == nPid)) ? (int) nLower : -1;
+}
+
+static double lookup(int (*pLookup)(uint16_t)) {
+	volatile int nSum = 0;
+	const uint64_t nStart = nanos();
+
+	for (uint32_t i = 0; i < ITERATIONS * 10; i++) {
+		nSum += pLookup(s_Pids[i % s_nPids]);
+	}
+
+	return (double) (nanos() - nStart) / (ITERATIONS * 10);
+}
+
+int main(int argc, char **argv) {
+	Hardware hw;
+	NetworkLinux nw;
+	Identify identify;
+	LightSetDebug lightSet;
+	RDMPersonality personality("PID lookup", lightSet.GetDmxFootprint());
+	RDMDeviceResponder responder(&personality, &lightSet);
+
+	responder.Init();
+
+	RDMHandler handler;
+
+	s_Request.sub_start_code = E120_SC_SUB_MESSAGE;
+	s_Request.message_length = RDM_MESSAGE_MINIMUM_SIZE;
+	memcpy(s_Request.destination_uid, responder.GetUID(), RDM_UID_SIZE);
+	memcpy(s_Request.source_uid, "\x12\x34\x00\x00\x00\x01", RDM_UID_SIZE);
+	s_Request.command_class = E120_GET_COMMAND;
+
+	get(handler, E120_SUPPORTED_PARAMETERS);
+
+	const struct TRdmMessage *pResponse = (const struct TRdmMessage *) s_Response;
+
+	if (pResponse->slot16.response_type != E120_RESPONSE_TYPE_ACK) {
+		puts("SUPPORTED_PARAMETERS failed");
+		return 1;
+	}
+
+	s_nPids = pResponse->param_data_length / 2;
+
+	for (uint32_t i = 0; i < s_nPids; i++) {
+		s_Pids[i] = (uint16_t) ((pResponse->param_data[2 * i] << 8) | pResponse->param_data[2 * i + 1]);
+
+		if ((i != 0) && (s_Pids[i - 1] >= s_Pids[i])) {
+			printf("Not sorted at %.4x\n", s_Pids[i]);
+			return 1;
+		}
+	}
+
+	for (uint32_t i = 0; i < s_nPids; i++) {
+		get(handler, s_Pids[i]);
+
+		if (is_unknown_pid()) {
+			printf("PID %.4x not found\n", s_Pids[i]);
+			return 1;
+		}
+	}
+
+	uint32_t nKnown = 0;
+
+	for (uint32_t nPid = 0; nPid <= 0xFFFF; nPid++) {
+		get(handler, (uint16_t) nPid);
+
+		if (!is_unknown_pid()) {
+			nKnown++;
+		}
+
+		if (linear((uint16_t) nPid) != binary((uint16_t) nPid)) {
+			printf("Lookup %.4x differs\n", nPid);
+			return 1;
+		}
+	}
+
+	printf("SUPPORTED_PARAMETERS : %u PID's, sorted, all found\n", s_nPids);
+	printf("PID's with a handler : %u\n", nKnown);
+
+	uint64_t nStart = nanos();
+
+	for (uint32_t i = 0; i < ITERATIONS; i++) {
+		get(handler, s_Pids[i % s_nPids]);
+	}
+
+	printf("HandleData GET       : %.1f ns\n", (double) (nanos() - nStart) / ITERATIONS);
+
+	nStart = nanos();
+
+	for (uint32_t i = 0; i < ITERATIONS; i++) {
+		get(handler, 0x7FF0);
+	}
+
+	printf("HandleData unknown   : %.1f ns\n", (double) (nanos() - nStart) / ITERATIONS);
+
+	printf("Lookup linear        : %.1f ns\n", lookup(linear));
+	printf("Lookup binary        : %.1f ns\n", lookup(binary));
+
+	return 0;
+}
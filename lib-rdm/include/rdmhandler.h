@@ -55,6 +55,13 @@ private:
 	static const pid_definition PID_DEFINITIONS[];
 	static const pid_definition PID_DEFINITIONS_SUB_DEVICES[];
 
+	static uint8_t BuildSupportedParameters(const pid_definition *pPidDefinitions, uint32_t nTableSize, uint8_t *pSupportedParameters);
+
+	static uint8_t s_SupportedParameters[];
+	static uint8_t s_SupportedParametersSubDevices[];
+	static uint8_t s_nSupportedParametersLength;
+	static uint8_t s_nSupportedParametersSubDevicesLength;
+
 	// Get
 	void GetQueuedMessage(uint16_t nSubDevice);
 	void GetSupportedParameters(uint16_t nSubDevice);
@@ -69,17 +69,6 @@ enum {
 	NO_DEFAULT_ROUTE = 0x00000000
 };
 
-RDMHandler::RDMHandler(bool bIsRdm):
-	m_bIsRDM(bIsRdm),
-	m_IsMuted(false),
-	m_pRdmDataIn(0),
-	m_pRdmDataOut(0)
-{
-}
-
-RDMHandler::~RDMHandler(void) {
-}
-
 void RDMHandler::HandleString(const char *pString, uint32_t nLength) {
 	struct TRdmMessage *RdmMessage = (struct TRdmMessage*) m_pRdmDataOut;
 
@@ -159,6 +148,10 @@ void RDMHandler::RespondMessageNack(uint16_t nReason) {
 	CreateRespondMessage(E120_RESPONSE_TYPE_NACK_REASON, nReason);
 }
 
+/*
+ * The PID tables must be sorted by pid, Handlers() does a binary search.
+ */
+
 const RDMHandler::pid_definition RDMHandler::PID_DEFINITIONS[] {
 //  {E120_QUEUED_MESSAGE,              	&RDMHandler::GetQueuedMessage,           	0,                   				1, true , false},
 	{E120_SUPPORTED_PARAMETERS,        	&RDMHandler::GetSupportedParameters,      	0,             						0, false, true , false},
@@ -183,10 +176,6 @@ const RDMHandler::pid_definition RDMHandler::PID_DEFINITIONS[] {
 	{E120_RECORD_SENSORS,			   	0,											&RDMHandler::SetRecordSensors,	 	0, true , true , false},
 	{E120_DEVICE_HOURS,                	&RDMHandler::GetDeviceHours,    	      	&RDMHandler::SetDeviceHours,       	0, true , true , false},
 	{E120_REAL_TIME_CLOCK,		       	&RDMHandler::GetRealTimeClock,  			&RDMHandler::SetRealTimeClock,    	0, true , true , false},
-	{E120_IDENTIFY_DEVICE,		       	&RDMHandler::GetIdentifyDevice,		    	&RDMHandler::SetIdentifyDevice,    	0, false, true , true },
-	{E120_RESET_DEVICE,			    	0,                                			&RDMHandler::SetResetDevice,       	0, true , true , true },
-	{E120_POWER_STATE,					&RDMHandler::GetPowerState,					&RDMHandler::SetPowerState,			0, true , true , false},
-	{E137_1_IDENTIFY_MODE,			   	&RDMHandler::GetIdentifyMode,				&RDMHandler::SetIdentifyMode,		0, true , true , false},
 	{E137_2_LIST_INTERFACES,			&RDMHandler::GetInterfaceList,				0,									0, false, false, true },
 	{E137_2_INTERFACE_LABEL,			&RDMHandler::GetInterfaceName,				0,									4, false, false, true },
 	{E137_2_INTERFACE_HARDWARE_ADDRESS_TYPE1,&RDMHandler::GetHardwareAddress,		0,									4, false, false, true },
@@ -198,7 +187,11 @@ const RDMHandler::pid_definition RDMHandler::PID_DEFINITIONS[] {
 	{E137_2_IPV4_DEFAULT_ROUTE, 		&RDMHandler::GetDefaultRoute,				0,									0, false, false, true },
 	{E137_2_DNS_IPV4_NAME_SERVER,		&RDMHandler::GetNameServers,				0,									1, false, false, true },
 	{E137_2_DNS_HOSTNAME,               &RDMHandler::GetHostName,                   &RDMHandler::SetHostName,           0, false, false, true },
-	{E137_2_DNS_DOMAIN_NAME,			&RDMHandler::GetDomainName,					0,									0, false, false, true }
+	{E137_2_DNS_DOMAIN_NAME,			&RDMHandler::GetDomainName,					0,									0, false, false, true },
+	{E120_IDENTIFY_DEVICE,		       	&RDMHandler::GetIdentifyDevice,		    	&RDMHandler::SetIdentifyDevice,    	0, false, true , true },
+	{E120_RESET_DEVICE,			    	0,                                			&RDMHandler::SetResetDevice,       	0, true , true , true },
+	{E120_POWER_STATE,					&RDMHandler::GetPowerState,					&RDMHandler::SetPowerState,			0, true , true , false},
+	{E137_1_IDENTIFY_MODE,			   	&RDMHandler::GetIdentifyMode,				&RDMHandler::SetIdentifyMode,		0, true , true , false}
 };
 
 const RDMHandler::pid_definition RDMHandler::PID_DEFINITIONS_SUB_DEVICES[] {
@@ -212,6 +205,47 @@ const RDMHandler::pid_definition RDMHandler::PID_DEFINITIONS_SUB_DEVICES[] {
 	{E120_IDENTIFY_DEVICE,		       &RDMHandler::GetIdentifyDevice,		    	&RDMHandler::SetIdentifyDevice,		0, true, true ,  false}
 };
 
+#define PID_DEFINITIONS_SIZE				(sizeof(RDMHandler::PID_DEFINITIONS) / sizeof(RDMHandler::PID_DEFINITIONS[0]))
+#define PID_DEFINITIONS_SUB_DEVICES_SIZE	(sizeof(RDMHandler::PID_DEFINITIONS_SUB_DEVICES) / sizeof(RDMHandler::PID_DEFINITIONS_SUB_DEVICES[0]))
+
+/*
+ * The SUPPORTED_PARAMETERS payloads do not change at runtime, they are built once
+ */
+uint8_t RDMHandler::s_SupportedParameters[2 * PID_DEFINITIONS_SIZE];
+uint8_t RDMHandler::s_SupportedParametersSubDevices[2 * PID_DEFINITIONS_SUB_DEVICES_SIZE];
+uint8_t RDMHandler::s_nSupportedParametersLength;
+uint8_t RDMHandler::s_nSupportedParametersSubDevicesLength;
+
+uint8_t RDMHandler::BuildSupportedParameters(const pid_definition *pPidDefinitions, uint32_t nTableSize, uint8_t *pSupportedParameters) {
+	uint32_t nLength = 0;
+
+	for (uint32_t i = 0; i < nTableSize; i++) {
+		assert((i == 0) || (pPidDefinitions[i - 1].pid < pPidDefinitions[i].pid));
+
+		if (pPidDefinitions[i].bIncludeInSupportedParams) {
+			pSupportedParameters[nLength++] = (uint8_t) (pPidDefinitions[i].pid >> 8);
+			pSupportedParameters[nLength++] = (uint8_t) pPidDefinitions[i].pid;
+		}
+	}
+
+	return (uint8_t) nLength;
+}
+
+RDMHandler::RDMHandler(bool bIsRdm):
+	m_bIsRDM(bIsRdm),
+	m_IsMuted(false),
+	m_pRdmDataIn(0),
+	m_pRdmDataOut(0)
+{
+	if (s_nSupportedParametersLength == 0) {
+		s_nSupportedParametersLength = BuildSupportedParameters(PID_DEFINITIONS, PID_DEFINITIONS_SIZE, s_SupportedParameters);
+		s_nSupportedParametersSubDevicesLength = BuildSupportedParameters(PID_DEFINITIONS_SUB_DEVICES, PID_DEFINITIONS_SUB_DEVICES_SIZE, s_SupportedParametersSubDevices);
+	}
+}
+
+RDMHandler::~RDMHandler(void) {
+}
+
 /**
  *
  * @param pRdmDataIn RDM with no Start Code
@@ -368,14 +402,25 @@ void RDMHandler::Handlers(bool bIsBroadcast, uint8_t nCommandClass, uint16_t nPa
 		return;
 	}
 
-	for (uint32_t i = 0; i < sizeof(PID_DEFINITIONS) / sizeof(PID_DEFINITIONS[0]); ++i) {
-		if (PID_DEFINITIONS[i].pid == nParamId) {
-			pid_handler = &PID_DEFINITIONS[i];
-			bRDM = PID_DEFINITIONS[i].bRDM;
-			bRDMNet = PID_DEFINITIONS[i].bRDMNet;
+	uint32_t nLower = 0;
+	uint32_t nUpper = PID_DEFINITIONS_SIZE;
+
+	while (nLower < nUpper) {
+		const uint32_t nMiddle = (nLower + nUpper) / 2;
+
+		if (PID_DEFINITIONS[nMiddle].pid < nParamId) {
+			nLower = nMiddle + 1;
+		} else {
+			nUpper = nMiddle;
 		}
 	}
 
+	if ((nLower < PID_DEFINITIONS_SIZE) && (PID_DEFINITIONS[nLower].pid == nParamId)) {
+		pid_handler = &PID_DEFINITIONS[nLower];
+		bRDM = pid_handler->bRDM;
+		bRDMNet = pid_handler->bRDMNet;
+	}
+
 	if (!pid_handler) {
 		RespondMessageNack(E120_NR_UNKNOWN_PID);
 		DEBUG1_EXIT
@@ -440,36 +485,14 @@ void RDMHandler::GetQueuedMessage(/*@unused@*/uint16_t nSubDevice) {
 }
 
 void RDMHandler::GetSupportedParameters(uint16_t nSubDevice) {
-	uint8_t nSupportedParams = 0;
-	pid_definition *pPidDefinitions;
-	uint32_t nTableSize = 0;
+	struct TRdmMessage *pRdmDataOut = (struct TRdmMessage *)m_pRdmDataOut;
 
 	if (nSubDevice != 0) {
-		pPidDefinitions = (pid_definition *)&PID_DEFINITIONS_SUB_DEVICES[0];
-		nTableSize = (int) (sizeof(PID_DEFINITIONS_SUB_DEVICES) / sizeof(PID_DEFINITIONS_SUB_DEVICES[0]));
+		pRdmDataOut->param_data_length = s_nSupportedParametersSubDevicesLength;
+		memcpy(pRdmDataOut->param_data, s_SupportedParametersSubDevices, s_nSupportedParametersSubDevicesLength);
 	} else {
-		pPidDefinitions = (pid_definition *)&PID_DEFINITIONS[0];
-		nTableSize = (int) (sizeof(PID_DEFINITIONS) / sizeof(PID_DEFINITIONS[0]));
-	}
-
-	for (uint32_t i = 0; i < nTableSize; i++) {
-		if (pPidDefinitions[i].bIncludeInSupportedParams) {
-			nSupportedParams++;
-		}
-	}
-
-	struct TRdmMessage *pRdmDataOut = (struct TRdmMessage *)m_pRdmDataOut;
-
-	pRdmDataOut->param_data_length = (2 * nSupportedParams);
-
-	uint32_t j = 0;
-
-	for (uint32_t i = 0; i < nTableSize; i++) {
-		if (pPidDefinitions[i].bIncludeInSupportedParams) {
-			pRdmDataOut->param_data[j + j] = (uint8_t) (pPidDefinitions[i].pid >> 8);
-			pRdmDataOut->param_data[j + j + 1] = (uint8_t) pPidDefinitions[i].pid;
-			j++;
-		}
+		pRdmDataOut->param_data_length = s_nSupportedParametersLength;
+		memcpy(pRdmDataOut->param_data, s_SupportedParameters, s_nSupportedParametersLength);
 	}
 
 	RespondMessageAck();
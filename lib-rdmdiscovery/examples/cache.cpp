@@ -0,0 +1,234 @@
+/**
+ * @file cache.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * RDMResponseCache with 500 fixtures and 16 cached PID's on a port.
+ * Every hit is compared with the response the fixture would have sent.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "rdm.h"
+#include "rdm_e120.h"
+#include "rdmresponsecache.h"
+
+#include "hardware.h"
+
+#define FIXTURES	500
+#define PORTS		4
+
+uint32_t g_nMicros = 5000;
+
+struct TPid {
+	uint16_t nPid;
+	uint8_t nPdl;	///< Of the response, a typical fixture
+};
+
+static const struct TPid s_Pids[] = {
+		{ E120_DEVICE_INFO, 19 },
+		{ E120_DEVICE_MODEL_DESCRIPTION, 20 },
+		{ E120_MANUFACTURER_LABEL, 12 },
+		{ E120_DEVICE_LABEL, 16 },
+		{ E120_SOFTWARE_VERSION_LABEL, 8 },
+		{ E120_BOOT_SOFTWARE_VERSION_ID, 4 },
+		{ E120_BOOT_SOFTWARE_VERSION_LABEL, 8 },
+		{ E120_SUPPORTED_PARAMETERS, 40 },
+		{ E120_PARAMETER_DESCRIPTION, 52 },
+		{ E120_PRODUCT_DETAIL_ID_LIST, 6 },
+		{ E120_LANGUAGE_CAPABILITIES, 2 },
+		{ E120_DMX_PERSONALITY_DESCRIPTION, 23 },
+		{ E120_SLOT_INFO, 80 },		///< 16 slots
+		{ E120_SLOT_DESCRIPTION, 14 },
+		{ E120_DEFAULT_SLOT_VALUE, 48 },
+		{ E120_SENSOR_DEFINITION, 25 }
+};
+
+#define PIDS	(sizeof(s_Pids) / sizeof(s_Pids[0]))
+
+static uint32_t s_nTransaction;
+static uint32_t s_Generation[FIXTURES];	///< Changes the responses, a SET
+
+static void request(struct TRdmMessageNoSc *pRequest, uint32_t nFixture, uint16_t nPid, uint8_t nCommandClass) {
+	memset(pRequest, 0, sizeof(struct TRdmMessageNoSc));
+
+	pRequest->sub_start_code = E120_SC_SUB_MESSAGE;
+	pRequest->message_length = RDM_MESSAGE_MINIMUM_SIZE;
+	pRequest->destination_uid[0] = 0x7F;
+	pRequest->destination_uid[1] = 0xF0;
+	pRequest->destination_uid[4] = (uint8_t) (nFixture >> 8);
+	pRequest->destination_uid[5] = (uint8_t) nFixture;
+	memcpy(pRequest->source_uid, "\x12\x34\x00\x00\x00\x01", RDM_UID_SIZE);
+	pRequest->transaction_number = (uint8_t) ++s_nTransaction;
+	pRequest->command_class = nCommandClass;
+	pRequest->param_id[0] = (uint8_t) (nPid >> 8);
+	pRequest->param_id[1] = (uint8_t) nPid;
+}
+
+/**
+ * The fixture
+ */
+static void response(uint8_t *pBuffer, const struct TRdmMessageNoSc *pRequest, uint8_t nPdl) {
+	struct TRdmMessage *pResponse = (struct TRdmMessage *) pBuffer;
+	const uint32_t nFixture = (pRequest->destination_uid[4] << 8) | pRequest->destination_uid[5];
+	const uint16_t nPid = (pRequest->param_id[0] << 8) | pRequest->param_id[1];
+
+	memset(pResponse, 0, sizeof(struct TRdmMessage));
+
+	pResponse->start_code = E120_SC_RDM;
+	pResponse->sub_start_code = E120_SC_SUB_MESSAGE;
+	memcpy(pResponse->destination_uid, pRequest->source_uid, RDM_UID_SIZE);
+	memcpy(pResponse->source_uid, pRequest->destination_uid, RDM_UID_SIZE);
+	pResponse->transaction_number = pRequest->transaction_number;
+	pResponse->slot16.response_type = E120_RESPONSE_TYPE_ACK;
+	pResponse->command_class = E120_GET_COMMAND_RESPONSE;
+	pResponse->param_id[0] = pRequest->param_id[0];
+	pResponse->param_id[1] = pRequest->param_id[1];
+	pResponse->param_data_length = nPdl;
+
+	for (uint32_t i = 0; i < pResponse->param_data_length; i++) {
+		pResponse->param_data[i] = (uint8_t) (nFixture * 7 + nPid + i + s_Generation[nFixture]);
+	}
+
+	pResponse->message_length = RDM_MESSAGE_MINIMUM_SIZE + pResponse->param_data_length;
+
+	uint16_t nChecksum = 0;
+	uint32_t nIndex;
+
+	for (nIndex = 0; nIndex < pResponse->message_length; nIndex++) {
+		nChecksum += pBuffer[nIndex];
+	}
+
+	pBuffer[nIndex++] = (uint8_t) (nChecksum >> 8);
+	pBuffer[nIndex] = (uint8_t) (nChecksum & 0xFF);
+}
+
+/**
+ * Returns the number of hits, -1 when a hit is not the response of the fixture
+ */
+static int get_all(RDMResponseCache& cache, uint8_t nPort, bool bPut) {
+	struct TRdmMessageNoSc Request;
+	uint8_t Expected[sizeof(struct TRdmMessage) + RDM_MESSAGE_CHECKSUM_SIZE];
+	int nHits = 0;
+
+	for (uint32_t nFixture = 0; nFixture < FIXTURES; nFixture++) {
+		for (uint32_t i = 0; i < PIDS; i++) {
+			request(&Request, nFixture, s_Pids[i].nPid, E120_GET_COMMAND);
+			response(Expected, &Request, s_Pids[i].nPdl);
+
+			const uint8_t *pCached = cache.Get(nPort, (const uint8_t *) &Request);
+
+			if (pCached != 0) {
+				if (memcmp(pCached, Expected, Expected[2] + RDM_MESSAGE_CHECKSUM_SIZE) != 0) {
+					printf("Fixture %u PID %.4x: wrong response\n", nFixture, s_Pids[i].nPid);
+					return -1;
+				}
+				nHits++;
+			} else if (bPut) {
+				cache.Put(nPort, (const uint8_t *) &Request, Expected);
+			}
+		}
+	}
+
+	return nHits;
+}
+
+static int s_nResult;
+
+static void check(const char *pText, int nHits, int nExpected) {
+	const bool isOk = (nHits == nExpected);
+
+	printf("%-28s : %5d/%d %s\n", pText, nHits, FIXTURES * (int) PIDS, isOk ? "OK" : "FAILED");
+
+	if (!isOk) {
+		s_nResult = 1;
+	}
+}
+
+int main(int argc, char **argv) {
+	const int nAll = FIXTURES * PIDS;
+	RDMResponseCache cache(PORTS);
+	struct TRdmMessageNoSc Request;
+
+	cache.SetUidCount(0, FIXTURES);
+	cache.SetUidCount(1, FIXTURES);
+
+	check("First pass", get_all(cache, 0, true), 0);
+	check("Second pass", get_all(cache, 0, false), nAll);
+	check("Other port", get_all(cache, 1, false), 0);
+
+	// A SET to one fixture changes its responses
+	request(&Request, 5, E120_DEVICE_LABEL, E120_SET_COMMAND);
+	cache.Invalidate(0, Request.destination_uid);
+	check("SET one fixture", get_all(cache, 0, false), nAll - (int) PIDS);
+
+	s_Generation[5]++;
+	check("SET one fixture, refill", get_all(cache, 0, true), nAll - (int) PIDS);
+	check("SET one fixture, hit", get_all(cache, 0, false), nAll);
+
+	// Background discovery: the UID's added or removed only
+	get_all(cache, 0, true);
+	for (uint32_t nFixture = 10; nFixture < 13; nFixture++) {
+		request(&Request, nFixture, 0, E120_GET_COMMAND);
+		cache.Invalidate(0, Request.destination_uid);
+	}
+	check("3 UID's changed", get_all(cache, 0, false), nAll - 3 * (int) PIDS);
+
+	// Full discovery
+	get_all(cache, 0, true);
+	cache.Invalidate(0);
+	check("Port invalidated", get_all(cache, 0, false), 0);
+	check("Port refilled", (get_all(cache, 0, true), get_all(cache, 0, false)), nAll);
+
+	// Manufacturer broadcast
+	request(&Request, 0, 0, E120_SET_COMMAND);
+	memset(&Request.destination_uid[2], 0xFF, 4);
+	cache.Invalidate(0, Request.destination_uid);
+	check("Manufacturer broadcast", get_all(cache, 0, false), 0);
+
+	// The data ring is overwritten many times, the hits are still the responses of the fixtures
+	for (uint32_t i = 0; i < 20; i++) {
+		for (uint32_t nFixture = 0; nFixture < FIXTURES; nFixture++) {
+			s_Generation[nFixture]++;
+		}
+		cache.Invalidate(0, Request.destination_uid);
+		get_all(cache, 0, true);
+	}
+	check("Data ring wrapped", get_all(cache, 0, false), nAll);
+
+	g_nMicros += (RDM_RESPONSE_CACHE_MAX_AGE + 1) * 1000;
+	check("Aged", get_all(cache, 0, false), 0);
+
+	cache.Print();
+
+	// A smaller TOD empties the port, the memory is allocated again with the first response cached
+	cache.SetUidCount(0, FIXTURES / 10);
+	check("TOD smaller", get_all(cache, 0, false), 0);
+	get_all(cache, 0, true);
+	printf("Memory for %d UID's: %u bytes\n", FIXTURES / 10, (unsigned) cache.GetMemorySize(0));
+
+	return s_nResult;
+}
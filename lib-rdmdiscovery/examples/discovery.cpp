@@ -0,0 +1,329 @@
+/**
+ * @file discovery.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * RDMDiscovery against a simulated bus of responders. The wire time is added
+ * to the simulated clock, so the results are the time on a real 250 kbit/s line.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rdm.h"
+#include "rdm_e120.h"
+#include "rdmmessage.h"
+#include "rdmdiscovery.h"
+
+#include "hardware.h"
+
+#define DEVICES_MAX		512
+#define BIT_MICROS		4		///< 250 kbit/s
+#define SLOT_MICROS		(11 * BIT_MICROS)
+#define BREAK_MAB		(176 + 12)
+#define TURNAROUND		200		///< Responder packet turnaround time
+
+uint32_t g_nMicros;
+
+static uint64_t s_Uids[DEVICES_MAX];
+static bool s_IsMuted[DEVICES_MAX];
+static uint32_t s_nDevices;
+
+static uint8_t s_Response[64];
+static bool s_bHasResponse;
+static uint32_t s_nResponseMicros;
+static uint32_t s_nPackets;
+
+static uint64_t to_uint64(const uint8_t *pUid) {
+	uint64_t nUid = 0;
+
+	for (uint32_t i = 0; i < RDM_UID_SIZE; i++) {
+		nUid = (nUid << 8) | pUid[i];
+	}
+
+	return nUid;
+}
+
+static void to_uid(uint64_t nUid, uint8_t *pUid) {
+	for (int i = RDM_UID_SIZE - 1; i >= 0; i--) {
+		pUid[i] = nUid & 0xFF;
+		nUid >>= 8;
+	}
+}
+
+static void respond(uint32_t nSlots) {
+	s_bHasResponse = true;
+	s_nResponseMicros = g_nMicros + TURNAROUND + nSlots * SLOT_MICROS;
+}
+
+/*
+ * The responders
+ */
+
+Rdm::Rdm(void) {
+}
+
+Rdm::~Rdm(void) {
+}
+
+void Rdm::Send(__attribute__((unused)) uint8_t nPort, struct TRdmMessage *pRdmCommand) {
+	s_nPackets++;
+	g_nMicros += BREAK_MAB + (pRdmCommand->message_length + 2) * SLOT_MICROS;
+	s_bHasResponse = false;
+
+	const uint16_t nPid = (pRdmCommand->param_id[0] << 8) | pRdmCommand->param_id[1];
+
+	if (nPid == E120_DISC_UN_MUTE) {
+		memset(s_IsMuted, 0, sizeof(s_IsMuted));
+		return;
+	}
+
+	if (nPid == E120_DISC_MUTE) {
+		const uint64_t nUid = to_uint64(pRdmCommand->destination_uid);
+
+		for (uint32_t i = 0; i < s_nDevices; i++) {
+			if (s_Uids[i] == nUid) {
+				s_IsMuted[i] = true;
+
+				struct TRdmMessage *pResponse = reinterpret_cast<struct TRdmMessage *>(s_Response);
+				memset(s_Response, 0, sizeof(s_Response));
+				pResponse->start_code = E120_SC_RDM;
+				pResponse->command_class = E120_DISCOVERY_COMMAND_RESPONSE;
+				to_uid(nUid, pResponse->source_uid);
+
+				respond(28);
+				break;
+			}
+		}
+
+		return;
+	}
+
+	if (nPid == E120_DISC_UNIQUE_BRANCH) {
+		const uint64_t nLowerBound = to_uint64(pRdmCommand->param_data);
+		const uint64_t nUpperBound = to_uint64(pRdmCommand->param_data + RDM_UID_SIZE);
+
+		uint32_t nCount = 0;
+		uint64_t nUid = 0;
+
+		for (uint32_t i = 0; i < s_nDevices; i++) {
+			if (!s_IsMuted[i] && (s_Uids[i] >= nLowerBound) && (s_Uids[i] <= nUpperBound)) {
+				nCount++;
+				nUid = s_Uids[i];
+			}
+		}
+
+		if (nCount == 0) {
+			return;
+		}
+
+		respond(24);
+
+		if (nCount > 1) {
+			// Collision
+			memset(s_Response, 0x5A, sizeof(s_Response));
+			s_Response[0] = 0xFE;
+			return;
+		}
+
+		uint8_t Uid[RDM_UID_SIZE];
+		to_uid(nUid, Uid);
+
+		memset(s_Response, 0xFE, 7);
+		s_Response[7] = 0xAA;
+
+		uint16_t nChecksum = 0;
+
+		for (uint32_t i = 0; i < RDM_UID_SIZE; i++) {
+			s_Response[8 + 2 * i] = Uid[i] | 0xAA;
+			s_Response[9 + 2 * i] = Uid[i] | 0x55;
+			nChecksum += s_Response[8 + 2 * i] + s_Response[9 + 2 * i];
+		}
+
+		s_Response[20] = (nChecksum >> 8) | 0xAA;
+		s_Response[21] = (nChecksum >> 8) | 0x55;
+		s_Response[22] = (nChecksum & 0xFF) | 0xAA;
+		s_Response[23] = (nChecksum & 0xFF) | 0x55;
+	}
+}
+
+const uint8_t *Rdm::Receive(__attribute__((unused)) uint8_t nPort) {
+	if (s_bHasResponse && ((int32_t) (g_nMicros - s_nResponseMicros) >= 0)) {
+		s_bHasResponse = false;
+		return s_Response;
+	}
+
+	return 0;
+}
+
+RDMMessage::RDMMessage(void) {
+	m_pRdmCommand = new struct TRdmMessage;
+	memset(m_pRdmCommand, 0, sizeof(struct TRdmMessage));
+
+	m_pRdmCommand->start_code = E120_SC_RDM;
+	m_pRdmCommand->sub_start_code = E120_SC_SUB_MESSAGE;
+	m_pRdmCommand->message_length = RDM_MESSAGE_MINIMUM_SIZE;
+}
+
+RDMMessage::~RDMMessage(void) {
+	delete m_pRdmCommand;
+}
+
+void RDMMessage::SetSrcUid(const uint8_t *pUid) {
+	memcpy(m_pRdmCommand->source_uid, pUid, RDM_UID_SIZE);
+}
+
+void RDMMessage::SetDstUid(const uint8_t *pUid) {
+	memcpy(m_pRdmCommand->destination_uid, pUid, RDM_UID_SIZE);
+}
+
+void RDMMessage::SetCc(uint8_t nCc) {
+	m_pRdmCommand->command_class = nCc;
+}
+
+void RDMMessage::SetPid(uint16_t nPid) {
+	m_pRdmCommand->param_id[0] = nPid >> 8;
+	m_pRdmCommand->param_id[1] = nPid & 0xFF;
+}
+
+void RDMMessage::SetPd(const uint8_t *pParamData, uint8_t nLength) {
+	memcpy(m_pRdmCommand->param_data, pParamData, nLength);
+	m_pRdmCommand->param_data_length = nLength;
+	m_pRdmCommand->message_length = RDM_MESSAGE_MINIMUM_SIZE + nLength;
+}
+
+void RDMMessage::Send(uint8_t nPort) {
+	Rdm::Send(nPort, m_pRdmCommand);
+}
+
+/*
+ * The controller
+ */
+
+static bool is_found(RDMDiscovery& discovery) {
+	uint32_t nFound = 0;
+
+	for (uint32_t i = 0; i < s_nDevices; i++) {
+		uint8_t Uid[RDM_UID_SIZE];
+		to_uid(s_Uids[i], Uid);
+
+		if (discovery.Exist(Uid)) {
+			nFound++;
+		}
+	}
+
+	return nFound == s_nDevices;
+}
+
+static void add_devices(uint32_t nCount) {
+	while ((s_nDevices < nCount) && (s_nDevices < DEVICES_MAX)) {
+		const uint64_t nUid = ((uint64_t) (rand() & 0xFFFF) << 32) | (uint32_t) rand();
+		uint32_t i;
+
+		for (i = 0; i < s_nDevices; i++) {
+			if (s_Uids[i] == nUid) {
+				break;
+			}
+		}
+
+		if (i == s_nDevices) {
+			s_Uids[s_nDevices++] = nUid;
+		}
+	}
+}
+
+static int run(RDMDiscovery& discovery, bool bIncremental, bool bInterleaveDmx, const char *pText) {
+	memset(s_IsMuted, 0, sizeof(s_IsMuted));
+	g_nMicros = 0;
+	s_nPackets = 0;
+
+	uint32_t nStepMax = 0;
+
+	discovery.Start(bIncremental);
+
+	uint32_t nPrevious = g_nMicros;
+
+	while (discovery.Run(bInterleaveDmx)) {
+		const uint32_t nStep = g_nMicros - nPrevious;
+
+		if (nStep > nStepMax) {
+			nStepMax = nStep;
+		}
+
+		if (bInterleaveDmx) {
+			g_nMicros += 100;	// The main loop
+		}
+
+		nPrevious = g_nMicros;
+	}
+
+	printf("%-12s devices=%3u found=%3u packets=%5u time=%8.1f ms longest step=%u us",
+			pText, s_nDevices, discovery.GetUidCount(), s_nPackets, (float) g_nMicros / 1000, nStepMax);
+
+	bool isFound = is_found(discovery);
+
+	if (bIncremental) {
+		printf(" +%u -%u", discovery.GetAdded(), discovery.GetRemoved());
+
+		// The UID's for the response cache invalidation
+		if (!discovery.IsChangedUidsComplete() || (discovery.GetChangedUidCount() != (discovery.GetAdded() + discovery.GetRemoved()))) {
+			printf(" changed UID's %u", discovery.GetChangedUidCount());
+			isFound = false;
+		}
+	}
+
+	puts(isFound ? "" : " MISSING");
+
+	return isFound ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+	const uint8_t Uid[RDM_UID_SIZE] = {0x7F, 0xF0, 0x00, 0x00, 0x00, 0x01};
+	const uint32_t Counts[] = {1, 50, 500};
+	int nResult = 0;
+
+	srand(1);
+
+	for (uint32_t i = 0; i < sizeof(Counts) / sizeof(Counts[0]); i++) {
+		s_nDevices = 0;
+		add_devices(Counts[i]);
+
+		RDMDiscovery discovery;
+		discovery.SetUid(Uid);
+
+		nResult |= run(discovery, false, false, "full");
+		nResult |= run(discovery, false, true, "interleaved");
+
+		// One device removed, two added
+		s_nDevices--;
+		s_Uids[0] = s_Uids[s_nDevices];
+		add_devices(s_nDevices + 2);
+
+		nResult |= run(discovery, true, false, "incremental");
+	}
+
+	return nResult;
+}
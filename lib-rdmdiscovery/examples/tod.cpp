@@ -0,0 +1,153 @@
+/**
+ * @file tod.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/*
+ * RDMTod against std::set: random AddUid/Delete, then the contents, the order
+ * and the change tracking are compared.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <set>
+
+#include "rdmtod.h"
+
+#define OPERATIONS		200000
+#define UID_RANGE		3000	///< Half of it is in the table on average, > TOD_TABLE_SIZE, so the table gets full
+#define CHECK_INTERVAL	1000
+
+static void to_uid(uint64_t nUid, uint8_t *pUid) {
+	for (int i = RDM_UID_SIZE - 1; i >= 0; i--) {
+		pUid[i] = nUid & 0xFF;
+		nUid >>= 8;
+	}
+}
+
+static uint64_t to_uint64(const uint8_t *pUid) {
+	uint64_t nUid = 0;
+
+	for (uint32_t i = 0; i < RDM_UID_SIZE; i++) {
+		nUid = (nUid << 8) | pUid[i];
+	}
+
+	return nUid;
+}
+
+static uint8_t s_Table[TOD_TABLE_SIZE * RDM_UID_SIZE];
+static uint8_t s_TablePrevious[TOD_TABLE_SIZE * RDM_UID_SIZE];
+
+static bool check(const RDMTod& tod, const std::set<uint64_t>& reference) {
+	const uint16_t nCount = tod.Copy(s_Table, 0, TOD_TABLE_SIZE);
+
+	if (nCount != reference.size()) {
+		printf("Count %u, expected %u\n", nCount, (unsigned) reference.size());
+		return false;
+	}
+
+	uint32_t nIndex = 0;
+
+	for (std::set<uint64_t>::const_iterator it = reference.begin(); it != reference.end(); ++it, nIndex++) {
+		if (to_uint64(&s_Table[nIndex * RDM_UID_SIZE]) != *it) {
+			printf("Order at index %u\n", nIndex);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int main(int argc, char **argv) {
+	RDMTod tod;
+	std::set<uint64_t> reference;
+	uint16_t nPrevious = 0;
+	uint32_t nAdded = 0;
+	uint32_t nRemoved = 0;
+
+	srand(3);
+
+	tod.ClearChanged();
+
+	for (uint32_t n = 0; n < OPERATIONS; n++) {
+		const uint64_t nUid = rand() % UID_RANGE;
+		uint8_t Uid[RDM_UID_SIZE];
+		to_uid(nUid, Uid);
+
+		if (rand() & 1) {
+			const bool isAdded = tod.AddUid(Uid);
+			const bool isExpected = (reference.size() < TOD_TABLE_SIZE) && reference.insert(nUid).second;
+
+			if (isAdded != isExpected) {
+				printf("AddUid %u: %d, expected %d\n", (unsigned) nUid, isAdded, isExpected);
+				return 1;
+			}
+
+			nAdded += isAdded;
+		} else {
+			const bool isDeleted = tod.Delete(Uid);
+			const bool isExpected = reference.erase(nUid) != 0;
+
+			if (isDeleted != isExpected) {
+				printf("Delete %u: %d, expected %d\n", (unsigned) nUid, isDeleted, isExpected);
+				return 1;
+			}
+
+			nRemoved += isDeleted;
+		}
+
+		if (((n + 1) % CHECK_INTERVAL) != 0) {
+			continue;
+		}
+
+		if (!check(tod, reference)) {
+			return 1;
+		}
+
+		if ((tod.GetAdded() != nAdded) || (tod.GetRemoved() != nRemoved)) {
+			printf("Added %u/%u, removed %u/%u\n", tod.GetAdded(), nAdded, tod.GetRemoved(), nRemoved);
+			return 1;
+		}
+
+		// The entries before the first changed index are untouched
+		const uint16_t nUnchanged = tod.IsChanged() ? tod.GetChangedFirst() : tod.GetUidCount();
+
+		if ((nUnchanged > nPrevious) || (memcmp(s_Table, s_TablePrevious, nUnchanged * RDM_UID_SIZE) != 0)) {
+			printf("Changed first %u\n", nUnchanged);
+			return 1;
+		}
+
+		memcpy(s_TablePrevious, s_Table, sizeof(s_Table));
+		nPrevious = tod.GetUidCount();
+		nAdded = 0;
+		nRemoved = 0;
+
+		tod.ClearChanged();
+	}
+
+	printf("TOD %u entries, %u operations: OK\n", tod.GetUidCount(), OPERATIONS);
+
+	return 0;
+}
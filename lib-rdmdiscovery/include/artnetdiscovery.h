@@ -8,6 +8,7 @@
 
 #include "rdmdiscovery.h"
 #include "rdmdevicecontroller.h"
+#include "rdmresponsecache.h"
 
 #include "dmx_uarts.h"
 #include "rdm.h"
@@ -20,15 +21,23 @@ public:
 	void Print(void);
 
 	void Full(uint8_t nPort = 0);
-	uint8_t GetUidCount(uint8_t nPort = 0);
-	void Copy(uint8_t nPort, uint8_t *pTod);
+	uint16_t GetUidCount(uint8_t nPort = 0);
+	uint16_t Copy(uint8_t nPort, uint8_t *pTod, uint16_t nIndex, uint16_t nCount);
 	const uint8_t *Handler(uint8_t nPort, const uint8_t *pRdmData);
 
+	void DiscoveryStart(uint8_t nPort, bool bIncremental);
+	bool DiscoveryRun(uint8_t nPort, bool bInterleaveDmx, bool &bIsLineRequired);
+	bool IsTodChanged(uint8_t nPort, uint16_t &nChangedFirst);
+
 	void DumpTod(uint8_t nPort = 0);
 
+private:
+	void InvalidateChanged(uint8_t nPort);
+
 private:
 	RDMDiscovery *m_Discovery[DMX_MAX_UARTS];
 	struct TRdmMessage *m_pRdmCommand;
+	RDMResponseCache m_ResponseCache;
 };
 
 #endif /* ARTNETDISCOVERY_H_ */
@@ -34,6 +34,32 @@
 #include "rdmmessage.h"
 #include "rdmtod.h"
 
+#define RDM_DISCOVERY_UID_MAX					0xfffffffffffe		///< 0xffffffffffff is the broadcast UID
+#define RDM_DISCOVERY_STACK_SIZE				49					///< One branch per bit of the 48-bit UID, plus the full range
+
+///< E1.20 Table 3-2 Controller Packet Timing
+#define RDM_DISCOVERY_RESPONSE_TIME_OUT			2800	///< Lost response
+#define RDM_DISCOVERY_DUB_TIME_OUT				5800	///< DISC_UNIQUE_BRANCH to any packet
+
+#define RDM_DISCOVERY_UNMUTE_COUNT				3
+
+///< Interleaving with DMX output
+#define RDM_DISCOVERY_SLICE_MICROS				10000	///< Maximum time the line is used for discovery in one go
+#define RDM_DISCOVERY_YIELD_MICROS				25000	///< Minimum time the line is given back to DMX, > 1 frame of 512 slots
+
+enum TRdmDiscoveryState {
+	RDM_DISCOVERY_STATE_IDLE,
+	RDM_DISCOVERY_STATE_UNMUTE,
+	RDM_DISCOVERY_STATE_MUTE_KNOWN,
+	RDM_DISCOVERY_STATE_UNIQUE_BRANCH,
+	RDM_DISCOVERY_STATE_MUTE
+};
+
+struct TRdmDiscoveryBranch {
+	uint64_t nLowerBound;
+	uint64_t nUpperBound;
+};
+
 class RDMDiscovery: public RDMTod {
 public:
 	RDMDiscovery(uint8_t nPort = 0);
@@ -42,12 +68,51 @@ public:
 	void SetUid(const uint8_t *);
 	const char *GetUid(void);
 
+	/**
+	 * Blocking, all the discovery steps are run back to back
+	 */
 	void Full(void);
 
+	/**
+	 * Non-blocking, the discovery is driven by Run()
+	 * Incremental keeps the TOD: the known UID's are muted (and removed when not responding)
+	 * after which the branch probes only find the new devices.
+	 * The TOD changes of a pass are available with RDMTod::IsChanged.
+	 */
+	void Start(bool bIncremental = false);
+	/**
+	 * Returns false when the discovery is finished.
+	 * With bInterleaveDmx the line is released after RDM_DISCOVERY_SLICE_MICROS for at least RDM_DISCOVERY_YIELD_MICROS.
+	 */
+	bool Run(bool bInterleaveDmx = false);
+
+	bool IsRunning(void) const {
+		return m_tState != RDM_DISCOVERY_STATE_IDLE;
+	}
+
+	/**
+	 * The line is owned by the discovery: DMX output must be stopped.
+	 * It is set one Run() before the first packet of a slice is sent.
+	 */
+	bool IsLineRequired(void) const {
+		return m_bIsLineRequired;
+	}
+
+	bool IsReceiving(void) const {
+		return m_bIsReceiving;
+	}
+
 private:
-	bool FindDevices(uint64_t, uint64_t);
-	bool QuickFind(const uint8_t *);
+	void Send(void);
+	void Process(const uint8_t *pResponse);
+	void ProcessUniqueBranch(const uint8_t *pResponse);
+	void Split(void);
+	void Push(uint64_t nLowerBound, uint64_t nUpperBound);
+	void Pop(void);
+	void Next(void);
+	void Finish(void);
 
+	bool IsValidMuteResponse(const uint8_t *pResponse, const uint8_t *pUid);
 	bool IsValidDiscoveryResponse(const uint8_t *, uint8_t *);
 
 	void PrintUid(const uint64_t);
@@ -61,6 +126,18 @@ private:
 	RDMMessage m_UnMute;
 	RDMMessage m_Mute;
 	RDMMessage m_DiscUniqueBranch;
+	TRdmDiscoveryState m_tState;
+	bool m_bIsIncremental;
+	bool m_bIsLineRequired;
+	bool m_bIsReceiving;
+	uint16_t m_nCounter;
+	uint8_t m_MuteUid[RDM_UID_SIZE];
+	uint32_t m_nSendMicros;
+	uint32_t m_nTimeOut;
+	uint32_t m_nSliceMicros;
+	uint32_t m_nYieldMicros;
+	uint32_t m_nStackTop;
+	struct TRdmDiscoveryBranch m_Stack[RDM_DISCOVERY_STACK_SIZE];
 };
 
 #endif /* RDMDISCOVERY_H_ */
@@ -0,0 +1,120 @@
+/**
+ * @file rdmresponsecache.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef RDMRESPONSECACHE_H_
+#define RDMRESPONSECACHE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "rdm.h"
+
+#if !defined (RDM_RESPONSE_CACHE_ENTRIES)
+# if defined (BARE_METAL)
+ #define RDM_RESPONSE_CACHE_ENTRIES		2048		///< Per port maximum, power of 2: 64 fixtures with 16 PID's at half load, 112 KB
+# else
+ #define RDM_RESPONSE_CACHE_ENTRIES		16384		///< Per port maximum, power of 2: 500 fixtures with 16 PID's at half load, 896 KB
+# endif
+#endif
+#define RDM_RESPONSE_CACHE_ENTRIES_MIN	256			///< Power of 2
+#define RDM_RESPONSE_CACHE_PIDS_PER_UID	16
+#define RDM_RESPONSE_CACHE_DATA_PER_ENTRY	32		///< Power of 2: the parameter data of the responses, 64 bytes on average at half load
+#define RDM_RESPONSE_CACHE_PROBES		16
+#define RDM_RESPONSE_CACHE_KEY_PD_SIZE	4			///< Requests with a larger PDL are not cached
+#define RDM_RESPONSE_CACHE_MAX_AGE		60000		///< Milliseconds, catches changes made locally at the device
+
+/**
+ * Only the parameter data of the response is stored, the other fields follow from the request.
+ */
+struct TRdmResponseCacheEntry {
+	uint8_t uid[RDM_UID_SIZE];
+	uint8_t nPdl;								///< Request
+	uint8_t nResponsePdl;
+	uint16_t nSubDevice;
+	uint16_t nPid;								///< 0 is an empty entry
+	uint8_t pd[RDM_RESPONSE_CACHE_KEY_PD_SIZE];	///< Request
+	uint32_t nMillis;
+	uint32_t nPosition;							///< Of the response parameter data in the data ring
+};
+
+/**
+ * The data ring is written at nPosition, which is not wrapped: an entry is valid as long as its
+ * parameter data is not overwritten, (nPosition - entry nPosition) <= nDataSize.
+ */
+struct TRdmResponseCachePort {
+	struct TRdmResponseCacheEntry *pEntries;
+	uint8_t *pData;
+	uint32_t nPosition;
+	uint32_t nEntries;	///< Power of 2, sized from the TOD
+	uint32_t nDataSize;	///< nEntries * RDM_RESPONSE_CACHE_DATA_PER_ENTRY
+};
+
+/**
+ * GET responses of parameters which rarely change, keyed on UID, sub-device, PID and PD.
+ * The memory for a port is allocated with the first response cached, when that fails the port is not cached.
+ */
+class RDMResponseCache {
+public:
+	RDMResponseCache(uint8_t nPorts);
+	~RDMResponseCache(void);
+
+	/**
+	 * pRdmDataNoSc is the request. On a hit the response is built with the transaction number
+	 * and the destination of the request.
+	 */
+	const uint8_t *Get(uint8_t nPort, const uint8_t *pRdmDataNoSc);
+	void Put(uint8_t nPort, const uint8_t *pRdmDataNoSc, const uint8_t *pResponse);
+
+	void Invalidate(uint8_t nPort, const uint8_t *pUid);
+	void Invalidate(uint8_t nPort);
+
+	/**
+	 * The size of the port follows the number of UID's in the TOD. A port with another size is emptied.
+	 */
+	void SetUidCount(uint8_t nPort, uint32_t nUidCount);
+
+	uint32_t GetMemorySize(uint8_t nPort) const;
+
+	static bool IsCacheable(const uint8_t *pRdmDataNoSc);
+
+	void Print(void);
+
+private:
+	uint32_t Hash(const struct TRdmMessageNoSc *p) const;
+	bool IsMatch(const struct TRdmResponseCacheEntry *pEntry, const struct TRdmMessageNoSc *p) const;
+	void Free(struct TRdmResponseCachePort *pPort);
+	bool IsValid(const struct TRdmResponseCachePort *pPort, const struct TRdmResponseCacheEntry *pEntry) const {
+		return (pEntry->nPid != 0) && ((pPort->nPosition - pEntry->nPosition) <= pPort->nDataSize);
+	}
+
+private:
+	uint8_t m_nPorts;
+	struct TRdmResponseCachePort *m_pPorts;
+	uint32_t m_nHits;
+	uint32_t m_nMisses;
+	uint8_t m_Response[sizeof(struct TRdmMessage) + RDM_MESSAGE_CHECKSUM_SIZE];
+};
+
+#endif /* RDMRESPONSECACHE_H_ */
@@ -28,15 +28,23 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "rdm.h"
 
-#define TOD_TABLE_SIZE	200
+#if !defined (TOD_TABLE_SIZE)
+ #define TOD_TABLE_SIZE	2048
+#endif
+#define TOD_CHANGED_SIZE	8		///< The UID's added or removed which are kept for a discovery pass
 
 struct TRdmTod {
 	uint8_t uid[RDM_UID_SIZE];
 };
 
+/**
+ * The UID's are kept sorted (the big-endian byte order is the numeric order),
+ * so the table can be copied as is into an ArtTodData / TOD_DATA response.
+ */
 class RDMTod {
 public:
 	 RDMTod(void);
@@ -44,17 +52,82 @@ public:
 
 	 void Reset(void);
 	 bool AddUid(const uint8_t *pUid);
-	 uint8_t GetUidCount(void) const;
-	 void Copy(uint8_t *pTable);
+	 uint16_t GetUidCount(void) const {
+		 return m_nEntries;
+	 }
+	 void Copy(uint8_t *pTable) const {
+		 Copy(pTable, 0, m_nEntries);
+	 }
+	 /**
+	  * Copies at most nCount UID's starting at nIndex, returns the number of UID's copied
+	  */
+	 uint16_t Copy(uint8_t *pTable, uint16_t nIndex, uint16_t nCount) const;
+	 const uint8_t *GetTodEntry(uint16_t nIndex) const;
 
 	 bool Delete(const uint8_t *pUid);
-	 bool Exist(const uint8_t *pUid);
+	 bool Exist(const uint8_t *pUid) const;
+
+	 /**
+	  * Changes since the last ClearChanged: all entries from GetChangedFirst onwards could have been moved
+	  */
+	 void ClearChanged(void) {
+		 m_nChangedFirst = TOD_TABLE_SIZE;
+		 m_nAdded = 0;
+		 m_nRemoved = 0;
+		 m_nChangedUids = 0;
+	 }
+	 bool IsChanged(void) const {
+		 return m_nChangedFirst != TOD_TABLE_SIZE;
+	 }
+	 uint16_t GetChangedFirst(void) const {
+		 return m_nChangedFirst;
+	 }
+	 uint16_t GetAdded(void) const {
+		 return m_nAdded;
+	 }
+	 uint16_t GetRemoved(void) const {
+		 return m_nRemoved;
+	 }
+	 /**
+	  * The UID's added or removed, when there are more than TOD_CHANGED_SIZE (or after a Reset) the list is not complete
+	  */
+	 bool IsChangedUidsComplete(void) const {
+		 return m_nChangedUids <= TOD_CHANGED_SIZE;
+	 }
+	 uint16_t GetChangedUidCount(void) const {
+		 return m_nChangedUids;
+	 }
+	 const uint8_t *GetChangedUid(uint16_t nIndex) const {
+		 return m_ChangedUids[nIndex].uid;
+	 }
 
 	 void Dump(void);
-	 void Dump(uint8_t nCount);
+	 void Dump(uint16_t nCount);
+
+private:
+	 bool Find(const uint8_t *pUid, uint16_t &nIndex) const;
+	 void SetChanged(uint16_t nIndex) {
+		 if (nIndex < m_nChangedFirst) {
+			 m_nChangedFirst = nIndex;
+		 }
+	 }
+	 void SetChangedUid(const uint8_t *pUid) {
+		 if (m_nChangedUids < TOD_CHANGED_SIZE) {
+			 memcpy(m_ChangedUids[m_nChangedUids].uid, pUid, RDM_UID_SIZE);
+		 }
+		 if (m_nChangedUids <= TOD_CHANGED_SIZE) {
+			 m_nChangedUids++;
+		 }
+	 }
+
 private:
-	 uint8_t m_nEntries;
+	 uint16_t m_nEntries;
+	 uint16_t m_nChangedFirst;
+	 uint16_t m_nAdded;
+	 uint16_t m_nRemoved;
+	 uint16_t m_nChangedUids;
 	 TRdmTod *m_pTable;
+	 TRdmTod m_ChangedUids[TOD_CHANGED_SIZE];
 };
 
 #endif /* RDMTOD_H_ */
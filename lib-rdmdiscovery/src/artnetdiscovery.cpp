@@ -46,7 +46,7 @@ ArtNetRdm::~ArtNetRdm(void) {
 
 }
 
-ArtNetRdmController::ArtNetRdmController(void) : m_pRdmCommand(0){
+ArtNetRdmController::ArtNetRdmController(void) : m_pRdmCommand(0), m_ResponseCache(DMX_MAX_UARTS) {
 	for (unsigned i = 0 ; i < DMX_MAX_UARTS; i++) {
 		m_Discovery[i] = new RDMDiscovery(i);
 		assert(m_Discovery[i] != 0);
@@ -70,6 +70,7 @@ ArtNetRdmController::~ArtNetRdmController(void) {
 
 void ArtNetRdmController::Print(void) {
 	RDMDeviceController::Print();
+	m_ResponseCache.Print();
 }
 
 void ArtNetRdmController::Full(uint8_t nPort) {
@@ -77,10 +78,65 @@ void ArtNetRdmController::Full(uint8_t nPort) {
 
 	DEBUG_PRINTF("nPort=%d", nPort);
 
+	m_ResponseCache.Invalidate(nPort);
 	m_Discovery[nPort]->Full();
+	m_ResponseCache.SetUidCount(nPort, m_Discovery[nPort]->GetUidCount());
 }
 
-uint8_t ArtNetRdmController::GetUidCount(uint8_t nPort) {
+void ArtNetRdmController::DiscoveryStart(uint8_t nPort, bool bIncremental) {
+	assert(nPort < DMX_MAX_UARTS);
+
+	DEBUG_PRINTF("nPort=%d, bIncremental=%d", nPort, (int) bIncremental);
+
+	if (!bIncremental) {
+		m_ResponseCache.Invalidate(nPort);
+	}
+
+	m_Discovery[nPort]->Start(bIncremental);
+}
+
+bool ArtNetRdmController::DiscoveryRun(uint8_t nPort, bool bInterleaveDmx, bool &bIsLineRequired) {
+	assert(nPort < DMX_MAX_UARTS);
+
+	const bool bIsRunning = m_Discovery[nPort]->Run(bInterleaveDmx);
+
+	bIsLineRequired = m_Discovery[nPort]->IsLineRequired();
+
+	if (!bIsRunning) {
+		InvalidateChanged(nPort);
+		m_ResponseCache.SetUidCount(nPort, m_Discovery[nPort]->GetUidCount());
+	}
+
+	return bIsRunning;
+}
+
+/**
+ * The cached responses of the devices which are gone, or are back (and could have been changed)
+ */
+void ArtNetRdmController::InvalidateChanged(uint8_t nPort) {
+	const RDMDiscovery *pDiscovery = m_Discovery[nPort];
+
+	if (!pDiscovery->IsChangedUidsComplete()) {
+		m_ResponseCache.Invalidate(nPort);
+		return;
+	}
+
+	for (uint32_t i = 0; i < pDiscovery->GetChangedUidCount(); i++) {
+		m_ResponseCache.Invalidate(nPort, pDiscovery->GetChangedUid(i));
+	}
+}
+
+bool ArtNetRdmController::IsTodChanged(uint8_t nPort, uint16_t &nChangedFirst) {
+	assert(nPort < DMX_MAX_UARTS);
+
+	DEBUG_PRINTF("nPort=%d, added=%d, removed=%d", nPort, m_Discovery[nPort]->GetAdded(), m_Discovery[nPort]->GetRemoved());
+
+	nChangedFirst = m_Discovery[nPort]->GetChangedFirst();
+
+	return m_Discovery[nPort]->IsChanged();
+}
+
+uint16_t ArtNetRdmController::GetUidCount(uint8_t nPort) {
 	assert(nPort < DMX_MAX_UARTS);
 
 	DEBUG_PRINTF("nPort=%d", nPort);
@@ -88,12 +144,12 @@ uint8_t ArtNetRdmController::GetUidCount(uint8_t nPort) {
 	return m_Discovery[nPort]->GetUidCount();
 }
 
-void ArtNetRdmController::Copy(uint8_t nPort, uint8_t *pTod) {
+uint16_t ArtNetRdmController::Copy(uint8_t nPort, uint8_t *pTod, uint16_t nIndex, uint16_t nCount) {
 	assert(nPort < DMX_MAX_UARTS);
 
-	DEBUG_PRINTF("nPort=%d", nPort);
+	DEBUG_PRINTF("nPort=%d, nIndex=%d, nCount=%d", nPort, nIndex, nCount);
 
-	m_Discovery[nPort]->Copy(pTod);
+	return m_Discovery[nPort]->Copy(pTod, nIndex, nCount);
 }
 
 void ArtNetRdmController::DumpTod(uint8_t nPort) {
@@ -111,13 +167,30 @@ const uint8_t *ArtNetRdmController::Handler(uint8_t nPort, const uint8_t *pRdmDa
 		return 0;
 	}
 
+	TRdmMessageNoSc *p = (TRdmMessageNoSc *) (pRdmData);
+
+	if (p->command_class == E120_SET_COMMAND) {
+		m_ResponseCache.Invalidate(nPort, p->destination_uid);
+	} else {
+		const uint8_t *pCached = m_ResponseCache.Get(nPort, pRdmData);
+
+		if (pCached != 0) {
+			DEBUG_PUTS("Cached");
+			return pCached;
+		}
+	}
+
 	Hardware::Get()->WatchdogFeed();
 
+	// Complete the discovery transaction in progress, the response would be discarded below
+	while (m_Discovery[nPort]->IsReceiving()) {
+		m_Discovery[nPort]->Run();
+	}
+
 	while (0 != RDMMessage::Receive(nPort)) {
 		// Discard late responses
 	}
 
-	TRdmMessageNoSc *p = (TRdmMessageNoSc *) (pRdmData);
 	uint8_t *c = (uint8_t *) m_pRdmCommand;
 
 	memcpy(&c[1], pRdmData, p->message_length + 2);
@@ -133,5 +206,17 @@ const uint8_t *ArtNetRdmController::Handler(uint8_t nPort, const uint8_t *pRdmDa
 #ifndef NDEBUG
 	RDMMessage::Print(pResponse);
 #endif
+
+	if (pResponse != 0) {
+		const struct TRdmMessage *pRdmResponse = (const struct TRdmMessage *) pResponse;
+
+		// Queued messages report changes made at the device
+		if ((pRdmResponse->message_count != 0) || ((p->param_id[0] == (E120_QUEUED_MESSAGE >> 8)) && (p->param_id[1] == (E120_QUEUED_MESSAGE & 0xFF)))) {
+			m_ResponseCache.Invalidate(nPort, p->destination_uid);
+		} else {
+			m_ResponseCache.Put(nPort, pRdmData, pResponse);
+		}
+	}
+
 	return pResponse;
 }
@@ -29,6 +29,7 @@
 #ifndef NDEBUG
 #include <stdio.h>
 #endif
+#include <assert.h>
 
 #include "rdm.h"
 #include "rdm_e120.h"
@@ -36,9 +37,7 @@
 
 #include "hardware.h"
 
-extern "C" {
- void udelay(uint32_t us);
-}
+#include "debug.h"
 
 static uint8_t pdl[2][RDM_UID_SIZE];
 
@@ -49,9 +48,19 @@ typedef union cast {
 
 static _cast uuid_cast;
 
-#define RECEIVE_TIME_OUT (2800*100) //TODO #define
-
-RDMDiscovery::RDMDiscovery(uint8_t nPort) : m_nPort(nPort) {
+RDMDiscovery::RDMDiscovery(uint8_t nPort) :
+	m_nPort(nPort),
+	m_tState(RDM_DISCOVERY_STATE_IDLE),
+	m_bIsIncremental(false),
+	m_bIsLineRequired(false),
+	m_bIsReceiving(false),
+	m_nCounter(0),
+	m_nSendMicros(0),
+	m_nTimeOut(0),
+	m_nSliceMicros(0),
+	m_nYieldMicros(0),
+	m_nStackTop(0)
+{
 	m_UnMute.SetDstUid(UID_ALL);
 	m_UnMute.SetCc(E120_DISCOVERY_COMMAND);
 	m_UnMute.SetPid(E120_DISC_UN_MUTE);
@@ -80,97 +89,278 @@ const char *RDMDiscovery::GetUid(void) {
 }
 
 void RDMDiscovery::Full(void) {
-	struct TRdmMessage *response;
+	Start(false);
 
-	Reset();
-
-	m_UnMute.Send(m_nPort);
-	m_UnMute.ReceiveTimeOut(m_nPort, 2800);
+	while (Run(false)) {
+		Hardware::Get()->WatchdogFeed();
+	}
 
-	Hardware::Get()->WatchdogFeed();
-	udelay(100000);
+	Dump();
+}
 
-	m_UnMute.Send(m_nPort);
-	m_UnMute.ReceiveTimeOut(m_nPort, 2800);
+void RDMDiscovery::Start(bool bIncremental) {
+	DEBUG_PRINTF("m_nPort=%d, bIncremental=%d", (int) m_nPort, (int) bIncremental);
 
-	Hardware::Get()->WatchdogFeed();
-	udelay(100000);
+	m_bIsIncremental = bIncremental;
 
-	m_UnMute.Send(m_nPort);
-	response = (struct TRdmMessage *) m_Mute.ReceiveTimeOut(m_nPort, RECEIVE_TIME_OUT);
+	ClearChanged();
 
-	if (response != 0) {
-		FindDevices(ConvertUid((const uint8_t *)response->source_uid), ConvertUid((const uint8_t *)response->source_uid));
+	if (!bIncremental) {
+		Reset();
 	}
 
-	FindDevices(0x000000000000, 0xfffffffffffe);
+	m_nCounter = 0;
+	m_nStackTop = 0;
+	m_bIsLineRequired = false;
+	m_bIsReceiving = false;
+	m_nYieldMicros = Hardware::Get()->Micros() - RDM_DISCOVERY_YIELD_MICROS;
 
-	Dump();
+	m_tState = RDM_DISCOVERY_STATE_UNMUTE;
 }
 
-bool RDMDiscovery::FindDevices(uint64_t LowerBound, uint64_t UpperBound) {
-	struct TRdmMessage *response;
-	uint8_t uid[RDM_UID_SIZE];
-	bool bDeviceFound = false;
-	uint64_t MidPosition;
+bool RDMDiscovery::Run(bool bInterleaveDmx) {
+	if (m_tState == RDM_DISCOVERY_STATE_IDLE) {
+		return false;
+	}
 
-	Hardware::Get()->WatchdogFeed();
+	const uint32_t nMicros = Hardware::Get()->Micros();
 
-#ifndef NDEBUG
-	printf("FindDevices : ");
-	PrintUid(LowerBound);
-	printf(" - ");
-	PrintUid(UpperBound);
-	printf("\n");
-#endif
+	if (m_bIsReceiving) {
+		const uint8_t *pResponse = Rdm::Receive(m_nPort);
 
-	if (LowerBound == UpperBound) {
-		memcpy(uid, ConvertUid(LowerBound), RDM_UID_SIZE);
+		if ((pResponse == 0) && ((nMicros - m_nSendMicros) < m_nTimeOut)) {
+			return true;
+		}
 
-		m_Mute.SetDstUid(uid);
-		m_Mute.Send(m_nPort);
+		m_bIsReceiving = false;
 
-		response = (struct TRdmMessage *) m_Mute.ReceiveTimeOut(m_nPort, RECEIVE_TIME_OUT);
+		Process(pResponse);
 
-		if (response != 0) {
-			if ((response->command_class == E120_DISCOVERY_COMMAND_RESPONSE) && (memcmp(uid, response->source_uid, RDM_UID_SIZE) == 0)) {
-				AddUid(uid);
-			}
-		} else {
+		if (m_tState == RDM_DISCOVERY_STATE_IDLE) {
+			return false;
+		}
+
+		if (bInterleaveDmx && ((nMicros - m_nSliceMicros) >= RDM_DISCOVERY_SLICE_MICROS)) {
+			m_bIsLineRequired = false;
+			m_nYieldMicros = nMicros;
+		}
+
+		return true;
+	}
+
+	if (!m_bIsLineRequired) {
+		if (bInterleaveDmx && ((nMicros - m_nYieldMicros) < RDM_DISCOVERY_YIELD_MICROS)) {
 			return true;
 		}
-	} else {
-		memcpy(pdl[0], ConvertUid(LowerBound), RDM_UID_SIZE);
-		memcpy(pdl[1], ConvertUid(UpperBound), RDM_UID_SIZE);
 
-		m_DiscUniqueBranch.SetPd((const uint8_t *)pdl, 2* RDM_UID_SIZE);
+		m_bIsLineRequired = true;
+		m_nSliceMicros = nMicros;
+
+		if (bInterleaveDmx) {
+			// The DMX output is stopped by the owner before the next packet is sent
+			return true;
+		}
+	}
+
+	Send();
+
+	return true;
+}
+
+void RDMDiscovery::Send(void) {
+	switch (m_tState) {
+	case RDM_DISCOVERY_STATE_UNMUTE:
+		m_UnMute.Send(m_nPort);
+		m_nTimeOut = RDM_DISCOVERY_RESPONSE_TIME_OUT;
+		break;
+	case RDM_DISCOVERY_STATE_MUTE_KNOWN:
+		memcpy(m_MuteUid, GetTodEntry(m_nCounter), RDM_UID_SIZE);
+		m_Mute.SetDstUid(m_MuteUid);
+		m_Mute.Send(m_nPort);
+		m_nTimeOut = RDM_DISCOVERY_RESPONSE_TIME_OUT;
+		break;
+	case RDM_DISCOVERY_STATE_MUTE:
+		m_Mute.SetDstUid(m_MuteUid);
+		m_Mute.Send(m_nPort);
+		m_nTimeOut = RDM_DISCOVERY_RESPONSE_TIME_OUT;
+		break;
+	case RDM_DISCOVERY_STATE_UNIQUE_BRANCH:
+		assert(m_nStackTop != 0);
+		memcpy(pdl[0], ConvertUid(m_Stack[m_nStackTop - 1].nLowerBound), RDM_UID_SIZE);
+		memcpy(pdl[1], ConvertUid(m_Stack[m_nStackTop - 1].nUpperBound), RDM_UID_SIZE);
+		m_DiscUniqueBranch.SetPd((const uint8_t *)pdl, 2 * RDM_UID_SIZE);
 		m_DiscUniqueBranch.Send(m_nPort);
+		m_nTimeOut = RDM_DISCOVERY_DUB_TIME_OUT;
+		break;
+	default:
+		assert(0);
+		return;
+		break;
+	}
 
-		response = (struct TRdmMessage *) m_DiscUniqueBranch.ReceiveTimeOut(m_nPort, RECEIVE_TIME_OUT);
+	m_nSendMicros = Hardware::Get()->Micros();
+	m_bIsReceiving = true;
+}
 
-		if (response != 0) {
-			bDeviceFound = true;
+void RDMDiscovery::Process(const uint8_t *pResponse) {
+	switch (m_tState) {
+	case RDM_DISCOVERY_STATE_UNMUTE:
+		if (++m_nCounter < RDM_DISCOVERY_UNMUTE_COUNT) {
+			return;
+		}
 
-			if (IsValidDiscoveryResponse((const uint8_t *)response, uid)) {
-				bDeviceFound = QuickFind(uid);
-			}
+		m_nCounter = 0;
+
+		if (m_bIsIncremental && (GetUidCount() != 0)) {
+			m_tState = RDM_DISCOVERY_STATE_MUTE_KNOWN;
+			return;
+		}
 
-			if (bDeviceFound) {
-				MidPosition = ((LowerBound & (0x0000800000000000 - 1)) + (UpperBound & (0x0000800000000000 - 1))) / 2
-						+ (UpperBound & (0x0000800000000000) ? 0x0000400000000000 : 0 )
-						+ (LowerBound & (0x0000800000000000) ? 0x0000400000000000 : 0 );
+		Push(0, RDM_DISCOVERY_UID_MAX);
+		Next();
+		break;
+	case RDM_DISCOVERY_STATE_MUTE_KNOWN:
+		if (IsValidMuteResponse(pResponse, m_MuteUid)) {
+			m_nCounter++;
+		} else {
+			// The next entry moves into this index
+			Delete(m_MuteUid);
+#ifndef NDEBUG
+			printf("Lost : ");
+			PrintUid(m_MuteUid);
+			printf("\n");
+#endif
+		}
 
-				bDeviceFound = FindDevices(LowerBound, MidPosition);
-				bDeviceFound |= FindDevices(MidPosition + 1, UpperBound);
+		if (m_nCounter < GetUidCount()) {
+			return;
+		}
 
-				if (bDeviceFound) {
-					return true;
-				}
+		Push(0, RDM_DISCOVERY_UID_MAX);
+		Next();
+		break;
+	case RDM_DISCOVERY_STATE_UNIQUE_BRANCH:
+		ProcessUniqueBranch(pResponse);
+		break;
+	case RDM_DISCOVERY_STATE_MUTE:
+		if (IsValidMuteResponse(pResponse, m_MuteUid) && AddUid(m_MuteUid)) {
+			if (m_Stack[m_nStackTop - 1].nLowerBound != m_Stack[m_nStackTop - 1].nUpperBound) {
+				// Quick find: probe the same branch again for the next device
+				m_tState = RDM_DISCOVERY_STATE_UNIQUE_BRANCH;
+				return;
 			}
 		}
+
+		// Not muted, or still responding after a mute: narrow it down
+		Split();
+		Next();
+		break;
+	default:
+		assert(0);
+		break;
+	}
+}
+
+void RDMDiscovery::ProcessUniqueBranch(const uint8_t *pResponse) {
+	assert(m_nStackTop != 0);
+
+	if (pResponse == 0) {
+		Pop();
+		Next();
+		return;
 	}
 
-	return false;
+	const struct TRdmDiscoveryBranch *pBranch = &m_Stack[m_nStackTop - 1];
+
+	if (IsValidDiscoveryResponse(pResponse, m_MuteUid)) {
+		const uint64_t nUid = ConvertUid(m_MuteUid);
+
+		if ((nUid >= pBranch->nLowerBound) && (nUid <= pBranch->nUpperBound)) {
+			m_tState = RDM_DISCOVERY_STATE_MUTE;
+			return;
+		}
+	}
+
+	// Collision
+	Split();
+	Next();
+}
+
+void RDMDiscovery::Split(void) {
+	assert(m_nStackTop != 0);
+
+	const uint64_t nLowerBound = m_Stack[m_nStackTop - 1].nLowerBound;
+	const uint64_t nUpperBound = m_Stack[m_nStackTop - 1].nUpperBound;
+
+	Pop();
+
+	if (nLowerBound == nUpperBound) {
+		return;
+	}
+
+	const uint64_t nMidPosition = (nLowerBound + nUpperBound) / 2;
+
+	// The lower half is on top, so it is probed first
+	Push(nMidPosition + 1, nUpperBound);
+	Push(nLowerBound, nMidPosition);
+}
+
+void RDMDiscovery::Push(uint64_t nLowerBound, uint64_t nUpperBound) {
+	assert(m_nStackTop < RDM_DISCOVERY_STACK_SIZE);
+
+	m_Stack[m_nStackTop].nLowerBound = nLowerBound;
+	m_Stack[m_nStackTop].nUpperBound = nUpperBound;
+	m_nStackTop++;
+}
+
+void RDMDiscovery::Pop(void) {
+	assert(m_nStackTop != 0);
+
+	m_nStackTop--;
+}
+
+void RDMDiscovery::Next(void) {
+	if (m_nStackTop == 0) {
+		Finish();
+		return;
+	}
+
+	const struct TRdmDiscoveryBranch *pBranch = &m_Stack[m_nStackTop - 1];
+
+#ifndef NDEBUG
+	printf("FindDevices : ");
+	PrintUid(pBranch->nLowerBound);
+	printf(" - ");
+	PrintUid(pBranch->nUpperBound);
+	printf("\n");
+#endif
+
+	if (pBranch->nLowerBound == pBranch->nUpperBound) {
+		memcpy(m_MuteUid, ConvertUid(pBranch->nLowerBound), RDM_UID_SIZE);
+		m_tState = RDM_DISCOVERY_STATE_MUTE;
+		return;
+	}
+
+	m_tState = RDM_DISCOVERY_STATE_UNIQUE_BRANCH;
+}
+
+void RDMDiscovery::Finish(void) {
+	DEBUG_PRINTF("m_nPort=%d, GetUidCount()=%d", (int) m_nPort, (int) GetUidCount());
+
+	m_tState = RDM_DISCOVERY_STATE_IDLE;
+	m_nStackTop = 0;
+	m_bIsLineRequired = false;
+	m_bIsReceiving = false;
+}
+
+bool RDMDiscovery::IsValidMuteResponse(const uint8_t *pResponse, const uint8_t *pUid) {
+	if (pResponse == 0) {
+		return false;
+	}
+
+	const struct TRdmMessage *p = (const struct TRdmMessage *) pResponse;
+
+	return (p->command_class == E120_DISCOVERY_COMMAND_RESPONSE) && (memcmp(pUid, p->source_uid, RDM_UID_SIZE) == 0);
 }
 
 const uint8_t *RDMDiscovery::ConvertUid(const uint64_t uid) {
@@ -233,43 +423,3 @@ bool RDMDiscovery::IsValidDiscoveryResponse(const uint8_t *response, uint8_t *ui
 
 	return bIsValid;
 }
-
-bool RDMDiscovery::QuickFind(const uint8_t *uid) {
-	uint8_t *response;
-	struct TRdmMessage *p;
-	uint8_t r_uid[RDM_UID_SIZE];
-
-	Hardware::Get()->WatchdogFeed();
-
-#ifndef NDEBUG
-	printf("QuickFind : ");
-	PrintUid((uint8_t *)uid);
-	printf("\n");
-#endif
-
-	m_Mute.SetDstUid(uid);
-	m_Mute.Send(m_nPort);
-
-	response = (uint8_t *) m_Mute.ReceiveTimeOut(m_nPort, RECEIVE_TIME_OUT);
-
-	if (response != 0) {
-		p = (struct TRdmMessage *) response;
-		if ((p->command_class == E120_DISCOVERY_COMMAND_RESPONSE) && (memcmp(uid, p->source_uid, RDM_UID_SIZE) == 0)) {
-			AddUid(uid);
-		}
-	}
-
-	Hardware::Get()->WatchdogFeed();
-
-	m_DiscUniqueBranch.Send(m_nPort);
-
-	response = (uint8_t *) m_DiscUniqueBranch.ReceiveTimeOut(m_nPort, RECEIVE_TIME_OUT);
-
-	if ((response != 0) && (IsValidDiscoveryResponse(response, r_uid))) {
-		QuickFind(r_uid);
-	} else {
-		return true;
-	}
-
-	return false;
-}
@@ -0,0 +1,372 @@
+/**
+ * @file rdmresponsecache.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <assert.h>
+
+#include "rdmresponsecache.h"
+
+#include "rdm.h"
+#include "rdm_e120.h"
+
+#include "hardware.h"
+
+#include "debug.h"
+
+static const uint16_t s_CacheablePids[] = {
+		E120_DEVICE_INFO,
+		E120_DEVICE_MODEL_DESCRIPTION,
+		E120_MANUFACTURER_LABEL,
+		E120_DEVICE_LABEL,
+		E120_SOFTWARE_VERSION_LABEL,
+		E120_BOOT_SOFTWARE_VERSION_ID,
+		E120_BOOT_SOFTWARE_VERSION_LABEL,
+		E120_SUPPORTED_PARAMETERS,
+		E120_PARAMETER_DESCRIPTION,
+		E120_PRODUCT_DETAIL_ID_LIST,
+		E120_LANGUAGE_CAPABILITIES,
+		E120_DMX_PERSONALITY_DESCRIPTION,
+		E120_SLOT_INFO,
+		E120_SLOT_DESCRIPTION,
+		E120_DEFAULT_SLOT_VALUE,
+		E120_SENSOR_DEFINITION
+};
+
+static bool is_broadcast(const uint8_t *pUid) {
+	return (pUid[2] == 0xFF) && (pUid[3] == 0xFF) && (pUid[4] == 0xFF) && (pUid[5] == 0xFF);
+}
+
+RDMResponseCache::RDMResponseCache(uint8_t nPorts) : m_nPorts(nPorts), m_nHits(0), m_nMisses(0) {
+	m_pPorts = new struct TRdmResponseCachePort[nPorts];
+	assert(m_pPorts != 0);
+
+	for (uint32_t i = 0; i < nPorts; i++) {
+		m_pPorts[i].pEntries = 0;
+		m_pPorts[i].pData = 0;
+		m_pPorts[i].nPosition = 0;
+		m_pPorts[i].nEntries = RDM_RESPONSE_CACHE_ENTRIES_MIN;
+		m_pPorts[i].nDataSize = RDM_RESPONSE_CACHE_ENTRIES_MIN * RDM_RESPONSE_CACHE_DATA_PER_ENTRY;
+	}
+}
+
+RDMResponseCache::~RDMResponseCache(void) {
+	for (uint32_t i = 0; i < m_nPorts; i++) {
+		Free(&m_pPorts[i]);
+	}
+
+	delete[] m_pPorts;
+}
+
+void RDMResponseCache::Free(struct TRdmResponseCachePort *pPort) {
+	delete[] pPort->pEntries;
+	pPort->pEntries = 0;
+
+	delete[] pPort->pData;
+	pPort->pData = 0;
+}
+
+void RDMResponseCache::SetUidCount(uint8_t nPort, uint32_t nUidCount) {
+	if (nPort >= m_nPorts) {
+		return;
+	}
+
+	// Half load
+	const uint32_t nRequired = 2 * nUidCount * RDM_RESPONSE_CACHE_PIDS_PER_UID;
+	uint32_t nEntries = RDM_RESPONSE_CACHE_ENTRIES_MIN;
+
+	while ((nEntries < nRequired) && (nEntries < RDM_RESPONSE_CACHE_ENTRIES)) {
+		nEntries <<= 1;
+	}
+
+	struct TRdmResponseCachePort *pPort = &m_pPorts[nPort];
+
+	if (nEntries == pPort->nEntries) {
+		return;
+	}
+
+	DEBUG_PRINTF("nPort=%d, nUidCount=%d, nEntries=%d", nPort, (int) nUidCount, (int) nEntries);
+
+	Free(pPort);
+
+	pPort->nEntries = nEntries;
+	pPort->nDataSize = nEntries * RDM_RESPONSE_CACHE_DATA_PER_ENTRY;
+}
+
+uint32_t RDMResponseCache::GetMemorySize(uint8_t nPort) const {
+	if ((nPort >= m_nPorts) || (m_pPorts[nPort].pEntries == 0)) {
+		return 0;
+	}
+
+	return (m_pPorts[nPort].nEntries * sizeof(struct TRdmResponseCacheEntry)) + m_pPorts[nPort].nDataSize;
+}
+
+bool RDMResponseCache::IsCacheable(const uint8_t *pRdmDataNoSc) {
+	const struct TRdmMessageNoSc *p = (const struct TRdmMessageNoSc *) pRdmDataNoSc;
+
+	if ((p->command_class != E120_GET_COMMAND) || (p->param_data_length > RDM_RESPONSE_CACHE_KEY_PD_SIZE) || is_broadcast(p->destination_uid)) {
+		return false;
+	}
+
+	const uint16_t nPid = (uint16_t) ((p->param_id[0] << 8) | p->param_id[1]);
+
+	for (uint32_t i = 0; i < sizeof(s_CacheablePids) / sizeof(s_CacheablePids[0]); i++) {
+		if (s_CacheablePids[i] == nPid) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+uint32_t RDMResponseCache::Hash(const struct TRdmMessageNoSc *p) const {
+	// FNV-1a
+	uint32_t nHash = 2166136261U;
+
+	for (uint32_t i = 0; i < RDM_UID_SIZE; i++) {
+		nHash = (nHash ^ p->destination_uid[i]) * 16777619U;
+	}
+
+	nHash = (nHash ^ p->sub_device[0]) * 16777619U;
+	nHash = (nHash ^ p->sub_device[1]) * 16777619U;
+	nHash = (nHash ^ p->param_id[0]) * 16777619U;
+	nHash = (nHash ^ p->param_id[1]) * 16777619U;
+
+	for (uint32_t i = 0; i < p->param_data_length; i++) {
+		nHash = (nHash ^ p->param_data[i]) * 16777619U;
+	}
+
+	return nHash;
+}
+
+bool RDMResponseCache::IsMatch(const struct TRdmResponseCacheEntry *pEntry, const struct TRdmMessageNoSc *p) const {
+	return (pEntry->nPid == (uint16_t) ((p->param_id[0] << 8) | p->param_id[1]))
+			&& (pEntry->nSubDevice == (uint16_t) ((p->sub_device[0] << 8) | p->sub_device[1]))
+			&& (pEntry->nPdl == p->param_data_length)
+			&& (memcmp(pEntry->uid, p->destination_uid, RDM_UID_SIZE) == 0)
+			&& (memcmp(pEntry->pd, p->param_data, p->param_data_length) == 0);
+}
+
+const uint8_t *RDMResponseCache::Get(uint8_t nPort, const uint8_t *pRdmDataNoSc) {
+	if ((nPort >= m_nPorts) || (m_pPorts[nPort].pEntries == 0) || !IsCacheable(pRdmDataNoSc)) {
+		return 0;
+	}
+
+	struct TRdmResponseCachePort *pPort = &m_pPorts[nPort];
+	const struct TRdmMessageNoSc *p = (const struct TRdmMessageNoSc *) pRdmDataNoSc;
+	const uint32_t nHash = Hash(p);
+
+	for (uint32_t i = 0; i < RDM_RESPONSE_CACHE_PROBES; i++) {
+		struct TRdmResponseCacheEntry *pEntry = &pPort->pEntries[(nHash + i) & (pPort->nEntries - 1)];
+
+		if (!IsValid(pPort, pEntry) || !IsMatch(pEntry, p)) {
+			continue;
+		}
+
+		if ((Hardware::Get()->Millis() - pEntry->nMillis) >= RDM_RESPONSE_CACHE_MAX_AGE) {
+			pEntry->nPid = 0;
+			break;
+		}
+
+		struct TRdmMessage *pResponse = (struct TRdmMessage *) m_Response;
+
+		pResponse->start_code = E120_SC_RDM;
+		pResponse->sub_start_code = E120_SC_SUB_MESSAGE;
+		pResponse->message_length = RDM_MESSAGE_MINIMUM_SIZE + pEntry->nResponsePdl;
+		memcpy(pResponse->destination_uid, p->source_uid, RDM_UID_SIZE);
+		memcpy(pResponse->source_uid, p->destination_uid, RDM_UID_SIZE);
+		pResponse->transaction_number = p->transaction_number;
+		pResponse->slot16.response_type = E120_RESPONSE_TYPE_ACK;
+		pResponse->message_count = 0;
+		pResponse->sub_device[0] = p->sub_device[0];
+		pResponse->sub_device[1] = p->sub_device[1];
+		pResponse->command_class = E120_GET_COMMAND_RESPONSE;
+		pResponse->param_id[0] = p->param_id[0];
+		pResponse->param_id[1] = p->param_id[1];
+		pResponse->param_data_length = pEntry->nResponsePdl;
+		memcpy(pResponse->param_data, &pPort->pData[pEntry->nPosition & (pPort->nDataSize - 1)], pEntry->nResponsePdl);
+
+		uint16_t nChecksum = 0;
+		uint32_t nIndex;
+
+		for (nIndex = 0; nIndex < pResponse->message_length; nIndex++) {
+			nChecksum += m_Response[nIndex];
+		}
+
+		m_Response[nIndex++] = (uint8_t) (nChecksum >> 8);
+		m_Response[nIndex] = (uint8_t) (nChecksum & 0xFF);
+
+		m_nHits++;
+		return m_Response;
+	}
+
+	m_nMisses++;
+	return 0;
+}
+
+void RDMResponseCache::Put(uint8_t nPort, const uint8_t *pRdmDataNoSc, const uint8_t *pResponse) {
+	if ((nPort >= m_nPorts) || (pResponse == 0) || !IsCacheable(pRdmDataNoSc)) {
+		return;
+	}
+
+	const struct TRdmMessageNoSc *p = (const struct TRdmMessageNoSc *) pRdmDataNoSc;
+	const struct TRdmMessage *pRdmResponse = (const struct TRdmMessage *) pResponse;
+
+	// Only a response which can be built from the request and the parameter data
+	if ((pRdmResponse->command_class != E120_GET_COMMAND_RESPONSE)
+			|| (pRdmResponse->slot16.response_type != E120_RESPONSE_TYPE_ACK)
+			|| (pRdmResponse->message_count != 0)
+			|| (pRdmResponse->message_length != (RDM_MESSAGE_MINIMUM_SIZE + pRdmResponse->param_data_length))
+			|| (pRdmResponse->param_id[0] != p->param_id[0]) || (pRdmResponse->param_id[1] != p->param_id[1])
+			|| (pRdmResponse->sub_device[0] != p->sub_device[0]) || (pRdmResponse->sub_device[1] != p->sub_device[1])
+			|| (memcmp(pRdmResponse->source_uid, p->destination_uid, RDM_UID_SIZE) != 0)) {
+		return;
+	}
+
+	struct TRdmResponseCachePort *pPort = &m_pPorts[nPort];
+
+	if (pPort->pEntries == 0) {
+		DEBUG_PRINTF("nPort=%d", nPort);
+
+		pPort->pEntries = new struct TRdmResponseCacheEntry[pPort->nEntries];
+		pPort->pData = new uint8_t[pPort->nDataSize];
+
+		if ((pPort->pEntries == 0) || (pPort->pData == 0)) {
+			DEBUG_PUTS("Not cached");
+			Free(pPort);
+			return;
+		}
+
+		for (uint32_t i = 0; i < pPort->nEntries; i++) {
+			pPort->pEntries[i].nPid = 0;
+		}
+	}
+
+	const uint32_t nHash = Hash(p);
+	const uint32_t nMillis = Hardware::Get()->Millis();
+	struct TRdmResponseCacheEntry *pEntry = 0;
+
+	for (uint32_t i = 0; i < RDM_RESPONSE_CACHE_PROBES; i++) {
+		struct TRdmResponseCacheEntry *pProbe = &pPort->pEntries[(nHash + i) & (pPort->nEntries - 1)];
+
+		if (!IsValid(pPort, pProbe) || IsMatch(pProbe, p)) {
+			pEntry = pProbe;
+			break;
+		}
+
+		// Replace the oldest
+		if ((pEntry == 0) || ((nMillis - pProbe->nMillis) > (nMillis - pEntry->nMillis))) {
+			pEntry = pProbe;
+		}
+	}
+
+	const uint32_t nLength = pRdmResponse->param_data_length;
+
+	// The parameter data is not split at the end of the ring
+	if (((pPort->nPosition & (pPort->nDataSize - 1)) + nLength) > pPort->nDataSize) {
+		pPort->nPosition = (pPort->nPosition + pPort->nDataSize) & ~(pPort->nDataSize - 1);
+	}
+
+	memcpy(pEntry->uid, p->destination_uid, RDM_UID_SIZE);
+	pEntry->nPdl = p->param_data_length;
+	pEntry->nResponsePdl = (uint8_t) nLength;
+	pEntry->nSubDevice = (uint16_t) ((p->sub_device[0] << 8) | p->sub_device[1]);
+	pEntry->nPid = (uint16_t) ((p->param_id[0] << 8) | p->param_id[1]);
+	memcpy(pEntry->pd, p->param_data, p->param_data_length);
+	pEntry->nMillis = nMillis;
+	pEntry->nPosition = pPort->nPosition;
+
+	memcpy(&pPort->pData[pPort->nPosition & (pPort->nDataSize - 1)], pRdmResponse->param_data, nLength);
+	pPort->nPosition += nLength;
+}
+
+/**
+ * A (manufacturer) broadcast UID invalidates all the (manufacturer) entries of the port
+ */
+void RDMResponseCache::Invalidate(uint8_t nPort, const uint8_t *pUid) {
+	if ((nPort >= m_nPorts) || (m_pPorts[nPort].pEntries == 0)) {
+		return;
+	}
+
+	const bool bIsBroadcast = is_broadcast(pUid);
+
+	if (bIsBroadcast && (pUid[0] == 0xFF) && (pUid[1] == 0xFF)) {
+		Invalidate(nPort);
+		return;
+	}
+
+	struct TRdmResponseCacheEntry *pEntries = m_pPorts[nPort].pEntries;
+
+	for (uint32_t i = 0; i < m_pPorts[nPort].nEntries; i++) {
+		struct TRdmResponseCacheEntry *pEntry = &pEntries[i];
+
+		if (pEntry->nPid == 0) {
+			continue;
+		}
+
+		if ((bIsBroadcast && (pEntry->uid[0] == pUid[0]) && (pEntry->uid[1] == pUid[1]))
+				|| (memcmp(pEntry->uid, pUid, RDM_UID_SIZE) == 0)) {
+			pEntry->nPid = 0;
+		}
+	}
+}
+
+/**
+ * Moving the write position a full ring ahead makes all the entries invalid
+ */
+void RDMResponseCache::Invalidate(uint8_t nPort) {
+	DEBUG_PRINTF("nPort=%d", nPort);
+
+	if (nPort < m_nPorts) {
+		m_pPorts[nPort].nPosition += m_pPorts[nPort].nDataSize + 1;
+	}
+}
+
+void RDMResponseCache::Print(void) {
+	printf("RDM response cache\n");
+
+	for (uint32_t nPort = 0; nPort < m_nPorts; nPort++) {
+		const struct TRdmResponseCachePort *pPort = &m_pPorts[nPort];
+
+		if (pPort->pEntries == 0) {
+			continue;
+		}
+
+		uint32_t nUsed = 0;
+
+		for (uint32_t i = 0; i < pPort->nEntries; i++) {
+			if (IsValid(pPort, &pPort->pEntries[i])) {
+				nUsed++;
+			}
+		}
+
+		printf(" Port %d  : %d/%d, %u bytes\n", (int) nPort, (int) nUsed, (int) pPort->nEntries, (unsigned) GetMemorySize(nPort));
+	}
+
+	printf(" Hits    : %u\n", (unsigned) m_nHits);
+	printf(" Misses  : %u\n", (unsigned) m_nMisses);
+}
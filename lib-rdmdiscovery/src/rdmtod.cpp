@@ -29,19 +29,15 @@
 #ifndef NDEBUG
  #include <stdio.h>
 #endif
+#include <assert.h>
 
 #include "rdmtod.h"
 
-#ifndef ALIGNED
- #define ALIGNED __attribute__ ((aligned (4)))
-#endif
-
 RDMTod::RDMTod(void) : m_nEntries(0) {
 	m_pTable = new TRdmTod[TOD_TABLE_SIZE];
+	assert(m_pTable != 0);
 
-	for (uint32_t i = 0 ; i < TOD_TABLE_SIZE; i++) {
-		memcpy(&m_pTable[i], UID_ALL, RDM_UID_SIZE);
-	}
+	ClearChanged();
 }
 
 RDMTod::~RDMTod(void) {
@@ -49,24 +45,43 @@ RDMTod::~RDMTod(void) {
 	delete[] m_pTable;
 }
 
-uint8_t RDMTod::GetUidCount(void) const {
-	return m_nEntries;
-}
+/**
+ * Binary search, nIndex is the position of the UID, or where it should be inserted
+ */
+bool RDMTod::Find(const uint8_t *pUid, uint16_t &nIndex) const {
+	uint32_t nLow = 0;
+	uint32_t nHigh = m_nEntries;
+
+	while (nLow < nHigh) {
+		const uint32_t nMiddle = (nLow + nHigh) / 2;
+		const int nCompare = memcmp(m_pTable[nMiddle].uid, pUid, RDM_UID_SIZE);
 
-bool RDMTod::Exist(const uint8_t *pUid) {
-	for (uint32_t i = 0 ; i < m_nEntries; i++) {
-		if (memcmp(&m_pTable[i], pUid, RDM_UID_SIZE) == 0) {
+		if (nCompare == 0) {
+			nIndex = nMiddle;
 			return true;
 		}
+
+		if (nCompare < 0) {
+			nLow = nMiddle + 1;
+		} else {
+			nHigh = nMiddle;
+		}
 	}
 
+	nIndex = nLow;
 	return false;
 }
 
-void RDMTod::Dump(uint8_t nCount) {
+bool RDMTod::Exist(const uint8_t *pUid) const {
+	uint16_t nIndex;
+
+	return Find(pUid, nIndex);
+}
+
+void RDMTod::Dump(uint16_t nCount) {
 #ifndef NDEBUG
-	if (nCount > TOD_TABLE_SIZE) {
-		nCount = TOD_TABLE_SIZE;
+	if (nCount > m_nEntries) {
+		nCount = m_nEntries;
 	}
 
 	for (uint32_t i = 0 ; i < nCount; i++) {
@@ -86,55 +101,71 @@ bool RDMTod::AddUid(const uint8_t *pUid) {
 		return false;
 	}
 
-	if (Exist(pUid)) {
+	uint16_t nIndex;
+
+	if (Find(pUid, nIndex)) {
 		return false;
 	}
 
-	memcpy(&m_pTable[m_nEntries++], pUid, RDM_UID_SIZE);
+	memmove(&m_pTable[nIndex + 1], &m_pTable[nIndex], (m_nEntries - nIndex) * sizeof(struct TRdmTod));
+	memcpy(&m_pTable[nIndex], pUid, RDM_UID_SIZE);
+
+	m_nEntries++;
+	m_nAdded++;
+	SetChanged(nIndex);
+	SetChangedUid(pUid);
 
 	return true;
 }
 
 bool RDMTod::Delete(const uint8_t *pUid) {
-	bool found = false;
-	uint32_t i;
+	uint16_t nIndex;
 
-	for (i = 0 ; i < m_nEntries; i++) {
-		if (memcmp(&m_pTable[i], pUid, RDM_UID_SIZE) == 0) {
-			found = true;
-			break;
-		}
-	}
-
-	if (!found) {
+	if (!Find(pUid, nIndex)) {
 		return false;
 	}
 
-	if (i == TOD_TABLE_SIZE - 1) {
-		memcpy(&m_pTable[i], UID_ALL, RDM_UID_SIZE);
-	} else {
-		for (; i < m_nEntries; i++) {
-			memcpy(&m_pTable[i], &m_pTable[i + 1], RDM_UID_SIZE);
-		}
-	}
+	// Before the move, pUid could be a table entry
+	SetChangedUid(pUid);
 
 	m_nEntries--;
 
+	memmove(&m_pTable[nIndex], &m_pTable[nIndex + 1], (m_nEntries - nIndex) * sizeof(struct TRdmTod));
+
+	m_nRemoved++;
+	SetChanged(nIndex);
+
 	return true;
 }
 
-void RDMTod::Copy(uint8_t *pTable) {
-	const uint8_t *src = (const uint8_t *) m_pTable;
-	uint8_t *dst = (uint8_t *) pTable;
+uint16_t RDMTod::Copy(uint8_t *pTable, uint16_t nIndex, uint16_t nCount) const {
+	if (nIndex >= m_nEntries) {
+		return 0;
+	}
 
-	for (uint32_t i = 0; i < (m_nEntries * RDM_UID_SIZE); i++) {
-		*dst++ = *src++;
+	if (nCount > (m_nEntries - nIndex)) {
+		nCount = m_nEntries - nIndex;
 	}
+
+	memcpy(pTable, &m_pTable[nIndex], nCount * sizeof(struct TRdmTod));
+
+	return nCount;
+}
+
+const uint8_t *RDMTod::GetTodEntry(uint16_t nIndex) const {
+	if (nIndex >= m_nEntries) {
+		return 0;
+	}
+
+	return m_pTable[nIndex].uid;
 }
 
 void RDMTod::Reset(void) {
-	for (uint32_t i = 0 ; i < m_nEntries; i++) {
-		memcpy(&m_pTable[i], UID_ALL, RDM_UID_SIZE);
+	if (m_nEntries != 0) {
+		m_nRemoved += m_nEntries;
+		SetChanged(0);
+		// The removed UID's are not kept
+		m_nChangedUids = TOD_CHANGED_SIZE + 1;
 	}
 
 	m_nEntries = 0;
@@ -0,0 +1,204 @@
+#!/usr/bin/env python3
+#
+# Stand-in E1.33 broker for testing the BrokerClient of the dummy_device.
+# It accepts one RPT Device, checks the Client Connect, runs a few functional
+# checks and then measures the GET/SET throughput.
+#
+# Usage: broker.py port [duration_s] [window] [mode]
+#   window  the number of RPT Requests kept outstanding
+#   mode    ok          functional checks and throughput
+#           refuse      answer the Client Connect with a refusal
+#           disconnect  ok, then send a Broker Disconnect
+#           redirect:N  send a Redirect V4 to 127.0.0.1:N, then wait for the device to return
+#           heartbeat   only answer the Client Connect and print what the device sends
+#
+
+import socket
+import struct
+import sys
+import time
+import uuid
+
+PORT = int(sys.argv[1])
+DURATION = float(sys.argv[2]) if len(sys.argv) > 2 else 3
+WINDOW = int(sys.argv[3]) if len(sys.argv) > 3 else 16
+MODE = sys.argv[4] if len(sys.argv) > 4 else 'ok'
+
+ACN_PACKET_IDENTIFIER = b"ASC-E1.17\0\0\0"
+CID = uuid.uuid4().bytes
+BROKER_UID = bytes.fromhex('7a7000000001')
+CONTROLLER_UID = bytes.fromhex('7a7000000002')
+
+VECTOR_ROOT_RPT = 5
+VECTOR_ROOT_BROKER = 9
+VECTOR_BROKER_CONNECT = 1
+VECTOR_BROKER_CONNECT_REPLY = 2
+VECTOR_BROKER_REDIRECT_V4 = 4
+VECTOR_BROKER_NULL = 15
+VECTOR_BROKER_DISCONNECT = 14
+VECTOR_RPT_STATUS = 2
+VECTOR_RPT_NOTIFICATION = 3
+
+
+def flags_length(n):
+    return bytes([0xF0 | ((n >> 16) & 0x0F), (n >> 8) & 0xFF, n & 0xFF])
+
+
+def get_length(b):
+    return ((b[0] & 0x0F) << 16) | (b[1] << 8) | b[2]
+
+
+def root_layer(vector, data):
+    pdu = flags_length(23 + len(data)) + struct.pack('>I', vector) + CID + data
+    return ACN_PACKET_IDENTIFIER + struct.pack('>I', len(pdu)) + pdu
+
+
+def broker_message(vector, data=b''):
+    return root_layer(VECTOR_ROOT_BROKER, flags_length(5 + len(data)) + struct.pack('>H', vector) + data)
+
+
+def rdm_command(destination, command_class, pid, pd=b'', tn=0):
+    message = bytes([0xCC, 0x01, 24 + len(pd)]) + destination + CONTROLLER_UID + bytes([tn, 1, 0, 0, 0, command_class]) + struct.pack('>H', pid) + bytes([len(pd)]) + pd
+    # Without the START Code, with the checksum
+    return message[1:] + struct.pack('>H', sum(message) & 0xFFFF)
+
+
+def rpt_request(destination, sequence, rdm_data, endpoint=0):
+    command = flags_length(4 + len(rdm_data)) + b'\xcc' + rdm_data
+    request = flags_length(7 + len(command)) + struct.pack('>I', 1) + command
+    rpt = flags_length(28 + len(request)) + struct.pack('>I', 1) + CONTROLLER_UID + struct.pack('>H', 0) + destination + struct.pack('>HIB', endpoint, sequence, 0) + request
+    return root_layer(VECTOR_ROOT_RPT, rpt)
+
+
+def messages(connection):
+    buffer = b''
+    while True:
+        while len(buffer) >= 16:
+            assert buffer[:12] == ACN_PACKET_IDENTIFIER, buffer[:16].hex()
+            n = struct.unpack('>I', buffer[12:16])[0]
+            if len(buffer) < 16 + n:
+                break
+            yield buffer[16:16 + n]
+            buffer = buffer[16 + n:]
+        data = connection.recv(65536)
+        if not data:
+            return
+        buffer += data
+
+
+def accept_client(server):
+    connection, _ = server.accept()
+    connection.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    it = messages(connection)
+    m = next(it)
+    assert struct.unpack('>I', m[3:7])[0] == VECTOR_ROOT_BROKER and struct.unpack('>H', m[26:28])[0] == VECTOR_BROKER_CONNECT, m[:30].hex()
+    client_connect = m[28:]
+    scope = client_connect[:63].rstrip(b'\0').decode()
+    version = struct.unpack('>H', client_connect[63:65])[0]
+    domain = client_connect[65:296].rstrip(b'\0').decode()
+    client_entry = client_connect[297:]
+    assert get_length(client_entry) == len(client_entry) == 46, len(client_entry)
+    uid = client_entry[23:29]
+    print('Client Connect scope=%s version=%d domain=%s uid=%s type=%d' % (scope, version, domain, uid.hex(), client_entry[29]), flush=True)
+    return connection, it, uid
+
+
+def connect_reply(connection, uid, code=0):
+    connection.sendall(broker_message(VECTOR_BROKER_CONNECT_REPLY, struct.pack('>HH', code, 1) + BROKER_UID + uid))
+
+
+def functional_checks(connection, it, uid):
+    checks = [
+        ('GET DEVICE_INFO', rdm_command(uid, 0x20, 0x0060), 0),
+        ('GET DEVICE_LABEL', rdm_command(uid, 0x20, 0x0082), 0),
+        ('SET IDENTIFY', rdm_command(uid, 0x30, 0x1000, b'\x00'), 0),
+        ('Unknown endpoint', rdm_command(uid, 0x20, 0x0060), 3),
+        ('Broadcast', rdm_command(b'\xff\xff\xff\xff\xff\xff', 0x30, 0x1000, b'\x00'), 0),
+    ]
+    sequence = 100
+    for name, data, endpoint in checks:
+        sequence += 1
+        connection.sendall(rpt_request(uid, sequence, data, endpoint))
+        m = next(it)
+        rpt = m[23:]
+        rpt_vector = struct.unpack('>I', rpt[3:7])[0]
+        assert struct.unpack('>I', m[3:7])[0] == VECTOR_ROOT_RPT and rpt[7:13] == uid and rpt[15:21] == CONTROLLER_UID and struct.unpack('>I', rpt[23:27])[0] == sequence, (name, m.hex())
+        if rpt_vector == VECTOR_RPT_NOTIFICATION:
+            notification = rpt[28:]
+            command_pdu = notification[7:]
+            response_pdu = command_pdu[get_length(command_pdu):]
+            assert command_pdu[4:get_length(command_pdu)] == data, name
+            response = response_pdu[4:get_length(response_pdu)]
+            print('%-18s Notification cc=%02x pid=%04x response_type=%d pdl=%d' % (name, response[19], struct.unpack('>H', response[20:22])[0], response[15], response[22]))
+        else:
+            assert rpt_vector == VECTOR_RPT_STATUS, (name, m.hex())
+            print('%-18s Status %d' % (name, struct.unpack('>H', rpt[31:33])[0]))
+
+
+def throughput(connection, it, uid):
+    sequence = 1000
+
+    def request(i):
+        if i % 2 == 0:
+            return rpt_request(uid, sequence + i, rdm_command(uid, 0x20, 0x0060, tn=i & 0xFF))
+        return rpt_request(uid, sequence + i, rdm_command(uid, 0x30, 0x1000, bytes([i & 1]), tn=i & 0xFF))
+
+    sent = 0
+    received = 0
+    t0 = time.time()
+    for _ in range(WINDOW):
+        connection.sendall(request(sent))
+        sent += 1
+    while time.time() - t0 < DURATION:
+        m = next(it)
+        rpt = m[23:]
+        assert struct.unpack('>I', rpt[3:7])[0] == VECTOR_RPT_NOTIFICATION, m.hex()
+        assert struct.unpack('>I', rpt[23:27])[0] == sequence + received
+        received += 1
+        connection.sendall(request(sent))
+        sent += 1
+    dt = time.time() - t0
+    print('Throughput: %d GET/SET in %.2f s = %.0f requests/s (window %d, latency %.0f us)' % (received, dt, received / dt, WINDOW, 1e6 * dt / received * WINDOW), flush=True)
+
+
+server = socket.socket()
+server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+server.bind(('127.0.0.1', PORT))
+server.listen(1)
+print('Broker listening on port %d, mode %s' % (PORT, MODE), flush=True)
+
+connection, it, uid = accept_client(server)
+
+if MODE == 'refuse':
+    connect_reply(connection, uid, 1)
+    time.sleep(0.5)
+    connection.close()
+    sys.exit(0)
+
+connect_reply(connection, uid)
+
+if MODE.startswith('redirect:'):
+    connection.sendall(broker_message(VECTOR_BROKER_REDIRECT_V4, socket.inet_aton('127.0.0.1') + struct.pack('>H', int(MODE.split(':')[1]))))
+    t0 = time.time()
+    connection.close()
+    connection, it, uid = accept_client(server)
+    print('Device returned after %.1f s' % (time.time() - t0), flush=True)
+    connect_reply(connection, uid)
+    MODE = 'ok'
+
+if MODE == 'heartbeat':
+    t0 = time.time()
+    for m in it:
+        vector = struct.unpack('>H', m[26:28])[0]
+        print('%.1f s %s' % (time.time() - t0, 'Broker NULL' if vector == VECTOR_BROKER_NULL else 'vector %04x' % vector), flush=True)
+    print('%.1f s closed by the device' % (time.time() - t0))
+    sys.exit(0)
+
+functional_checks(connection, it, uid)
+throughput(connection, it, uid)
+
+if MODE == 'disconnect':
+    connection.sendall(broker_message(VECTOR_BROKER_DISCONNECT, struct.pack('>H', 4)))
+    time.sleep(0.2)
+
+connection.close()
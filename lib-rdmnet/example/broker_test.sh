@@ -0,0 +1,41 @@
+#!/bin/bash
+#
+# Runs the dummy_device against the stand-in broker.py on the loopback interface:
+# functional checks, throughput with 1 and 64 requests outstanding, reconnect
+# after a refusal and after a Broker Disconnect, and the return to the configured
+# broker when a redirected broker does not answer.
+# With the argument heartbeat only the heartbeat timing is checked (takes ~50 s).
+#
+# Build the dummy_device first with make.
+#
+
+PORT=${PORT:-20500}
+UNUSED_PORT=$((PORT + 1))
+
+cd "$(dirname "$0")"
+
+if [ "$1" == "heartbeat" ]; then
+	python3 broker.py $PORT 0 0 heartbeat &
+	sleep 0.3
+	timeout 55 stdbuf -oL ./dummy_device lo 127.0.0.1 $PORT > dummy_device.log 2>&1
+	wait
+	exit 0
+fi
+
+python3 broker.py $PORT 3 1 &
+sleep 0.3
+timeout 40 stdbuf -oL ./dummy_device lo 127.0.0.1 $PORT > dummy_device.log 2>&1 &
+DEVICE=$!
+wait %1
+
+sleep 0.5
+python3 broker.py $PORT 3 64
+sleep 0.5
+python3 broker.py $PORT 1 4 refuse
+python3 broker.py $PORT 1 4 disconnect
+python3 broker.py $PORT 1 4 redirect:$UNUSED_PORT
+
+kill $DEVICE 2>/dev/null
+wait
+
+grep -E "Connected|refused|disconnect|Redirected|Returning" dummy_device.log
@@ -27,6 +27,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
+#include <arpa/inet.h>
 
 #include "hardware.h"
 #include "networklinux.h"
@@ -50,7 +51,7 @@ int main(int argc, char **argv) {
 	FirmwareVersion fw(SOFTWARE_VERSION, __DATE__, __TIME__);
 
 	if (argc < 2) {
-		printf("Usage: %s ip_address|interface_name\n", argv[0]);
+		printf("Usage: %s ip_address|interface_name [broker_ip_address broker_port]\n", argv[0]);
 		return -1;
 	}
 
@@ -79,6 +80,17 @@ int main(int argc, char **argv) {
 		rdmDeviceParams.Dump();
 	}
 
+	if (argc >= 4) {
+		struct in_addr addr;
+
+		if (inet_aton(argv[2], &addr) == 0) {
+			fprintf(stderr, "Invalid broker address %s\n", argv[2]);
+			return -1;
+		}
+
+		device.SetBroker(addr.s_addr, (uint16_t) atoi(argv[3]));
+	}
+
 	device.Init();
 	device.Print();
 	device.Start();
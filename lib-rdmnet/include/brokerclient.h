@@ -0,0 +1,140 @@
+/**
+ * @file brokerclient.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BROKERCLIENT_H_
+#define BROKERCLIENT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "e133.h"
+
+#define BROKER_CLIENT_BACKOFF_MIN_MS		1000	///< First reconnect delay
+#define BROKER_CLIENT_BACKOFF_MAX_MS		30000	///< The delay doubles after each failure up to this limit
+#define BROKER_CLIENT_CONNECT_TIMEOUT_MS	5000	///< For the TCP connect and for the Connect Reply
+#define BROKER_CLIENT_BUFFER_SIZE			1024
+#define BROKER_CLIENT_RECEIVE_ROUNDS		8		///< Upper limit for the recv calls in one Run()
+#define BROKER_CLIENT_REDIRECT_ATTEMPTS		3		///< Failed attempts at a redirected broker before returning to the configured one
+
+enum TBrokerClientState {
+	BROKER_CLIENT_STATE_IDLE,
+	BROKER_CLIENT_STATE_BACKOFF,
+	BROKER_CLIENT_STATE_CONNECTING,
+	BROKER_CLIENT_STATE_HANDSHAKE,
+	BROKER_CLIENT_STATE_CONNECTED
+};
+
+/**
+ * Non-blocking E1.33 RPT Device client. Run() does not wait for the network:
+ * the TCP connect, the Client Connect handshake, the heartbeats and the
+ * RDM request routing are all stepped from the main loop.
+ */
+class BrokerClient {
+public:
+	BrokerClient(void);
+	virtual ~BrokerClient(void);
+
+	void SetBroker(uint32_t nIp, uint16_t nPort);
+	void SetScope(const char *pScope);
+
+	void Start(void);
+	void Stop(void);
+	void Run(void);
+
+	void Print(void);
+
+	bool IsConnected(void) const {
+		return m_tState == BROKER_CLIENT_STATE_CONNECTED;
+	}
+
+	uint32_t GetRdmRequests(void) const {
+		return m_nRdmRequests;
+	}
+
+	uint32_t GetConnects(void) const {
+		return m_nConnects;
+	}
+
+	/**
+	 * For a poll() together with the other sockets of the main loop.
+	 * The socket is -1 when there is no connection, poll() then ignores it.
+	 */
+	int GetSocket(void) const {
+		return m_nSocket;
+	}
+
+	short GetPollEvents(void) const;
+
+protected:
+	virtual void CopyUID(uint8_t *pUID);
+	virtual void CopyCID(uint8_t *pCID);
+	virtual uint8_t *BrokerHandleRdmCommand(const uint8_t *pRdmDataNoSC);
+
+private:
+	void Connect(void);
+	void Close(void);
+	void Fail(void);
+
+	uint8_t *PrepareRootLayer(uint32_t nVector, uint32_t nLength);
+	void Send(uint32_t nLength);
+	bool Flush(void);
+	bool Receive(void);
+
+	void SendClientConnect(void);
+	void SendBrokerMessage(uint16_t nVector, const uint8_t *pData = 0, uint32_t nDataLength = 0);
+	void SendRptStatus(const uint8_t *pRptRequest, uint16_t nStatus);
+	void SendRptNotification(const uint8_t *pRptRequest, const uint8_t *pRdmCommandNoSC, uint32_t nCommandLength, const uint8_t *pRdmReply);
+
+	void HandleBlock(const uint8_t *pBlock, uint32_t nLength);
+	void HandleBrokerPDU(const uint8_t *pPDU, uint32_t nLength);
+	void HandleRptPDU(const uint8_t *pPDU, uint32_t nLength);
+
+private:
+	uint32_t m_nConfiguredIp;
+	uint16_t m_nConfiguredPort;
+	uint32_t m_nBrokerIp;
+	uint16_t m_nBrokerPort;
+	uint32_t m_nRedirectFailures;
+	bool m_bIsRedirected;
+	char m_aScope[E133_SCOPE_STRING_PADDED_LENGTH];
+	int m_nSocket;
+	TBrokerClientState m_tState;
+	uint32_t m_nStateMillis;
+	uint32_t m_nBackoffMillis;
+	uint32_t m_nLastSendMillis;
+	uint32_t m_nLastReceiveMillis;
+	uint8_t m_aUID[6];
+	uint8_t m_aCid[16];
+	uint8_t m_aBrokerUID[6];
+	uint8_t *m_pRxBuffer;
+	uint32_t m_nRxLength;
+	uint32_t m_nRxDiscard;
+	uint8_t *m_pTxBuffer;
+	uint32_t m_nTxLength;
+	uint32_t m_nRdmRequests;
+	uint32_t m_nConnects;
+};
+
+#endif /* BROKERCLIENT_H_ */
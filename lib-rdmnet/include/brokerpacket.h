@@ -0,0 +1,162 @@
+/**
+ * @file brokerpacket.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BROKERPACKET_H_
+#define BROKERPACKET_H_
+
+#include <stdint.h>
+
+#include "llrppacket.h"
+#include "e133.h"
+
+#if  ! defined (PACKED)
+#define PACKED __attribute__((packed))
+#endif
+
+/**
+ * 6.1 ACN TCP Preamble
+ */
+struct TTcpPreAmble {
+	uint8_t ACNPacketIdentifier[12];	///< ACN Packet Identifier
+	uint32_t RLPBlockSize;				///< Length of the Root Layer PDU block that follows
+}PACKED;
+
+struct TBrokerPDU {
+	uint8_t FlagsLength[3];				///< Protocol flags and length. Low 20 bits = PDU length High 4 bits = 0xF
+	uint16_t Vector;					///< Identifies the Broker message. See Table A-7
+}PACKED;
+
+/**
+ * 6.3.1.1 RPT Client Entry
+ */
+struct TClientEntryPDU {
+	uint8_t FlagsLength[3];				///< Protocol flags and length. Low 20 bits = PDU length High 4 bits = 0xF
+	uint32_t Vector;					///< Client Protocol -> E133_CLIENT_PROTOCOL_RPT
+	uint8_t Cid[16];					///< The Client's CID
+	uint8_t UID[6];						///< The Client's UID
+	uint8_t Type;						///< RPT Client Type
+	uint8_t BindingCid[16];				///< Binding CID
+}PACKED;
+
+/**
+ * 6.3.1.2 Client Connect Message
+ */
+struct TBrokerClientConnect {
+	uint8_t Scope[E133_SCOPE_STRING_PADDED_LENGTH];
+	uint16_t Version;
+	uint8_t SearchDomain[E133_DOMAIN_STRING_PADDED_LENGTH];
+	uint8_t ConnectionFlags;
+	struct TClientEntryPDU ClientEntry;
+}PACKED;
+
+/**
+ * 6.3.1.3 Connect Reply Message
+ */
+struct TBrokerConnectReply {
+	uint16_t ConnectionCode;
+	uint16_t Version;
+	uint8_t BrokerUID[6];
+	uint8_t ClientUID[6];
+}PACKED;
+
+/**
+ * 6.3.1.5 Client Redirect IPv4 Message
+ */
+struct TBrokerRedirectV4 {
+	uint32_t IpAddress;
+	uint16_t Port;
+}PACKED;
+
+/**
+ * 6.3.1.9 Disconnect Message
+ */
+struct TBrokerDisconnect {
+	uint16_t DisconnectReason;
+}PACKED;
+
+/**
+ * 7.5 RPT PDU
+ */
+struct TRptPDU {
+	uint8_t FlagsLength[3];				///< Protocol flags and length. Low 20 bits = PDU length High 4 bits = 0xF
+	uint32_t Vector;					///< See Table A-8
+	uint8_t SourceUID[6];
+	uint16_t SourceEndpoint;
+	uint8_t DestinationUID[6];
+	uint16_t DestinationEndpoint;
+	uint32_t SequenceNumber;
+	uint8_t Reserved;
+}PACKED;
+
+/**
+ * 7.5.2 Request PDU, 7.5.4 Notification PDU
+ */
+struct TRptRdmPDU {
+	uint8_t FlagsLength[3];				///< Protocol flags and length. Low 20 bits = PDU length High 4 bits = 0xF
+	uint32_t Vector;					///< VECTOR_REQUEST_RDM_CMD or VECTOR_NOTIFICATION_RDM_CMD
+}PACKED;
+
+/**
+ * 7.5.3 RPT Status PDU
+ */
+struct TRptStatusPDU {
+	uint8_t FlagsLength[3];				///< Protocol flags and length. Low 20 bits = PDU length High 4 bits = 0xF
+	uint16_t Vector;					///< See Table A-10
+}PACKED;
+
+struct TBrokerCommonPacket {
+	struct TTcpPreAmble TcpPreAmble;
+	struct TRootLayerPDU RootLayerPDU;
+}PACKED;
+
+struct TBrokerMessagePacket {
+	struct TBrokerCommonPacket Common;
+	struct TBrokerPDU BrokerPDU;
+}PACKED;
+
+struct TBrokerClientConnectPacket {
+	struct TBrokerCommonPacket Common;
+	struct TBrokerPDU BrokerPDU;
+	struct TBrokerClientConnect ClientConnect;
+}PACKED;
+
+struct TRptStatusPacket {
+	struct TBrokerCommonPacket Common;
+	struct TRptPDU RptPDU;
+	struct TRptStatusPDU StatusPDU;
+}PACKED;
+
+/**
+ * The RDM Command PDUs follow the Notification PDU header
+ */
+struct TRptNotificationPacket {
+	struct TBrokerCommonPacket Common;
+	struct TRptPDU RptPDU;
+	struct TRptRdmPDU NotificationPDU;
+}PACKED;
+
+#define RDM_COMMAND_PDU_HEADER_SIZE	(sizeof(struct TRDMCommandPDU) - 232)
+
+#endif /* BROKERPACKET_H_ */
@@ -42,6 +42,10 @@ public:
 	void Print(void);
 
 protected:
+	int32_t GetHandle(void) const {
+		return m_nHandleLLRP;
+	}
+
 	virtual void CopyUID(uint8_t *pUID);
 	virtual void CopyCID(uint8_t *pCID);
 	virtual uint8_t *LLRPHandleRdmCommand(const uint8_t *pRdmDataNoSC);
@@ -31,12 +31,26 @@
 #include "rdmdeviceresponder.h"
 #include "llrpdevice.h"
 
+/*
+ * The broker client needs TCP, which only the Linux build has (src/linux)
+ */
+#if defined (__linux__)
+# define RDMNET_BROKER_CLIENT
+# include "brokerclient.h"
+#endif
+
+#define RDMNET_DEVICE_POLL_TIMEOUT_MS	1	///< Longest wait in Run() for the LLRP and the broker socket
+
 #include "rdmhandler.h"
 
 #include "e131.h"
 #include "e131uuid.h"
 
+#if defined (RDMNET_BROKER_CLIENT)
+class RDMNetDevice: public RDMDeviceResponder, LLRPDevice, BrokerClient {
+#else
 class RDMNetDevice: public RDMDeviceResponder, LLRPDevice {
+#endif
 public:
 	RDMNetDevice(RDMPersonality *pRDMPersonality);
 	~RDMNetDevice(void);
@@ -47,10 +61,23 @@ public:
 
 	void Print(void);
 
+#if defined (RDMNET_BROKER_CLIENT)
+	void SetBroker(uint32_t nIp, uint16_t nPort) {
+		BrokerClient::SetBroker(nIp, nPort);
+	}
+
+	bool IsBrokerConnected(void) const {
+		return BrokerClient::IsConnected();
+	}
+#endif
+
 	void CopyUID(uint8_t *pUID) override;
 	void CopyCID(uint8_t *pCID) override;
 
 	uint8_t *LLRPHandleRdmCommand(const uint8_t *pRdmDataNoSC) override;
+#if defined (RDMNET_BROKER_CLIENT)
+	uint8_t *BrokerHandleRdmCommand(const uint8_t *pRdmDataNoSC) override;
+#endif
 
 private:
 	RDMHandler *m_RDMHandler;
@@ -0,0 +1,785 @@
+/**
+ * @file brokerclient.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <assert.h>
+
+#include "brokerclient.h"
+#include "brokerpacket.h"
+
+#include "e133.h"
+#include "rdm_e120.h"
+
+#include "hardware.h"
+#include "network.h"
+
+#include "debug.h"
+
+#define RDM_MESSAGE_NO_SC_MIN_LENGTH	25
+#define RDM_MESSAGE_NO_SC_MAX_LENGTH	256
+
+#define RPT_NOTIFICATION_SIZE_MAX	(sizeof(struct TRptNotificationPacket) + 2 * (RDM_COMMAND_PDU_HEADER_SIZE + RDM_MESSAGE_NO_SC_MAX_LENGTH))
+
+static void set_flags_length(uint8_t *pFlagsLength, uint32_t nLength) {
+	pFlagsLength[0] = (uint8_t) (0xF0 | ((nLength >> 16) & 0x0F));
+	pFlagsLength[1] = (uint8_t) (nLength >> 8);
+	pFlagsLength[2] = (uint8_t) nLength;
+}
+
+static uint32_t get_length(const uint8_t *pFlagsLength) {
+	return ((uint32_t) (pFlagsLength[0] & 0x0F) << 16) | ((uint32_t) pFlagsLength[1] << 8) | (uint32_t) pFlagsLength[2];
+}
+
+BrokerClient::BrokerClient(void) :
+	m_nConfiguredIp(0),
+	m_nConfiguredPort(0),
+	m_nBrokerIp(0),
+	m_nBrokerPort(0),
+	m_nRedirectFailures(0),
+	m_bIsRedirected(false),
+	m_nSocket(-1),
+	m_tState(BROKER_CLIENT_STATE_IDLE),
+	m_nStateMillis(0),
+	m_nBackoffMillis(0),
+	m_nLastSendMillis(0),
+	m_nLastReceiveMillis(0),
+	m_nRxLength(0),
+	m_nRxDiscard(0),
+	m_nTxLength(0),
+	m_nRdmRequests(0),
+	m_nConnects(0)
+{
+	DEBUG_ENTRY
+
+	SetScope(E133_DEFAULT_SCOPE);
+
+	memset(m_aUID, 0, sizeof(m_aUID));
+	memset(m_aCid, 0, sizeof(m_aCid));
+	memset(m_aBrokerUID, 0, sizeof(m_aBrokerUID));
+
+	m_pRxBuffer = new uint8_t[BROKER_CLIENT_BUFFER_SIZE];
+	assert(m_pRxBuffer != 0);
+
+	m_pTxBuffer = new uint8_t[BROKER_CLIENT_BUFFER_SIZE];
+	assert(m_pTxBuffer != 0);
+
+	DEBUG_EXIT
+}
+
+BrokerClient::~BrokerClient(void) {
+	DEBUG_ENTRY
+
+	Close();
+
+	delete [] m_pTxBuffer;
+	m_pTxBuffer = 0;
+
+	delete [] m_pRxBuffer;
+	m_pRxBuffer = 0;
+
+	DEBUG_EXIT
+}
+
+void BrokerClient::SetBroker(uint32_t nIp, uint16_t nPort) {
+	m_nConfiguredIp = nIp;
+	m_nConfiguredPort = nPort;
+}
+
+void BrokerClient::SetScope(const char *pScope) {
+	assert(pScope != 0);
+
+	strncpy(m_aScope, pScope, sizeof(m_aScope) - 1);
+	m_aScope[sizeof(m_aScope) - 1] = '\0';
+}
+
+void BrokerClient::Start(void) {
+	DEBUG_ENTRY
+
+	if ((m_nConfiguredIp == 0) || (m_nConfiguredPort == 0)) {
+		DEBUG_EXIT
+		return;
+	}
+
+	m_nBrokerIp = m_nConfiguredIp;
+	m_nBrokerPort = m_nConfiguredPort;
+	m_bIsRedirected = false;
+
+	CopyUID(m_aUID);
+	CopyCID(m_aCid);
+
+	m_nBackoffMillis = 0;
+	m_nStateMillis = Hardware::Get()->Millis();
+	m_tState = BROKER_CLIENT_STATE_BACKOFF;
+
+	DEBUG_EXIT
+}
+
+void BrokerClient::Stop(void) {
+	DEBUG_ENTRY
+
+	if (m_tState == BROKER_CLIENT_STATE_CONNECTED) {
+		const uint16_t nReason = __builtin_bswap16(E133_DISCONNECT_SHUTDOWN);
+		SendBrokerMessage(VECTOR_BROKER_DISCONNECT, (const uint8_t *) &nReason, sizeof(nReason));
+	}
+
+	Close();
+	m_tState = BROKER_CLIENT_STATE_IDLE;
+
+	DEBUG_EXIT
+}
+
+void BrokerClient::Connect(void) {
+	DEBUG_ENTRY
+
+	Close();
+
+	m_nStateMillis = Hardware::Get()->Millis();
+	m_nLastReceiveMillis = m_nStateMillis;
+
+	if ((m_nSocket = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
+		perror("socket");
+		Fail();
+		DEBUG_EXIT
+		return;
+	}
+
+	const int nFlags = fcntl(m_nSocket, F_GETFL, 0);
+
+	if ((nFlags < 0) || (fcntl(m_nSocket, F_SETFL, nFlags | O_NONBLOCK) < 0)) {
+		perror("fcntl(O_NONBLOCK)");
+		Fail();
+		DEBUG_EXIT
+		return;
+	}
+
+	int nNoDelay = 1;
+
+	if (setsockopt(m_nSocket, IPPROTO_TCP, TCP_NODELAY, &nNoDelay, sizeof(nNoDelay)) < 0) {
+		perror("setsockopt(TCP_NODELAY)");
+	}
+
+	struct sockaddr_in addr;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = m_nBrokerIp;
+	addr.sin_port = htons(m_nBrokerPort);
+
+	if (connect(m_nSocket, (struct sockaddr *) &addr, sizeof(addr)) == 0) {
+		m_tState = BROKER_CLIENT_STATE_HANDSHAKE;
+		SendClientConnect();
+	} else if (errno == EINPROGRESS) {
+		m_tState = BROKER_CLIENT_STATE_CONNECTING;
+	} else {
+		perror("connect");
+		Fail();
+	}
+
+	DEBUG_EXIT
+}
+
+void BrokerClient::Close(void) {
+	if (m_nSocket >= 0) {
+		close(m_nSocket);
+		m_nSocket = -1;
+	}
+
+	m_nRxLength = 0;
+	m_nRxDiscard = 0;
+	m_nTxLength = 0;
+}
+
+/**
+ * Close the connection and wait before the next attempt.
+ * The wait doubles with every attempt, a Connect Reply resets it.
+ * A redirected broker that keeps failing is given up for the configured one.
+ */
+void BrokerClient::Fail(void) {
+	DEBUG_ENTRY
+
+	Close();
+
+	if (m_bIsRedirected && (++m_nRedirectFailures >= BROKER_CLIENT_REDIRECT_ATTEMPTS)) {
+		m_nBrokerIp = m_nConfiguredIp;
+		m_nBrokerPort = m_nConfiguredPort;
+		m_bIsRedirected = false;
+		m_nBackoffMillis = 0;
+
+		printf("Returning to broker " IPSTR ":%d\n", IP2STR(m_nBrokerIp), (int) m_nBrokerPort);
+	}
+
+	m_nStateMillis = Hardware::Get()->Millis();
+	m_tState = BROKER_CLIENT_STATE_BACKOFF;
+
+	DEBUG_PRINTF("Backoff %d ms", (int) m_nBackoffMillis);
+	DEBUG_EXIT
+}
+
+uint8_t *BrokerClient::PrepareRootLayer(uint32_t nVector, uint32_t nLength) {
+	const uint32_t nRootLayerLength = sizeof(struct TRootLayerPDU) + nLength;
+
+	if (__builtin_expect((m_nTxLength + sizeof(struct TTcpPreAmble) + nRootLayerLength > BROKER_CLIENT_BUFFER_SIZE), 0)) {
+		DEBUG_PUTS("Transmit buffer overflow");
+		return 0;
+	}
+
+	struct TBrokerCommonPacket *pCommon = (struct TBrokerCommonPacket *) &m_pTxBuffer[m_nTxLength];
+
+	memcpy(pCommon->TcpPreAmble.ACNPacketIdentifier, ACN_TCP_PACKET_IDENTIFIER, sizeof(pCommon->TcpPreAmble.ACNPacketIdentifier));
+	pCommon->TcpPreAmble.RLPBlockSize = __builtin_bswap32(nRootLayerLength);
+
+	set_flags_length(pCommon->RootLayerPDU.FlagsLength, nRootLayerLength);
+	pCommon->RootLayerPDU.Vector = __builtin_bswap32(nVector);
+	memcpy(pCommon->RootLayerPDU.SenderCid, m_aCid, sizeof(pCommon->RootLayerPDU.SenderCid));
+
+	return (uint8_t *) pCommon;
+}
+
+void BrokerClient::Send(uint32_t nLength) {
+	m_nTxLength += nLength;
+	m_nLastSendMillis = Hardware::Get()->Millis();
+
+	if (!Flush()) {
+		Fail();
+	}
+}
+
+bool BrokerClient::Flush(void) {
+	while (m_nTxLength != 0) {
+		const ssize_t nBytes = send(m_nSocket, m_pTxBuffer, m_nTxLength, MSG_NOSIGNAL | MSG_DONTWAIT);
+
+		if (nBytes < 0) {
+			if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)) {
+				return true;
+			}
+
+			perror("send");
+			return false;
+		}
+
+		m_nTxLength -= (uint32_t) nBytes;
+		memmove(m_pTxBuffer, &m_pTxBuffer[nBytes], m_nTxLength);
+	}
+
+	return true;
+}
+
+/**
+ * Each round is one recv, then every complete message in the buffer is handled.
+ * Messages that do not fit in the buffer (Connected Client List) are skipped.
+ */
+bool BrokerClient::Receive(void) {
+	for (uint32_t nRound = 0; nRound < BROKER_CLIENT_RECEIVE_ROUNDS; nRound++) {
+		bool bIsReceived = false;
+
+		if (m_nRxLength < BROKER_CLIENT_BUFFER_SIZE) {
+			const ssize_t nBytes = recv(m_nSocket, &m_pRxBuffer[m_nRxLength], BROKER_CLIENT_BUFFER_SIZE - m_nRxLength, MSG_DONTWAIT);
+
+			if (nBytes == 0) {
+				DEBUG_PUTS("Connection closed by the broker");
+				return false;
+			}
+
+			if (nBytes < 0) {
+				if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)) {
+					perror("recv");
+					return false;
+				}
+			} else {
+				bIsReceived = true;
+				m_nLastReceiveMillis = Hardware::Get()->Millis();
+				m_nRxLength += (uint32_t) nBytes;
+
+				if (m_nRxDiscard != 0) {
+					const uint32_t nDiscard = m_nRxDiscard < m_nRxLength ? m_nRxDiscard : m_nRxLength;
+					m_nRxLength -= nDiscard;
+					m_nRxDiscard -= nDiscard;
+					memmove(m_pRxBuffer, &m_pRxBuffer[nDiscard], m_nRxLength);
+				}
+			}
+		}
+
+		uint32_t nOffset = 0;
+
+		while ((m_nRxLength - nOffset) >= sizeof(struct TTcpPreAmble)) {
+			const struct TTcpPreAmble *pPreAmble = (struct TTcpPreAmble *) &m_pRxBuffer[nOffset];
+
+			if (memcmp(pPreAmble->ACNPacketIdentifier, ACN_TCP_PACKET_IDENTIFIER, sizeof(pPreAmble->ACNPacketIdentifier)) != 0) {
+				DEBUG_PUTS("Invalid ACN TCP Preamble");
+				return false;
+			}
+
+			const uint32_t nBlockSize = __builtin_bswap32(pPreAmble->RLPBlockSize);
+			const uint32_t nMessageSize = sizeof(struct TTcpPreAmble) + nBlockSize;
+
+			if (nMessageSize > BROKER_CLIENT_BUFFER_SIZE) {
+				DEBUG_PRINTF("Skipping %d bytes", (int) nMessageSize);
+				m_nRxDiscard = nMessageSize - (m_nRxLength - nOffset);
+				nOffset = m_nRxLength;
+				break;
+			}
+
+			if ((m_nRxLength - nOffset) < nMessageSize) {
+				break;
+			}
+
+			// Keep room for the reply, the remaining requests are handled when the socket accepts more data
+			if (m_nTxLength + RPT_NOTIFICATION_SIZE_MAX > BROKER_CLIENT_BUFFER_SIZE) {
+				break;
+			}
+
+			HandleBlock(&m_pRxBuffer[nOffset + sizeof(struct TTcpPreAmble)], nBlockSize);
+
+			if (m_nSocket < 0) {
+				return true;
+			}
+
+			nOffset += nMessageSize;
+		}
+
+		m_nRxLength -= nOffset;
+		memmove(m_pRxBuffer, &m_pRxBuffer[nOffset], m_nRxLength);
+
+		if (!bIsReceived) {
+			return true;
+		}
+
+		if (!Flush()) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void BrokerClient::HandleBlock(const uint8_t *pBlock, uint32_t nLength) {
+	uint32_t nOffset = 0;
+
+	while ((nOffset + sizeof(struct TRootLayerPDU)) <= nLength) {
+		const struct TRootLayerPDU *pRootLayerPDU = (struct TRootLayerPDU *) &pBlock[nOffset];
+		const uint32_t nPDULength = get_length(pRootLayerPDU->FlagsLength);
+
+		if ((nPDULength < sizeof(struct TRootLayerPDU)) || ((nOffset + nPDULength) > nLength)) {
+			DEBUG_PUTS("Invalid Root Layer PDU");
+			return;
+		}
+
+		const uint8_t *pData = &pBlock[nOffset + sizeof(struct TRootLayerPDU)];
+		const uint32_t nDataLength = nPDULength - sizeof(struct TRootLayerPDU);
+
+		switch (__builtin_bswap32(pRootLayerPDU->Vector)) {
+		case VECTOR_ROOT_BROKER:
+			HandleBrokerPDU(pData, nDataLength);
+			break;
+		case VECTOR_ROOT_RPT:
+			if (m_tState == BROKER_CLIENT_STATE_CONNECTED) {
+				HandleRptPDU(pData, nDataLength);
+			}
+			break;
+		default:
+			break;
+		}
+
+		if (m_nSocket < 0) {
+			return;
+		}
+
+		nOffset += nPDULength;
+	}
+}
+
+void BrokerClient::HandleBrokerPDU(const uint8_t *pPDU, uint32_t nLength) {
+	if (nLength < sizeof(struct TBrokerPDU)) {
+		return;
+	}
+
+	const struct TBrokerPDU *pBrokerPDU = (struct TBrokerPDU *) pPDU;
+	const uint8_t *pData = &pPDU[sizeof(struct TBrokerPDU)];
+	const uint32_t nDataLength = nLength - sizeof(struct TBrokerPDU);
+
+	switch (__builtin_bswap16(pBrokerPDU->Vector)) {
+	case VECTOR_BROKER_CONNECT_REPLY: {
+		if ((m_tState != BROKER_CLIENT_STATE_HANDSHAKE) || (nDataLength < sizeof(struct TBrokerConnectReply))) {
+			return;
+		}
+
+		const struct TBrokerConnectReply *pReply = (struct TBrokerConnectReply *) pData;
+		const uint16_t nConnectionCode = __builtin_bswap16(pReply->ConnectionCode);
+
+		if (nConnectionCode != E133_CONNECT_OK) {
+			printf("Broker " IPSTR ":%d refused the connection: %d\n", IP2STR(m_nBrokerIp), (int) m_nBrokerPort, (int) nConnectionCode);
+			Fail();
+			return;
+		}
+
+		memcpy(m_aBrokerUID, pReply->BrokerUID, sizeof(m_aBrokerUID));
+
+		m_nBackoffMillis = 0;
+		m_nRedirectFailures = 0;
+		m_nStateMillis = Hardware::Get()->Millis();
+		m_tState = BROKER_CLIENT_STATE_CONNECTED;
+		m_nConnects++;
+
+		printf("Connected to broker " IPSTR ":%d\n", IP2STR(m_nBrokerIp), (int) m_nBrokerPort);
+	}
+		break;
+	case VECTOR_BROKER_REDIRECT_V4: {
+		if (nDataLength < sizeof(struct TBrokerRedirectV4)) {
+			return;
+		}
+
+		const struct TBrokerRedirectV4 *pRedirect = (struct TBrokerRedirectV4 *) pData;
+
+		m_nBrokerIp = pRedirect->IpAddress;
+		m_nBrokerPort = __builtin_bswap16(pRedirect->Port);
+
+		printf("Redirected to broker " IPSTR ":%d\n", IP2STR(m_nBrokerIp), (int) m_nBrokerPort);
+
+		m_bIsRedirected = true;
+		m_nRedirectFailures = 0;
+		m_nBackoffMillis = 0;
+		Close();
+		m_nStateMillis = Hardware::Get()->Millis();
+		m_tState = BROKER_CLIENT_STATE_BACKOFF;
+	}
+		break;
+	case VECTOR_BROKER_DISCONNECT:
+		if (nDataLength >= sizeof(struct TBrokerDisconnect)) {
+			printf("Broker disconnect: %d\n", (int) __builtin_bswap16(((struct TBrokerDisconnect *) pData)->DisconnectReason));
+		}
+		Fail();
+		break;
+	case VECTOR_BROKER_NULL:
+		// The receive time is already updated
+	default:
+		break;
+	}
+}
+
+void BrokerClient::HandleRptPDU(const uint8_t *pPDU, uint32_t nLength) {
+	if (nLength < (sizeof(struct TRptPDU) + sizeof(struct TRptRdmPDU))) {
+		return;
+	}
+
+	const struct TRptPDU *pRptPDU = (struct TRptPDU *) pPDU;
+
+	if (__builtin_bswap32(pRptPDU->Vector) != VECTOR_RPT_REQUEST) {
+		return;
+	}
+
+	if (__builtin_bswap16(pRptPDU->DestinationEndpoint) != E133_NULL_ENDPOINT) {
+		SendRptStatus(pPDU, VECTOR_RPT_STATUS_UNKNOWN_ENDPOINT);
+		return;
+	}
+
+	const struct TRptRdmPDU *pRequestPDU = (struct TRptRdmPDU *) &pPDU[sizeof(struct TRptPDU)];
+
+	if (__builtin_bswap32(pRequestPDU->Vector) != VECTOR_REQUEST_RDM_CMD) {
+		SendRptStatus(pPDU, VECTOR_RPT_STATUS_UNKNOWN_VECTOR);
+		return;
+	}
+
+	const uint32_t nCommandOffset = sizeof(struct TRptPDU) + sizeof(struct TRptRdmPDU);
+	const struct TRDMCommandPDU *pCommandPDU = (struct TRDMCommandPDU *) &pPDU[nCommandOffset];
+	const uint32_t nCommandPDULength = (nLength >= nCommandOffset + RDM_COMMAND_PDU_HEADER_SIZE) ? get_length(pCommandPDU->FlagsLength) : 0;
+	const uint32_t nCommandLength = nCommandPDULength - RDM_COMMAND_PDU_HEADER_SIZE;
+
+	if ((nCommandPDULength < RDM_COMMAND_PDU_HEADER_SIZE + RDM_MESSAGE_NO_SC_MIN_LENGTH)
+			|| (nCommandLength > RDM_MESSAGE_NO_SC_MAX_LENGTH)
+			|| ((nCommandOffset + nCommandPDULength) > nLength)
+			|| (pCommandPDU->Vector != VECTOR_RDM_CMD_RDM_DATA)
+			|| ((uint32_t) pCommandPDU->RDMData[1] + 1 != nCommandLength)) {
+		SendRptStatus(pPDU, VECTOR_RPT_STATUS_INVALID_MESSAGE);
+		return;
+	}
+
+	m_nRdmRequests++;
+
+	const uint8_t *pReply = BrokerHandleRdmCommand(pCommandPDU->RDMData);
+
+	if ((pReply == 0) || (pReply[0] != E120_SC_RDM)) {
+		// No response for an RDM broadcast, RDMData[4..7] is the device part of the destination UID
+		const bool bIsBroadcast = (pCommandPDU->RDMData[4] & pCommandPDU->RDMData[5] & pCommandPDU->RDMData[6] & pCommandPDU->RDMData[7]) == 0xFF;
+		SendRptStatus(pPDU, bIsBroadcast ? VECTOR_RPT_STATUS_BROADCAST_COMPLETE : VECTOR_RPT_STATUS_UNKNOWN_RDM_UID);
+		return;
+	}
+
+	SendRptNotification(pPDU, pCommandPDU->RDMData, nCommandLength, pReply);
+}
+
+void BrokerClient::SendClientConnect(void) {
+	DEBUG_ENTRY
+
+	const uint32_t nLength = sizeof(struct TBrokerPDU) + sizeof(struct TBrokerClientConnect);
+	struct TBrokerClientConnectPacket *pConnect = (struct TBrokerClientConnectPacket *) PrepareRootLayer(VECTOR_ROOT_BROKER, nLength);
+
+	if (pConnect == 0) {
+		Fail();
+		DEBUG_EXIT
+		return;
+	}
+
+	set_flags_length(pConnect->BrokerPDU.FlagsLength, nLength);
+	pConnect->BrokerPDU.Vector = __builtin_bswap16(VECTOR_BROKER_CONNECT);
+
+	struct TBrokerClientConnect *pClientConnect = &pConnect->ClientConnect;
+
+	memset(pClientConnect, 0, sizeof(struct TBrokerClientConnect));
+	memcpy(pClientConnect->Scope, m_aScope, strlen(m_aScope));
+	pClientConnect->Version = __builtin_bswap16(E133_VERSION);
+	memcpy(pClientConnect->SearchDomain, E133_DEFAULT_DOMAIN, sizeof(E133_DEFAULT_DOMAIN) - 1);
+
+	set_flags_length(pClientConnect->ClientEntry.FlagsLength, sizeof(struct TClientEntryPDU));
+	pClientConnect->ClientEntry.Vector = __builtin_bswap32(E133_CLIENT_PROTOCOL_RPT);
+	memcpy(pClientConnect->ClientEntry.Cid, m_aCid, sizeof(pClientConnect->ClientEntry.Cid));
+	memcpy(pClientConnect->ClientEntry.UID, m_aUID, sizeof(pClientConnect->ClientEntry.UID));
+	pClientConnect->ClientEntry.Type = RPT_CLIENT_TYPE_DEVICE;
+
+	Send(sizeof(struct TBrokerClientConnectPacket));
+
+	DEBUG_EXIT
+}
+
+void BrokerClient::SendBrokerMessage(uint16_t nVector, const uint8_t *pData, uint32_t nDataLength) {
+	const uint32_t nLength = sizeof(struct TBrokerPDU) + nDataLength;
+	struct TBrokerMessagePacket *pMessage = (struct TBrokerMessagePacket *) PrepareRootLayer(VECTOR_ROOT_BROKER, nLength);
+
+	if (pMessage == 0) {
+		Fail();
+		return;
+	}
+
+	set_flags_length(pMessage->BrokerPDU.FlagsLength, nLength);
+	pMessage->BrokerPDU.Vector = __builtin_bswap16(nVector);
+
+	if (nDataLength != 0) {
+		memcpy(&((uint8_t *) pMessage)[sizeof(struct TBrokerMessagePacket)], pData, nDataLength);
+	}
+
+	Send(sizeof(struct TBrokerMessagePacket) + nDataLength);
+}
+
+void BrokerClient::SendRptStatus(const uint8_t *pRptRequest, uint16_t nStatus) {
+	const struct TRptPDU *pRequest = (struct TRptPDU *) pRptRequest;
+	const uint32_t nLength = sizeof(struct TRptPDU) + sizeof(struct TRptStatusPDU);
+	struct TRptStatusPacket *pStatus = (struct TRptStatusPacket *) PrepareRootLayer(VECTOR_ROOT_RPT, nLength);
+
+	if (pStatus == 0) {
+		Fail();
+		return;
+	}
+
+	set_flags_length(pStatus->RptPDU.FlagsLength, nLength);
+	pStatus->RptPDU.Vector = __builtin_bswap32(VECTOR_RPT_STATUS);
+	memcpy(pStatus->RptPDU.SourceUID, m_aUID, sizeof(pStatus->RptPDU.SourceUID));
+	pStatus->RptPDU.SourceEndpoint = __builtin_bswap16(E133_NULL_ENDPOINT);
+	memcpy(pStatus->RptPDU.DestinationUID, pRequest->SourceUID, sizeof(pStatus->RptPDU.DestinationUID));
+	pStatus->RptPDU.DestinationEndpoint = pRequest->SourceEndpoint;
+	pStatus->RptPDU.SequenceNumber = pRequest->SequenceNumber;
+	pStatus->RptPDU.Reserved = 0;
+
+	set_flags_length(pStatus->StatusPDU.FlagsLength, sizeof(struct TRptStatusPDU));
+	pStatus->StatusPDU.Vector = __builtin_bswap16(nStatus);
+
+	Send(sizeof(struct TRptStatusPacket));
+}
+
+/**
+ * The Notification carries the RDM command followed by the RDM response,
+ * both without the START Code.
+ */
+void BrokerClient::SendRptNotification(const uint8_t *pRptRequest, const uint8_t *pRdmCommandNoSC, uint32_t nCommandLength, const uint8_t *pRdmReply) {
+	const struct TRptPDU *pRequest = (struct TRptPDU *) pRptRequest;
+	const uint32_t nReplyLength = (uint32_t) pRdmReply[2] + 1;	// RDM response length without SC
+	const uint32_t nNotificationLength = sizeof(struct TRptRdmPDU) + 2 * RDM_COMMAND_PDU_HEADER_SIZE + nCommandLength + nReplyLength;
+	const uint32_t nLength = sizeof(struct TRptPDU) + nNotificationLength;
+	struct TRptNotificationPacket *pNotification = (struct TRptNotificationPacket *) PrepareRootLayer(VECTOR_ROOT_RPT, nLength);
+
+	if (pNotification == 0) {
+		Fail();
+		return;
+	}
+
+	set_flags_length(pNotification->RptPDU.FlagsLength, nLength);
+	pNotification->RptPDU.Vector = __builtin_bswap32(VECTOR_RPT_NOTIFICATION);
+	memcpy(pNotification->RptPDU.SourceUID, m_aUID, sizeof(pNotification->RptPDU.SourceUID));
+	pNotification->RptPDU.SourceEndpoint = __builtin_bswap16(E133_NULL_ENDPOINT);
+	memcpy(pNotification->RptPDU.DestinationUID, pRequest->SourceUID, sizeof(pNotification->RptPDU.DestinationUID));
+	pNotification->RptPDU.DestinationEndpoint = pRequest->SourceEndpoint;
+	pNotification->RptPDU.SequenceNumber = pRequest->SequenceNumber;
+	pNotification->RptPDU.Reserved = 0;
+
+	set_flags_length(pNotification->NotificationPDU.FlagsLength, nNotificationLength);
+	pNotification->NotificationPDU.Vector = __builtin_bswap32(VECTOR_NOTIFICATION_RDM_CMD);
+
+	uint8_t *pCommandPDU = &((uint8_t *) pNotification)[sizeof(struct TRptNotificationPacket)];
+
+	set_flags_length(pCommandPDU, RDM_COMMAND_PDU_HEADER_SIZE + nCommandLength);
+	pCommandPDU[3] = VECTOR_RDM_CMD_RDM_DATA;
+	memcpy(&pCommandPDU[RDM_COMMAND_PDU_HEADER_SIZE], pRdmCommandNoSC, nCommandLength);
+
+	uint8_t *pReplyPDU = &pCommandPDU[RDM_COMMAND_PDU_HEADER_SIZE + nCommandLength];
+
+	set_flags_length(pReplyPDU, RDM_COMMAND_PDU_HEADER_SIZE + nReplyLength);
+	pReplyPDU[3] = VECTOR_RDM_CMD_RDM_DATA;
+	memcpy(&pReplyPDU[RDM_COMMAND_PDU_HEADER_SIZE], &pRdmReply[1], nReplyLength);
+
+	Send(sizeof(struct TBrokerCommonPacket) + nLength);
+}
+
+short BrokerClient::GetPollEvents(void) const {
+	switch (m_tState) {
+	case BROKER_CLIENT_STATE_CONNECTING:
+		return POLLOUT;
+	case BROKER_CLIENT_STATE_HANDSHAKE:
+	case BROKER_CLIENT_STATE_CONNECTED:
+		return (m_nTxLength != 0) ? (POLLIN | POLLOUT) : POLLIN;
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+void BrokerClient::Run(void) {
+	uint32_t nMillis = Hardware::Get()->Millis();
+
+	switch (m_tState) {
+	case BROKER_CLIENT_STATE_IDLE:
+		break;
+	case BROKER_CLIENT_STATE_BACKOFF:
+		if ((nMillis - m_nStateMillis) >= m_nBackoffMillis) {
+			if (m_nBackoffMillis == 0) {
+				m_nBackoffMillis = BROKER_CLIENT_BACKOFF_MIN_MS;
+			} else if ((m_nBackoffMillis *= 2) > BROKER_CLIENT_BACKOFF_MAX_MS) {
+				m_nBackoffMillis = BROKER_CLIENT_BACKOFF_MAX_MS;
+			}
+			Connect();
+		}
+		break;
+	case BROKER_CLIENT_STATE_CONNECTING: {
+		struct pollfd pfd;
+
+		pfd.fd = m_nSocket;
+		pfd.events = POLLOUT;
+		pfd.revents = 0;
+
+		if (poll(&pfd, 1, 0) > 0) {
+			int nError = 0;
+			socklen_t nErrorLength = sizeof(nError);
+
+			if ((getsockopt(m_nSocket, SOL_SOCKET, SO_ERROR, &nError, &nErrorLength) < 0) || (nError != 0)) {
+				DEBUG_PRINTF("connect: %s", strerror(nError));
+				Fail();
+				break;
+			}
+
+			m_nStateMillis = nMillis;
+			m_tState = BROKER_CLIENT_STATE_HANDSHAKE;
+			SendClientConnect();
+		} else if ((nMillis - m_nStateMillis) >= BROKER_CLIENT_CONNECT_TIMEOUT_MS) {
+			DEBUG_PUTS("connect: timeout");
+			Fail();
+		}
+	}
+		break;
+	case BROKER_CLIENT_STATE_HANDSHAKE:
+		if (!Flush() || !Receive()) {
+			Fail();
+			break;
+		}
+
+		if ((m_tState == BROKER_CLIENT_STATE_HANDSHAKE) && ((nMillis - m_nStateMillis) >= BROKER_CLIENT_CONNECT_TIMEOUT_MS)) {
+			DEBUG_PUTS("Connect Reply timeout");
+			Fail();
+		}
+		break;
+	case BROKER_CLIENT_STATE_CONNECTED:
+		if (!Flush() || !Receive()) {
+			Fail();
+			break;
+		}
+
+		if (m_tState != BROKER_CLIENT_STATE_CONNECTED) {
+			break;
+		}
+
+		// Receive and the replies have updated the timestamps, they are newer than nMillis
+		nMillis = Hardware::Get()->Millis();
+
+		if ((nMillis - m_nLastReceiveMillis) >= E133_HEARTBEAT_TIMEOUT_MS) {
+			printf("Broker " IPSTR ":%d heartbeat timeout\n", IP2STR(m_nBrokerIp), (int) m_nBrokerPort);
+			Fail();
+			break;
+		}
+
+		if ((nMillis - m_nLastSendMillis) >= E133_TCP_HEARTBEAT_INTERVAL_MS) {
+			SendBrokerMessage(VECTOR_BROKER_NULL);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void BrokerClient::Print(void) {
+	printf("RDMNet Broker client\n");
+
+	if ((m_nConfiguredIp == 0) || (m_nConfiguredPort == 0)) {
+		printf(" Broker : Not configured\n");
+		return;
+	}
+
+	printf(" Broker : " IPSTR ":%d\n", IP2STR(m_nConfiguredIp), (int) m_nConfiguredPort);
+
+	if (m_bIsRedirected) {
+		printf(" Redirected : " IPSTR ":%d\n", IP2STR(m_nBrokerIp), (int) m_nBrokerPort);
+	}
+
+	printf(" Scope  : %s\n", m_aScope);
+}
+
+void BrokerClient::CopyUID(uint8_t *pUID) {
+	// Override
+}
+
+void BrokerClient::CopyCID(uint8_t *pCID) {
+	// Override
+}
+
+uint8_t *BrokerClient::BrokerHandleRdmCommand(const uint8_t *pRdmDataNoSC) {
+	// Override
+	return 0;
+}
@@ -28,6 +28,9 @@
 #include <stdio.h>
 #include <uuid/uuid.h>
 #include <assert.h>
+#if defined (__linux__)
+# include <poll.h>
+#endif
 
 #include "rdmnetdevice.h"
 
@@ -80,6 +83,9 @@ void RDMNetDevice::Start(void) {
 	DEBUG_ENTRY
 
 	LLRPDevice::Start();
+#if defined (RDMNET_BROKER_CLIENT)
+	BrokerClient::Start();
+#endif
 
 	DEBUG_EXIT
 }
@@ -87,13 +93,39 @@ void RDMNetDevice::Start(void) {
 void RDMNetDevice::Stop(void) {
 	DEBUG_ENTRY
 
+#if defined (RDMNET_BROKER_CLIENT)
+	BrokerClient::Stop();
+#endif
 	LLRPDevice::Stop();
 
 	DEBUG_EXIT
 }
 
 void RDMNetDevice::Run(void) {
+#if defined (RDMNET_BROKER_CLIENT)
+	/*
+	 * One wait for both sockets, so a request from the broker is not held up
+	 * by the receive timeout of the LLRP socket.
+	 */
+	struct pollfd pfd[2];
+
+	pfd[0].fd = LLRPDevice::GetHandle();
+	pfd[0].events = POLLIN;
+	pfd[0].revents = 0;
+	pfd[1].fd = BrokerClient::GetSocket();
+	pfd[1].events = BrokerClient::GetPollEvents();
+	pfd[1].revents = 0;
+
+	if (poll(pfd, 2, RDMNET_DEVICE_POLL_TIMEOUT_MS) > 0) {
+		if (pfd[0].revents != 0) {
+			LLRPDevice::Run();
+		}
+	}
+
+	BrokerClient::Run();
+#else
 	LLRPDevice::Run();
+#endif
 }
 
 void RDMNetDevice::Print(void) {
@@ -105,6 +137,9 @@ void RDMNetDevice::Print(void) {
 	printf(" CID : %s\n", uuid_str);
 
 	LLRPDevice::Print();
+#if defined (RDMNET_BROKER_CLIENT)
+	BrokerClient::Print();
+#endif
 	RDMDeviceResponder::Print();
 }
 
@@ -123,3 +158,11 @@ uint8_t* RDMNetDevice::LLRPHandleRdmCommand(const uint8_t *pRdmDataNoSC) {
 
 	return (uint8_t*) m_pRdmCommand;
 }
+
+#if defined (RDMNET_BROKER_CLIENT)
+uint8_t* RDMNetDevice::BrokerHandleRdmCommand(const uint8_t *pRdmDataNoSC) {
+	m_RDMHandler->HandleData(pRdmDataNoSC, (uint8_t*) m_pRdmCommand);
+
+	return (uint8_t*) m_pRdmCommand;
+}
+#endif
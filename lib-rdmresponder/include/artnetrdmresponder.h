@@ -31,6 +31,7 @@
 #include "artnetrdm.h"
 
 #include "rdmdeviceresponder.h"
+#include "rdmsensors.h"
 #include "rdmpersonality.h"
 #include "rdmhandler.h"
 #include "rdm.h"
@@ -43,10 +44,14 @@ public:
 	~ArtNetRdmResponder(void);
 
 	void Full(uint8_t nPort);
-	uint8_t GetUidCount(uint8_t nPort);
-	void Copy(uint8_t nPort, uint8_t *);
+	uint16_t GetUidCount(uint8_t nPort);
+	uint16_t Copy(uint8_t nPort, uint8_t *pTod, uint16_t nIndex, uint16_t nCount);
 	const uint8_t *Handler(uint8_t nPort, const uint8_t *);
 
+	void Run(void) {
+		RDMSensors::Get()->Run();
+	}
+
 private:
 	struct TRdmMessage *m_pRdmCommand;
 	RDMHandler *m_RDMHandler;
@@ -75,12 +75,17 @@ void ArtNetRdmResponder::Full(uint8_t nPort) {
 	// We are a Responder - no code needed
 }
 
-uint8_t ArtNetRdmResponder::GetUidCount(uint8_t nPort) {
+uint16_t ArtNetRdmResponder::GetUidCount(uint8_t nPort) {
 	return 1; // We are a Responder
 }
 
-void ArtNetRdmResponder::Copy(uint8_t nPort, unsigned char *tod) {
-	memcpy(tod, RDMDeviceResponder::GetUID(), RDM_UID_SIZE);
+uint16_t ArtNetRdmResponder::Copy(uint8_t nPort, uint8_t *pTod, uint16_t nIndex, uint16_t nCount) {
+	if ((nIndex != 0) || (nCount == 0)) {
+		return 0;
+	}
+
+	memcpy(pTod, RDMDeviceResponder::GetUID(), RDM_UID_SIZE);
+	return 1;
 }
 
 const uint8_t *ArtNetRdmResponder::Handler(uint8_t nPort, const uint8_t *pRdmDataNoSC) {
@@ -31,6 +31,7 @@
 #include "dmxreceiver.h"
 
 #include "rdmresponder.h"
+#include "rdmsensors.h"
 
 #include "lightset.h"
 
@@ -89,6 +90,8 @@ int RDMResponder::HandleResponse(uint8_t *pResponse) {
 int RDMResponder::Run(void) {
 	int16_t nLength;
 
+	RDMSensors::Get()->Run();
+
 	const uint8_t *pDmxDataIn = DMXReceiver::Run(nLength);
 
 	if (m_IsEnableSubDevices && (nLength == -1)) {
@@ -137,6 +140,8 @@ int RDMResponder::Run(void) {
 
 void RDMResponder::Print(void) {
 	RDMDeviceResponder::Print();
+	RDMSubDevices::Get()->Print();
+	RDMSensors::Get()->Print();
 	DMXReceiver::Print();
 }
 #endif
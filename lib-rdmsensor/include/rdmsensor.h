@@ -101,14 +101,36 @@ public:
 	void SetValues(void);
 	void Record(void);
 
+	/*
+	 * Background sampling, see RDMSensors::Run
+	 * Once sampled, GetValues/SetValues/Record use the cached value
+	 */
+	void Sample(void);
+	bool IsSampled(void) const {
+		return m_bIsSampled;
+	}
+	uint32_t GetSampleAge(void) const;
+
 public:
 	virtual bool Initialize(void)=0;
 	virtual int16_t GetValue(void)=0;
+	/*
+	 * Starts a conversion and returns the time in milliseconds before GetValue
+	 * can fetch the result. Sensors which can be read directly return 0.
+	 */
+	virtual uint32_t StartConversion(void) {
+		return 0;
+	}
+
+private:
+	void Update(int16_t nValue);
 
 private:
 	uint8_t m_nSensor;
 	struct TRDMSensorDefintion m_tRDMSensorDefintion;
 	struct TRDMSensorValues m_tRDMSensorValues;
+	bool m_bIsSampled;
+	uint32_t m_nSampleMillis;
 };
 
 #endif /* RDMSENSOR_H_ */
@@ -30,6 +30,14 @@
 
 #include "rdmsensor.h"
 
+#define RDM_SENSORS_SAMPLE_PERIOD_DEFAULT	1000	///< Milliseconds, 0 = read on request
+
+enum TRDMSensorsSampleState {
+	RDM_SENSORS_SAMPLE_IDLE,
+	RDM_SENSORS_SAMPLE_START,
+	RDM_SENSORS_SAMPLE_FETCH
+};
+
 class RDMSensors {
 public:
 	RDMSensors(void);
@@ -44,6 +52,22 @@ public:
 	void SetValues(uint8_t nSensor);
 	void SetRecord(uint8_t nSensor);
 
+	/*
+	 * Must be set before Init
+	 */
+	void SetSamplePeriod(uint32_t nSamplePeriod) {
+		m_nSamplePeriod = nSamplePeriod;
+	}
+	uint32_t GetSamplePeriod(void) const {
+		return m_nSamplePeriod;
+	}
+
+	uint32_t GetSampleAge(uint8_t nSensor);
+
+	void Run(void);
+
+	void Print(void);
+
 public:
     static void staticCallbackFunction(void *p, const char *s);
 
@@ -57,6 +81,12 @@ private:
 private:
 	RDMSensor **m_pRDMSensor;
 	uint8_t m_nCount;
+	TRDMSensorsSampleState m_tSampleState;
+	uint8_t m_nSampleIndex;
+	uint32_t m_nSamplePeriod;
+	uint32_t m_nSampleMillis;
+	uint32_t m_nConversionMillis;
+	uint32_t m_nConversionTime;
 
 	static RDMSensors *s_pThis;
 };
@@ -37,8 +37,10 @@ public:
 
 	bool Initialize(void);
 	int16_t GetValue(void);
+	uint32_t StartConversion(void);
 
 private:
+	bool m_bIsConverting;
 };
 
 #endif /* SENSORHTU21DHUMIDITY_H_ */
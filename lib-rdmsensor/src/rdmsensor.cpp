@@ -28,6 +28,8 @@
 
 #include "rdmsensor.h"
 
+#include "hardware.h"
+
 #include <debug.h>
 
 #ifndef MAX
@@ -38,7 +40,7 @@
 #define RDM_SENSOR_RECORDED_SUPPORTED		(1 << 0)	///<
 #define RDM_SENSOR_LOW_HIGH_DETECT			(1 << 1)	///<
 
-RDMSensor::RDMSensor(uint8_t nSensor) : m_nSensor(nSensor) {
+RDMSensor::RDMSensor(uint8_t nSensor) : m_nSensor(nSensor), m_bIsSampled(false), m_nSampleMillis(0) {
 	DEBUG1_ENTRY
 
 	m_tRDMSensorDefintion.sensor = m_nSensor;
@@ -68,14 +70,18 @@ void RDMSensor::SetDescription(const char *pDescription) {
 	m_tRDMSensorDefintion.len = i;
 }
 
+void RDMSensor::Update(int16_t nValue) {
+	m_tRDMSensorValues.present = nValue;
+	m_tRDMSensorValues.lowest_detected = MIN(m_tRDMSensorValues.lowest_detected, nValue);
+	m_tRDMSensorValues.highest_detected = MAX(m_tRDMSensorValues.highest_detected, nValue);
+}
+
 const struct TRDMSensorValues* RDMSensor::GetValues(void) {
 	DEBUG1_ENTRY
 
-	const uint16_t value = this->GetValue();
-
-	m_tRDMSensorValues.present = value;
-	m_tRDMSensorValues.lowest_detected = MIN(m_tRDMSensorValues.lowest_detected, value);
-	m_tRDMSensorValues.highest_detected = MAX(m_tRDMSensorValues.highest_detected, value);
+	if (!m_bIsSampled) {
+		Update(this->GetValue());
+	}
 
 	DEBUG1_EXIT
 
@@ -85,7 +91,7 @@ const struct TRDMSensorValues* RDMSensor::GetValues(void) {
 void RDMSensor::SetValues(void) {
 	DEBUG1_ENTRY
 
-	const uint16_t value = this->GetValue();
+	const int16_t value = m_bIsSampled ? m_tRDMSensorValues.present : this->GetValue();
 
 	m_tRDMSensorValues.present = value;
 	m_tRDMSensorValues.lowest_detected = value;
@@ -98,12 +104,25 @@ void RDMSensor::SetValues(void) {
 void RDMSensor::Record(void) {
 	DEBUG1_ENTRY
 
-	const uint16_t value = this->GetValue();
+	const int16_t value = m_bIsSampled ? m_tRDMSensorValues.present : this->GetValue();
 
-	m_tRDMSensorValues.present = value;
+	Update(value);
 	m_tRDMSensorValues.recorded = value;
-	m_tRDMSensorValues.lowest_detected = MIN(m_tRDMSensorValues.lowest_detected, value);
-	m_tRDMSensorValues.highest_detected = MAX(m_tRDMSensorValues.highest_detected, value);
 
 	DEBUG1_EXIT
 }
+
+void RDMSensor::Sample(void) {
+	Update(this->GetValue());
+
+	m_nSampleMillis = Hardware::Get()->Millis();
+	m_bIsSampled = true;
+}
+
+uint32_t RDMSensor::GetSampleAge(void) const {
+	if (!m_bIsSampled) {
+		return 0;
+	}
+
+	return Hardware::Get()->Millis() - m_nSampleMillis;
+}
@@ -24,6 +24,7 @@
  */
 
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 #include <assert.h>
 
@@ -32,6 +33,8 @@
 #include "readconfigfile.h"
 #include "sscan.h"
 
+#include "hardware.h"
+
 #include "debug.h"
 
 #if defined (RASPPI) || defined(BARE_METAL)
@@ -64,13 +67,23 @@
  #include "sensorsi7021temperature.h"
 
  static const char SENSORS_PARAMS_FILE_NAME[] __attribute__ ((aligned (4))) = "sensors.txt";
+ static const char SENSORS_PARAMS_SAMPLE_PERIOD[] __attribute__ ((aligned (4))) = "sample_period";
 #endif
 
 #define RDM_SENSORS_MAX		32
 
 RDMSensors *RDMSensors::s_pThis = 0;
 
-RDMSensors::RDMSensors(void): m_pRDMSensor(0), m_nCount(0) {
+RDMSensors::RDMSensors(void):
+	m_pRDMSensor(0),
+	m_nCount(0),
+	m_tSampleState(RDM_SENSORS_SAMPLE_IDLE),
+	m_nSampleIndex(0),
+	m_nSamplePeriod(RDM_SENSORS_SAMPLE_PERIOD_DEFAULT),
+	m_nSampleMillis(0),
+	m_nConversionMillis(0),
+	m_nConversionTime(0)
+{
 	DEBUG_ENTRY
 
 	s_pThis = this;
@@ -110,7 +123,16 @@ void RDMSensors::Init(void) {
 	}
 #endif
 
-	DEBUG_PRINTF("Sensors added: %d", (int) m_nCount);
+	if (m_nSamplePeriod != 0) {
+		// The first sample is blocking, after that the cache is always valid
+		for (uint32_t i = 0; i < m_nCount; i++) {
+			m_pRDMSensor[i]->Sample();
+		}
+
+		m_nSampleMillis = Hardware::Get()->Millis();
+	}
+
+	DEBUG_PRINTF("Sensors added: %d, sample period: %d", (int) m_nCount, (int) m_nSamplePeriod);
 	DEBUG_EXIT
 }
 
@@ -170,6 +192,54 @@ void RDMSensors::SetRecord(uint8_t nSensor) {
 	}
 }
 
+uint32_t RDMSensors::GetSampleAge(uint8_t nSensor) {
+	assert(nSensor < m_nCount);
+
+	assert(m_pRDMSensor[nSensor] != 0);
+	return m_pRDMSensor[nSensor]->GetSampleAge();
+}
+
+/*
+ * One sensor at a time, one I2C transaction per call.
+ * A conversion is started, and the result is fetched in a later call.
+ */
+void RDMSensors::Run(void) {
+	if (__builtin_expect(((m_nSamplePeriod == 0) || (m_nCount == 0)), 0)) {
+		return;
+	}
+
+	const uint32_t nMillis = Hardware::Get()->Millis();
+
+	switch (m_tSampleState) {
+	case RDM_SENSORS_SAMPLE_IDLE:
+		if ((nMillis - m_nSampleMillis) >= m_nSamplePeriod) {
+			m_nSampleMillis = nMillis;
+			m_nSampleIndex = 0;
+			m_tSampleState = RDM_SENSORS_SAMPLE_START;
+		}
+		break;
+	case RDM_SENSORS_SAMPLE_START:
+		m_nConversionTime = m_pRDMSensor[m_nSampleIndex]->StartConversion();
+		m_nConversionMillis = nMillis;
+		m_tSampleState = RDM_SENSORS_SAMPLE_FETCH;
+		break;
+	case RDM_SENSORS_SAMPLE_FETCH:
+		// Millis granularity, so wait one more millisecond
+		if ((nMillis - m_nConversionMillis) > m_nConversionTime) {
+			m_pRDMSensor[m_nSampleIndex]->Sample();
+
+			if (++m_nSampleIndex == m_nCount) {
+				m_tSampleState = RDM_SENSORS_SAMPLE_IDLE;
+			} else {
+				m_tSampleState = RDM_SENSORS_SAMPLE_START;
+			}
+		}
+		break;
+	default:
+		break;
+	}
+}
+
 void RDMSensors::staticCallbackFunction(void *p, const char *s) {
 	assert(p != 0);
 	assert(s != 0);
@@ -186,6 +256,13 @@ void RDMSensors::callbackFunction(const char *pLine) {
 	uint8_t nI2cAddress = 0;
 	uint8_t nI2cChannel = 0; // TODO Replace with I2C name
 
+	uint32_t nSamplePeriod;
+
+	if (Sscan::Uint32(pLine, SENSORS_PARAMS_SAMPLE_PERIOD, &nSamplePeriod) == SSCAN_OK) {
+		m_nSamplePeriod = nSamplePeriod;
+		return;
+	}
+
 	memset(aSensorName, 0, sizeof(aSensorName));
 
 	nReturnCode = Sscan::I2c(pLine, aSensorName, &nLength, &nI2cAddress, &nI2cChannel);
@@ -216,3 +293,20 @@ void RDMSensors::callbackFunction(const char *pLine) {
 	}
 #endif
 }
+
+void RDMSensors::Print(void) {
+	printf("RDM Sensors\n");
+	printf(" Sample period : %d ms\n", (int) m_nSamplePeriod);
+
+	for (uint32_t i = 0; i < m_nCount; i++) {
+		const struct TRDMSensorDefintion *pDefinition = m_pRDMSensor[i]->GetDefintion();
+
+		printf(" %d %.*s : ", (int) i, (int) pDefinition->len, (const char *) pDefinition->description);
+
+		if (m_pRDMSensor[i]->IsSampled()) {
+			printf("%d, %u ms ago\n", (int) m_pRDMSensor[i]->GetValues()->present, (unsigned) GetSampleAge(i));
+		} else {
+			printf("not sampled\n");
+		}
+	}
+}
@@ -41,7 +41,7 @@
 
 static struct _device_info sDeviceInfo;
 
-SensorHTU21DHumidity::SensorHTU21DHumidity(uint8_t nSensor, uint8_t nAddress): RDMSensor(nSensor) {
+SensorHTU21DHumidity::SensorHTU21DHumidity(uint8_t nSensor, uint8_t nAddress): RDMSensor(nSensor), m_bIsConverting(false) {
 	SetType(E120_SENS_HUMIDITY);
 	SetUnit(E120_UNITS_NONE);
 	SetPrefix(E120_PREFIX_NONE);
@@ -68,11 +68,25 @@ bool SensorHTU21DHumidity::Initialize(void) {
 }
 
 int16_t SensorHTU21DHumidity::GetValue(void) {
-	const int16_t nValue = (int16_t) htu21d_get_humidity(&sDeviceInfo);
+	int16_t nValue;
+
+	if (m_bIsConverting) {
+		nValue = (int16_t) htu21d_read_humidity(&sDeviceInfo);
+		m_bIsConverting = false;
+	} else {
+		nValue = (int16_t) htu21d_get_humidity(&sDeviceInfo);
+	}
 
 #ifndef NDEBUG
 	printf("%s\tnValue=%d\n", __FUNCTION__, (int) nValue);
 #endif
 	return nValue;
 }
+
+uint32_t SensorHTU21DHumidity::StartConversion(void) {
+	htu21d_start_humidity(&sDeviceInfo);
+	m_bIsConverting = true;
+
+	return HTU21D_CONVERSION_TIME_MS;
+}
 #endif
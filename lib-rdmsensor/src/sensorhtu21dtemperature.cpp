@@ -41,7 +41,7 @@
 
 static struct _device_info sDeviceInfo;
 
-SensorHTU21DTemperature::SensorHTU21DTemperature(uint8_t nSensor, uint8_t nAddress): RDMSensor(nSensor) {
+SensorHTU21DTemperature::SensorHTU21DTemperature(uint8_t nSensor, uint8_t nAddress): RDMSensor(nSensor), m_bIsConverting(false) {
 	SetType(E120_SENS_TEMPERATURE);
 	SetUnit(E120_UNITS_CENTIGRADE);
 	SetPrefix(E120_PREFIX_NONE);
@@ -68,11 +68,25 @@ bool SensorHTU21DTemperature::Initialize(void) {
 }
 
 int16_t SensorHTU21DTemperature::GetValue(void) {
-	const int16_t nValue = (int16_t) htu21d_get_temperature(&sDeviceInfo);
+	int16_t nValue;
+
+	if (m_bIsConverting) {
+		nValue = (int16_t) htu21d_read_temperature(&sDeviceInfo);
+		m_bIsConverting = false;
+	} else {
+		nValue = (int16_t) htu21d_get_temperature(&sDeviceInfo);
+	}
 
 #ifndef NDEBUG
 	printf("%s\tnValue=%d\n", __FUNCTION__, (int) nValue);
 #endif
 	return nValue;
 }
+
+uint32_t SensorHTU21DTemperature::StartConversion(void) {
+	htu21d_start_temperature(&sDeviceInfo);
+	m_bIsConverting = true;
+
+	return HTU21D_CONVERSION_TIME_MS;
+}
 #endif
@@ -41,7 +41,7 @@
 
 static struct _device_info sDeviceInfo;
 
-SensorSI7021Humidity::SensorSI7021Humidity(uint8_t nSensor, uint8_t nAddress): RDMSensor(nSensor) {
+SensorSI7021Humidity::SensorSI7021Humidity(uint8_t nSensor, uint8_t nAddress): RDMSensor(nSensor), m_bIsConverting(false) {
 	SetType(E120_SENS_HUMIDITY);
 	SetUnit(E120_UNITS_NONE);
 	SetPrefix(E120_PREFIX_NONE);
@@ -68,11 +68,25 @@ bool SensorSI7021Humidity::Initialize(void) {
 }
 
 int16_t SensorSI7021Humidity::GetValue(void) {
-	const int16_t nValue = (int16_t) si7021_get_humidity(&sDeviceInfo);
+	int16_t nValue;
+
+	if (m_bIsConverting) {
+		nValue = (int16_t) si7021_read_humidity(&sDeviceInfo);
+		m_bIsConverting = false;
+	} else {
+		nValue = (int16_t) si7021_get_humidity(&sDeviceInfo);
+	}
 
 #ifndef NDEBUG
 	printf("%s\tnValue=%d\n", __FUNCTION__, (int) nValue);
 #endif
 	return nValue;
 }
+
+uint32_t SensorSI7021Humidity::StartConversion(void) {
+	si7021_start_humidity(&sDeviceInfo);
+	m_bIsConverting = true;
+
+	return SI7021_CONVERSION_TIME_MS;
+}
 #endif
@@ -41,7 +41,7 @@
 
 static struct _device_info sDeviceInfo;
 
-SensorSI7021Temperature::SensorSI7021Temperature(uint8_t nSensor, uint8_t nAddress) : RDMSensor(nSensor) {
+SensorSI7021Temperature::SensorSI7021Temperature(uint8_t nSensor, uint8_t nAddress) : RDMSensor(nSensor), m_bIsConverting(false) {
 	SetType(E120_SENS_TEMPERATURE);
 	SetUnit(E120_UNITS_CENTIGRADE);
 	SetPrefix(E120_PREFIX_NONE);
@@ -68,11 +68,25 @@ bool SensorSI7021Temperature::Initialize(void) {
 }
 
 int16_t SensorSI7021Temperature::GetValue(void) {
-	const int16_t nValue = (int16_t) si7021_get_temperature(&sDeviceInfo);
+	int16_t nValue;
+
+	if (m_bIsConverting) {
+		nValue = (int16_t) si7021_read_temperature(&sDeviceInfo);
+		m_bIsConverting = false;
+	} else {
+		nValue = (int16_t) si7021_get_temperature(&sDeviceInfo);
+	}
 
 #ifndef NDEBUG
 	printf("%s\tnValue=%d\n", __FUNCTION__, (int) nValue);
 #endif
 	return nValue;
 }
+
+uint32_t SensorSI7021Temperature::StartConversion(void) {
+	si7021_start_temperature(&sDeviceInfo);
+	m_bIsConverting = true;
+
+	return SI7021_CONVERSION_TIME_MS;
+}
 #endif
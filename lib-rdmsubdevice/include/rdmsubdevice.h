@@ -39,6 +39,8 @@ struct TRDMSubDevicesInfo {
 	uint8_t device_label_length;
 };
 
+struct spi_batch;
+
 enum TRDMSubDeviceUpdateEvent {
 	RDM_SUBDEVICE_UPDATE_EVENT_DMX_STARTADDRESS,
 	RDM_SUBDEVICE_UPDATE_EVENT_PERSONALITY
@@ -75,6 +77,14 @@ public:
 	virtual void Start(void)= 0;
 	virtual void Stop(void)= 0;
 	virtual void Data(const uint8_t *pDdata, uint16_t nLength)=0;
+	/**
+	 * SPI based sub devices queue their transfers in pSpiBatch,
+	 * the caller flushes the batch once for all sub devices.
+	 */
+	virtual void Update(const uint8_t *pData, uint16_t nLength, struct spi_batch *pSpiBatch) {
+		(void) pSpiBatch;
+		Data(pData, nLength);
+	}
 
 protected:
 	void SetDmxFootprint(uint16_t nDmxFootprint);
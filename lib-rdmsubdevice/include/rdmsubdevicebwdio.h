@@ -42,6 +42,7 @@ public:
 	void Start(void);
 	void Stop(void);
 	void Data(const uint8_t *pData, uint16_t nLength);
+	void Update(const uint8_t *pData, uint16_t nLength, struct spi_batch *pSpiBatch) override;
 
 private:
 	void UpdateEvent(TRDMSubDeviceUpdateEvent tUpdateEvent) override;
@@ -66,6 +66,23 @@ public:
 	void Stop(void);
 	void SetData(const uint8_t *pData, uint16_t nLength);
 
+	/**
+	 * Time of the last SPI batch flush. The maximum is that of the previous 1 second period.
+	 */
+	uint32_t GetBusTime(void) const {
+		return m_nBusTime;
+	}
+
+	uint32_t GetBusTimeMax(void) const {
+		return m_nBusTimeMax;
+	}
+
+	uint32_t GetTransfers(void) const {
+		return m_nTransfers;
+	}
+
+	void Print(void);
+
 public:
 	static RDMSubDevices* Get(void) {
 		return s_pThis;
@@ -80,6 +97,12 @@ private:
 private:
 	RDMSubDevice **m_pRDMSubDevice;
 	uint16_t m_nCount;
+	struct spi_batch *m_pSpiBatch;
+	uint32_t m_nBusTime;
+	uint32_t m_nBusTimeMax;
+	uint32_t m_nBusTimeMaxPeriod;
+	uint32_t m_nBusTimeMaxMillis;
+	uint32_t m_nTransfers;
 
 	static RDMSubDevices *s_pThis;
 };
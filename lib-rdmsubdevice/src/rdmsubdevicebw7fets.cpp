@@ -76,6 +76,10 @@ void RDMSubDeviceBw7fets::Stop(void) {
 }
 
 void RDMSubDeviceBw7fets::Data(const uint8_t* pData, uint16_t nLength) {
+	Update(pData, nLength, 0);
+}
+
+void RDMSubDeviceBw7fets::Update(const uint8_t* pData, uint16_t nLength, struct spi_batch *pSpiBatch) {
 	uint8_t nData = 0;
 	const uint16_t nDmxStartAddress = GetDmxStartAddress();
 
@@ -86,7 +90,7 @@ void RDMSubDeviceBw7fets::Data(const uint8_t* pData, uint16_t nLength) {
 	}
 
 	if (m_nData != nData) {
-		bw_spi_7fets_output(&m_tDeviceInfo, nData);
+		bw_spi_7fets_output_batch(pSpiBatch, &m_tDeviceInfo, nData);
 		m_nData = nData;
 	}
 }
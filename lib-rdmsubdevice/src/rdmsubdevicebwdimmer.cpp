@@ -74,12 +74,16 @@ void RDMSubDeviceBwDimmer::Stop(void) {
 }
 
 void RDMSubDeviceBwDimmer::Data(const uint8_t* pData, uint16_t nLength) {
+	Update(pData, nLength, 0);
+}
+
+void RDMSubDeviceBwDimmer::Update(const uint8_t* pData, uint16_t nLength, struct spi_batch *pSpiBatch) {
 	const uint16_t nDmxStartAddress = GetDmxStartAddress();
 
 	if (nDmxStartAddress <= nLength) {
 		const uint8_t nData = pData[nDmxStartAddress - 1];
 		if (m_nData != nData) {
-			bw_spi_dimmer_output(&m_tDeviceInfo, nData);
+			bw_spi_dimmer_output_batch(pSpiBatch, &m_tDeviceInfo, nData);
 			m_nData = nData;
 		}
 	}
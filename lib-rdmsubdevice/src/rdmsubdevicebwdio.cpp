@@ -77,6 +77,10 @@ void RDMSubDeviceBwDio::Stop(void) {
 }
 
 void RDMSubDeviceBwDio::Data(const uint8_t* pData, uint16_t nLength) {
+	Update(pData, nLength, 0);
+}
+
+void RDMSubDeviceBwDio::Update(const uint8_t* pData, uint16_t nLength, struct spi_batch *pSpiBatch) {
 	uint8_t nData = 0;
 	const uint16_t nDmxStartAddress = GetDmxStartAddress();
 
@@ -91,7 +95,7 @@ void RDMSubDeviceBwDio::Data(const uint8_t* pData, uint16_t nLength) {
 #endif
 
 	if (m_nData != nData) {
-		bw_spi_dio_output(&m_tDeviceInfo, nData);
+		bw_spi_dio_output_batch(pSpiBatch, &m_tDeviceInfo, nData);
 		m_nData = nData;
 	}
 }
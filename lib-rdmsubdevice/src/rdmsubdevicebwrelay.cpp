@@ -76,6 +76,10 @@ void RDMSubDeviceBwRelay::Stop(void) {
 }
 
 void RDMSubDeviceBwRelay::Data(const uint8_t* pData, uint16_t nLength) {
+	Update(pData, nLength, 0);
+}
+
+void RDMSubDeviceBwRelay::Update(const uint8_t* pData, uint16_t nLength, struct spi_batch *pSpiBatch) {
 	uint8_t nData = 0;
 	const uint16_t nDmxStartAddress = GetDmxStartAddress();
 
@@ -90,7 +94,7 @@ void RDMSubDeviceBwRelay::Data(const uint8_t* pData, uint16_t nLength) {
 #endif
 
 	if (m_nData != nData) {
-		bw_spi_relay_output(&m_tDeviceInfo, nData);
+		bw_spi_relay_output_batch(pSpiBatch, &m_tDeviceInfo, nData);
 		m_nData = nData;
 	}
 }
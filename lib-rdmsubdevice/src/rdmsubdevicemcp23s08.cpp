@@ -80,6 +80,10 @@ void RDMSubDeviceMCP23S08::Stop(void) {
 }
 
 void RDMSubDeviceMCP23S08::Data(const uint8_t* pData, uint16_t nLength) {
+	Update(pData, nLength, 0);
+}
+
+void RDMSubDeviceMCP23S08::Update(const uint8_t* pData, uint16_t nLength, struct spi_batch *pSpiBatch) {
 	uint8_t nData = 0;
 	const uint16_t nDmxStartAddress = GetDmxStartAddress();
 
@@ -94,7 +98,7 @@ void RDMSubDeviceMCP23S08::Data(const uint8_t* pData, uint16_t nLength) {
 #endif
 
 	if (m_nData != nData) {
-		mcp23s08_reg_write(&m_tDeviceInfo, MCP23S08_GPIO, nData);
+		mcp23s08_reg_write_batch(pSpiBatch, &m_tDeviceInfo, MCP23S08_GPIO, nData);
 		m_nData = nData;
 	}
 }
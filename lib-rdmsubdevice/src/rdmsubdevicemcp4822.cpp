@@ -78,6 +78,10 @@ void RDMSubDeviceMCP4822::Stop(void) {
 }
 
 void RDMSubDeviceMCP4822::Data(const uint8_t* pData, uint16_t nLength) {
+	Update(pData, nLength, 0);
+}
+
+void RDMSubDeviceMCP4822::Update(const uint8_t* pData, uint16_t nLength, struct spi_batch *pSpiBatch) {
 	assert(nLength <= 512);
 
 	uint16_t nOffset = GetDmxStartAddress() - 1;
@@ -86,7 +90,7 @@ void RDMSubDeviceMCP4822::Data(const uint8_t* pData, uint16_t nLength) {
 		const uint16_t nDataA = (uint16_t) ((uint16_t) (pData[nOffset] << 4) | (uint16_t) (pData[nOffset] >> 4));
 
 		if (nDataA != m_nDataA) {
-			mcp4822_write_a(&m_tDeviceInfo, nDataA);
+			mcp4822_write_a_batch(pSpiBatch, &m_tDeviceInfo, nDataA);
 			m_nDataA = nDataA;
 		}
 
@@ -96,7 +100,7 @@ void RDMSubDeviceMCP4822::Data(const uint8_t* pData, uint16_t nLength) {
 			const uint16_t nDataB = (uint16_t) ((uint16_t) (pData[nOffset] << 4) | (uint16_t) (pData[nOffset] >> 4));
 
 			if (nDataB != m_nDataB) {
-				mcp4822_write_b(&m_tDeviceInfo, nDataB);
+				mcp4822_write_b_batch(pSpiBatch, &m_tDeviceInfo, nDataB);
 				m_nDataB = nDataB;
 			}
 		}
@@ -78,6 +78,10 @@ void RDMSubDeviceMCP4902::Stop(void) {
 }
 
 void RDMSubDeviceMCP4902::Data(const uint8_t* pData, uint16_t nLength) {
+	Update(pData, nLength, 0);
+}
+
+void RDMSubDeviceMCP4902::Update(const uint8_t* pData, uint16_t nLength, struct spi_batch *pSpiBatch) {
 	assert(nLength <= 512);
 
 	uint16_t nOffset = GetDmxStartAddress() - 1;
@@ -86,7 +90,7 @@ void RDMSubDeviceMCP4902::Data(const uint8_t* pData, uint16_t nLength) {
 		const uint8_t nDataA = pData[nOffset];
 
 		if (nDataA != m_nDataA) {
-			mcp4902_write_a(&m_tDeviceInfo, nDataA);
+			mcp4902_write_a_batch(pSpiBatch, &m_tDeviceInfo, nDataA);
 			m_nDataA = nDataA;
 		}
 
@@ -96,7 +100,7 @@ void RDMSubDeviceMCP4902::Data(const uint8_t* pData, uint16_t nLength) {
 			const uint8_t nDataB = pData[nOffset];
 
 			if (nDataB != m_nDataB) {
-				mcp4902_write_b(&m_tDeviceInfo, nDataB);
+				mcp4902_write_b_batch(pSpiBatch, &m_tDeviceInfo, nDataB);
 				m_nDataB = nDataB;
 			}
 		}
@@ -28,6 +28,8 @@
 #include <string.h>
 #include <assert.h>
 
+#include "hardware.h"
+
 #include "readconfigfile.h"
 #include "sscan.h"
 
@@ -58,19 +60,44 @@
 #include "rdmsubdevicemcp23s17.h"
 #include "rdmsubdevicemcp4822.h"
 #include "rdmsubdevicemcp4902.h"
+//
+#include "spi_batch.h"
 
 static const char SUBDEVICES_PARAMS_FILE_NAME[] __attribute__ ((aligned (4))) = "devices.txt";
 #endif
 
 #define RDM_SUBDEVICES_MAX	8
 
+#if defined(RDM_SUBDEVICES_ENABLE)
+// A sub device queues at most 2 transfers per frame, the batch is never flushed before SetData does
+# if (2 * RDM_SUBDEVICES_MAX) > SPI_BATCH_TRANSFERS_MAX
+#  error SPI_BATCH_TRANSFERS_MAX
+# endif
+#endif
+
+#define BUS_TIME_MAX_PERIOD_MILLIS	1000
+
 RDMSubDevices *RDMSubDevices::s_pThis = 0;
 
-RDMSubDevices::RDMSubDevices(void) : m_nCount(0) {
+RDMSubDevices::RDMSubDevices(void) :
+	m_nCount(0),
+	m_pSpiBatch(0),
+	m_nBusTime(0),
+	m_nBusTimeMax(0),
+	m_nBusTimeMaxPeriod(0),
+	m_nBusTimeMaxMillis(0),
+	m_nTransfers(0)
+{
 	s_pThis = this;
 
 	m_pRDMSubDevice = new RDMSubDevice*[RDM_SUBDEVICES_MAX];
 	assert(m_pRDMSubDevice != 0);
+
+#if defined(RDM_SUBDEVICES_ENABLE)
+	m_pSpiBatch = new spi_batch_t;
+	assert(m_pSpiBatch != 0);
+	spi_batch_init(m_pSpiBatch);
+#endif
 }
 
 RDMSubDevices::~RDMSubDevices(void) {
@@ -82,6 +109,11 @@ RDMSubDevices::~RDMSubDevices(void) {
 	delete [] m_pRDMSubDevice;
 
 	m_nCount = 0;
+
+#if defined(RDM_SUBDEVICES_ENABLE)
+	delete m_pSpiBatch;
+	m_pSpiBatch = 0;
+#endif
 }
 
 void RDMSubDevices::Init(void) {
@@ -217,13 +249,48 @@ void RDMSubDevices::Stop(void) {
 }
 
 void RDMSubDevices::SetData(const uint8_t* pData, uint16_t nLength) {
+	if (m_nCount == 0) {
+		return;
+	}
+
 	for (unsigned i = 0; i < m_nCount; i++) {
 		if (m_pRDMSubDevice[i] != 0) {
 			if (nLength >= m_pRDMSubDevice[i]->GetDmxStartAddress() + m_pRDMSubDevice[i]->GetDmxFootPrint() - 1) {
-				m_pRDMSubDevice[i]->Data(pData, nLength);
+				m_pRDMSubDevice[i]->Update(pData, nLength, m_pSpiBatch);
 			}
 		}
 	}
+
+#if defined(RDM_SUBDEVICES_ENABLE)
+	const uint32_t nMicros = Hardware::Get()->Micros();
+
+	m_nTransfers = spi_batch_flush(m_pSpiBatch);
+
+	m_nBusTime = Hardware::Get()->Micros() - nMicros;
+#endif
+
+	if (m_nBusTime > m_nBusTimeMaxPeriod) {
+		m_nBusTimeMaxPeriod = m_nBusTime;
+	}
+
+	const uint32_t nMillis = Hardware::Get()->Millis();
+
+	if ((nMillis - m_nBusTimeMaxMillis) >= BUS_TIME_MAX_PERIOD_MILLIS) {
+		m_nBusTimeMaxMillis = nMillis;
+		m_nBusTimeMax = m_nBusTimeMaxPeriod;
+		m_nBusTimeMaxPeriod = 0;
+	}
+}
+
+void RDMSubDevices::Print(void) {
+	if (m_nCount == 0) {
+		return;
+	}
+
+	printf("RDM Sub Devices\n");
+	printf(" Count     : %d\n", (int) m_nCount);
+	printf(" Transfers : %d\n", (int) m_nTransfers);
+	printf(" Bus time  : %d us, max %d us in %d ms\n", (int) m_nBusTime, (int) m_nBusTimeMax, BUS_TIME_MAX_PERIOD_MILLIS);
 }
 
 bool RDMSubDevices::GetFactoryDefaults(void) {
@@ -161,6 +161,9 @@ private:
 	void HandleList(void);
 	void HandleUptime(void);
 	void HandleVersion(void);
+#if defined (H3) && (defined (DMXSEND) || defined (DMXSEND_MULTI))
+	void HandleStatistics(void);
+#endif
 
 	void HandleGet(void);
 	void HandleGetRconfigTxt(uint32_t& nSize);
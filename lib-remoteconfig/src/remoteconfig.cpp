@@ -70,6 +70,10 @@
  #include "dmxparams.h"
  #include "storedmxsend.h"
 #endif
+#if defined (H3) && (defined (DMXSEND) || defined (DMXSEND_MULTI))
+ /* ?stats# */
+ #include "dmx.h"
+#endif
 #if defined (PIXEL)
  /* devices.txt */
  #include "ws28xxdmxparams.h"
@@ -150,6 +154,9 @@ static const char sRequestUptime[] ALIGNED = "?uptime#";
 static const char sRequestVersion[] ALIGNED = "?version#";
 #define REQUEST_VERSION_LENGTH (sizeof(sRequestVersion)/sizeof(sRequestVersion[0]) - 1)
 
+static const char sRequestStatistics[] ALIGNED = "?stats#";
+#define REQUEST_STATISTICS_LENGTH (sizeof(sRequestStatistics)/sizeof(sRequestStatistics[0]) - 1)
+
 static const char sRequestStore[] ALIGNED = "?store#";
 #define REQUEST_STORE_LENGTH (sizeof(sRequestStore)/sizeof(sRequestStore[0]) - 1)
 
@@ -287,6 +294,10 @@ int RemoteConfig::Run(void) {
 			HandleUptime();
 		} else if (memcmp(m_pUdpBuffer, sRequestVersion, REQUEST_VERSION_LENGTH) == 0) {
 			HandleVersion();
+#if defined (H3) && (defined (DMXSEND) || defined (DMXSEND_MULTI))
+		} else if (memcmp(m_pUdpBuffer, sRequestStatistics, REQUEST_STATISTICS_LENGTH) == 0) {
+			HandleStatistics();
+#endif
 		} else if (memcmp(m_pUdpBuffer, sRequestList, REQUEST_LIST_LENGTH) == 0) {
 			HandleList();
 		} else if ((m_nBytesReceived > REQUEST_GET_LENGTH) && (memcmp(m_pUdpBuffer, sRequestGet, REQUEST_GET_LENGTH) == 0)) {
@@ -369,6 +380,68 @@ void RemoteConfig::HandleVersion() {
 	DEBUG_EXIT
 }
 
+#if defined (H3) && (defined (DMXSEND) || defined (DMXSEND_MULTI))
+/**
+ * One reply per DMX port, "?stats#bin" returns the struct _dmx_port_statistics of all ports
+ */
+void RemoteConfig::HandleStatistics(void) {
+	DEBUG_ENTRY
+
+	DmxSet *pDmxSet = DmxSet::Get();
+
+	if (pDmxSet == 0) {
+		DEBUG_EXIT
+		return;
+	}
+
+	const bool bBinary = (m_nBytesReceived == REQUEST_STATISTICS_LENGTH + 3) && (memcmp((const void *)&m_pUdpBuffer[REQUEST_STATISTICS_LENGTH], "bin", 3) == 0);
+	uint32_t nLength = 0;
+
+	for (uint32_t nPort = 0; nPort < DMX_MAX_OUT; nPort++) {
+		const struct _dmx_port_statistics *p = pDmxSet->GetPortStatistics(nPort);
+
+		if (p == 0) {
+			break;
+		}
+
+		if (bBinary) {
+			memcpy(&m_pUdpBuffer[nLength], p, sizeof(struct _dmx_port_statistics));
+			nLength += sizeof(struct _dmx_port_statistics);
+			continue;
+		}
+
+		nLength = snprintf((char *)m_pUdpBuffer, UDP_BUFFER_SIZE,
+				"port:%d\ndmx:%u,%uHz\nbreak_mab:%uus\nbreak_to_break:%uus\nerrors:framing %u,overrun %u\n",
+				(int) nPort, (unsigned) p->dmx_packets, (unsigned) p->updates_per_second, (unsigned) p->break_mab, (unsigned) p->break_to_break,
+				(unsigned) p->framing_errors, (unsigned) p->overrun_errors);
+
+		nLength += snprintf((char *)&m_pUdpBuffer[nLength], UDP_BUFFER_SIZE - nLength, "jitter:");
+
+		for (uint32_t i = 0; i < DMX_PORT_STATISTICS_JITTER_BUCKETS; i++) {
+			nLength += snprintf((char *)&m_pUdpBuffer[nLength], UDP_BUFFER_SIZE - nLength, "%u%c", (unsigned) p->jitter[i], i == DMX_PORT_STATISTICS_JITTER_BUCKETS - 1 ? '\n' : ',');
+		}
+
+		nLength += snprintf((char *)&m_pUdpBuffer[nLength], UDP_BUFFER_SIZE - nLength, "slots:");
+
+		for (uint32_t i = 0; i < DMX_PORT_STATISTICS_SLOTS_BUCKETS; i++) {
+			nLength += snprintf((char *)&m_pUdpBuffer[nLength], UDP_BUFFER_SIZE - nLength, "%u%c", (unsigned) p->slots[i], i == DMX_PORT_STATISTICS_SLOTS_BUCKETS - 1 ? '\n' : ',');
+		}
+
+		nLength += snprintf((char *)&m_pUdpBuffer[nLength], UDP_BUFFER_SIZE - nLength, "rdm:%u,requests %u,timeouts %u,latency %u/%uus\n",
+				(unsigned) p->rdm_packets, (unsigned) p->rdm_requests, (unsigned) p->rdm_timeouts,
+				(unsigned) dmx_latency_average(&p->rdm_latency), (unsigned) p->rdm_latency.max);
+
+		Network::Get()->SendTo(m_nHandle, (const uint8_t *)m_pUdpBuffer, nLength, m_nIPAddressFrom, (uint16_t) UDP_PORT);
+	}
+
+	if (bBinary) {
+		Network::Get()->SendTo(m_nHandle, (const uint8_t *)m_pUdpBuffer, nLength, m_nIPAddressFrom, (uint16_t) UDP_PORT);
+	}
+
+	DEBUG_EXIT
+}
+#endif
+
 void RemoteConfig::HandleList(void) {
 	DEBUG_ENTRY
 
@@ -49,6 +49,7 @@ public:
 	void Stop(uint8_t nPort = 0);
 
 	void SetData(uint8_t nPort, const uint8_t *pDmxData, uint16_t nLength);
+	void SetDataChanged(uint8_t nPort, const uint8_t *pDmxData, uint16_t nLength, uint16_t nChangedFirst, uint16_t nChangedLast);
 
 	void Blackout(bool bBlackout);
 
@@ -101,6 +102,7 @@ private:
 	uint8_t m_nBoardInstances;
 	bool m_bIsStarted;
 	bool m_bBlackout;
+	bool m_bUpdateAll;
 	TLC59711 *m_pTLC59711;
 	uint32_t m_nSpiSpeedHz;
 	TTLC59711Type m_LEDType;
@@ -46,6 +46,7 @@ TLC59711Dmx::TLC59711Dmx(void):
 	m_nBoardInstances(1),
 	m_bIsStarted(false),
 	m_bBlackout(false),
+	m_bUpdateAll(true),
 	m_pTLC59711(0),
 	m_nSpiSpeedHz(0),
 	m_LEDType(TTLC59711_TYPE_RGB),
@@ -81,6 +82,10 @@ void TLC59711Dmx::Stop(uint8_t nPort) {
 }
 
 void TLC59711Dmx::SetData(uint8_t nPort, const uint8_t* pDmxData, uint16_t nLength) {
+	SetDataChanged(nPort, pDmxData, nLength, 0, nLength);
+}
+
+void TLC59711Dmx::SetDataChanged(uint8_t nPort, const uint8_t* pDmxData, uint16_t nLength, uint16_t nChangedFirst, uint16_t nChangedLast) {
 	assert(pDmxData != 0);
 	assert(nLength <= DMX_UNIVERSE_SIZE);
 
@@ -88,11 +93,26 @@ void TLC59711Dmx::SetData(uint8_t nPort, const uint8_t* pDmxData, uint16_t nLeng
 		Start();
 	}
 
-	uint8_t *p = (uint8_t *)pDmxData + m_nDmxStartAddress - 1;
+	if (__builtin_expect(m_bUpdateAll, 0)) {
+		m_bUpdateAll = false;
+		nChangedFirst = 0;
+		nChangedLast = nLength;
+	}
+
+	// Only the changed channels within the footprint are written
+	const unsigned nOffset = m_nDmxStartAddress - 1;
+	const unsigned nFirst = (nChangedFirst > nOffset) ? (nChangedFirst - nOffset) : 0;
+	unsigned nLast = (nChangedLast > nOffset) ? (nChangedLast - nOffset) : 0;
+
+	if (nLast > m_nDmxFootprint) {
+		nLast = m_nDmxFootprint;
+	}
+
+	uint8_t *p = (uint8_t *)pDmxData + nOffset + nFirst;
 
-	unsigned nDmxAddress = m_nDmxStartAddress;
+	unsigned nDmxAddress = m_nDmxStartAddress + nFirst;
 
-	for (unsigned i = 0; i < m_nDmxFootprint; i++) {
+	for (unsigned i = nFirst; i < nLast; i++) {
 		if (nDmxAddress > nLength) {
 			break;
 		}
@@ -105,7 +125,7 @@ void TLC59711Dmx::SetData(uint8_t nPort, const uint8_t* pDmxData, uint16_t nLeng
 		nDmxAddress++;
 	}
 
-	if (__builtin_expect((nDmxAddress == m_nDmxStartAddress), 0)) {
+	if (__builtin_expect((nDmxAddress == (m_nDmxStartAddress + nFirst)), 0)) {
 		return;
 	}
 
@@ -143,6 +163,7 @@ void TLC59711Dmx::UpdateMembers(void) {
 	}
 
 	m_nBoardInstances = (uint8_t) ceil((float) m_nDmxFootprint / TLC59711_OUT_CHANNELS);
+	m_bUpdateAll = true;
 }
 
 void TLC59711Dmx::Blackout(bool bBlackout) {
@@ -164,6 +185,7 @@ bool TLC59711Dmx::SetDmxStartAddress(uint16_t nDmxStartAddress) {
 
 	if ((nDmxStartAddress != 0) && (nDmxStartAddress <= DMX_UNIVERSE_SIZE)) {
 		m_nDmxStartAddress = nDmxStartAddress;
+		m_bUpdateAll = true;
 
 		if (m_pTLC59711DmxStore != 0) {
 			m_pTLC59711DmxStore->SaveDmxStartAddress(m_nDmxStartAddress);
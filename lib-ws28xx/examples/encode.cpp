@@ -0,0 +1,220 @@
+/**
+ * @file encode.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ws28xx.h"
+#include "ws28xxconst.h"
+
+#define LED_COUNT	680
+#define FRAMES		1000
+#define CHECK_FRAMES	64
+
+static uint64_t nanos(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t) ts.tv_sec * 1000000000) + (uint64_t) ts.tv_nsec;
+}
+
+/*
+ * The per-bit encoder as it was before the table-driven one, the reference
+ */
+class WS28xxPerBit {
+public:
+	WS28xxPerBit(TWS28XXType tType, uint8_t *pBuffer) :
+		m_tLEDType(tType),
+		m_nGlobalBrightness(0xFF),
+		m_nHighCode(tType == WS2812B ? 0xF8 : (((tType == UCS1903) || (tType == UCS2903)) ? 0xFC : 0xF0)),
+		m_pBuffer(pBuffer)
+	{
+	}
+
+	void SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+		if (m_tLEDType == APA102) {
+			uint32_t nOffset = 4 + (nLEDIndex * 4);
+			m_pBuffer[nOffset] = m_nGlobalBrightness;
+			m_pBuffer[nOffset + 1] = nRed;
+			m_pBuffer[nOffset + 2] = nGreen;
+			m_pBuffer[nOffset + 3] = nBlue;
+		} else if (m_tLEDType == WS2801) {
+			uint32_t nOffset = nLEDIndex * 3;
+			m_pBuffer[nOffset] = nRed;
+			m_pBuffer[nOffset + 1] = nGreen;
+			m_pBuffer[nOffset + 2] = nBlue;
+		} else if ((m_tLEDType == WS2811) || (m_tLEDType == UCS2903)) {
+			uint32_t nOffset = nLEDIndex * 3 * 8;
+			SetColorWS28xx(nOffset, nRed);
+			SetColorWS28xx(nOffset + 8, nGreen);
+			SetColorWS28xx(nOffset + 16, nBlue);
+		} else if (m_tLEDType == UCS1903) {
+			uint32_t nOffset = nLEDIndex * 3 * 8;
+			SetColorWS28xx(nOffset, nBlue);
+			SetColorWS28xx(nOffset + 8, nRed);
+			SetColorWS28xx(nOffset + 16, nGreen);
+		} else {
+			uint32_t nOffset = nLEDIndex * 3 * 8;
+			SetColorWS28xx(nOffset, nGreen);
+			SetColorWS28xx(nOffset + 8, nRed);
+			SetColorWS28xx(nOffset + 16, nBlue);
+		}
+	}
+
+	void SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
+		uint32_t nOffset = nLEDIndex * 4 * 8;
+		SetColorWS28xx(nOffset, nGreen);
+		SetColorWS28xx(nOffset + 8, nRed);
+		SetColorWS28xx(nOffset + 16, nBlue);
+		SetColorWS28xx(nOffset + 24, nWhite);
+	}
+
+private:
+	void SetColorWS28xx(uint32_t nOffset, uint8_t nValue) {
+		for (uint8_t mask = 0x80; mask != 0; mask >>= 1) {
+			if (nValue & mask) {
+				m_pBuffer[nOffset] = m_nHighCode;
+			} else {
+				m_pBuffer[nOffset] = 0xC0;
+			}
+			nOffset++;
+		}
+	}
+
+private:
+	TWS28XXType m_tLEDType;
+	uint8_t m_nGlobalBrightness;
+	uint8_t m_nHighCode;
+	uint8_t *m_pBuffer;
+};
+
+/*
+ * The driver with access to the encoded buffer
+ */
+class WS28xxEncode: public WS28xx {
+public:
+	WS28xxEncode(TWS28XXType tType, uint16_t nLEDCount): WS28xx(tType, nLEDCount) {
+	}
+
+	const uint8_t *GetBuffer(void) {
+		return m_pBuffer;
+	}
+
+	uint32_t GetBufSize(void) {
+		return m_nBufSize;
+	}
+};
+
+static uint8_t s_aPixels[FRAMES][LED_COUNT][4];
+
+template<class T>
+static void encode(T& leds, TWS28XXType tType, uint32_t nFrame) {
+	const uint8_t (*p)[4] = s_aPixels[nFrame];
+
+	if (tType == SK6812W) {
+		for (uint32_t i = 0; i < LED_COUNT; i++) {
+			leds.SetLED(i, p[i][0], p[i][1], p[i][2], p[i][3]);
+		}
+	} else {
+		for (uint32_t i = 0; i < LED_COUNT; i++) {
+			leds.SetLED(i, p[i][0], p[i][1], p[i][2]);
+		}
+	}
+}
+
+/*
+ * Encode time per LED type, only SetLED is measured (no SPI transfer).
+ * The table-driven encoder is compared with the per-bit reference, the buffers must be identical.
+ */
+int main(int argc, char **argv) {
+	srand(1);
+
+	for (uint32_t nFrame = 0; nFrame < FRAMES; nFrame++) {
+		for (uint32_t i = 0; i < LED_COUNT; i++) {
+			for (uint32_t j = 0; j < 4; j++) {
+				s_aPixels[nFrame][i][j] = (uint8_t) rand();
+			}
+		}
+	}
+
+	printf("%d LEDs, %d frames, Mpixel/s\n", LED_COUNT, FRAMES);
+	printf("Type      per-bit  table  speedup  buffer\n");
+
+	int nResult = 0;
+
+	for (uint32_t nType = 0; nType < WS28XX_UNDEFINED; nType++) {
+		const TWS28XXType tType = (TWS28XXType) nType;
+
+		WS28xxEncode leds(tType, LED_COUNT);
+		leds.Initialize();
+
+		// The header and trailer bytes are set by Initialize()
+		uint8_t *pReference = new uint8_t[leds.GetBufSize()];
+		memcpy(pReference, leds.GetBuffer(), leds.GetBufSize());
+
+		WS28xxPerBit reference(tType, pReference);
+
+		bool bIsIdentical = true;
+
+		for (uint32_t nFrame = 0; nFrame < CHECK_FRAMES; nFrame++) {
+			encode(leds, tType, nFrame);
+			encode(reference, tType, nFrame);
+			bIsIdentical &= (memcmp(leds.GetBuffer(), pReference, leds.GetBufSize()) == 0);
+		}
+
+		uint64_t nStart = nanos();
+
+		for (uint32_t nFrame = 0; nFrame < FRAMES; nFrame++) {
+			encode(reference, tType, nFrame);
+		}
+
+		const uint64_t nPerBit = nanos() - nStart;
+
+		nStart = nanos();
+
+		for (uint32_t nFrame = 0; nFrame < FRAMES; nFrame++) {
+			encode(leds, tType, nFrame);
+		}
+
+		const uint64_t nTable = nanos() - nStart;
+
+		// The last frame encoded is the same
+		bIsIdentical &= (memcmp(leds.GetBuffer(), pReference, leds.GetBufSize()) == 0);
+
+		printf("%-8s %8.1f %6.1f %7.2fx  %s\n", WS28xxConst::TYPES[nType],
+				(1e3 * FRAMES * LED_COUNT) / nPerBit, (1e3 * FRAMES * LED_COUNT) / nTable,
+				(double) nPerBit / nTable, bIsIdentical ? "identical" : "DIFFERENT");
+
+		if (!bIsIdentical) {
+			nResult = 1;
+		}
+
+		delete[] pReference;
+	}
+
+	return nResult;
+}
@@ -0,0 +1,225 @@
+/**
+ * @file multi.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ws28xxmulti.h"
+
+#define LED_COUNT_RGB	680
+#define LED_COUNT_RGBW	512
+#define FRAMES			64
+
+static uint64_t nanos(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t) ts.tv_sec * 1000000000) + (uint64_t) ts.tv_nsec;
+}
+
+/*
+ * The per-output encoder as it was before SetLEDRow, the reference.
+ * Outputs 0-3 are bits 0-3, outputs 4-7 are bits 7-10 (bit 6 is the PULSE).
+ */
+class WS28xxMultiPerBit {
+public:
+	WS28xxMultiPerBit(TWS28xxMultiType tType, uint32_t *pBuffer): m_tType(tType), m_pBuffer(pBuffer) {
+	}
+
+	void SetLED(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+		const uint32_t nBit = nPort < 4 ? nPort : nPort + 3;
+		uint32_t *p = &m_pBuffer[nLedIndex * 24];
+
+		for (uint8_t mask = 0x80; mask != 0; mask >>= 1) {
+			if (m_tType == WS28XXMULTI_WS2811) {
+				SetBit(p[0], nBit, mask & nRed);
+				SetBit(p[8], nBit, mask & nGreen);
+				SetBit(p[16], nBit, mask & nBlue);
+			} else if (m_tType == WS28XXMULTI_UCS1903) {
+				SetBit(p[0], nBit, mask & nBlue);
+				SetBit(p[8], nBit, mask & nRed);
+				SetBit(p[16], nBit, mask & nGreen);
+			} else {
+				SetBit(p[0], nBit, mask & nGreen);
+				SetBit(p[8], nBit, mask & nRed);
+				SetBit(p[16], nBit, mask & nBlue);
+			}
+			p++;
+		}
+	}
+
+	void SetLED(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
+		const uint32_t nBit = nPort < 4 ? nPort : nPort + 3;
+		uint32_t *p = &m_pBuffer[nLedIndex * 32];
+
+		for (uint8_t mask = 0x80; mask != 0; mask >>= 1) {
+			SetBit(p[0], nBit, mask & nGreen);
+			SetBit(p[8], nBit, mask & nRed);
+			SetBit(p[16], nBit, mask & nBlue);
+			SetBit(p[24], nBit, mask & nWhite);
+			p++;
+		}
+	}
+
+private:
+	static void SetBit(uint32_t &nWord, uint32_t nBit, uint32_t nIsSet) {
+		if (nIsSet) {
+			nWord |= (1U << nBit);
+		} else {
+			nWord &= ~(1U << nBit);
+		}
+	}
+
+private:
+	TWS28xxMultiType m_tType;
+	uint32_t *m_pBuffer;
+};
+
+/*
+ * The driver with access to the encoded buffer
+ */
+class WS28xxMultiEncode: public WS28xxMulti {
+public:
+	WS28xxMultiEncode(TWS28xxMultiType tType, uint16_t nLedCount, uint8_t nActiveOutputs): WS28xxMulti(tType, nLedCount, nActiveOutputs) {
+	}
+
+	const uint32_t *GetBuffer(void) {
+		return m_pBuffer;
+	}
+
+	uint32_t GetBufSize(void) {
+		return m_nBufSize;
+	}
+};
+
+static const char *s_pTypes[] = { "WS2801", "WS2811", "WS2812", "WS2812B", "WS2813", "WS2815", "SK6812", "SK6812W", "APA102", "UCS1903" };
+
+static uint8_t s_aPixels[FRAMES][LED_COUNT_RGB][WS28XXMULTI_ACTIVE_PORTS_MAX * 4];	///< A row of the outputs, output 0 first
+
+template<class T>
+static void encode_per_output(T& leds, bool bIsRGBW, uint32_t nLedCount, uint32_t nOutputs, uint32_t nFrame) {
+	for (uint32_t nPort = 0; nPort < nOutputs; nPort++) {
+		for (uint32_t i = 0; i < nLedCount; i++) {
+			if (bIsRGBW) {
+				const uint8_t *p = &s_aPixels[nFrame][i][nPort * 4];
+				leds.SetLED(nPort, i, p[0], p[1], p[2], p[3]);
+			} else {
+				const uint8_t *p = &s_aPixels[nFrame][i][nPort * 3];
+				leds.SetLED(nPort, i, p[0], p[1], p[2]);
+			}
+		}
+	}
+}
+
+static void encode_row(WS28xxMultiEncode& leds, uint32_t nLedCount, uint32_t nFrame) {
+	for (uint32_t i = 0; i < nLedCount; i++) {
+		leds.SetLEDRow(i, s_aPixels[nFrame][i]);
+	}
+}
+
+/*
+ * SetLEDRow (all outputs of a pixel with an 8x8 bit transpose) is compared with
+ * the per-output SetLED and with the per-bit reference: the buffers must be identical.
+ * Only the encoding is measured.
+ */
+int main(int argc, char **argv) {
+	srand(1);
+
+	for (uint32_t nFrame = 0; nFrame < FRAMES; nFrame++) {
+		for (uint32_t i = 0; i < LED_COUNT_RGB; i++) {
+			for (uint32_t j = 0; j < sizeof(s_aPixels[0][0]); j++) {
+				s_aPixels[nFrame][i][j] = (uint8_t) rand();
+			}
+		}
+	}
+
+	printf("%d RGB / %d RGBW LEDs per output, %d frames, us per frame\n", LED_COUNT_RGB, LED_COUNT_RGBW, FRAMES);
+	printf("Type     outputs  per-bit  SetLED  SetLEDRow  speedup  buffer\n");
+
+	int nResult = 0;
+
+	for (uint32_t nType = WS28XXMULTI_WS2811; nType <= WS28XXMULTI_UCS1903; nType++) {
+		if (nType == WS28XXMULTI_APA102_NOT_SUPPORTED) {
+			continue;
+		}
+
+		const TWS28xxMultiType tType = static_cast<TWS28xxMultiType>(nType);
+		const bool bIsRGBW = (tType == WS28XXMULTI_SK6812W);
+		const uint32_t nLedCount = bIsRGBW ? LED_COUNT_RGBW : LED_COUNT_RGB;
+
+		for (uint32_t nOutputs = 4; nOutputs <= WS28XXMULTI_ACTIVE_PORTS_MAX; nOutputs += 4) {
+			WS28xxMultiEncode perOutput(tType, nLedCount, nOutputs);
+			WS28xxMultiEncode row(tType, nLedCount, nOutputs);
+
+			const uint32_t nBufSize = row.GetBufSize();
+			uint32_t *pReference = new uint32_t[nBufSize];
+			memcpy(pReference, row.GetBuffer(), nBufSize * sizeof(uint32_t));
+
+			WS28xxMultiPerBit reference(tType, pReference);
+
+			uint64_t nStart = nanos();
+
+			for (uint32_t nFrame = 0; nFrame < FRAMES; nFrame++) {
+				encode_per_output(reference, bIsRGBW, nLedCount, nOutputs, nFrame);
+			}
+
+			const uint64_t nPerBit = nanos() - nStart;
+
+			nStart = nanos();
+
+			for (uint32_t nFrame = 0; nFrame < FRAMES; nFrame++) {
+				encode_per_output(perOutput, bIsRGBW, nLedCount, nOutputs, nFrame);
+			}
+
+			const uint64_t nSetLED = nanos() - nStart;
+
+			nStart = nanos();
+
+			for (uint32_t nFrame = 0; nFrame < FRAMES; nFrame++) {
+				encode_row(row, nLedCount, nFrame);
+			}
+
+			const uint64_t nSetLEDRow = nanos() - nStart;
+
+			// The last frame encoded is the same, the PULSE bits are kept
+			const bool bIsIdentical = (memcmp(row.GetBuffer(), pReference, nBufSize * sizeof(uint32_t)) == 0)
+					&& (memcmp(perOutput.GetBuffer(), pReference, nBufSize * sizeof(uint32_t)) == 0);
+
+			printf("%-8s %7u %8.1f %7.1f %10.1f %7.2fx  %s\n", s_pTypes[nType], (unsigned) nOutputs,
+					nPerBit / (1e3 * FRAMES), nSetLED / (1e3 * FRAMES), nSetLEDRow / (1e3 * FRAMES),
+					(double) nSetLED / nSetLEDRow, bIsIdentical ? "identical" : "DIFFERENT");
+
+			if (!bIsIdentical) {
+				nResult = 1;
+			}
+
+			delete[] pReference;
+		}
+	}
+
+	return nResult;
+}
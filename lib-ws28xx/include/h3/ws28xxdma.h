@@ -46,6 +46,9 @@ public:
 	bool IsUpdating (void) { // returns TRUE while DMA operation is active
 		return h3_spi_dma_tx_is_active();
 	}
+
+private:
+	uint8_t *m_pDMABuffer;	///< Clocked out by the DMA, m_pBuffer is encoded meanwhile
 };
 
 #endif /* WS28XXDMA_H_ */
@@ -27,6 +27,7 @@
 #define WS28XX_H_
 
 #include <stdint.h>
+#include <string.h>
 #include <stdbool.h>
 
 #if defined (__circle__)
@@ -81,8 +82,17 @@ public:
 		return m_nGlobalBrightness;
 	}
 
-	void SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue);
-	void SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite);
+	void SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+		(this->*m_pSetLED)(nLEDIndex, nRed, nGreen, nBlue);
+	}
+	void SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
+		(this->*m_pSetLEDW)(nLEDIndex, nRed, nGreen, nBlue, nWhite);
+	}
+
+	/**
+	 * Copies the encoded LED nLEDIndex to the next nCount LEDs
+	 */
+	void RepeatLED(uint32_t nLEDIndex, uint32_t nCount);
 
 	void Update(void);
 	void Blackout(void);
@@ -99,8 +109,41 @@ public:
 	static const char *GetLedTypeString(TWS28XXType tType);
 	static TWS28XXType GetLedTypeString(const char *pVale);
 
+protected:
+	/**
+	 * Nothing has been encoded since the last Update()
+	 */
+	void ClearDirty(void) {
+		m_nDirtyFirst = m_nBufSize;
+		m_nDirtyLast = 0;
+	}
+
+	/**
+	 * Copies the bytes encoded since the last Update() from pSource into m_pBuffer.
+	 * With ping-pong buffers only these differ between the buffer just sent and the idle buffer.
+	 */
+	void CopyDirty(const uint8_t *pSource) {
+		if (m_nDirtyFirst < m_nDirtyLast) {
+			memcpy(&m_pBuffer[m_nDirtyFirst], &pSource[m_nDirtyFirst], m_nDirtyLast - m_nDirtyFirst);
+		}
+		ClearDirty();
+	}
+
 private:
-	void SetColorWS28xx(uint32_t nOffset, uint8_t nValue);
+	void InitializeEncoder(void);
+
+	void SetDirty(uint32_t nFirst, uint32_t nLast) {
+		if (nFirst < m_nDirtyFirst) {
+			m_nDirtyFirst = nFirst;
+		}
+		if (nLast > m_nDirtyLast) {
+			m_nDirtyLast = nLast;
+		}
+	}
+
+	template<typename T> void SelectEncoder(void);
+	template<typename T> void SetLEDEncoder(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue);
+	template<typename T> void SetLEDEncoderW(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite);
 
 #if defined (__circle__)
 private:
@@ -120,7 +163,16 @@ protected:
 	alignas(uint32_t) uint8_t *m_pBlackoutBuffer;
 
 private:
+	void (WS28xx::*m_pSetLED)(uint32_t, uint8_t, uint8_t, uint8_t);	///< Selected for the LED type at construction
+	void (WS28xx::*m_pSetLEDW)(uint32_t, uint8_t, uint8_t, uint8_t, uint8_t);
+	uint32_t m_nLEDSize;		///< Encoded bytes per LED
+	uint32_t m_nHeader;			///< Start frame bytes
+	uint32_t m_nDirtyFirst;		///< Byte range of m_pBuffer encoded since the last Update()
+	uint32_t m_nDirtyLast;
+	alignas(uint64_t) uint64_t m_aBitExpand[256];	///< A colour byte expanded into 8 SPI bytes, for m_nHighCode
+
 #if defined (__circle__)
+	uint8_t *m_pDMABuffer;	///< Clocked out by the DMA, m_pBuffer is encoded meanwhile
 	uint8_t *m_pReadBuffer;
 	CSPIMasterDMA m_SPIMaster;
 #endif
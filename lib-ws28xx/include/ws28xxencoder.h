@@ -0,0 +1,131 @@
+/**
+ * @file ws28xxencoder.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef WS28XXENCODER_H_
+#define WS28XXENCODER_H_
+
+#include <stdint.h>
+
+/*
+ * The wire format of a LED type. Everything is a compile-time constant,
+ * an encoder is selected once when the driver is constructed.
+ *
+ * RED, GREEN, BLUE and WHITE are the positions of the colours on the wire.
+ * LED_SIZE is the number of bytes per LED in the SPI buffer, HEADER and
+ * TRAILER are the start and end frame bytes around the LEDs.
+ */
+
+namespace ws28xx {
+
+struct EncoderWS2801 {
+	enum {
+		COLOURS = 3, RED = 0, GREEN = 1, BLUE = 2, WHITE = 3,
+		LED_SIZE = 3, HEADER = 0, TRAILER = 0,
+		HIGH_CODE = 0, LOW_CODE = 0
+	};
+
+	static void Encode(uint8_t *p, const uint64_t *pBitExpand, uint8_t nBrightness, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+		p[RED] = nRed;
+		p[GREEN] = nGreen;
+		p[BLUE] = nBlue;
+	}
+
+	static void Encode(uint8_t *p, const uint64_t *pBitExpand, uint8_t nBrightness, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
+		Encode(p, pBitExpand, nBrightness, nRed, nGreen, nBlue);
+	}
+};
+
+/*
+ * Start frame 4 x 0x00, LED frame 0xE0 | brightness, end frame 4 x 0xFF
+ */
+struct EncoderAPA102 {
+	enum {
+		COLOURS = 3, RED = 0, GREEN = 1, BLUE = 2, WHITE = 3,
+		LED_SIZE = 4, HEADER = 4, TRAILER = 4,
+		HIGH_CODE = 0, LOW_CODE = 0
+	};
+
+	static void Encode(uint8_t *p, const uint64_t *pBitExpand, uint8_t nBrightness, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+		p[0] = nBrightness;
+		p[1 + RED] = nRed;
+		p[1 + GREEN] = nGreen;
+		p[1 + BLUE] = nBlue;
+	}
+
+	static void Encode(uint8_t *p, const uint64_t *pBitExpand, uint8_t nBrightness, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
+		Encode(p, pBitExpand, nBrightness, nRed, nGreen, nBlue);
+	}
+};
+
+/*
+ * Each colour bit is one SPI byte at 6.4MHz: HIGH_CODE for a 1, LOW_CODE for a 0.
+ * pBitExpand holds a colour byte expanded into its 8 SPI bytes.
+ * The pixel buffers are only guaranteed to be 4 byte aligned (malloc), so the
+ * 8 SPI bytes are written with two 32-bit stores.
+ */
+inline void StoreBits(uint8_t *p, uint64_t nBits) {
+	uint32_t *p32 = reinterpret_cast<uint32_t *>(p);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	p32[0] = static_cast<uint32_t>(nBits >> 32);
+	p32[1] = static_cast<uint32_t>(nBits);
+#else
+	p32[0] = static_cast<uint32_t>(nBits);
+	p32[1] = static_cast<uint32_t>(nBits >> 32);
+#endif
+}
+
+template<uint8_t T_HIGH_CODE, uint32_t T_RED, uint32_t T_GREEN, uint32_t T_BLUE, uint32_t T_COLOURS = 3>
+struct EncoderWS281x {
+	enum {
+		COLOURS = T_COLOURS, RED = T_RED, GREEN = T_GREEN, BLUE = T_BLUE, WHITE = 3,
+		LED_SIZE = T_COLOURS * 8, HEADER = 0, TRAILER = 0,
+		HIGH_CODE = T_HIGH_CODE, LOW_CODE = 0xC0
+	};
+
+	static void Encode(uint8_t *p, const uint64_t *pBitExpand, uint8_t nBrightness, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+		StoreBits(&p[RED * 8], pBitExpand[nRed]);
+		StoreBits(&p[GREEN * 8], pBitExpand[nGreen]);
+		StoreBits(&p[BLUE * 8], pBitExpand[nBlue]);
+	}
+
+	static void Encode(uint8_t *p, const uint64_t *pBitExpand, uint8_t nBrightness, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
+		Encode(p, pBitExpand, nBrightness, nRed, nGreen, nBlue);
+
+		if (COLOURS == 4) {
+			StoreBits(&p[WHITE * 8], pBitExpand[nWhite]);
+		}
+	}
+};
+
+typedef EncoderWS281x<0xF0, 0, 1, 2> EncoderWS2811;		///< RGB
+typedef EncoderWS281x<0xF0, 1, 0, 2> EncoderWS2812;		///< GRB, also WS2813, WS2815 and SK6812
+typedef EncoderWS281x<0xF8, 1, 0, 2> EncoderWS2812B;	///< GRB
+typedef EncoderWS281x<0xF0, 1, 0, 2, 4> EncoderSK6812W;	///< GRBW
+typedef EncoderWS281x<0xFC, 1, 2, 0> EncoderUCS1903;	///< BRG
+typedef EncoderWS281x<0xFC, 0, 1, 2> EncoderUCS2903;	///< RGB
+
+}  // namespace ws28xx
+
+#endif /* WS28XXENCODER_H_ */
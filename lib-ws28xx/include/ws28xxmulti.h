@@ -44,9 +44,24 @@ enum TWS28xxMultiType {
 };
 
 enum WS28xxMultiActivePorts {
-	WS28XXMULTI_ACTIVE_PORTS_MAX = 4
+	WS28XXMULTI_ACTIVE_PORTS_MAX = 8
 };
 
+enum WS28xxMultiLedCount {
+	WS28XXMULTI_LEDCOUNT_RGB_MAX = (6 * 170),	///< Per output, 6 universes
+	WS28XXMULTI_LEDCOUNT_RGBW_MAX = (6 * 128)	///< Per output, 6 universes
+};
+
+/*
+ * Each bit is a word in the buffer, clocked out at 800kHz -> 1.25us per bit.
+ * All outputs are clocked out in parallel, so the frame time depends on the LED count only:
+ *  RGB  : 24 bits x 1.25us = 30us per pixel -> 170 pixels 5.1ms, 680 pixels 20.4ms, 1020 pixels 30.6ms
+ *  RGBW : 32 bits x 1.25us = 40us per pixel -> 128 pixels 5.1ms, 512 pixels 20.5ms,  768 pixels 30.7ms
+ * followed by the reset (latch) time.
+ */
+#define WS28XXMULTI_BIT_TIME_NS		1250
+#define WS28XXMULTI_RESET_TIME_US	280
+
 class WS28xxMulti {
 public:
 	WS28xxMulti(TWS28xxMultiType tWS28xxMultiType, uint16_t nLedCount, uint8_t nActiveOutputs, uint8_t nT0H = 0, uint8_t nT1H = 0, bool bUseSI5351A = false);
@@ -72,28 +87,62 @@ public:
 		return m_nHighCode;
 	}
 
-	void SetLED(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue);
-	void SetLED(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite);
+	void SetLED(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+		(this->*m_pSetLED)(nPort, nLedIndex, nRed, nGreen, nBlue);
+	}
+	void SetLED(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
+		(this->*m_pSetLEDW)(nPort, nLedIndex, nRed, nGreen, nBlue, nWhite);
+	}
+
+	/**
+	 * Encodes pixel nLedIndex of all outputs at once.
+	 * pPixels holds GetActiveOutputs() pixels of 3 (RGB) or 4 (RGBW) bytes, output 0 first.
+	 */
+	void SetLEDRow(uint16_t nLedIndex, const uint8_t *pPixels) {
+		(this->*m_pSetLEDRow)(nLedIndex, pPixels);
+	}
 
 	void Update(void);
 	void Blackout(void);
 
+	/**
+	 * Time in micro seconds to clock out one frame, including the reset time
+	 */
+	uint32_t GetFrameTime(void);
+
 private:
+	/*
+	 * Outputs 0-3 are bits 0-3 in the buffer, outputs 4-7 are bits 7-10 (bit 6 is the PULSE)
+	 */
+	static uint32_t GetPortBit(uint32_t nPort) {
+		return nPort < 4 ? nPort : nPort + 3;
+	}
+	void InitializeEncoder(void);
+	template<typename T> void SelectEncoder(void);
+	template<typename T> void SetLEDEncoder(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue);
+	template<typename T> void SetLEDEncoderW(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite);
+	template<typename T> void SetLEDRowEncoder(uint16_t nLedIndex, const uint8_t *pPixels);
 	uint8_t CalculateBits(uint8_t nNanoSeconds);
 	uint8_t ReverseBits(uint8_t nBits);
 	bool SetupSI5351A(void);
 	bool SetupMCP23017(uint8_t nT0H, uint8_t nT1H);
 	void Generate800kHz(const uint32_t *pBuffer);
 
-private:
+protected:
 	TWS28xxMultiType m_tWS28xxMultiType;
 	uint16_t m_nLedCount;
 	uint8_t m_nActiveOutputs;
 	uint8_t m_nLowCode;
 	uint8_t m_nHighCode;
 	uint32_t m_nBufSize;
+	uint32_t m_nPortsMask;
 	uint32_t *m_pBuffer;
 	uint32_t *m_pBlackoutBuffer;
+
+private:
+	void (WS28xxMulti::*m_pSetLED)(uint8_t, uint16_t, uint8_t, uint8_t, uint8_t);	///< Selected for the LED type at construction
+	void (WS28xxMulti::*m_pSetLEDW)(uint8_t, uint16_t, uint8_t, uint8_t, uint8_t, uint8_t);
+	void (WS28xxMulti::*m_pSetLEDRow)(uint16_t, const uint8_t *);
 };
 
 #endif /* WS28XXMULTI_H_ */
@@ -40,25 +40,12 @@ WS28xx::WS28xx (CInterruptSystem *pInterruptSystem, TWS28XXType Type, uint16_t n
 	m_nClockSpeedHz(nClockSpeed),
 	m_nGlobalBrightness(0xFF),
 	m_bUpdating (FALSE),
-	m_nHighCode(Type == WS2812B ? 0xF8 : (((Type == UCS1903) || (Type == UCS2903)) ? 0xFC : 0xF0)),
 	m_SPIMaster (pInterruptSystem, ((m_tLEDType == WS2801) || (m_tLEDType == APA102)) ? (nClockSpeed == 0 ? WS2801_SPI_SPEED_DEFAULT_HZ : nClockSpeed) : 6400000, 0, 0)
 {
 	assert(m_tLEDType <= UCS2903);
 	assert(m_nLEDCount > 0);
 
-	if ((m_tLEDType == SK6812W) || (m_tLEDType == APA102)) {
-		m_nBufSize = m_nLEDCount * 4;
-	} else {
-		m_nBufSize = m_nLEDCount * 3;
-	}
-
-	if (m_tLEDType == WS2811 || m_tLEDType == WS2812 || m_tLEDType == WS2812B || m_tLEDType == WS2813 || m_tLEDType == WS2815 || m_tLEDType == SK6812 || m_tLEDType == SK6812W || m_tLEDType == UCS1903 || m_tLEDType == UCS2903) {
-		m_nBufSize *= 8;
-	}
-
-	if (m_tLEDType == APA102) {
-		m_nBufSize += 8;
-	}
+	InitializeEncoder();
 
 	m_pBuffer = new u8[m_nBufSize];
 	assert(m_pBuffer != 0);
@@ -73,12 +60,18 @@ WS28xx::WS28xx (CInterruptSystem *pInterruptSystem, TWS28XXType Type, uint16_t n
 		memset(m_pBuffer, m_tLEDType == WS2801 ? 0 : 0xC0, m_nBufSize);
 	}
 
+	m_pDMABuffer = new u8[m_nBufSize];
+	assert(m_pDMABuffer != 0);
+	memcpy(m_pDMABuffer, m_pBuffer, m_nBufSize);
+
 	m_pReadBuffer = new u8[m_nBufSize];
 	assert(m_pReadBuffer != 0);
 
 	m_pBlackoutBuffer = new u8[m_nBufSize];
 	assert(m_pBlackoutBuffer != 0);
 	memcpy(m_pBlackoutBuffer, m_pBuffer, m_nBufSize);
+
+	ClearDirty();
 }
 
 WS28xx::~WS28xx(void) {
@@ -92,6 +85,9 @@ WS28xx::~WS28xx(void) {
 	delete[] m_pReadBuffer;
 	m_pReadBuffer = 0;
 
+	delete[] m_pDMABuffer;
+	m_pDMABuffer = 0;
+
 	delete[] m_pBuffer;
 	m_pBuffer = 0;
 }
@@ -109,6 +105,14 @@ void WS28xx::Update(void) {
 	assert(m_pBuffer != 0);
 	assert(m_pReadBuffer != 0);
 	m_SPIMaster.StartWriteRead(0, m_pBuffer, m_pReadBuffer, m_nBufSize);
+
+	// The next frame is encoded into the idle buffer while this one is clocked out
+	u8 *pBuffer = m_pDMABuffer;
+	m_pDMABuffer = m_pBuffer;
+	m_pBuffer = pBuffer;
+
+	// Only changed pixels are encoded, so the idle buffer continues from the frame just sent
+	CopyDirty(m_pDMABuffer);
 }
 
 void WS28xx::Blackout(void) {
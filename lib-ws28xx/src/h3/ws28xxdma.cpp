@@ -35,11 +35,12 @@
 
 #include "debug.h"
 
-WS28xxDMA::WS28xxDMA(TWS28XXType Type, uint16_t nLEDCount, uint32_t nClockSpeed): WS28xx(Type, nLEDCount, nClockSpeed) {
+WS28xxDMA::WS28xxDMA(TWS28XXType Type, uint16_t nLEDCount, uint32_t nClockSpeed): WS28xx(Type, nLEDCount, nClockSpeed), m_pDMABuffer(0) {
 }
 
 WS28xxDMA::~WS28xxDMA(void) {
 	m_pBlackoutBuffer = 0;
+	m_pDMABuffer = 0;
 	m_pBuffer = 0;
 }
 
@@ -49,14 +50,16 @@ bool WS28xxDMA::Initialize(void) {
 	m_pBuffer = (uint8_t *)h3_spi_dma_tx_prepare(&nSize);
 	assert(m_pBuffer != 0);
 
-	const uint32_t nSizeHalf = nSize / 2;
-	assert(m_nBufSize <= nSizeHalf);
+	// Two buffers for ping-pong, one for blackout
+	const uint32_t nSizeThird = (nSize / 3) & ~3;
+	assert(m_nBufSize <= nSizeThird);
 
-	if (m_nBufSize > nSizeHalf) {
+	if (m_nBufSize > nSizeThird) {
 		return false;
 	}
 
-	m_pBlackoutBuffer = m_pBuffer + (nSizeHalf & ~3);
+	m_pDMABuffer = m_pBuffer + nSizeThird;
+	m_pBlackoutBuffer = m_pDMABuffer + nSizeThird;
 
 	if (m_tLEDType == APA102) {
 		memset(m_pBuffer, 0, 4);
@@ -68,9 +71,11 @@ bool WS28xxDMA::Initialize(void) {
 		memset(m_pBuffer, m_tLEDType == WS2801 ? 0 : 0xC0, m_nBufSize);
 	}
 
+	memcpy(m_pDMABuffer, m_pBuffer, m_nBufSize);
 	memcpy(m_pBlackoutBuffer, m_pBuffer, m_nBufSize);
+	ClearDirty();
 
-	DEBUG_PRINTF("nSize=%x, m_pBuffer=%p, m_pBlackoutBuffer=%p", nSize, m_pBuffer, m_pBlackoutBuffer);
+	DEBUG_PRINTF("nSize=%x, m_pBuffer=%p, m_pDMABuffer=%p, m_pBlackoutBuffer=%p", nSize, m_pBuffer, m_pDMABuffer, m_pBlackoutBuffer);
 
 	Blackout();
 
@@ -82,6 +87,14 @@ void WS28xxDMA::Update(void) {
 	assert(!IsUpdating());
 
 	h3_spi_dma_tx_start(m_pBuffer, m_nBufSize);
+
+	// The next frame is encoded into the idle buffer while this one is clocked out
+	uint8_t *pBuffer = m_pDMABuffer;
+	m_pDMABuffer = m_pBuffer;
+	m_pBuffer = pBuffer;
+
+	// Only changed pixels are encoded, so the idle buffer continues from the frame just sent
+	CopyDirty(m_pDMABuffer);
 }
 
 void WS28xxDMA::Blackout(void) {
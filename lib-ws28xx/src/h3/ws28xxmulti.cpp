@@ -38,10 +38,6 @@
 
 #include "debug.h"
 
-enum {
-	LEDCOUNT_RGB_MAX = (4 * 170), LEDCOUNT_RGBW_MAX = (4 * 128)
-};
-
 enum {
 	SINGLE_RGB = 24, SINGLE_RGBW = 32
 };
@@ -53,11 +49,14 @@ enum {
 #define OUT1	H3_PORT_TO_GPIO(H3_GPIO_PORTA, 1)	// Pin 11
 #define OUT2	H3_PORT_TO_GPIO(H3_GPIO_PORTA, 2)	// Pin 22
 #define OUT3	H3_PORT_TO_GPIO(H3_GPIO_PORTA, 3)	// Pin 15
+#define OUT4	H3_PORT_TO_GPIO(H3_GPIO_PORTA, 7)	// Pin 29
+#define OUT5	H3_PORT_TO_GPIO(H3_GPIO_PORTA, 8)	// Pin 31
+#define OUT6	H3_PORT_TO_GPIO(H3_GPIO_PORTA, 9)	// Pin 33
+#define OUT7	H3_PORT_TO_GPIO(H3_GPIO_PORTA, 10)	// Pin 35
 
-#define DATA_MASK	((1 << PULSE) | (1 << ENABLE) | (1 << OUT3) | (1 << OUT2) | (1 << OUT1) | (1 << OUT0))
+#define CONTROL_MASK	((1 << PULSE) | (1 << ENABLE))
 
-#define BIT_SET(a,b) 	((a) |= (1<<(b)))
-#define BIT_CLEAR(a,b) 	((a) &= ~(1<<(b)))
+static const uint8_t s_Out[WS28XXMULTI_ACTIVE_PORTS_MAX] = {OUT0, OUT1, OUT2, OUT3, OUT4, OUT5, OUT6, OUT7};
 
 static TWS28xxMultiType s_NotSupported[] = {WS28XXMULTI_WS2801_NOT_SUPPORTED, WS28XXMULTI_APA102_NOT_SUPPORTED};
 
@@ -68,6 +67,7 @@ WS28xxMulti::WS28xxMulti(TWS28xxMultiType tWS28xxMultiType, uint16_t nLedCount,
 	m_nLowCode(CalculateBits(nT0H)),
 	m_nHighCode(CalculateBits(nT1H)),
 	m_nBufSize(0),
+	m_nPortsMask(0),
 	m_pBuffer(0),
 	m_pBlackoutBuffer(0)
 {
@@ -84,24 +84,27 @@ WS28xxMulti::WS28xxMulti(TWS28xxMultiType tWS28xxMultiType, uint16_t nLedCount,
 		}
 	}
 
+	InitializeEncoder();
+
 	if (m_tWS28xxMultiType == WS28XXMULTI_SK6812W) {
-		m_nLedCount =  nLedCount <= LEDCOUNT_RGBW_MAX ? nLedCount : LEDCOUNT_RGBW_MAX;
-		m_nBufSize = nLedCount * SINGLE_RGBW;
+		m_nLedCount =  nLedCount <= WS28XXMULTI_LEDCOUNT_RGBW_MAX ? nLedCount : WS28XXMULTI_LEDCOUNT_RGBW_MAX;
+		m_nBufSize = m_nLedCount * SINGLE_RGBW;
 	} else {
-		m_nLedCount =  nLedCount <= LEDCOUNT_RGB_MAX ? nLedCount : LEDCOUNT_RGB_MAX;
-		m_nBufSize = nLedCount * SINGLE_RGB;
+		m_nLedCount =  nLedCount <= WS28XXMULTI_LEDCOUNT_RGB_MAX ? nLedCount : WS28XXMULTI_LEDCOUNT_RGB_MAX;
+		m_nBufSize = m_nLedCount * SINGLE_RGB;
+	}
+
+	for (uint32_t nPort = 0; nPort < m_nActiveOutputs; nPort++) {
+		m_nPortsMask |= (1U << GetPortBit(nPort));
 	}
 
 	DEBUG_PRINTF("type=%d, count=%d, active=%d, bufsize=%d", m_tWS28xxMultiType, m_nLedCount, m_nActiveOutputs, m_nBufSize);
 
-	h3_gpio_fsel(OUT0, GPIO_FSEL_OUTPUT);
-	h3_gpio_clr(OUT0);
-	h3_gpio_fsel(OUT1, GPIO_FSEL_OUTPUT);
-	h3_gpio_clr(OUT1);
-	h3_gpio_fsel(OUT2, GPIO_FSEL_OUTPUT);
-	h3_gpio_clr(OUT2);
-	h3_gpio_fsel(OUT3, GPIO_FSEL_OUTPUT);
-	h3_gpio_clr(OUT3);
+	for (uint32_t nPort = 0; nPort < m_nActiveOutputs; nPort++) {
+		assert(s_Out[nPort] == GetPortBit(nPort));
+		h3_gpio_fsel(s_Out[nPort], GPIO_FSEL_OUTPUT);
+		h3_gpio_clr(s_Out[nPort]);
+	}
 
 	h3_gpio_fsel(PULSE, GPIO_FSEL_OUTPUT);
 	h3_gpio_set(PULSE);
@@ -113,9 +116,6 @@ WS28xxMulti::WS28xxMulti(TWS28xxMultiType tWS28xxMultiType, uint16_t nLedCount,
 		SetupSI5351A();
 	}
 
-	m_nLowCode = 0xC0;
-	m_nHighCode = (m_tWS28xxMultiType == WS28XXMULTI_WS2812B ? 0xF8 : (((m_tWS28xxMultiType == WS28XXMULTI_UCS1903) || (m_tWS28xxMultiType == WS28XXMULTI_UCS2903)) ? 0xFC : 0xF0));
-
 	SetupMCP23017(ReverseBits(m_nLowCode), ReverseBits(m_nHighCode));
 
 	m_pBuffer = new uint32_t[m_nBufSize];
@@ -141,115 +141,6 @@ WS28xxMulti::~WS28xxMulti(void) {
 	m_pBuffer = 0;
 }
 
-void WS28xxMulti::SetLED(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
-	assert(nPort < WS28XXMULTI_ACTIVE_PORTS_MAX);
-	assert(nLedIndex < m_nLedCount);
-
-	uint32_t j = 0;
-	uint32_t k = nLedIndex * SINGLE_RGB;
-
-	for (uint8_t mask = 0x80; mask != 0; mask >>= 1) {
-		if (m_tWS28xxMultiType == WS28XXMULTI_WS2811) {
-			// RGB
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer[k + j], nPort);
-			}
-
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer[8 + k + j], nPort);
-			}
-
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer[16 + k + j], nPort);
-			}
-		} else if  (m_tWS28xxMultiType == WS28XXMULTI_UCS1903) {
-			// BRG
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer[k + j], nPort);
-			}
-
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer[8 + k + j], nPort);
-			}
-
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer[16 + k + j], nPort);
-			}
-		} else {
-			// GRB
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer[k + j], nPort);
-			}
-
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer[8 + k + j], nPort);
-			}
-
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer[16 + k + j], nPort);
-			}
-		}
-
-		j++;
-	}
-}
-
-void WS28xxMulti::SetLED(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
-	assert(nPort < WS28XXMULTI_ACTIVE_PORTS_MAX);
-	assert(nLedIndex < m_nLedCount);
-	assert(m_tWS28xxMultiType == WS28XXMULTI_SK6812W);
-
-	uint32_t j = 0;
-	uint32_t k = nLedIndex * SINGLE_RGBW;
-
-	for (uint8_t mask = 0x80; mask != 0; mask >>= 1) {
-		// GRB
-		if (mask & nGreen) {
-			BIT_SET(m_pBuffer[k + j], nPort);
-		} else {
-			BIT_CLEAR(m_pBuffer[k + j], nPort);
-		}
-
-		if (mask & nRed) {
-			BIT_SET(m_pBuffer[8 + k + j], nPort);
-		} else {
-			BIT_CLEAR(m_pBuffer[8 + k + j], nPort);
-		}
-
-		if (mask & nBlue) {
-			BIT_SET(m_pBuffer[16 + k + j], nPort);
-		} else {
-			BIT_CLEAR(m_pBuffer[16 + k + j], nPort);
-		}
-
-		if (mask & nWhite) {
-			BIT_SET(m_pBuffer[24 + k + j], nPort);
-		} else {
-			BIT_CLEAR(m_pBuffer[24 + k + j], nPort);
-		}
-
-		j++;
-	}
-}
-
 void WS28xxMulti::Update(void) {
 	Generate800kHz(m_pBuffer);
 }
@@ -265,6 +156,7 @@ void WS28xxMulti::Blackout(void) {
 void WS28xxMulti::Generate800kHz(const uint32_t* pBuffer) {
 	uint32_t i = 0;
 	const uint32_t d = (125 * 24) / 100;
+	const uint32_t nDataMask = CONTROL_MASK | m_nPortsMask;
 	uint32_t dat;
 
 	do {
@@ -272,7 +164,7 @@ void WS28xxMulti::Generate800kHz(const uint32_t* pBuffer) {
 		asm volatile("mrrc p15, 1, %Q0, %R0, c14" : "=r" (cval));
 
 		dat = H3_PIO_PORTA->DAT;
-		dat &= (~(DATA_MASK));
+		dat &= (~nDataMask);
 		dat |= pBuffer[i];
 		H3_PIO_PORTA->DAT = dat;
 
@@ -342,7 +234,3 @@ bool WS28xxMulti::SetupMCP23017(uint8_t nT0H, uint8_t nT1H) {
 
 	return true;
 }
-
-uint8_t WS28xxMulti::CalculateBits(uint8_t nNanoSeconds) {
-	return 0;
-}
@@ -26,6 +26,7 @@
  * THE SOFTWARE.
  */
 
+#include <stdio.h>
 #include <stdint.h>
 #include <assert.h>
 
@@ -33,19 +34,12 @@
 
 #include "debug.h"
 
-enum {
-	LEDCOUNT_RGB_MAX = (4 * 170), LEDCOUNT_RGBW_MAX = (4 * 128)
-};
-
 enum {
 	SINGLE_RGB = 24, SINGLE_RGBW = 32
 };
 
 #define PULSE 	(6)
 
-#define BIT_SET(a,b) 	((a) |= (1<<(b)))
-#define BIT_CLEAR(a,b) 	((a) &= ~(1<<(b)))
-
 static TWS28xxMultiType s_NotSupported[] = {WS28XXMULTI_WS2801_NOT_SUPPORTED, WS28XXMULTI_APA102_NOT_SUPPORTED};
 
 WS28xxMulti::WS28xxMulti(TWS28xxMultiType tWS28xxMultiType, uint16_t nLedCount, uint8_t nActiveOutputs, uint8_t nT0H, uint8_t nT1H, bool bUseSI5351A):
@@ -55,6 +49,7 @@ WS28xxMulti::WS28xxMulti(TWS28xxMultiType tWS28xxMultiType, uint16_t nLedCount,
 	m_nLowCode(CalculateBits(nT0H)),
 	m_nHighCode(CalculateBits(nT1H)),
 	m_nBufSize(0),
+	m_nPortsMask(0),
 	m_pBuffer(0),
 	m_pBlackoutBuffer(0)
 {
@@ -71,12 +66,18 @@ WS28xxMulti::WS28xxMulti(TWS28xxMultiType tWS28xxMultiType, uint16_t nLedCount,
 		}
 	}
 
+	InitializeEncoder();
+
 	if (m_tWS28xxMultiType == WS28XXMULTI_SK6812W) {
-		m_nLedCount =  nLedCount <= LEDCOUNT_RGBW_MAX ? nLedCount : LEDCOUNT_RGBW_MAX;
-		m_nBufSize = nLedCount * SINGLE_RGBW;
+		m_nLedCount =  nLedCount <= WS28XXMULTI_LEDCOUNT_RGBW_MAX ? nLedCount : WS28XXMULTI_LEDCOUNT_RGBW_MAX;
+		m_nBufSize = m_nLedCount * SINGLE_RGBW;
 	} else {
-		m_nLedCount =  nLedCount <= LEDCOUNT_RGB_MAX ? nLedCount : LEDCOUNT_RGB_MAX;
-		m_nBufSize = nLedCount * SINGLE_RGB;
+		m_nLedCount =  nLedCount <= WS28XXMULTI_LEDCOUNT_RGB_MAX ? nLedCount : WS28XXMULTI_LEDCOUNT_RGB_MAX;
+		m_nBufSize = m_nLedCount * SINGLE_RGB;
+	}
+
+	for (uint32_t nPort = 0; nPort < m_nActiveOutputs; nPort++) {
+		m_nPortsMask |= (1U << GetPortBit(nPort));
 	}
 
 	DEBUG_PRINTF("type=%d, count=%d, active=%d, bufsize=%d", m_tWS28xxMultiType, m_nLedCount, m_nActiveOutputs, m_nBufSize);
@@ -108,81 +109,6 @@ WS28xxMulti::~WS28xxMulti(void) {
 	DEBUG_EXIT
 }
 
-void WS28xxMulti::SetLED(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
-	assert(nPort < WS28XXMULTI_ACTIVE_PORTS_MAX);
-	assert(nLedIndex < m_nLedCount);
-
-	uint32_t j = 0;
-	uint32_t k = nLedIndex * SINGLE_RGB;
-
-	for (uint8_t mask = 0x80; mask != 0; mask >>= 1) {
-		if (m_tWS28xxMultiType == WS28XXMULTI_WS2811) {
-			// RGB
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer[k + j], nPort);
-			}
-
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer[8 + k + j], nPort);
-			}
-
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer[16 + k + j], nPort);
-			}
-		} else if  (m_tWS28xxMultiType == WS28XXMULTI_UCS1903) {
-			// BRG
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer[k + j], nPort);
-			}
-
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer[8 + k + j], nPort);
-			}
-
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer[16 + k + j], nPort);
-			}
-		} else {
-			// GRB
-			if (mask & nGreen) {
-				BIT_SET(m_pBuffer[k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer[k + j], nPort);
-			}
-
-			if (mask & nRed) {
-				BIT_SET(m_pBuffer[8 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer[8 + k + j], nPort);
-			}
-
-			if (mask & nBlue) {
-				BIT_SET(m_pBuffer[16 + k + j], nPort);
-			} else {
-				BIT_CLEAR(m_pBuffer[16 + k + j], nPort);
-			}
-		}
-
-		j++;
-	}
-}
-
-void WS28xxMulti::SetLED(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
-	//TODO Implement set RGBW
-}
-
 void WS28xxMulti::Update(void) {
 	Generate800kHz(m_pBuffer);
 }
@@ -195,10 +121,10 @@ void WS28xxMulti::Generate800kHz(const uint32_t* pBuffer) {
 	for (uint32_t k = 0; k < m_nBufSize; k = k + SINGLE_RGB) {
 		printf("%.2d ", k / SINGLE_RGB);
 
-		for (uint32_t j = 0; j < 4; j++) {
+		for (uint32_t j = 0; j < m_nActiveOutputs; j++) {
 
 			for (uint32_t i = 0; i < 24; i++) {
-				bool b = (pBuffer[k + i] & (1 << j)) == 0;
+				bool b = (pBuffer[k + i] & (1 << GetPortBit(j))) == 0;
 				printf("%c", '0' + (b ? 0 : 1));
 
 				if ((i != 0) && ((i + 1) % 8 == 0)) {
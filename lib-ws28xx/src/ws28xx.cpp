@@ -39,25 +39,12 @@ WS28xx::WS28xx(TWS28XXType Type, uint16_t nLEDCount, uint32_t nClockSpeed) :
 	m_nLEDCount(nLEDCount),
 	m_nClockSpeedHz(nClockSpeed),
 	m_nGlobalBrightness(0xFF),
-	m_nHighCode(Type == WS2812B ? 0xF8 : (((Type == UCS1903) || (Type == UCS2903)) ? 0xFC : 0xF0)),
 	m_bUpdating(false)
 {
 	assert(m_tLEDType < WS28XX_UNDEFINED);
 	assert(m_nLEDCount > 0);
 
-	if ((m_tLEDType == SK6812W) || (m_tLEDType == APA102)) {
-		m_nBufSize = nLEDCount * 4;
-	} else {
-		m_nBufSize = nLEDCount * 3;
-	}
-
-	if (m_tLEDType == WS2811 || m_tLEDType == WS2812 || m_tLEDType == WS2812B || m_tLEDType == WS2813 || m_tLEDType == WS2815 || m_tLEDType == SK6812 || m_tLEDType == SK6812W || m_tLEDType == UCS1903 || m_tLEDType == UCS2903) {
-		m_nBufSize *= 8;
-	}
-
-	if (m_tLEDType == APA102) {
-		m_nBufSize += 8;
-	}
+	InitializeEncoder();
 
 #ifdef H3
 	if (!((m_tLEDType == WS2801) || (m_tLEDType == APA102))) {
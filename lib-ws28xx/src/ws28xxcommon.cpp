@@ -24,86 +24,126 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 #include <assert.h>
 
 #include "ws28xx.h"
+#include "ws28xxencoder.h"
 
-void WS28xx::SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
-	assert(!m_bUpdating);
+#if defined (__circle__)
+ // m_pBuffer is encoded while m_pDMABuffer is clocked out
+ #define ASSERT_NOT_UPDATING()	assert(!m_bUpdating || (m_pBuffer != m_pDMABuffer))
+#else
+ #define ASSERT_NOT_UPDATING()	assert(!m_bUpdating)
+#endif
 
-	assert(m_pBuffer != 0);
-	assert(nLEDIndex < m_nLEDCount);
+/**
+ * Called by the constructors, after m_tLEDType and m_nLEDCount are set.
+ * Selects the encoder and sets m_nHighCode and m_nBufSize.
+ */
+void WS28xx::InitializeEncoder(void) {
+	switch (m_tLEDType) {
+	case WS2801:
+		SelectEncoder<ws28xx::EncoderWS2801>();
+		break;
+	case APA102:
+		SelectEncoder<ws28xx::EncoderAPA102>();
+		break;
+	case WS2811:
+		SelectEncoder<ws28xx::EncoderWS2811>();
+		break;
+	case WS2812B:
+		SelectEncoder<ws28xx::EncoderWS2812B>();
+		break;
+	case SK6812W:
+		SelectEncoder<ws28xx::EncoderSK6812W>();
+		break;
+	case UCS1903:
+		SelectEncoder<ws28xx::EncoderUCS1903>();
+		break;
+	case UCS2903:
+		SelectEncoder<ws28xx::EncoderUCS2903>();
+		break;
+	default:	// WS2812, WS2813, WS2815, SK6812
+		SelectEncoder<ws28xx::EncoderWS2812>();
+		break;
+	}
 
-	if (m_tLEDType == APA102) {
-		uint32_t nOffset = 4 + (nLEDIndex * 4);
-		assert(nOffset + 3 < m_nBufSize);
-		m_pBuffer[nOffset] = m_nGlobalBrightness;
-		m_pBuffer[nOffset + 1] = nRed;
-		m_pBuffer[nOffset + 2] = nGreen;
-		m_pBuffer[nOffset + 3] = nBlue;
-	} else if (m_tLEDType == WS2801) {
-		uint32_t nOffset = nLEDIndex * 3;
-		assert(nOffset + 2 < m_nBufSize);
-		m_pBuffer[nOffset] = nRed;
-		m_pBuffer[nOffset + 1] = nGreen;
-		m_pBuffer[nOffset + 2] = nBlue;
-	} else if ((m_tLEDType == WS2811) || (m_tLEDType == UCS2903)) {
-		uint32_t nOffset = nLEDIndex * 3;
-		nOffset *= 8;
-
-		SetColorWS28xx(nOffset, nRed);
-		SetColorWS28xx(nOffset + 8, nGreen);
-		SetColorWS28xx(nOffset + 16, nBlue);
-	} else if (m_tLEDType == UCS1903) {
-		uint32_t nOffset = nLEDIndex * 3;
-		nOffset *= 8;
-
-		SetColorWS28xx(nOffset, nBlue);
-		SetColorWS28xx(nOffset + 8, nRed);
-		SetColorWS28xx(nOffset + 16, nGreen);
-	} else {
-		uint32_t nOffset = nLEDIndex * 3;
-		nOffset *= 8;
-
-		SetColorWS28xx(nOffset, nGreen);
-		SetColorWS28xx(nOffset + 8, nRed);
-		SetColorWS28xx(nOffset + 16, nBlue);
+	for (uint32_t nValue = 0; nValue < 256; nValue++) {
+		uint64_t nBits = 0;
+
+		for (uint32_t nBit = 0; nBit < 8; nBit++) {
+			const uint64_t nCode = (nValue & (0x80 >> nBit)) ? m_nHighCode : 0xC0;	// 0xC0 is the same for all
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+			nBits |= nCode << ((7 - nBit) * 8);
+#else
+			nBits |= nCode << (nBit * 8);
+#endif
+		}
+
+		m_aBitExpand[nValue] = nBits;
 	}
+
+	ClearDirty();
 }
 
-void WS28xx::SetLED(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
-	assert(!m_bUpdating);
+template<typename T>
+void WS28xx::SelectEncoder(void) {
+	m_pSetLED = &WS28xx::SetLEDEncoder<T>;
+	m_pSetLEDW = &WS28xx::SetLEDEncoderW<T>;
+	m_nHighCode = T::HIGH_CODE;
+	m_nLEDSize = T::LED_SIZE;
+	m_nHeader = T::HEADER;
+	m_nBufSize = T::HEADER + (m_nLEDCount * T::LED_SIZE) + T::TRAILER;
+}
 
+template<typename T>
+void WS28xx::SetLEDEncoder(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+	ASSERT_NOT_UPDATING();
 	assert(m_pBuffer != 0);
 	assert(nLEDIndex < m_nLEDCount);
-	assert(m_tLEDType == SK6812W);
 
-	uint32_t nOffset = nLEDIndex * 4;
+	const uint32_t nOffset = T::HEADER + (nLEDIndex * T::LED_SIZE);
 
-	if (m_tLEDType == SK6812W) {
-		nOffset *= 8;
+	T::Encode(&m_pBuffer[nOffset], m_aBitExpand, m_nGlobalBrightness, nRed, nGreen, nBlue);
+	SetDirty(nOffset, nOffset + T::LED_SIZE);
+}
 
-		SetColorWS28xx(nOffset, nGreen);
-		SetColorWS28xx(nOffset + 8, nRed);
-		SetColorWS28xx(nOffset + 16, nBlue);
-		SetColorWS28xx(nOffset + 24, nWhite);
-	}
+template<typename T>
+void WS28xx::SetLEDEncoderW(uint32_t nLEDIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
+	ASSERT_NOT_UPDATING();
+	assert(m_pBuffer != 0);
+	assert(nLEDIndex < m_nLEDCount);
+
+	const uint32_t nOffset = T::HEADER + (nLEDIndex * T::LED_SIZE);
+
+	T::Encode(&m_pBuffer[nOffset], m_aBitExpand, m_nGlobalBrightness, nRed, nGreen, nBlue, nWhite);
+	SetDirty(nOffset, nOffset + T::LED_SIZE);
 }
 
-void WS28xx::SetColorWS28xx(uint32_t nOffset, uint8_t nValue) {
-	assert(m_tLEDType != WS2801);
-	uint8_t mask;
+void WS28xx::RepeatLED(uint32_t nLEDIndex, uint32_t nCount) {
+	ASSERT_NOT_UPDATING();
+	assert(m_pBuffer != 0);
+	assert(nLEDIndex + nCount < m_nLEDCount);
 
-	assert(nOffset + 7 < m_nBufSize);
+	const uint32_t nOffset = m_nHeader + (nLEDIndex * m_nLEDSize);
+	const uint8_t *pSrc = &m_pBuffer[nOffset];
+	uint8_t *pDst = const_cast<uint8_t *>(pSrc) + m_nLEDSize;
+	uint32_t nBytes = nCount * m_nLEDSize;
 
-	for (mask = 0x80; mask != 0; mask >>= 1) {
-		if (nValue & mask) {
-			m_pBuffer[nOffset] = m_nHighCode;
-		} else {
-			m_pBuffer[nOffset] = 0xC0;	// Same for all
+	SetDirty(nOffset + m_nLEDSize, nOffset + m_nLEDSize + nBytes);
+
+	// The copied LEDs are the source for the next copy, doubling each time
+	while (nBytes != 0) {
+		uint32_t n = static_cast<uint32_t>(pDst - pSrc);
+
+		if (n > nBytes) {
+			n = nBytes;
 		}
 
-		nOffset++;
+		memcpy(pDst, pSrc, n);
+		pDst += n;
+		nBytes -= n;
 	}
 }
 
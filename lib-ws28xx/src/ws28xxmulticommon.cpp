@@ -0,0 +1,184 @@
+/**
+ * @file ws28xxmulticommon.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <assert.h>
+
+#include "ws28xxmulti.h"
+#include "ws28xxencoder.h"
+
+/*
+ * Byte n holds the colour byte of output n. On return byte n holds
+ * bit n of every output, output 0 in bit 0.
+ */
+static inline uint64_t Transpose8x8(uint64_t x) {
+	uint64_t t;
+
+	t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+	x = x ^ t ^ (t << 7);
+	t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+	x = x ^ t ^ (t << 14);
+	t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+	x = x ^ t ^ (t << 28);
+
+	return x;
+}
+
+/*
+ * Bits 0-7 of nBits are the outputs 0-7, see GetPortBit
+ */
+static inline uint32_t SpreadPorts(uint32_t nBits) {
+	return (nBits & 0x0F) | ((nBits & 0xF0) << 3);
+}
+
+/*
+ * The 8 words of a colour, bit nPortBit is set to the bits of nValue, MSB first
+ */
+static inline void SetPortBits(uint32_t *pWord, uint32_t nPortBit, uint8_t nValue) {
+	const uint32_t nBit = 1U << nPortBit;
+
+	for (uint32_t nMask = 0x80; nMask != 0; nMask >>= 1) {
+		if (nValue & nMask) {
+			*pWord |= nBit;
+		} else {
+			*pWord &= ~nBit;
+		}
+		pWord++;
+	}
+}
+
+/*
+ * The 8 words of a colour, for all outputs. p points to the colour of output 0,
+ * nStride is the pixel size. The bits which are not an output (PULSE) are kept.
+ */
+static inline void SetColourRow(uint32_t *pWord, const uint8_t *p, uint32_t nStride, uint32_t nActiveOutputs, uint32_t nMask) {
+	uint64_t nBits = 0;
+
+	for (uint32_t nPort = 0; nPort < nActiveOutputs; nPort++) {
+		nBits |= static_cast<uint64_t>(*p) << (nPort * 8);
+		p += nStride;
+	}
+
+	nBits = Transpose8x8(nBits);
+
+	// Word 0 carries the most significant bit
+	const uint32_t nHigh = static_cast<uint32_t>(nBits >> 32);
+	const uint32_t nLow = static_cast<uint32_t>(nBits);
+
+	pWord[0] = (pWord[0] & nMask) | SpreadPorts(nHigh >> 24);
+	pWord[1] = (pWord[1] & nMask) | SpreadPorts((nHigh >> 16) & 0xFF);
+	pWord[2] = (pWord[2] & nMask) | SpreadPorts((nHigh >> 8) & 0xFF);
+	pWord[3] = (pWord[3] & nMask) | SpreadPorts(nHigh & 0xFF);
+	pWord[4] = (pWord[4] & nMask) | SpreadPorts(nLow >> 24);
+	pWord[5] = (pWord[5] & nMask) | SpreadPorts((nLow >> 16) & 0xFF);
+	pWord[6] = (pWord[6] & nMask) | SpreadPorts((nLow >> 8) & 0xFF);
+	pWord[7] = (pWord[7] & nMask) | SpreadPorts(nLow & 0xFF);
+}
+
+/**
+ * Called by the constructors, after m_tWS28xxMultiType is set.
+ * Selects the encoder and sets m_nLowCode and m_nHighCode.
+ */
+void WS28xxMulti::InitializeEncoder(void) {
+	switch (m_tWS28xxMultiType) {
+	case WS28XXMULTI_WS2811:
+		SelectEncoder<ws28xx::EncoderWS2811>();
+		break;
+	case WS28XXMULTI_WS2812B:
+		SelectEncoder<ws28xx::EncoderWS2812B>();
+		break;
+	case WS28XXMULTI_SK6812W:
+		SelectEncoder<ws28xx::EncoderSK6812W>();
+		break;
+	case WS28XXMULTI_UCS1903:
+		SelectEncoder<ws28xx::EncoderUCS1903>();
+		break;
+	case WS28XXMULTI_UCS2903:
+		SelectEncoder<ws28xx::EncoderWS281x<0xFC, 1, 0, 2> >();	// GRB
+		break;
+	default:	// WS2812, WS2813, WS2815, SK6812
+		SelectEncoder<ws28xx::EncoderWS2812>();
+		break;
+	}
+}
+
+/*
+ * The encoder LED_SIZE is the number of bits per LED, which is the number of words in the buffer
+ */
+template<typename T>
+void WS28xxMulti::SelectEncoder(void) {
+	m_pSetLED = &WS28xxMulti::SetLEDEncoder<T>;
+	m_pSetLEDW = &WS28xxMulti::SetLEDEncoderW<T>;
+	m_pSetLEDRow = &WS28xxMulti::SetLEDRowEncoder<T>;
+	m_nLowCode = T::LOW_CODE;
+	m_nHighCode = T::HIGH_CODE;
+}
+
+template<typename T>
+void WS28xxMulti::SetLEDEncoder(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue) {
+	assert(nPort < WS28XXMULTI_ACTIVE_PORTS_MAX);
+	assert(nLedIndex < m_nLedCount);
+
+	uint32_t *pWord = &m_pBuffer[nLedIndex * T::LED_SIZE];
+	const uint32_t nPortBit = GetPortBit(nPort);
+
+	SetPortBits(&pWord[T::RED * 8], nPortBit, nRed);
+	SetPortBits(&pWord[T::GREEN * 8], nPortBit, nGreen);
+	SetPortBits(&pWord[T::BLUE * 8], nPortBit, nBlue);
+}
+
+template<typename T>
+void WS28xxMulti::SetLEDEncoderW(uint8_t nPort, uint16_t nLedIndex, uint8_t nRed, uint8_t nGreen, uint8_t nBlue, uint8_t nWhite) {
+	SetLEDEncoder<T>(nPort, nLedIndex, nRed, nGreen, nBlue);
+
+	if (T::COLOURS == 4) {
+		SetPortBits(&m_pBuffer[(nLedIndex * T::LED_SIZE) + (T::WHITE * 8)], GetPortBit(nPort), nWhite);
+	}
+}
+
+template<typename T>
+void WS28xxMulti::SetLEDRowEncoder(uint16_t nLedIndex, const uint8_t *pPixels) {
+	assert(pPixels != 0);
+	assert(nLedIndex < m_nLedCount);
+
+	uint32_t *pWord = &m_pBuffer[nLedIndex * T::LED_SIZE];
+	const uint32_t nMask = ~m_nPortsMask;
+
+	SetColourRow(&pWord[T::RED * 8], &pPixels[0], T::COLOURS, m_nActiveOutputs, nMask);
+	SetColourRow(&pWord[T::GREEN * 8], &pPixels[1], T::COLOURS, m_nActiveOutputs, nMask);
+	SetColourRow(&pWord[T::BLUE * 8], &pPixels[2], T::COLOURS, m_nActiveOutputs, nMask);
+
+	if (T::COLOURS == 4) {
+		SetColourRow(&pWord[T::WHITE * 8], &pPixels[3], T::COLOURS, m_nActiveOutputs, nMask);
+	}
+}
+
+uint8_t WS28xxMulti::CalculateBits(uint8_t nNanoSeconds) {
+	return 0;
+}
+
+uint32_t WS28xxMulti::GetFrameTime(void) {
+	return ((m_nBufSize * WS28XXMULTI_BIT_TIME_NS) / 1000) + WS28XXMULTI_RESET_TIME_US;
+}
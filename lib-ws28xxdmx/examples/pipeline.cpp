@@ -0,0 +1,165 @@
+/**
+ * @file pipeline.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "pixelpipeline.h"
+
+#define LED_COUNT		680
+#define CHANNELS		3
+#define FRAMES			20000
+#define DITHER_FRAMES	256
+
+static uint64_t nanos(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t) ts.tv_sec * 1000000000) + (uint64_t) ts.tv_nsec;
+}
+
+/*
+ * With the default settings (8-bit, gamma 1.0, no correction) the output must be the input.
+ */
+static uint32_t identity(bool bDithering) {
+	PixelPipeline pipeline;
+	pipeline.SetDithering(bDithering);
+	pipeline.Initialize(256, CHANNELS);
+
+	uint8_t aIn[256 * CHANNELS];
+	uint8_t aOut[256 * CHANNELS];
+
+	for (uint32_t i = 0; i < sizeof(aIn); i++) {
+		aIn[i] = static_cast<uint8_t>(i / CHANNELS);
+	}
+
+	pipeline.Input(0, aIn, 256);
+
+	uint32_t nMismatches = 0;
+
+	for (uint32_t nFrame = 0; nFrame < 10; nFrame++) {
+		pipeline.Output(0, aOut, 256);
+
+		for (uint32_t i = 0; i < sizeof(aIn); i++) {
+			if (aOut[i] != aIn[i]) {
+				nMismatches++;
+			}
+		}
+	}
+
+	printf("Identity 8-bit dither=%d : %u mismatches\n", bDithering, nMismatches);
+
+	return nMismatches;
+}
+
+/*
+ * The average of the dithered 8-bit output over 256 frames against the 16-bit gamma curve
+ */
+static void gamma16(void) {
+	PixelPipeline pipeline;
+	pipeline.SetGamma(2.2f);
+	pipeline.SetInput16Bit(true);
+	pipeline.SetDithering(true);
+	pipeline.Initialize(1, 1);
+
+	double fErrorMax = 0;
+
+	for (uint32_t nValue = 0; nValue < 65536; nValue += 7) {
+		const uint8_t aSlots[2] = { static_cast<uint8_t>(nValue >> 8), static_cast<uint8_t>(nValue) };
+		pipeline.Input(0, aSlots, 1);
+
+		uint32_t nSum = 0;
+
+		for (uint32_t nFrame = 0; nFrame < DITHER_FRAMES; nFrame++) {
+			uint8_t nOut;
+			pipeline.Output(0, &nOut, 1);
+			nSum += nOut;
+		}
+
+		const double fReference = pow(nValue / 65535.0, 2.2) * 255;
+		const double fError = fabs((static_cast<double>(nSum) / DITHER_FRAMES) - fReference);
+
+		if (fError > fErrorMax) {
+			fErrorMax = fError;
+		}
+	}
+
+	printf("Gamma 2.2 16-bit dithered average : max error %.3f (8-bit steps)\n", fErrorMax);
+}
+
+int main(int argc, char **argv) {
+	uint32_t nMismatches = identity(false);
+	nMismatches += identity(true);
+
+	gamma16();
+
+	static uint8_t aIn[LED_COUNT * CHANNELS * 2];
+	static uint8_t aOut[LED_COUNT * CHANNELS];
+
+	for (uint32_t i = 0; i < sizeof(aIn); i++) {
+		aIn[i] = static_cast<uint8_t>(rand());
+	}
+
+	// WS2812B: 24 bits of 1.25 us per pixel
+	const double fFrameMicros = LED_COUNT * 24 * 1.25;
+
+	printf("%d RGB pixels, Input + Output, %.0f us frame time\n", LED_COUNT, fFrameMicros);
+
+	for (uint32_t nInput = 8; nInput <= 16; nInput += 8) {
+		for (uint32_t nDithering = 0; nDithering < 2; nDithering++) {
+			PixelPipeline pipeline;
+			pipeline.SetGamma(2.2f);
+			pipeline.SetInput16Bit(nInput == 16);
+			pipeline.SetDithering(nDithering != 0);
+			pipeline.Initialize(LED_COUNT, CHANNELS);
+
+			const uint64_t nStart = nanos();
+
+			for (uint32_t nFrame = 0; nFrame < FRAMES; nFrame++) {
+				pipeline.Input(0, aIn, LED_COUNT);
+				pipeline.Output(0, aOut, LED_COUNT);
+			}
+
+			const double fMicros = static_cast<double>(nanos() - nStart) / 1000 / FRAMES;
+
+			printf(" %2u-bit dither=%u : %6.2f us/frame (%.3f%%)\n", nInput, nDithering, fMicros, (100 * fMicros) / fFrameMicros);
+		}
+	}
+
+	PixelPipeline pipeline;
+
+	const uint64_t nStart = nanos();
+
+	for (uint32_t i = 0; i < 100; i++) {
+		pipeline.SetGamma(2.2f + (i * 0.001f));
+		pipeline.Initialize(1, CHANNELS);
+	}
+
+	printf("Tables : %.1f us\n", static_cast<double>(nanos() - nStart) / 1000 / 100);
+
+	return nMismatches == 0 ? 0 : -1;
+}
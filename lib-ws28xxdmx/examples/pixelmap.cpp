@@ -0,0 +1,215 @@
+/**
+ * @file pixelmap.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pixelmap.h"
+
+#define PORTS			4
+#define DMX_LENGTH		512
+
+typedef int32_t (*map_t)(uint32_t nLogical, uint32_t nLedCount);
+
+static int32_t identity(uint32_t nLogical, uint32_t nLedCount) {
+	return static_cast<int32_t>(nLogical);
+}
+
+static int32_t serpentine16(uint32_t nLogical, uint32_t nLedCount) {
+	const uint32_t nRow = nLogical / 16;
+	uint32_t nColumn = nLogical % 16;
+
+	if ((nRow & 0x1) != 0) {
+		nColumn = 15 - nColumn;
+	}
+
+	return static_cast<int32_t>((nRow * 16) + nColumn);
+}
+
+static int32_t reverse(uint32_t nLogical, uint32_t nLedCount) {
+	return static_cast<int32_t>(nLedCount - 1 - nLogical);
+}
+
+static int32_t segments(uint32_t nLogical, uint32_t nLedCount) {
+	if (nLogical < 100) {
+		return static_cast<int32_t>(nLogical);
+	}
+
+	if (nLogical < 150) {
+		return static_cast<int32_t>(199 - (nLogical - 100));
+	}
+
+	return -1;
+}
+
+static uint32_t s_nFailed;
+
+/*
+ * Compares the compiled map against a per pixel reference, and the universes
+ * reported by GetUniverses against the universes the reference reads.
+ */
+static void check(const char *pName, PixelMap &pixelMap, uint32_t nLedCount, uint32_t nChannelsPerLed, uint32_t nPixelsPerUniverse, uint32_t nLogicalCount, map_t map) {
+	const bool bDense = (pixelMap.GetPacking() == PIXELMAP_PACKING_DENSE);
+	const uint32_t nStart = pixelMap.GetStartAddress() - 1;
+	const uint32_t nUniverses = pixelMap.GetUniverses(nLedCount, nChannelsPerLed);
+
+	if (!pixelMap.Compile(nLedCount, nChannelsPerLed)) {
+		printf("%-28s Compile failed\n", pName);
+		s_nFailed++;
+		return;
+	}
+
+	if (nPixelsPerUniverse == 0) {
+		nPixelsPerUniverse = (DMX_LENGTH - nStart) / nChannelsPerLed;
+	}
+
+	uint8_t aDmxData[PORTS][DMX_LENGTH];
+
+	for (uint32_t nPort = 0; nPort < PORTS; nPort++) {
+		for (uint32_t i = 0; i < DMX_LENGTH; i++) {
+			aDmxData[nPort][i] = static_cast<uint8_t>(rand());
+		}
+	}
+
+	const uint32_t nSize = nLedCount * nChannelsPerLed;
+	uint8_t *pPixels = new uint8_t[nSize];
+	uint8_t *pReference = new uint8_t[nSize];
+	memset(pPixels, 0, nSize);
+	memset(pReference, 0, nSize);
+
+	uint32_t nPixelFirst = 0;
+	uint32_t nPixelLast = 0;
+
+	for (uint32_t nPort = 0; nPort < PORTS; nPort++) {
+		pixelMap.Apply(nPort, aDmxData[nPort], DMX_LENGTH, 0, DMX_LENGTH, pPixels, nPixelFirst, nPixelLast);
+	}
+
+	pixelMap.FrameDone();
+
+	uint32_t nUniversesRead = 0;
+
+	for (uint32_t nLogical = 0; nLogical < nLogicalCount; nLogical++) {
+		const int32_t nPixel = map(nLogical, nLedCount);
+
+		if ((nPixel < 0) || (nPixel >= static_cast<int32_t>(nLedCount))) {
+			continue;
+		}
+
+		for (uint32_t i = 0; i < nChannelsPerLed; i++) {
+			uint32_t nPort, nSlot;
+
+			if (bDense) {
+				const uint32_t nChannel = nStart + (nLogical * nChannelsPerLed) + i;
+				nPort = nChannel / DMX_LENGTH;
+				nSlot = nChannel % DMX_LENGTH;
+			} else {
+				nPort = nLogical / nPixelsPerUniverse;
+				nSlot = nStart + ((nLogical % nPixelsPerUniverse) * nChannelsPerLed) + i;
+			}
+
+			if (nPort >= PORTS) {
+				continue;
+			}
+
+			if (nPort >= nUniversesRead) {
+				nUniversesRead = nPort + 1;
+			}
+
+			pReference[(nPixel * nChannelsPerLed) + i] = aDmxData[nPort][nSlot];
+		}
+	}
+
+	const bool bMapped = (memcmp(pPixels, pReference, nSize) == 0);
+	const bool bUniverses = (nUniverses == nUniversesRead);
+
+	printf("%-28s %-8s universes %u %-8s pixels %u-%u, %u us\n", pName, bMapped ? "OK" : "MISMATCH", nUniverses, bUniverses ? "OK" : "MISMATCH",
+			nPixelFirst, nPixelLast, pixelMap.GetStats()->nMicrosLast);
+
+	if (!bMapped || !bUniverses) {
+		s_nFailed++;
+	}
+
+	delete [] pPixels;
+	delete [] pReference;
+}
+
+int main(int argc, char **argv) {
+	{
+		PixelMap pixelMap;
+		check("identity RGB 680", pixelMap, 680, 3, 0, 680, identity);
+	}
+	{
+		PixelMap pixelMap;
+		check("identity RGB 340", pixelMap, 340, 3, 0, 340, identity);
+	}
+	{
+		PixelMap pixelMap;
+		check("identity RGBW 512", pixelMap, 512, 4, 0, 512, identity);
+	}
+	{
+		PixelMap pixelMap;
+		pixelMap.SetMatrix(16, true);
+		check("serpentine 16 x 40", pixelMap, 640, 3, 0, 640, serpentine16);
+	}
+	{
+		PixelMap pixelMap;
+		pixelMap.SetReverse(true);
+		check("reverse 600", pixelMap, 600, 3, 0, 600, reverse);
+	}
+	{
+		PixelMap pixelMap;
+		pixelMap.SetPacking(PIXELMAP_PACKING_DENSE);
+		check("dense RGB 680", pixelMap, 680, 3, 0, 680, identity);
+	}
+	{
+		PixelMap pixelMap;
+		pixelMap.SetPacking(PIXELMAP_PACKING_DENSE);
+		pixelMap.SetStartAddress(11);
+		check("dense start 11 RGBW 500", pixelMap, 500, 4, 0, 500, identity);
+	}
+	{
+		PixelMap pixelMap;
+		pixelMap.SetStartAddress(4);
+		pixelMap.SetPixelsPerUniverse(150);
+		check("150 per universe start 4", pixelMap, 600, 3, 150, 600, identity);
+	}
+	{
+		PixelMap pixelMap;
+		pixelMap.SetPixelsPerUniverse(100);
+		check("100 per universe 350", pixelMap, 350, 3, 100, 350, identity);
+	}
+	{
+		PixelMap pixelMap;
+		pixelMap.AddSegment(0, 100, 0, false);
+		pixelMap.AddSegment(100, 50, 150, true);
+		check("segments", pixelMap, 200, 3, 0, 150, segments);
+	}
+
+	printf("%u failed\n", s_nFailed);
+
+	return s_nFailed == 0 ? 0 : -1;
+}
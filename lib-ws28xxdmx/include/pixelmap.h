@@ -0,0 +1,167 @@
+/**
+ * @file pixelmap.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PIXELMAP_H_
+#define PIXELMAP_H_
+
+#include <stdint.h>
+
+enum TPixelMapPacking {
+	PIXELMAP_PACKING_UNIVERSE,	///< Whole pixels per universe
+	PIXELMAP_PACKING_DENSE		///< The channels continue in the next universe, a pixel can be split
+};
+
+enum {
+	PIXELMAP_PORTS_MAX = 4,
+	PIXELMAP_SEGMENTS_MAX = 16,
+	PIXELMAP_RUNS_MAX = 256
+};
+
+struct TPixelMapSegment {
+	uint16_t nFirst;	///< First logical (DMX) pixel
+	uint16_t nCount;
+	uint16_t nPixel;	///< First output pixel
+	bool bReverse;
+};
+
+/*
+ * Copy nCount pixels from slot nSlot to pixel nPixel, nPixel + nStep, ...
+ * A pixel split over 2 universes gets a run in each universe, with nOffset/nChannels the part of the pixel.
+ */
+struct TPixelMapRun {
+	uint16_t nSlot;
+	uint16_t nPixel;
+	uint16_t nCount;
+	int8_t nStep;
+	uint8_t nOffset;
+	uint8_t nChannels;
+	uint8_t nPort;
+};
+
+struct TPixelMapStats {
+	uint32_t nFrames;
+	uint32_t nMicrosLast;	///< Time spent in Apply for the last frame
+	uint32_t nMicrosMax;
+	uint32_t nBytesLast;	///< Bytes copied for the last frame
+};
+
+class PixelMap {
+public:
+	PixelMap(void);
+	~PixelMap(void);
+
+	void SetPacking(TPixelMapPacking tPacking) {
+		m_tPacking = tPacking;
+	}
+	TPixelMapPacking GetPacking(void) {
+		return m_tPacking;
+	}
+
+	void SetStartAddress(uint16_t nStartAddress);
+	uint16_t GetStartAddress(void) {
+		return m_nStartAddress;
+	}
+
+	/**
+	 * Universe packing only, 0 is as many as fit
+	 */
+	void SetPixelsPerUniverse(uint16_t nPixelsPerUniverse) {
+		m_nPixelsPerUniverse = nPixelsPerUniverse;
+	}
+
+	/**
+	 * The output pixels are rows of nWidth pixels, every other row reversed when bSerpentine
+	 */
+	void SetMatrix(uint16_t nWidth, bool bSerpentine) {
+		m_nMatrixWidth = nWidth;
+		m_bSerpentine = bSerpentine;
+	}
+
+	void SetReverse(bool bReverse) {
+		m_bReverse = bReverse;
+	}
+
+	bool AddSegment(uint16_t nFirst, uint16_t nCount, uint16_t nPixel, bool bReverse);
+
+	/**
+	 * Translates the map into runs for nLedCount pixels of nChannelsPerLed slots (twice the colours for 16-bit input).
+	 * Returns false when the runs do not fit.
+	 */
+	bool Compile(uint32_t nLedCount, uint32_t nChannelsPerLed);
+
+	/**
+	 * The number of universes the map receives for nLedCount pixels of nChannelsPerLed slots, at most PIXELMAP_PORTS_MAX
+	 */
+	uint32_t GetUniverses(uint32_t nLedCount, uint32_t nChannelsPerLed);
+
+	bool IsCompiled(void) {
+		return m_nRuns != 0;
+	}
+
+	/**
+	 * Copies the changed slots of a universe into pPixels (nChannelsPerLed bytes per pixel, input order).
+	 * The range of changed pixels is merged into nPixelFirst/nPixelLast.
+	 */
+	void Apply(uint32_t nPort, const uint8_t *pData, uint32_t nLength, uint32_t nChangedFirst, uint32_t nChangedLast, uint8_t *pPixels, uint32_t &nPixelFirst, uint32_t &nPixelLast);
+
+	/**
+	 * Called once per frame, after all universes are applied
+	 */
+	void FrameDone(void);
+
+	const struct TPixelMapStats *GetStats(void) {
+		return &m_Stats;
+	}
+
+	void Print(void);
+
+private:
+	uint32_t GetPixelsPerUniverse(uint32_t nChannelsPerLed);
+	uint32_t GetLogicalCount(uint32_t nLedCount);
+	int32_t MapPixel(uint32_t nLogical);
+	bool AddRun(uint32_t nPort, uint32_t nSlot, uint32_t nPixel, uint32_t nOffset, uint32_t nChannels);
+
+private:
+	TPixelMapPacking m_tPacking;
+	uint16_t m_nStartAddress;
+	uint16_t m_nPixelsPerUniverse;
+	uint16_t m_nMatrixWidth;
+	bool m_bSerpentine;
+	bool m_bReverse;
+	uint32_t m_nSegments;
+	struct TPixelMapSegment m_aSegments[PIXELMAP_SEGMENTS_MAX];
+
+	uint32_t m_nLedCount;
+	uint32_t m_nChannelsPerLed;
+	uint32_t m_nRuns;
+	struct TPixelMapRun *m_pRuns;
+	uint16_t m_aPortRunFirst[PIXELMAP_PORTS_MAX + 1];
+
+	uint32_t m_nFrameMicros;
+	uint32_t m_nFrameBytes;
+	struct TPixelMapStats m_Stats;
+};
+
+#endif /* PIXELMAP_H_ */
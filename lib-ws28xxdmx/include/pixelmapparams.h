@@ -0,0 +1,88 @@
+/**
+ * @file pixelmapparams.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PIXELMAPPARAMS_H_
+#define PIXELMAPPARAMS_H_
+
+#include <stdint.h>
+
+#include "pixelmap.h"
+
+struct TPixelMapParams {
+	uint32_t nSetList;
+	TPixelMapPacking tPacking;
+	uint16_t nStartAddress;
+	uint16_t nPixelsPerUniverse;
+	uint16_t nMatrixWidth;
+	bool bSerpentine;
+	bool bReverse;
+	uint32_t nSegments;
+	struct TPixelMapSegment aSegments[PIXELMAP_SEGMENTS_MAX];
+};
+
+enum TPixelMapParamsMask {
+	PIXELMAP_PARAMS_MASK_PACKING = (1 << 0),
+	PIXELMAP_PARAMS_MASK_START_ADDRESS = (1 << 1),
+	PIXELMAP_PARAMS_MASK_PIXELS_PER_UNIVERSE = (1 << 2),
+	PIXELMAP_PARAMS_MASK_MATRIX_WIDTH = (1 << 3),
+	PIXELMAP_PARAMS_MASK_SERPENTINE = (1 << 4),
+	PIXELMAP_PARAMS_MASK_REVERSE = (1 << 5),
+	PIXELMAP_PARAMS_MASK_SEGMENT = (1 << 6)
+};
+
+/**
+ * pixelmap.txt, for example a serpentine matrix, 16 pixels wide, 4 universes with 128 pixels each:
+ *  matrix_width=16
+ *  serpentine=1
+ *  pixels_per_universe=128
+ * or explicit segments <first DMX pixel>,<count>,<first output pixel>[,r]:
+ *  segment=0,100,0
+ *  segment=100,50,199,r
+ */
+class PixelMapParams {
+public:
+	PixelMapParams(void);
+	~PixelMapParams(void);
+
+	bool Load(void);
+
+	void Set(PixelMap *pPixelMap);
+
+	void Dump(void);
+
+public:
+	static void staticCallbackFunction(void *p, const char *s);
+
+private:
+	void callbackFunction(const char *pLine);
+	bool isMaskSet(uint32_t nMask) const {
+		return (m_tPixelMapParams.nSetList & nMask) == nMask;
+	}
+
+private:
+	struct TPixelMapParams m_tPixelMapParams;
+};
+
+#endif /* PIXELMAPPARAMS_H_ */
@@ -0,0 +1,110 @@
+/**
+ * @file pixelpipeline.h
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef PIXELPIPELINE_H_
+#define PIXELPIPELINE_H_
+
+#include <stdint.h>
+
+enum {
+	PIXELPIPELINE_CHANNELS_MAX = 4,
+	PIXELPIPELINE_LUT_SIZE = 257		///< 16-bit input, interpolated between the 8-bit steps
+};
+
+/*
+ * Optional stage between the DMX slots and the LEDs:
+ * 8- or 16-bit (coarse, fine) input -> gamma / colour correction -> 16-bit linear -> 8-bit with temporal dithering
+ */
+class PixelPipeline {
+public:
+	PixelPipeline(void);
+	~PixelPipeline(void);
+
+	void SetInput16Bit(bool bInput16Bit) {
+		m_bInput16Bit = bInput16Bit;
+	}
+	bool IsInput16Bit(void) {
+		return m_bInput16Bit;
+	}
+
+	uint32_t GetSlotsPerChannel(void) {
+		return m_bInput16Bit ? 2 : 1;
+	}
+
+	void SetGamma(float fGamma);
+	float GetGamma(void) {
+		return m_fGamma;
+	}
+
+	/**
+	 * Scale of a colour channel in DMX order (R, G, B, W), 255 is 1.0
+	 */
+	void SetCorrection(uint32_t nChannel, uint8_t nCorrection);
+
+	void SetDithering(bool bDithering) {
+		m_bDithering = bDithering;
+	}
+	bool IsDithering(void) {
+		return m_bDithering;
+	}
+
+	/**
+	 * Builds the tables and allocates the state for nPixels of nChannelsPerLed
+	 */
+	void Initialize(uint32_t nPixels, uint32_t nChannelsPerLed);
+
+	uint32_t GetPixels(void) {
+		return m_nPixels;
+	}
+
+	/**
+	 * Converts nPixels from the DMX slots into the 16-bit linear values of pixel nPixel onwards
+	 */
+	void Input(uint32_t nPixel, const uint8_t *pSlots, uint32_t nPixels);
+
+	/**
+	 * Writes nPixels from pixel nPixel onwards as 8-bit, the remainder is carried over to the next frame when dithering
+	 */
+	void Output(uint32_t nPixel, uint8_t *pOut, uint32_t nPixels);
+
+	void Print(void);
+
+private:
+	void BuildTables(void);
+
+private:
+	bool m_bInput16Bit;
+	bool m_bDithering;
+	float m_fGamma;
+	uint8_t m_aCorrection[PIXELPIPELINE_CHANNELS_MAX];
+	uint32_t m_nPixels;
+	uint32_t m_nChannelsPerLed;
+	uint16_t *m_pLinear;
+	uint8_t *m_pError;
+	alignas(uint32_t) uint16_t m_aLut[PIXELPIPELINE_CHANNELS_MAX][PIXELPIPELINE_LUT_SIZE];
+	alignas(uint32_t) uint16_t m_aLut8[PIXELPIPELINE_CHANNELS_MAX][256];
+};
+
+#endif /* PIXELPIPELINE_H_ */
@@ -34,8 +34,13 @@
 
 #include "lightset.h"
 
+#if defined(USE_SPI_DMA)
+ #include "h3/ws28xxdma.h"
+#endif
 #include "ws28xx.h"
 #include "ws28xxdmxstore.h"
+#include "pixelmap.h"
+#include "pixelpipeline.h"
 
 class WS28xxDmx: public LightSet {
 public:
@@ -50,6 +55,8 @@ public:
 	void Stop(uint8_t nPort = 0);
 
 	virtual void SetData(uint8_t nPort, const uint8_t*, uint16_t);
+	virtual void SetDataChanged(uint8_t nPort, const uint8_t*, uint16_t, uint16_t, uint16_t);
+	void Sync(void);
 
 	void Blackout(bool bBlackout);
 
@@ -83,6 +90,35 @@ public:
 		m_pWS28xxDmxStore = pWS28xxDmxStore;
 	}
 
+	/**
+	 * Must be set before Start. The map is compiled for the LED type and count at Start.
+	 */
+	void SetPixelMap(PixelMap *pPixelMap) {
+		m_pPixelMap = pPixelMap;
+	}
+
+	/**
+	 * Must be set before the LED type and count, the input width changes the pixels per universe.
+	 */
+	void SetPixelPipeline(PixelPipeline *pPixelPipeline) {
+		m_pPixelPipeline = pPixelPipeline;
+		UpdateMembers();
+	}
+
+	uint32_t GetLEDsPerUniverse(void) {
+		return m_nLedsPerUniverse;
+	}
+
+	/**
+	 * The number of universes received, from the pixel map when set
+	 */
+	uint32_t GetUniverses(void);
+
+	/**
+	 * Sends the next dither step of the current frame when the stripe is idle. Call from the main loop.
+	 */
+	void Dither(void);
+
 	virtual void Print(void);
 
 public: // RDM
@@ -105,6 +141,11 @@ private:
 
 private:
 	void UpdateMembers(void);
+	void SetDataMapped(uint8_t nPort, const uint8_t *pData, uint16_t nLength, uint16_t nChangedFirst, uint16_t nChangedLast);
+	void EncodeMapped(void);
+
+protected:
+	virtual void EncodePipeline(uint32_t nFirst, uint32_t nLast);
 
 protected:
 	TWS28XXType m_tLedType;
@@ -112,21 +153,30 @@ protected:
 	uint16_t m_nDmxStartAddress;
 	uint16_t m_nDmxFootprint;
 
+#if defined(USE_SPI_DMA)
+	WS28xxDMA *m_pLEDStripe;
+#else
 	WS28xx* m_pLEDStripe;
+#endif
 	bool m_bIsStarted;
 	bool m_bBlackout;
+	bool m_bIsSyncPending;
 
 	WS28xxDmxStore *m_pWS28xxDmxStore;
 
+	PixelPipeline *m_pPixelPipeline;
+	uint32_t m_nPixelFirst;			///< Changed pixels, encoded in Sync
+	uint32_t m_nPixelLast;
+
 private:
 	uint32_t m_nClockSpeedHz;
 	uint8_t m_nGlobalBrightness;
-	uint32_t m_nBeginIndexPortId1;
-	uint32_t m_nBeginIndexPortId2;
-	uint32_t m_nBeginIndexPortId3;
+	uint32_t m_nLedsPerUniverse;
 	uint32_t m_nChannelsPerLed;
-
-	uint32_t m_nPortIdLast;
+	uint32_t m_nSlotsPerLed;		///< Twice the channels for 16-bit input
+	uint32_t m_nUpdateAllMask;	///< Ports that must be encoded completely on the next frame
+	PixelMap *m_pPixelMap;
+	uint8_t *m_pPixels;			///< Mapped pixels, input order, encoded in Sync
 };
 
 #endif /* WS28XXDMX_H_ */
@@ -47,6 +47,10 @@ public:
 	void Start(uint8_t nPort = 0);
 
 	void SetData(uint8_t nPort, const uint8_t *pData, uint16_t nLenght);
+	void SetDataChanged(uint8_t nPort, const uint8_t *pData, uint16_t nLength, uint16_t nChangedFirst, uint16_t nChangedLast) {
+		// The groups are compared by SetData
+		SetData(nPort, pData, nLength);
+	}
 
 	void SetLEDType(TWS28XXType tLedType);
 	void SetLEDCount(uint16_t nLedCount);
@@ -57,17 +61,37 @@ public:
 
 	void Print(void);
 
+	/**
+	 * Encode cost, measured in SetData
+	 */
+	struct TEncodeStats {
+		uint32_t nFrames;		///< Frames with at least one changed group
+		uint64_t nGroups;		///< Changed groups, total
+		uint64_t nMicros;		///< Compare and encode time, total
+		uint32_t nLastGroups;
+		uint32_t nLastMicros;
+	};
+
+	const struct TEncodeStats *GetEncodeStats(void) const {
+		return &m_tEncodeStats;
+	}
+
 public: // RDM
 	bool SetDmxStartAddress(uint16_t nDmxStartAddress);
 	bool GetSlotInfo(uint16_t nSlotOffset, struct TLightSetSlotInfo &tSlotInfo);
 
 private:
 	void UpdateMembers(void);
+	void EncodePipeline(uint32_t nFirst, uint32_t nLast);
+	void EncodeGroup(uint32_t nGroup, const uint8_t *p);
 
 private:
 	uint8_t* m_pDmxData;
 	uint32_t m_nLEDGroupCount;
 	uint32_t m_nGroups;
+	uint32_t m_nSlotsPerGroup;
+	bool m_bUpdateAll;			///< All groups are encoded on the next frame
+	struct TEncodeStats m_tEncodeStats;
 };
 
 #endif /* WS28XXDMXGROUPING_H_ */
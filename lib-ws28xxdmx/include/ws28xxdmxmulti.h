@@ -31,6 +31,7 @@
 #include "lightset.h"
 
 #include "ws28xxmulti.h"
+#include "pixelpipeline.h"
 
 enum TWS28xxDmxMultiSrc {
 	WS28XXDMXMULTI_SRC_ARTNET,
@@ -46,6 +47,7 @@ public:
 	void Stop(uint8_t nPort);
 
 	void SetData(uint8_t nPort, const uint8_t *pData, uint16_t nLength);
+	void Sync(void);
 
 	void Blackout(bool bBlackout);
 
@@ -68,6 +70,33 @@ public:
 		return m_nUniverses;
 	}
 
+	/**
+	 * Number of LightSet ports reserved per output: the universes, rounded up to whole pages for Art-Net
+	 */
+	uint32_t GetPortsPerOutput(void) {
+		return m_nPortsPerOutput;
+	}
+
+	/**
+	 * The ports the node or bridge can map, the outputs beyond them are not fed
+	 */
+	void SetPortsAvailable(uint32_t nPortsAvailable) {
+		m_nPortsAvailable = nPortsAvailable;
+	}
+
+	/**
+	 * Number of active outputs with all their universes mapped
+	 */
+	uint32_t GetOutputsFed(void);
+
+	/**
+	 * Must be set before the LED type and count. Dithers per frame received, the outputs are not refreshed in between.
+	 */
+	void SetPixelPipeline(PixelPipeline *pPixelPipeline) {
+		m_pPixelPipeline = pPixelPipeline;
+		UpdateMembers();
+	}
+
 	void SetUseSI5351A(bool bUse) {
 		m_bUseSI5351A = bUse;
 	}
@@ -79,6 +108,7 @@ public:
 
 private:
 	void UpdateMembers(void);
+	void Encode(void);
 
 private:
 	TWS28xxDmxMultiSrc m_tSrc;
@@ -87,18 +117,24 @@ private:
 	uint32_t m_nActiveOutputs;
 
 	WS28xxMulti* m_pLEDStripe;
+	uint8_t *m_pPixels;
+	uint32_t m_nRowFirst;
+	uint32_t m_nRowLast;
 
 	bool m_bIsStarted;
 	bool m_bBlackout;
+	bool m_bIsSyncPending;
 
 	uint32_t m_nUniverses;
 
-	uint32_t m_nBeginIndexPortId1;
-	uint32_t m_nBeginIndexPortId2;
-	uint32_t m_nBeginIndexPortId3;
+	uint32_t m_nPortsPerOutput;
+	uint32_t m_nPortsAvailable;
+	uint32_t m_nLedsPerUniverse;
 	uint32_t m_nChannelsPerLed;
+	uint32_t m_nSlotsPerLed;
+
+	PixelPipeline *m_pPixelPipeline;
 
-	uint32_t m_nPortIdLast;
 	bool m_bUseSI5351A;
 };
 
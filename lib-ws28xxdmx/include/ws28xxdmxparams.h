@@ -32,6 +32,7 @@
 #include "ws28xx.h"
 #include "ws28xxdmx.h"
 #include "ws28xxdmxmulti.h"
+#include "pixelpipeline.h"
 
 struct TWS28xxDmxParams {
     uint32_t nSetList;
@@ -44,6 +45,10 @@ struct TWS28xxDmxParams {
 	uint8_t nActiveOutputs;
 	bool bUseSI5351A;
 	uint16_t nLedGroupCount;
+	bool bInput16Bit;
+	float fGamma;
+	uint8_t aCorrection[4];
+	bool bDither;
 };
 
 enum TWS28xxDmxParamsMask {
@@ -55,9 +60,15 @@ enum TWS28xxDmxParamsMask {
 	WS28XXDMX_PARAMS_MASK_GLOBAL_BRIGHTNESS = (1 << 5),
 	WS28XXDMX_PARAMS_MASK_ACTIVE_OUT = (1 << 6),
 	WS28XXDMX_PARAMS_MASK_USE_SI5351A = (1 << 7),
-	WS28XXDMX_PARAMS_MASK_LED_GROUP_COUNT = (1 << 8)
+	WS28XXDMX_PARAMS_MASK_LED_GROUP_COUNT = (1 << 8),
+	WS28XXDMX_PARAMS_MASK_INPUT_16BIT = (1 << 9),
+	WS28XXDMX_PARAMS_MASK_GAMMA = (1 << 10),
+	WS28XXDMX_PARAMS_MASK_CORRECTION = (1 << 11),
+	WS28XXDMX_PARAMS_MASK_DITHER = (1 << 12)
 };
 
+#define WS28XXDMX_PARAMS_MASK_PIXEL_PIPELINE	(WS28XXDMX_PARAMS_MASK_INPUT_16BIT | WS28XXDMX_PARAMS_MASK_GAMMA | WS28XXDMX_PARAMS_MASK_CORRECTION | WS28XXDMX_PARAMS_MASK_DITHER)
+
 class WS28xxDmxParamsStore {
 public:
 	virtual ~WS28xxDmxParamsStore(void);
@@ -79,6 +90,7 @@ public:
 
 	void Set(WS28xxDmx *);
 	void Set(WS28xxDmxMulti *pWS28xxDmxMulti);
+	void Set(PixelPipeline *pPixelPipeline);
 
 	void Dump(void);
 
@@ -118,6 +130,10 @@ public:
 		return m_tWS28xxParams.nLedGroupCount;
 	}
 
+	bool IsPixelPipeline(void) {
+		return (m_tWS28xxParams.nSetList & WS28XXDMX_PARAMS_MASK_PIXEL_PIPELINE) != 0;
+	}
+
 public:
 	static void staticCallbackFunction(void *p, const char *s);
 
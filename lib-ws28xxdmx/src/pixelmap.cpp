@@ -0,0 +1,413 @@
+/**
+ * @file pixelmap.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#include "pixelmap.h"
+
+#include "lightset.h"
+
+#include "hardware.h"
+
+#include "debug.h"
+
+#ifndef MIN
+ #define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+PixelMap::PixelMap(void):
+	m_tPacking(PIXELMAP_PACKING_UNIVERSE),
+	m_nStartAddress(DMX_START_ADDRESS_DEFAULT),
+	m_nPixelsPerUniverse(0),
+	m_nMatrixWidth(0),
+	m_bSerpentine(false),
+	m_bReverse(false),
+	m_nSegments(0),
+	m_nLedCount(0),
+	m_nChannelsPerLed(3),
+	m_nRuns(0),
+	m_pRuns(0),
+	m_nFrameMicros(0),
+	m_nFrameBytes(0)
+{
+	DEBUG_ENTRY
+
+	memset(m_aPortRunFirst, 0, sizeof(m_aPortRunFirst));
+	memset(&m_Stats, 0, sizeof(struct TPixelMapStats));
+
+	DEBUG_EXIT
+}
+
+PixelMap::~PixelMap(void) {
+	delete [] m_pRuns;
+	m_pRuns = 0;
+}
+
+void PixelMap::SetStartAddress(uint16_t nStartAddress) {
+	if ((nStartAddress != 0) && (nStartAddress <= DMX_UNIVERSE_SIZE)) {
+		m_nStartAddress = nStartAddress;
+	}
+}
+
+bool PixelMap::AddSegment(uint16_t nFirst, uint16_t nCount, uint16_t nPixel, bool bReverse) {
+	if ((m_nSegments == PIXELMAP_SEGMENTS_MAX) || (nCount == 0)) {
+		return false;
+	}
+
+	m_aSegments[m_nSegments].nFirst = nFirst;
+	m_aSegments[m_nSegments].nCount = nCount;
+	m_aSegments[m_nSegments].nPixel = nPixel;
+	m_aSegments[m_nSegments].bReverse = bReverse;
+	m_nSegments++;
+
+	return true;
+}
+
+/*
+ * Returns the output pixel for a logical (DMX) pixel, or -1 when not mapped
+ */
+int32_t PixelMap::MapPixel(uint32_t nLogical) {
+	int32_t nPixel = static_cast<int32_t>(nLogical);
+
+	if (m_nSegments != 0) {
+		nPixel = -1;
+
+		for (uint32_t i = 0; i < m_nSegments; i++) {
+			const struct TPixelMapSegment *pSegment = &m_aSegments[i];
+
+			if ((nLogical >= pSegment->nFirst) && (nLogical < (static_cast<uint32_t>(pSegment->nFirst) + pSegment->nCount))) {
+				const uint32_t nIndex = nLogical - pSegment->nFirst;
+				nPixel = pSegment->nPixel + (pSegment->bReverse ? (pSegment->nCount - 1 - nIndex) : nIndex);
+				break;
+			}
+		}
+
+		if (nPixel < 0) {
+			return -1;
+		}
+	}
+
+	if (m_nMatrixWidth != 0) {
+		const uint32_t nRow = static_cast<uint32_t>(nPixel) / m_nMatrixWidth;
+		uint32_t nColumn = static_cast<uint32_t>(nPixel) - (nRow * m_nMatrixWidth);
+
+		if (m_bSerpentine && ((nRow & 0x1) != 0)) {
+			nColumn = m_nMatrixWidth - 1 - nColumn;
+		}
+
+		nPixel = static_cast<int32_t>((nRow * m_nMatrixWidth) + nColumn);
+	}
+
+	if (nPixel >= static_cast<int32_t>(m_nLedCount)) {
+		return -1;
+	}
+
+	if (m_bReverse) {
+		nPixel = static_cast<int32_t>(m_nLedCount) - 1 - nPixel;
+	}
+
+	return nPixel;
+}
+
+/*
+ * Extends the last run when the pixel continues it, else starts a new run
+ */
+bool PixelMap::AddRun(uint32_t nPort, uint32_t nSlot, uint32_t nPixel, uint32_t nOffset, uint32_t nChannels) {
+	if (m_nRuns != 0) {
+		struct TPixelMapRun *pRun = &m_pRuns[m_nRuns - 1];
+
+		if ((pRun->nPort == nPort) && (pRun->nChannels == m_nChannelsPerLed) && (nChannels == m_nChannelsPerLed)
+				&& (nSlot == (pRun->nSlot + pRun->nCount * m_nChannelsPerLed))) {
+			if (pRun->nCount == 1) {
+				if (nPixel == static_cast<uint32_t>(pRun->nPixel + 1)) {
+					pRun->nStep = 1;
+					pRun->nCount++;
+					return true;
+				}
+				if (nPixel + 1 == pRun->nPixel) {
+					pRun->nStep = -1;
+					pRun->nCount++;
+					return true;
+				}
+			} else if (static_cast<int32_t>(nPixel) == (pRun->nPixel + static_cast<int32_t>(pRun->nCount) * pRun->nStep)) {
+				pRun->nCount++;
+				return true;
+			}
+		}
+	}
+
+	if (m_nRuns == PIXELMAP_RUNS_MAX) {
+		return false;
+	}
+
+	struct TPixelMapRun *pRun = &m_pRuns[m_nRuns++];
+
+	pRun->nSlot = nSlot;
+	pRun->nPixel = nPixel;
+	pRun->nCount = 1;
+	pRun->nStep = 1;
+	pRun->nOffset = nOffset;
+	pRun->nChannels = nChannels;
+	pRun->nPort = nPort;
+
+	return true;
+}
+
+uint32_t PixelMap::GetPixelsPerUniverse(uint32_t nChannelsPerLed) {
+	const uint32_t nPixelsPerUniverse = (DMX_UNIVERSE_SIZE - (m_nStartAddress - 1)) / nChannelsPerLed;
+
+	if ((m_nPixelsPerUniverse != 0) && (m_nPixelsPerUniverse < nPixelsPerUniverse)) {
+		return m_nPixelsPerUniverse;
+	}
+
+	return nPixelsPerUniverse;
+}
+
+/*
+ * The number of logical (DMX) pixels, the segments can address more or less pixels than the LED count
+ */
+uint32_t PixelMap::GetLogicalCount(uint32_t nLedCount) {
+	if (m_nSegments == 0) {
+		return nLedCount;
+	}
+
+	uint32_t nLogicalCount = 0;
+
+	for (uint32_t i = 0; i < m_nSegments; i++) {
+		const uint32_t nEnd = m_aSegments[i].nFirst + m_aSegments[i].nCount;
+		if (nEnd > nLogicalCount) {
+			nLogicalCount = nEnd;
+		}
+	}
+
+	return nLogicalCount;
+}
+
+uint32_t PixelMap::GetUniverses(uint32_t nLedCount, uint32_t nChannelsPerLed) {
+	const uint32_t nLogicalCount = GetLogicalCount(nLedCount);
+
+	if (nLogicalCount == 0) {
+		return 0;
+	}
+
+	uint32_t nUniverses;
+
+	if (m_tPacking == PIXELMAP_PACKING_UNIVERSE) {
+		const uint32_t nPixelsPerUniverse = GetPixelsPerUniverse(nChannelsPerLed);
+
+		if (nPixelsPerUniverse == 0) {
+			return 0;
+		}
+
+		nUniverses = (nLogicalCount + nPixelsPerUniverse - 1) / nPixelsPerUniverse;
+	} else {
+		const uint32_t nChannels = (m_nStartAddress - 1) + nLogicalCount * nChannelsPerLed;
+		nUniverses = (nChannels + DMX_UNIVERSE_SIZE - 1) / DMX_UNIVERSE_SIZE;
+	}
+
+	return MIN(nUniverses, static_cast<uint32_t>(PIXELMAP_PORTS_MAX));
+}
+
+bool PixelMap::Compile(uint32_t nLedCount, uint32_t nChannelsPerLed) {
+	DEBUG_ENTRY
+
+	// 6 and 8 are 16-bit input
+	assert((nChannelsPerLed == 3) || (nChannelsPerLed == 4) || (nChannelsPerLed == 6) || (nChannelsPerLed == 8));
+
+	if (m_pRuns == 0) {
+		m_pRuns = new struct TPixelMapRun[PIXELMAP_RUNS_MAX];
+		assert(m_pRuns != 0);
+	}
+
+	m_nLedCount = nLedCount;
+	m_nChannelsPerLed = nChannelsPerLed;
+	m_nRuns = 0;
+
+	const uint32_t nStart = m_nStartAddress - 1;
+	const uint32_t nPixelsPerUniverse = GetPixelsPerUniverse(nChannelsPerLed);
+	const uint32_t nLogicalCount = GetLogicalCount(nLedCount);
+
+	bool bFits = (nPixelsPerUniverse != 0);
+
+	for (uint32_t nLogical = 0; bFits && (nLogical < nLogicalCount); nLogical++) {
+		const int32_t nPixel = MapPixel(nLogical);
+
+		if (nPixel < 0) {
+			continue;
+		}
+
+		if (m_tPacking == PIXELMAP_PACKING_UNIVERSE) {
+			const uint32_t nPort = nLogical / nPixelsPerUniverse;
+
+			if (nPort >= PIXELMAP_PORTS_MAX) {
+				break;
+			}
+
+			const uint32_t nSlot = nStart + (nLogical - nPort * nPixelsPerUniverse) * nChannelsPerLed;
+			bFits = AddRun(nPort, nSlot, nPixel, 0, nChannelsPerLed);
+		} else {
+			const uint32_t nChannel = nStart + nLogical * nChannelsPerLed;
+			const uint32_t nPort = nChannel / DMX_UNIVERSE_SIZE;
+
+			if (nPort >= PIXELMAP_PORTS_MAX) {
+				break;
+			}
+
+			const uint32_t nSlot = nChannel - nPort * DMX_UNIVERSE_SIZE;
+			const uint32_t nChannels = MIN(nChannelsPerLed, DMX_UNIVERSE_SIZE - nSlot);
+
+			bFits = AddRun(nPort, nSlot, nPixel, 0, nChannels);
+
+			if (bFits && (nChannels < nChannelsPerLed) && ((nPort + 1) < PIXELMAP_PORTS_MAX)) {
+				bFits = AddRun(nPort + 1, 0, nPixel, nChannels, nChannelsPerLed - nChannels);
+			}
+		}
+	}
+
+	if (!bFits) {
+		m_nRuns = 0;
+		printf("PixelMap: too many runs (max %d)\n", PIXELMAP_RUNS_MAX);
+		DEBUG_EXIT
+		return false;
+	}
+
+	// The runs are in port order
+	uint32_t nRun = 0;
+
+	for (uint32_t nPort = 0; nPort <= PIXELMAP_PORTS_MAX; nPort++) {
+		while ((nRun < m_nRuns) && (m_pRuns[nRun].nPort < nPort)) {
+			nRun++;
+		}
+		m_aPortRunFirst[nPort] = nRun;
+	}
+
+	DEBUG_PRINTF("m_nRuns=%d", m_nRuns);
+	DEBUG_EXIT
+	return true;
+}
+
+void PixelMap::Apply(uint32_t nPort, const uint8_t *pData, uint32_t nLength, uint32_t nChangedFirst, uint32_t nChangedLast, uint8_t *pPixels, uint32_t &nPixelFirst, uint32_t &nPixelLast) {
+	assert(nPort < PIXELMAP_PORTS_MAX);
+	assert(pData != 0);
+	assert(pPixels != 0);
+
+	const uint32_t nMicros = Hardware::Get()->Micros();
+	const uint32_t nChannelsPerLed = m_nChannelsPerLed;
+
+	for (uint32_t i = m_aPortRunFirst[nPort]; i < m_aPortRunFirst[nPort + 1]; i++) {
+		const struct TPixelMapRun *pRun = &m_pRuns[i];
+
+		if ((pRun->nSlot + pRun->nChannels) > nLength) {
+			continue;
+		}
+
+		// Pixels completely received
+		uint32_t nCount = 1 + ((nLength - pRun->nSlot - pRun->nChannels) / nChannelsPerLed);
+		nCount = MIN(nCount, pRun->nCount);
+
+		const uint32_t nSlotLast = pRun->nSlot + (nCount - 1) * nChannelsPerLed + pRun->nChannels;
+
+		if ((nChangedFirst >= nSlotLast) || (nChangedLast <= pRun->nSlot)) {
+			continue;
+		}
+
+		const uint8_t *pSrc = &pData[pRun->nSlot];
+		uint32_t nPixelLow;
+
+		if (pRun->nStep > 0) {
+			nPixelLow = pRun->nPixel;
+			memcpy(&pPixels[(nPixelLow * nChannelsPerLed) + pRun->nOffset], pSrc, (nCount - 1) * nChannelsPerLed + pRun->nChannels);
+		} else {
+			nPixelLow = pRun->nPixel + 1 - nCount;
+			uint8_t *pDst = &pPixels[pRun->nPixel * nChannelsPerLed];
+
+			if (nChannelsPerLed == 4) {
+				for (uint32_t j = 0; j < nCount; j++) {
+					pDst[0] = pSrc[0];
+					pDst[1] = pSrc[1];
+					pDst[2] = pSrc[2];
+					pDst[3] = pSrc[3];
+					pSrc += 4;
+					pDst -= 4;
+				}
+			} else if (nChannelsPerLed == 3) {
+				for (uint32_t j = 0; j < nCount; j++) {
+					pDst[0] = pSrc[0];
+					pDst[1] = pSrc[1];
+					pDst[2] = pSrc[2];
+					pSrc += 3;
+					pDst -= 3;
+				}
+			} else {
+				for (uint32_t j = 0; j < nCount; j++) {
+					memcpy(pDst, pSrc, nChannelsPerLed);
+					pSrc += nChannelsPerLed;
+					pDst -= nChannelsPerLed;
+				}
+			}
+		}
+
+		m_nFrameBytes += (nCount - 1) * nChannelsPerLed + pRun->nChannels;
+
+		if (nPixelFirst >= nPixelLast) {
+			nPixelFirst = nPixelLow;
+			nPixelLast = nPixelLow + nCount;
+		} else {
+			nPixelFirst = MIN(nPixelFirst, nPixelLow);
+			if ((nPixelLow + nCount) > nPixelLast) {
+				nPixelLast = nPixelLow + nCount;
+			}
+		}
+	}
+
+	m_nFrameMicros += Hardware::Get()->Micros() - nMicros;
+}
+
+void PixelMap::FrameDone(void) {
+	m_Stats.nFrames++;
+	m_Stats.nMicrosLast = m_nFrameMicros;
+	m_Stats.nBytesLast = m_nFrameBytes;
+
+	if (m_nFrameMicros > m_Stats.nMicrosMax) {
+		m_Stats.nMicrosMax = m_nFrameMicros;
+	}
+
+	m_nFrameMicros = 0;
+	m_nFrameBytes = 0;
+}
+
+void PixelMap::Print(void) {
+	printf("Pixel map\n");
+	printf(" Packing    : %s, start address %d\n", m_tPacking == PIXELMAP_PACKING_DENSE ? "dense" : "universe", static_cast<int>(m_nStartAddress));
+	if (m_nMatrixWidth != 0) {
+		printf(" Matrix     : width %d%s\n", static_cast<int>(m_nMatrixWidth), m_bSerpentine ? ", serpentine" : "");
+	}
+	printf(" Segments   : %d%s\n", static_cast<int>(m_nSegments), m_bReverse ? ", reversed" : "");
+	printf(" Runs       : %d\n", static_cast<int>(m_nRuns));
+	printf(" Frame cost : %d us (max %d us), %d bytes, %d frames\n", static_cast<int>(m_Stats.nMicrosLast), static_cast<int>(m_Stats.nMicrosMax), static_cast<int>(m_Stats.nBytesLast), static_cast<int>(m_Stats.nFrames));
+}
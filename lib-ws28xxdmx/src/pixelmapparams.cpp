@@ -0,0 +1,241 @@
+/**
+ * @file pixelmapparams.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#if !defined(__clang__)	// Needed for compiling on MacOS
+ #pragma GCC push_options
+ #pragma GCC optimize ("Os")
+#endif
+
+#include <stdint.h>
+#include <string.h>
+#ifndef NDEBUG
+ #include <stdio.h>
+#endif
+#include <assert.h>
+
+#include "pixelmapparams.h"
+#include "pixelmapparamsconst.h"
+#include "pixelmap.h"
+
+#include "lightset.h"
+
+#include "readconfigfile.h"
+#include "sscan.h"
+
+PixelMapParams::PixelMapParams(void) {
+	memset(&m_tPixelMapParams, 0, sizeof(struct TPixelMapParams));
+	m_tPixelMapParams.tPacking = PIXELMAP_PACKING_UNIVERSE;
+	m_tPixelMapParams.nStartAddress = DMX_START_ADDRESS_DEFAULT;
+}
+
+PixelMapParams::~PixelMapParams(void) {
+	m_tPixelMapParams.nSetList = 0;
+}
+
+bool PixelMapParams::Load(void) {
+	m_tPixelMapParams.nSetList = 0;
+	m_tPixelMapParams.nSegments = 0;
+
+	ReadConfigFile configfile(PixelMapParams::staticCallbackFunction, this);
+
+	return configfile.Read(PixelMapParamsConst::FILE_NAME);
+}
+
+/*
+ * <first>,<count>,<pixel>[,r]
+ */
+static bool ParseSegment(const char *pValue, struct TPixelMapSegment *pSegment) {
+	uint32_t aValues[3];
+
+	for (uint32_t i = 0; i < 3; i++) {
+		if ((*pValue < '0') || (*pValue > '9')) {
+			return false;
+		}
+
+		uint32_t nValue = 0;
+
+		while ((*pValue >= '0') && (*pValue <= '9')) {
+			nValue = (nValue * 10) + static_cast<uint32_t>(*pValue++ - '0');
+			if (nValue > 0xFFFF) {
+				return false;
+			}
+		}
+
+		aValues[i] = nValue;
+
+		if (i < 2) {
+			if (*pValue++ != ',') {
+				return false;
+			}
+		}
+	}
+
+	pSegment->nFirst = aValues[0];
+	pSegment->nCount = aValues[1];
+	pSegment->nPixel = aValues[2];
+	pSegment->bReverse = (pValue[0] == ',') && ((pValue[1] == 'r') || (pValue[1] == 'R'));
+
+	return (pSegment->nCount != 0);
+}
+
+void PixelMapParams::callbackFunction(const char *pLine) {
+	assert(pLine != 0);
+
+	uint8_t value8;
+	uint16_t value16;
+	uint8_t len;
+	char buffer[24];
+
+	len = 8;
+	if (Sscan::Char(pLine, PixelMapParamsConst::PACKING, buffer, &len) == SSCAN_OK) {
+		buffer[len] = '\0';
+		if (strcasecmp(buffer, "dense") == 0) {
+			m_tPixelMapParams.tPacking = PIXELMAP_PACKING_DENSE;
+			m_tPixelMapParams.nSetList |= PIXELMAP_PARAMS_MASK_PACKING;
+		} else if (strcasecmp(buffer, "universe") == 0) {
+			m_tPixelMapParams.tPacking = PIXELMAP_PACKING_UNIVERSE;
+			m_tPixelMapParams.nSetList |= PIXELMAP_PARAMS_MASK_PACKING;
+		}
+		return;
+	}
+
+	if (Sscan::Uint16(pLine, PixelMapParamsConst::START_ADDRESS, &value16) == SSCAN_OK) {
+		if (value16 != 0 && value16 <= DMX_UNIVERSE_SIZE) {
+			m_tPixelMapParams.nStartAddress = value16;
+			m_tPixelMapParams.nSetList |= PIXELMAP_PARAMS_MASK_START_ADDRESS;
+		}
+		return;
+	}
+
+	if (Sscan::Uint16(pLine, PixelMapParamsConst::PIXELS_PER_UNIVERSE, &value16) == SSCAN_OK) {
+		if (value16 != 0 && value16 <= (DMX_UNIVERSE_SIZE / 3)) {
+			m_tPixelMapParams.nPixelsPerUniverse = value16;
+			m_tPixelMapParams.nSetList |= PIXELMAP_PARAMS_MASK_PIXELS_PER_UNIVERSE;
+		}
+		return;
+	}
+
+	if (Sscan::Uint16(pLine, PixelMapParamsConst::MATRIX_WIDTH, &value16) == SSCAN_OK) {
+		m_tPixelMapParams.nMatrixWidth = value16;
+		m_tPixelMapParams.nSetList |= PIXELMAP_PARAMS_MASK_MATRIX_WIDTH;
+		return;
+	}
+
+	if (Sscan::Uint8(pLine, PixelMapParamsConst::SERPENTINE, &value8) == SSCAN_OK) {
+		m_tPixelMapParams.bSerpentine = (value8 != 0);
+		m_tPixelMapParams.nSetList |= PIXELMAP_PARAMS_MASK_SERPENTINE;
+		return;
+	}
+
+	if (Sscan::Uint8(pLine, PixelMapParamsConst::REVERSE, &value8) == SSCAN_OK) {
+		m_tPixelMapParams.bReverse = (value8 != 0);
+		m_tPixelMapParams.nSetList |= PIXELMAP_PARAMS_MASK_REVERSE;
+		return;
+	}
+
+	len = sizeof(buffer) - 1;
+	if (Sscan::Char(pLine, PixelMapParamsConst::SEGMENT, buffer, &len) == SSCAN_OK) {
+		buffer[len] = '\0';
+		if ((m_tPixelMapParams.nSegments < PIXELMAP_SEGMENTS_MAX) && ParseSegment(buffer, &m_tPixelMapParams.aSegments[m_tPixelMapParams.nSegments])) {
+			m_tPixelMapParams.nSegments++;
+			m_tPixelMapParams.nSetList |= PIXELMAP_PARAMS_MASK_SEGMENT;
+		}
+	}
+}
+
+void PixelMapParams::Set(PixelMap *pPixelMap) {
+	assert(pPixelMap != 0);
+
+	if (isMaskSet(PIXELMAP_PARAMS_MASK_PACKING)) {
+		pPixelMap->SetPacking(m_tPixelMapParams.tPacking);
+	}
+
+	if (isMaskSet(PIXELMAP_PARAMS_MASK_START_ADDRESS)) {
+		pPixelMap->SetStartAddress(m_tPixelMapParams.nStartAddress);
+	}
+
+	if (isMaskSet(PIXELMAP_PARAMS_MASK_PIXELS_PER_UNIVERSE)) {
+		pPixelMap->SetPixelsPerUniverse(m_tPixelMapParams.nPixelsPerUniverse);
+	}
+
+	if (isMaskSet(PIXELMAP_PARAMS_MASK_MATRIX_WIDTH)) {
+		pPixelMap->SetMatrix(m_tPixelMapParams.nMatrixWidth, m_tPixelMapParams.bSerpentine);
+	}
+
+	if (isMaskSet(PIXELMAP_PARAMS_MASK_REVERSE)) {
+		pPixelMap->SetReverse(m_tPixelMapParams.bReverse);
+	}
+
+	for (uint32_t i = 0; i < m_tPixelMapParams.nSegments; i++) {
+		const struct TPixelMapSegment *pSegment = &m_tPixelMapParams.aSegments[i];
+		pPixelMap->AddSegment(pSegment->nFirst, pSegment->nCount, pSegment->nPixel, pSegment->bReverse);
+	}
+}
+
+void PixelMapParams::Dump(void) {
+#ifndef NDEBUG
+	if (m_tPixelMapParams.nSetList == 0) {
+		return;
+	}
+
+	printf("%s::%s \'%s\':\n", __FILE__,__FUNCTION__, PixelMapParamsConst::FILE_NAME);
+
+	if (isMaskSet(PIXELMAP_PARAMS_MASK_PACKING)) {
+		printf(" %s=%s\n", PixelMapParamsConst::PACKING, m_tPixelMapParams.tPacking == PIXELMAP_PACKING_DENSE ? "dense" : "universe");
+	}
+
+	if (isMaskSet(PIXELMAP_PARAMS_MASK_START_ADDRESS)) {
+		printf(" %s=%d\n", PixelMapParamsConst::START_ADDRESS, (int) m_tPixelMapParams.nStartAddress);
+	}
+
+	if (isMaskSet(PIXELMAP_PARAMS_MASK_PIXELS_PER_UNIVERSE)) {
+		printf(" %s=%d\n", PixelMapParamsConst::PIXELS_PER_UNIVERSE, (int) m_tPixelMapParams.nPixelsPerUniverse);
+	}
+
+	if (isMaskSet(PIXELMAP_PARAMS_MASK_MATRIX_WIDTH)) {
+		printf(" %s=%d\n", PixelMapParamsConst::MATRIX_WIDTH, (int) m_tPixelMapParams.nMatrixWidth);
+	}
+
+	if (isMaskSet(PIXELMAP_PARAMS_MASK_SERPENTINE)) {
+		printf(" %s=%d\n", PixelMapParamsConst::SERPENTINE, (int) m_tPixelMapParams.bSerpentine);
+	}
+
+	if (isMaskSet(PIXELMAP_PARAMS_MASK_REVERSE)) {
+		printf(" %s=%d\n", PixelMapParamsConst::REVERSE, (int) m_tPixelMapParams.bReverse);
+	}
+
+	for (uint32_t i = 0; i < m_tPixelMapParams.nSegments; i++) {
+		const struct TPixelMapSegment *pSegment = &m_tPixelMapParams.aSegments[i];
+		printf(" %s=%d,%d,%d%s\n", PixelMapParamsConst::SEGMENT, (int) pSegment->nFirst, (int) pSegment->nCount, (int) pSegment->nPixel, pSegment->bReverse ? ",r" : "");
+	}
+#endif
+}
+
+void PixelMapParams::staticCallbackFunction(void *p, const char *s) {
+	assert(p != 0);
+	assert(s != 0);
+
+	((PixelMapParams *) p)->callbackFunction(s);
+}
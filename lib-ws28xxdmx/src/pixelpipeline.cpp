@@ -0,0 +1,253 @@
+/**
+ * @file pixelpipeline.cpp
+ *
+ */
+/* Copyright (C) 2020 by Arjan van Vught mailto:info@raspberrypi-dmx.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#include "pixelpipeline.h"
+
+#include "debug.h"
+
+#define LINEAR_MAX	0xFF00	///< 255.0, so that the value plus the dither remainder fits in 16-bit
+
+/*
+ * There is no libm on the bare-metal targets. The tables are built once, so simple series will do.
+ */
+
+#define LN2	0.693147180559945309417f
+
+static float Ln(float x) {
+	union {
+		float f;
+		int32_t i;
+	} m;
+
+	m.f = x;
+
+	const int32_t nExponent = ((m.i >> 23) & 0xFF) - 127;
+
+	m.i = (m.i & 0x007FFFFF) | (127 << 23);	// [1, 2)
+
+	// ln(m) = 2 * atanh(z), z <= 1/3
+	const float z = (m.f - 1.0f) / (m.f + 1.0f);
+	const float z2 = z * z;
+	float fSum = 0;
+	float fPower = z;
+
+	for (uint32_t n = 1; n <= 13; n += 2) {
+		fSum += fPower / n;
+		fPower *= z2;
+	}
+
+	return (nExponent * LN2) + (2.0f * fSum);
+}
+
+static float Exp(float y) {
+	if (y < -87.0f) {
+		return 0;
+	}
+
+	int32_t n = static_cast<int32_t>(y / LN2);
+
+	if ((n * LN2) > y) {
+		n--;
+	}
+
+	const float r = y - (n * LN2);	// [0, ln 2)
+	float fSum = 1.0f;
+	float fTerm = 1.0f;
+
+	for (uint32_t k = 1; k <= 9; k++) {
+		fTerm *= r / k;
+		fSum += fTerm;
+	}
+
+	union {
+		float f;
+		int32_t i;
+	} m;
+
+	m.i = (n + 127) << 23;	// 2^n
+
+	return fSum * m.f;
+}
+
+static float Pow(float x, float y) {
+	if (x <= 0) {
+		return 0;
+	}
+
+	return Exp(y * Ln(x));
+}
+
+PixelPipeline::PixelPipeline(void):
+	m_bInput16Bit(false),
+	m_bDithering(false),
+	m_fGamma(1.0f),
+	m_nPixels(0),
+	m_nChannelsPerLed(3),
+	m_pLinear(0),
+	m_pError(0)
+{
+	DEBUG_ENTRY
+
+	memset(m_aCorrection, 0xFF, sizeof(m_aCorrection));
+
+	BuildTables();
+
+	DEBUG_EXIT
+}
+
+PixelPipeline::~PixelPipeline(void) {
+	delete [] m_pLinear;
+	m_pLinear = 0;
+
+	delete [] m_pError;
+	m_pError = 0;
+}
+
+void PixelPipeline::SetGamma(float fGamma) {
+	if ((fGamma >= 0.5f) && (fGamma <= 4.0f)) {
+		m_fGamma = fGamma;
+	}
+}
+
+void PixelPipeline::SetCorrection(uint32_t nChannel, uint8_t nCorrection) {
+	if (nChannel < PIXELPIPELINE_CHANNELS_MAX) {
+		m_aCorrection[nChannel] = nCorrection;
+	}
+}
+
+/*
+ * Entry i is the output for the 16-bit input i * 256, the last entry is full scale.
+ * The 8-bit table is the same curve at the inputs n * 257, so that 0xFF is full scale.
+ */
+void PixelPipeline::BuildTables(void) {
+	for (uint32_t nChannel = 0; nChannel < PIXELPIPELINE_CHANNELS_MAX; nChannel++) {
+		const float fScale = (static_cast<float>(LINEAR_MAX) * m_aCorrection[nChannel]) / 255.0f;
+		uint16_t *pLut = m_aLut[nChannel];
+
+		for (uint32_t i = 0; i < PIXELPIPELINE_LUT_SIZE; i++) {
+			const uint32_t nInput = (i < 256) ? (i << 8) : 0xFFFF;
+			const float fOut = fScale * Pow(static_cast<float>(nInput) / 0xFFFF, m_fGamma);
+			pLut[i] = static_cast<uint16_t>(fOut + 0.5f);
+		}
+
+		for (uint32_t i = 0; i < 256; i++) {
+			const uint32_t nInput = i * 257;
+			const uint32_t nIndex = nInput >> 8;
+			const uint32_t nLow = pLut[nIndex];
+			m_aLut8[nChannel][i] = static_cast<uint16_t>(nLow + (((pLut[nIndex + 1] - nLow) * (nInput & 0xFF)) >> 8));
+		}
+	}
+}
+
+void PixelPipeline::Initialize(uint32_t nPixels, uint32_t nChannelsPerLed) {
+	DEBUG_ENTRY
+
+	assert(nChannelsPerLed <= PIXELPIPELINE_CHANNELS_MAX);
+
+	BuildTables();
+
+	delete [] m_pLinear;
+	delete [] m_pError;
+
+	m_nPixels = nPixels;
+	m_nChannelsPerLed = nChannelsPerLed;
+
+	const uint32_t nSize = nPixels * nChannelsPerLed;
+
+	m_pLinear = new uint16_t[nSize];
+	assert(m_pLinear != 0);
+	memset(m_pLinear, 0, nSize * sizeof(uint16_t));
+
+	m_pError = new uint8_t[nSize];
+	assert(m_pError != 0);
+
+	// Start half way, so that the first frames round to nearest
+	memset(m_pError, 0x80, nSize);
+
+	DEBUG_PRINTF("nPixels=%d, nChannelsPerLed=%d", static_cast<int>(nPixels), static_cast<int>(nChannelsPerLed));
+	DEBUG_EXIT
+}
+
+void PixelPipeline::Input(uint32_t nPixel, const uint8_t *pSlots, uint32_t nPixels) {
+	assert(pSlots != 0);
+	assert((nPixel + nPixels) <= m_nPixels);
+
+	uint16_t *pLinear = &m_pLinear[nPixel * m_nChannelsPerLed];
+	const uint32_t nChannelsPerLed = m_nChannelsPerLed;
+
+	if (m_bInput16Bit) {
+		for (uint32_t j = 0; j < nPixels; j++) {
+			for (uint32_t nChannel = 0; nChannel < nChannelsPerLed; nChannel++) {
+				const uint16_t *pLut = m_aLut[nChannel];
+				const uint32_t nIndex = pSlots[0];
+				const uint32_t nLow = pLut[nIndex];
+				*pLinear++ = static_cast<uint16_t>(nLow + (((pLut[nIndex + 1] - nLow) * pSlots[1]) >> 8));
+				pSlots += 2;
+			}
+		}
+	} else {
+		for (uint32_t j = 0; j < nPixels; j++) {
+			for (uint32_t nChannel = 0; nChannel < nChannelsPerLed; nChannel++) {
+				*pLinear++ = m_aLut8[nChannel][*pSlots++];
+			}
+		}
+	}
+}
+
+void PixelPipeline::Output(uint32_t nPixel, uint8_t *pOut, uint32_t nPixels) {
+	assert(pOut != 0);
+	assert((nPixel + nPixels) <= m_nPixels);
+
+	const uint32_t nOffset = nPixel * m_nChannelsPerLed;
+	const uint32_t nChannels = nPixels * m_nChannelsPerLed;
+	const uint16_t *pLinear = &m_pLinear[nOffset];
+
+	if (m_bDithering) {
+		uint8_t *pError = &m_pError[nOffset];
+
+		for (uint32_t i = 0; i < nChannels; i++) {
+			const uint32_t nValue = pLinear[i] + pError[i];
+			pOut[i] = static_cast<uint8_t>(nValue >> 8);
+			pError[i] = static_cast<uint8_t>(nValue);
+		}
+	} else {
+		for (uint32_t i = 0; i < nChannels; i++) {
+			pOut[i] = static_cast<uint8_t>((pLinear[i] + 0x80) >> 8);
+		}
+	}
+}
+
+void PixelPipeline::Print(void) {
+	printf("Pixel pipeline\n");
+	printf(" Input      : %d-bit\n", m_bInput16Bit ? 16 : 8);
+	printf(" Gamma      : %.1f\n", m_fGamma);
+	printf(" Correction : %d %d %d %d\n", static_cast<int>(m_aCorrection[0]), static_cast<int>(m_aCorrection[1]), static_cast<int>(m_aCorrection[2]), static_cast<int>(m_aCorrection[3]));
+	printf(" Dithering  : %c\n", m_bDithering ? 'Y' : 'N');
+}
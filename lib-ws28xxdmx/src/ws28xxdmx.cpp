@@ -25,6 +25,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include <assert.h>
 
 #if defined (__circle__)
@@ -38,7 +39,12 @@
 #endif
 
 #include "ws28xxdmx.h"
+#if defined(USE_SPI_DMA)
+ #include "h3/ws28xxdma.h"
+#endif
 #include "ws28xx.h"
+#include "pixelmap.h"
+#include "pixelpipeline.h"
 
 #include "lightset.h"
 #include "lightsetdisplay.h"
@@ -60,14 +66,19 @@ WS28xxDmx::WS28xxDmx(void) :
 	m_pLEDStripe(0),
 	m_bIsStarted(false),
 	m_bBlackout(false),
+	m_bIsSyncPending(false),
 	m_pWS28xxDmxStore(0),
+	m_pPixelPipeline(0),
+	m_nPixelFirst(0),
+	m_nPixelLast(0),
 	m_nClockSpeedHz(0),
 	m_nGlobalBrightness(0xFF),
-	m_nBeginIndexPortId1(170),
-	m_nBeginIndexPortId2(340),
-	m_nBeginIndexPortId3(510),
+	m_nLedsPerUniverse(170),
 	m_nChannelsPerLed(3),
-	m_nPortIdLast(3)
+	m_nSlotsPerLed(3),
+	m_nUpdateAllMask(0x0F),
+	m_pPixelMap(0),
+	m_pPixels(0)
 {
 	UpdateMembers();
 }
@@ -76,6 +87,9 @@ WS28xxDmx::~WS28xxDmx(void) {
 	Stop();
 	delete m_pLEDStripe;
 	m_pLEDStripe = 0;
+
+	delete [] m_pPixels;
+	m_pPixels = 0;
 }
 
 void WS28xxDmx::Start(uint8_t nPort) {
@@ -88,12 +102,25 @@ void WS28xxDmx::Start(uint8_t nPort) {
 	if (m_pLEDStripe == 0) {
 #if defined (__circle__)
 		m_pLEDStripe = new WS28xx(m_pInterrupt, m_tLedType, m_nLedCount, m_nClockSpeedHz);
+#elif defined(USE_SPI_DMA)
+		m_pLEDStripe = new WS28xxDMA(m_tLedType, m_nLedCount, m_nClockSpeedHz);
 #else
 		m_pLEDStripe = new WS28xx(m_tLedType, m_nLedCount, m_nClockSpeedHz);
 #endif
 		assert(m_pLEDStripe != 0);
 		m_pLEDStripe->SetGlobalBrightness(m_nGlobalBrightness);
 		m_pLEDStripe->Initialize();
+
+		if (m_pPixelPipeline != 0) {
+			m_pPixelPipeline->Initialize(m_nLedCount, m_nChannelsPerLed);
+		}
+
+		if ((m_pPixelMap != 0) && m_pPixelMap->Compile(m_nLedCount, m_nSlotsPerLed)) {
+			const uint32_t nSize = m_nLedCount * m_nSlotsPerLed;
+			m_pPixels = new uint8_t[nSize];
+			assert(m_pPixels != 0);
+			memset(m_pPixels, 0, nSize);
+		}
 	} else {
 		while (m_pLEDStripe->IsUpdating()) {
 			// wait for completion
@@ -118,6 +145,10 @@ void WS28xxDmx::Stop(uint8_t nPort) {
 }
 
 void WS28xxDmx::SetData(uint8_t nPortId, const uint8_t *pData, uint16_t nLength) {
+	SetDataChanged(nPortId, pData, nLength, 0, nLength);
+}
+
+void WS28xxDmx::SetDataChanged(uint8_t nPortId, const uint8_t *pData, uint16_t nLength, uint16_t nChangedFirst, uint16_t nChangedLast) {
 	assert(pData != 0);
 	assert(nLength <= DMX_UNIVERSE_SIZE);
 
@@ -128,29 +159,16 @@ void WS28xxDmx::SetData(uint8_t nPortId, const uint8_t *pData, uint16_t nLength)
 		Start();
 	}
 
-	switch (nPortId & 0x03) {
-	case 0:
-		beginIndex = 0;
-		endIndex = MIN(m_nLedCount, (nLength / m_nChannelsPerLed));
-		if (m_nLedCount < m_nBeginIndexPortId1) {
-			i = m_nDmxStartAddress - 1;
-		}
-		break;
-	case 1:
-		beginIndex = m_nBeginIndexPortId1;
-		endIndex = MIN(m_nLedCount, (beginIndex + (nLength /  m_nChannelsPerLed)));
-		break;
-	case 2:
-		beginIndex = m_nBeginIndexPortId2;
-		endIndex = MIN(m_nLedCount, (beginIndex + (nLength /  m_nChannelsPerLed)));
-		break;
-	case 3:
-		beginIndex = m_nBeginIndexPortId3;
-		endIndex = MIN(m_nLedCount, (beginIndex + (nLength /  m_nChannelsPerLed)));
-		break;
-	default:
-		__builtin_unreachable();
-		break;
+	if (m_pPixels != 0) {
+		SetDataMapped(nPortId, pData, nLength, nChangedFirst, nChangedLast);
+		return;
+	}
+
+	beginIndex = (nPortId & 0x03) * m_nLedsPerUniverse;
+	endIndex = MIN(m_nLedCount, (beginIndex + (nLength / m_nSlotsPerLed)));
+
+	if ((beginIndex == 0) && (m_nLedCount < m_nLedsPerUniverse)) {
+		i = m_nDmxStartAddress - 1;
 	}
 
 #ifndef NDEBUG
@@ -159,10 +177,48 @@ void WS28xxDmx::SetData(uint8_t nPortId, const uint8_t *pData, uint16_t nLength)
 #endif
 #endif
 
-	while (m_pLEDStripe->IsUpdating()) {
-		// wait for completion
+	const uint32_t nPortMask = (1U << (nPortId & 0x03));
+
+	if (__builtin_expect(((m_nUpdateAllMask & nPortMask) != 0), 0)) {
+		m_nUpdateAllMask &= ~nPortMask;
+	} else {
+		// Only the pixels with a changed channel need to be encoded
+		if ((nChangedLast <= i) || (nChangedFirst >= nChangedLast)) {
+			endIndex = beginIndex;
+		} else {
+			const uint32_t nLast = beginIndex + ((nChangedLast - i) + m_nSlotsPerLed - 1) / m_nSlotsPerLed;
+			endIndex = MIN(endIndex, nLast);
+
+			if (nChangedFirst > i) {
+				const uint32_t nSkip = (nChangedFirst - i) / m_nSlotsPerLed;
+				beginIndex += nSkip;
+				i += nSkip * m_nSlotsPerLed;
+			}
+		}
+	}
+
+	if (m_pPixelPipeline != 0) {
+		// Whole pixels only
+		const uint32_t nReceived = (i < nLength) ? ((nLength - i) / m_nSlotsPerLed) : 0;
+		endIndex = MIN(endIndex, beginIndex + nReceived);
+
+		if (beginIndex < endIndex) {
+			m_pPixelPipeline->Input(beginIndex, &pData[i], endIndex - beginIndex);
+
+			if (m_nPixelFirst >= m_nPixelLast) {
+				m_nPixelFirst = beginIndex;
+				m_nPixelLast = endIndex;
+			} else {
+				m_nPixelFirst = MIN(m_nPixelFirst, beginIndex);
+				m_nPixelLast = (endIndex > m_nPixelLast) ? endIndex : m_nPixelLast;
+			}
+		}
+
+		m_bIsSyncPending = true;
+		return;
 	}
 
+	// Encoded into the idle buffer, the previous frame can still be clocked out
 	for (uint32_t j = beginIndex; j < endIndex; j++) {
 		__builtin_prefetch(&pData[i]);
 		if (m_tLedType == SK6812W) {
@@ -180,20 +236,136 @@ void WS28xxDmx::SetData(uint8_t nPortId, const uint8_t *pData, uint16_t nLength)
 		}
 	}
 
-	if (nPortId == m_nPortIdLast) {
+	m_bIsSyncPending = true;
+}
+
+/*
+ * The pixel map copies the universe into m_pPixels, the changed pixels are encoded in Sync
+ */
+void WS28xxDmx::SetDataMapped(uint8_t nPortId, const uint8_t *pData, uint16_t nLength, uint16_t nChangedFirst, uint16_t nChangedLast) {
+	const uint32_t nPort = nPortId & 0x03;
+	const uint32_t nPortMask = (1U << nPort);
+
+	if (__builtin_expect(((m_nUpdateAllMask & nPortMask) != 0), 0)) {
+		m_nUpdateAllMask &= ~nPortMask;
+		nChangedFirst = 0;
+		nChangedLast = nLength;
+	}
+
+	m_pPixelMap->Apply(nPort, pData, nLength, nChangedFirst, nChangedLast, m_pPixels, m_nPixelFirst, m_nPixelLast);
+
+	m_bIsSyncPending = true;
+}
+
+void WS28xxDmx::EncodeMapped(void) {
+	if (m_pPixelPipeline != 0) {
+		// The pipeline encodes the range
+		if (m_nPixelFirst < m_nPixelLast) {
+			m_pPixelPipeline->Input(m_nPixelFirst, &m_pPixels[m_nPixelFirst * m_nSlotsPerLed], m_nPixelLast - m_nPixelFirst);
+		}
+
+		m_pPixelMap->FrameDone();
+		return;
+	}
+
+	const uint8_t *p = &m_pPixels[m_nPixelFirst * m_nChannelsPerLed];
+
+	if (m_tLedType == SK6812W) {
+		for (uint32_t j = m_nPixelFirst; j < m_nPixelLast; j++) {
+			m_pLEDStripe->SetLED(j, p[0], p[1], p[2], p[3]);
+			p += 4;
+		}
+	} else {
+		for (uint32_t j = m_nPixelFirst; j < m_nPixelLast; j++) {
+			m_pLEDStripe->SetLED(j, p[0], p[1], p[2]);
+			p += 3;
+		}
+	}
+
+	m_nPixelFirst = 0;
+	m_nPixelLast = 0;
+
+	m_pPixelMap->FrameDone();
+}
+
+void WS28xxDmx::Sync(void) {
+	if (!m_bIsSyncPending) {
+		return;
+	}
+
+	m_bIsSyncPending = false;
+
+	if (m_pPixels != 0) {
+		EncodeMapped();
+	}
+
+	if (m_pPixelPipeline != 0) {
+		if (m_pPixelPipeline->IsDithering()) {
+			// The remainders change every frame
+			EncodePipeline(0, m_pPixelPipeline->GetPixels());
+		} else if (m_nPixelFirst < m_nPixelLast) {
+			EncodePipeline(m_nPixelFirst, m_nPixelLast);
+		}
+
+		m_nPixelFirst = 0;
+		m_nPixelLast = 0;
+	}
+
+	if (!m_bBlackout) {
+		// Only starting the transfer has to wait for the previous one
+		while (m_pLEDStripe->IsUpdating()) {
+			// wait for completion
+		}
 		m_pLEDStripe->Update();
 	}
 }
 
+void WS28xxDmx::EncodePipeline(uint32_t nFirst, uint32_t nLast) {
+	uint8_t aOut[32 * 4];
+	const uint32_t nBlock = sizeof(aOut) / m_nChannelsPerLed;
+
+	while (nFirst < nLast) {
+		const uint32_t nPixels = MIN(nBlock, nLast - nFirst);
+		const uint8_t *p = aOut;
+
+		m_pPixelPipeline->Output(nFirst, aOut, nPixels);
+
+		if (m_tLedType == SK6812W) {
+			for (uint32_t j = nFirst; j < nFirst + nPixels; j++) {
+				m_pLEDStripe->SetLED(j, p[0], p[1], p[2], p[3]);
+				p += 4;
+			}
+		} else {
+			for (uint32_t j = nFirst; j < nFirst + nPixels; j++) {
+				m_pLEDStripe->SetLED(j, p[0], p[1], p[2]);
+				p += 3;
+			}
+		}
+
+		nFirst += nPixels;
+	}
+}
+
+void WS28xxDmx::Dither(void) {
+	if ((m_pPixelPipeline == 0) || !m_pPixelPipeline->IsDithering() || !m_bIsStarted || m_bBlackout || m_bIsSyncPending) {
+		return;
+	}
+
+	if (m_pLEDStripe->IsUpdating()) {
+		return;
+	}
+
+	EncodePipeline(0, m_pPixelPipeline->GetPixels());
+	m_pLEDStripe->Update();
+}
+
 void WS28xxDmx::SetLEDType(TWS28XXType type) {
 	m_tLedType = type;
 
 	if (type == SK6812W) {
-		m_nBeginIndexPortId1 = 128;
-		m_nBeginIndexPortId2 = 256;
-		m_nBeginIndexPortId3 = 384;
-
 		m_nChannelsPerLed = 4;
+	} else {
+		m_nChannelsPerLed = 3;
 	}
 
 	UpdateMembers();
@@ -206,13 +378,30 @@ void WS28xxDmx::SetLEDCount(uint16_t nCount) {
 }
 
 void WS28xxDmx::UpdateMembers(void) {
-	m_nDmxFootprint = m_nLedCount * m_nChannelsPerLed;
+	m_nSlotsPerLed = m_nChannelsPerLed;
+
+	if (m_pPixelPipeline != 0) {
+		m_nSlotsPerLed *= m_pPixelPipeline->GetSlotsPerChannel();
+	}
+
+	m_nLedsPerUniverse = DMX_UNIVERSE_SIZE / m_nSlotsPerLed;
+	m_nDmxFootprint = m_nLedCount * m_nSlotsPerLed;
 
 	if (m_nDmxFootprint > DMX_UNIVERSE_SIZE) {
 		m_nDmxFootprint = DMX_UNIVERSE_SIZE;
 	}
 
-	m_nPortIdLast = m_nLedCount / (1 + m_nBeginIndexPortId1);
+	m_nUpdateAllMask = 0x0F;
+}
+
+uint32_t WS28xxDmx::GetUniverses(void) {
+	if (m_pPixelMap != 0) {
+		return m_pPixelMap->GetUniverses(m_nLedCount, m_nSlotsPerLed);
+	}
+
+	const uint32_t nUniverses = (m_nLedCount + m_nLedsPerUniverse - 1) / m_nLedsPerUniverse;
+
+	return MIN(nUniverses, 4U);
 }
 
 void WS28xxDmx::Blackout(bool bBlackout) {
@@ -238,6 +427,7 @@ bool WS28xxDmx::SetDmxStartAddress(uint16_t nDmxStartAddress) {
 
 	if ((nDmxStartAddress != 0) && (nDmxStartAddress <= DMX_UNIVERSE_SIZE)) {
 		m_nDmxStartAddress = nDmxStartAddress;
+		m_nUpdateAllMask = 0x0F;
 
 		if (m_pWS28xxDmxStore != 0) {
 			m_pWS28xxDmxStore->SaveDmxStartAddress(m_nDmxStartAddress);
@@ -264,12 +454,18 @@ bool WS28xxDmx::GetSlotInfo(uint16_t nSlotOffset, struct TLightSetSlotInfo& tSlo
 		return false;
 	}
 
-	if (m_tLedType == SK6812W) {
-		nIndex = MOD(nSlotOffset, 4);
-	} else {
-		nIndex = MOD(nSlotOffset, 3);
+	if (m_nSlotsPerLed != m_nChannelsPerLed) {
+		// 16-bit, the fine slot follows the coarse slot
+		if ((nSlotOffset & 0x1) != 0) {
+			tSlotInfo.nType = 0x01;	// ST_SEC_FINE
+			tSlotInfo.nCategory = nSlotOffset - 1;
+			return true;
+		}
+		nSlotOffset = nSlotOffset / 2;
 	}
 
+	nIndex = MOD(nSlotOffset, m_nChannelsPerLed);
+
 	tSlotInfo.nType = 0x00;	// ST_PRIMARY
 
 	switch (nIndex) {
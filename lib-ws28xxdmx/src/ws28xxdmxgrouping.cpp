@@ -26,15 +26,19 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 
 #include "ws28xxdmxgrouping.h"
 #include "ws28xxdmxparams.h"
 #include "ws28xx.h"
+#include "pixelpipeline.h"
 
 #include "lightset.h"
 #include "lightsetdisplay.h"
 
+#include "hardware.h"
+
 #include "debug.h"
 
 #if defined (__circle__)
@@ -42,15 +46,21 @@ WS28xxDmxGrouping::WS28xxDmxGrouping(CInterruptSystem *pInterruptSystem) :
 	WS28xxDmx(pInterruptSystem),
 	m_pDmxData(0),
 	m_nLEDGroupCount(0),
-	m_nGroups(0)
+	m_nGroups(0),
+	m_nSlotsPerGroup(3),
+	m_bUpdateAll(true)
 {
 #else
 WS28xxDmxGrouping::WS28xxDmxGrouping(void):
 	m_pDmxData(0),
 	m_nLEDGroupCount(0),
-	m_nGroups(0)
+	m_nGroups(0),
+	m_nSlotsPerGroup(3),
+	m_bUpdateAll(true)
 {
 #endif
+	memset(&m_tEncodeStats, 0, sizeof(struct TEncodeStats));
+
 	UpdateMembers();
 }
 
@@ -71,61 +81,114 @@ void WS28xxDmxGrouping::SetData(uint8_t nPort, const uint8_t* pData, uint16_t nL
 		Start();
 	}
 
-	while (m_pLEDStripe->IsUpdating()) {
-		// wait for completion
+	const uint32_t nMicros = Hardware::Get()->Micros();
+	const uint32_t nStart = m_nDmxStartAddress - 1;
+
+	// Whole groups only
+	uint32_t nGroups = (nStart < nLength) ? ((nLength - nStart) / m_nSlotsPerGroup) : 0;
+
+	if (nGroups > m_nGroups) {
+		nGroups = m_nGroups;
 	}
 
-//	const uint8_t *p = pData + m_nDmxStartAddress - 1;
-	bool bIsChanged = false;
+	const uint8_t *pSrc = &pData[nStart];
+	uint8_t *pDst = m_pDmxData;
+	uint32_t nFirst = nGroups;
+	uint32_t nLast = 0;
+	uint32_t nChanged = 0;
+
+	for (uint32_t g = 0; g < nGroups; g++) {
+		bool bIsChanged = m_bUpdateAll;
 
-	for (uint32_t i = m_nDmxStartAddress - 1, j = 0; (i < nLength) && (j < m_nDmxFootprint); i++, j++) {
-		if (pData[i] != m_pDmxData[j]) {
-			m_pDmxData[j] = pData[i];
-			bIsChanged = true;
+		for (uint32_t k = 0; k < m_nSlotsPerGroup; k++) {
+			if (pSrc[k] != pDst[k]) {
+				pDst[k] = pSrc[k];
+				bIsChanged = true;
+			}
 		}
-	}
 
-//	for (uint32_t i = 0; i < m_nDmxFootprint; i++) {
-//		if (p[i] != m_pDmxData[i]) {
-//			m_pDmxData[i] = p[i];
-//			bIsChanged = true;
-//		}
-//	}
-
-	if (bIsChanged) {
-		uint32_t i = 0;
-		uint32_t d = 0;
-
-		if (m_tLedType == SK6812W) {
-			for (uint32_t g = 0; g < m_nGroups; g++) {
-				__builtin_prefetch(&m_pDmxData[d]);
-				for (uint32_t k = 0; k < m_nLEDGroupCount; k++) {
-					m_pLEDStripe->SetLED(k + i, m_pDmxData[d + 0], m_pDmxData[d + 1], m_pDmxData[d + 2], m_pDmxData[d + 3]);
-				}
-				i = i + m_nLEDGroupCount;
-				d = d + 4;
+		if (bIsChanged) {
+			if (nChanged == 0) {
+				nFirst = g;
 			}
-		} else {
-			for (uint32_t g = 0; g < m_nGroups; g++) {
-				__builtin_prefetch(&m_pDmxData[d]);
-				for (uint32_t k = 0; k < m_nLEDGroupCount; k++) {
-					m_pLEDStripe->SetLED(k + i, m_pDmxData[d + 0], m_pDmxData[d + 1], m_pDmxData[d + 2]);
-				}
-				i = i + m_nLEDGroupCount;
-				d = d + 3;
+			nLast = g + 1;
+			nChanged++;
+
+			if (m_pPixelPipeline == 0) {
+				EncodeGroup(g, pDst);
 			}
 		}
 
-		if (!m_bBlackout) {
-			m_pLEDStripe->Update();
+		pSrc += m_nSlotsPerGroup;
+		pDst += m_nSlotsPerGroup;
+	}
+
+	if (nGroups == m_nGroups) {
+		m_bUpdateAll = false;
+	}
+
+	if (nChanged == 0) {
+		return;
+	}
+
+	if (m_pPixelPipeline != 0) {
+		// The groups are the pixels of the pipeline, the changed ones are expanded in Sync
+		m_pPixelPipeline->Input(nFirst, &m_pDmxData[nFirst * m_nSlotsPerGroup], nLast - nFirst);
+
+		if (m_nPixelFirst >= m_nPixelLast) {
+			m_nPixelFirst = nFirst;
+			m_nPixelLast = nLast;
+		} else {
+			m_nPixelFirst = (nFirst < m_nPixelFirst) ? nFirst : m_nPixelFirst;
+			m_nPixelLast = (nLast > m_nPixelLast) ? nLast : m_nPixelLast;
 		}
 	}
+
+	const uint32_t nElapsed = Hardware::Get()->Micros() - nMicros;
+
+	m_tEncodeStats.nFrames++;
+	m_tEncodeStats.nGroups += nChanged;
+	m_tEncodeStats.nMicros += nElapsed;
+	m_tEncodeStats.nLastGroups = nChanged;
+	m_tEncodeStats.nLastMicros = nElapsed;
+
+	m_bIsSyncPending = true;
+}
+
+/*
+ * Only the first LED of a group is encoded, the others are copies of its SPI bytes
+ */
+void WS28xxDmxGrouping::EncodeGroup(uint32_t nGroup, const uint8_t *p) {
+	const uint32_t nLED = nGroup * m_nLEDGroupCount;
+
+	if (m_tLedType == SK6812W) {
+		m_pLEDStripe->SetLED(nLED, p[0], p[1], p[2], p[3]);
+	} else {
+		m_pLEDStripe->SetLED(nLED, p[0], p[1], p[2]);
+	}
+
+	if (m_nLEDGroupCount > 1) {
+		m_pLEDStripe->RepeatLED(nLED, m_nLEDGroupCount - 1);
+	}
+}
+
+void WS28xxDmxGrouping::EncodePipeline(uint32_t nFirst, uint32_t nLast) {
+	uint8_t aOut[4];
+
+	if (nLast > m_nGroups) {
+		nLast = m_nGroups;
+	}
+
+	for (uint32_t g = nFirst; g < nLast; g++) {
+		m_pPixelPipeline->Output(g, aOut, 1);
+		EncodeGroup(g, aOut);
+	}
 }
 
 void WS28xxDmxGrouping::SetLEDType(TWS28XXType tLedType) {
 	DEBUG_PRINTF("tLedType=%d", (int)tLedType);
 
-	m_tLedType = tLedType;
+	WS28xxDmx::SetLEDType(tLedType);
 
 	UpdateMembers();
 }
@@ -153,6 +216,7 @@ bool WS28xxDmxGrouping::SetDmxStartAddress(uint16_t nDmxStartAddress) {
 
 	if ((nDmxStartAddress != 0) && (nDmxStartAddress <= (DMX_UNIVERSE_SIZE - m_nDmxFootprint))) {
 		m_nDmxStartAddress = nDmxStartAddress;
+		m_bUpdateAll = true;
 
 		if (m_pWS28xxDmxStore != 0) {
 			m_pWS28xxDmxStore->SaveDmxStartAddress(m_nDmxStartAddress);
@@ -175,18 +239,19 @@ void WS28xxDmxGrouping::UpdateMembers(void) {
 
 	m_nGroups = m_nLedCount / m_nLEDGroupCount;
 
-	if (m_tLedType == SK6812W) {
-		if (m_nGroups > (DMX_UNIVERSE_SIZE / 4)) {
-			m_nGroups = DMX_UNIVERSE_SIZE / 4;
-		}
-		m_nDmxFootprint = m_nGroups * 4;
-	} else {
-		if (m_nGroups > (DMX_UNIVERSE_SIZE / 3)) {
-			m_nGroups = DMX_UNIVERSE_SIZE / 3;
-		}
-		m_nDmxFootprint = m_nGroups * 3;
+	m_nSlotsPerGroup = (m_tLedType == SK6812W) ? 4 : 3;
+
+	if (m_pPixelPipeline != 0) {
+		m_nSlotsPerGroup *= m_pPixelPipeline->GetSlotsPerChannel();
 	}
 
+	if (m_nGroups > (DMX_UNIVERSE_SIZE / m_nSlotsPerGroup)) {
+		m_nGroups = DMX_UNIVERSE_SIZE / m_nSlotsPerGroup;
+	}
+
+	m_nDmxFootprint = m_nGroups * m_nSlotsPerGroup;
+	m_bUpdateAll = true;
+
 	DEBUG_PRINTF("m_nLEDGroupCount=%d, m_nGroups=%d, m_nDmxFootprint=%d", m_nLEDGroupCount, m_nGroups, m_nDmxFootprint);
 }
 
@@ -195,6 +260,12 @@ void WS28xxDmxGrouping::Print(void) {
 	printf(" Type  : %s [%d]\n", WS28xx::GetLedTypeString(m_tLedType), m_tLedType);
 	printf(" Count : %d\n", (int) m_nLedCount);
 	printf(" Group : %d\n", (int) m_nLEDGroupCount);
+	if (m_tEncodeStats.nGroups != 0) {
+		printf(" Encode: %u groups in %u us (last), %u ns per changed group\n", (unsigned) m_tEncodeStats.nLastGroups, (unsigned) m_tEncodeStats.nLastMicros, (unsigned) ((m_tEncodeStats.nMicros * 1000) / m_tEncodeStats.nGroups));
+	}
+	if (m_pPixelPipeline != 0) {
+		m_pPixelPipeline->Print();
+	}
 }
 
 // RDM
@@ -25,12 +25,14 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 
 #include "ws28xxdmxmulti.h"
 #include "ws28xxmulti.h"
 #include "ws28xxdmxparams.h"
 #include "ws28xx.h"
+#include "pixelpipeline.h"
 
 #include "debug.h"
 
@@ -44,14 +46,19 @@ WS28xxDmxMulti::WS28xxDmxMulti(TWS28xxDmxMultiSrc tSrc):
 	m_nLedCount(170),
 	m_nActiveOutputs(WS28XXMULTI_ACTIVE_PORTS_MAX),
 	m_pLEDStripe(0),
+	m_pPixels(0),
+	m_nRowFirst(0),
+	m_nRowLast(0),
 	m_bIsStarted(false),
 	m_bBlackout(false),
+	m_bIsSyncPending(false),
 	m_nUniverses(1), // -> m_nLedCount(170)
-	m_nBeginIndexPortId1(170),
-	m_nBeginIndexPortId2(340),
-	m_nBeginIndexPortId3(510),
+	m_nPortsPerOutput(1),
+	m_nPortsAvailable(static_cast<uint32_t>(~0)),
+	m_nLedsPerUniverse(170),
 	m_nChannelsPerLed(3),
-	m_nPortIdLast(3), // -> (m_nActiveOutputs * m_nUniverses) -1;
+	m_nSlotsPerLed(3),
+	m_pPixelPipeline(0),
 	m_bUseSI5351A(false)
 {
 	DEBUG_ENTRY
@@ -66,6 +73,9 @@ WS28xxDmxMulti::~WS28xxDmxMulti(void) {
 
 	delete m_pLEDStripe;
 	m_pLEDStripe = 0;
+
+	delete [] m_pPixels;
+	m_pPixels = 0;
 }
 
 void WS28xxDmxMulti::Start(uint8_t nPort) {
@@ -80,6 +90,16 @@ void WS28xxDmxMulti::Start(uint8_t nPort) {
 	if (m_pLEDStripe == 0) {
 		m_pLEDStripe = new WS28xxMulti(m_tLedType, m_nLedCount, m_nActiveOutputs, m_bUseSI5351A);
 		assert(m_pLEDStripe != 0);
+
+		if (m_pPixelPipeline != 0) {
+			m_pPixelPipeline->Initialize(m_nLedCount * m_nActiveOutputs, m_nChannelsPerLed);
+		}
+
+		const uint32_t nSize = m_nLedCount * m_nActiveOutputs * m_nSlotsPerLed;
+		m_pPixels = new uint8_t[nSize];
+		assert(m_pPixels != 0);
+		memset(m_pPixels, 0, nSize);
+
 		m_pLEDStripe->Blackout();
 	} else {
 		m_pLEDStripe->Update();
@@ -105,74 +125,106 @@ void WS28xxDmxMulti::SetData(uint8_t nPortId, const uint8_t* pData, uint16_t nLe
 	assert(nLength <= DMX_UNIVERSE_SIZE);
 
 	uint32_t i = 0;
-	uint32_t beginIndex, endIndex;
 
 	if (__builtin_expect((m_pLEDStripe == 0), 0)) {
 		Start(0);
 	}
 
-	switch (nPortId & ~(uint8_t)m_nUniverses & (uint8_t)0x03) {
-	case 0:
-		beginIndex = 0;
-		endIndex = MIN(m_nLedCount, (nLength / m_nChannelsPerLed));
-		break;
-	case 1:
-		beginIndex = m_nBeginIndexPortId1;
-		endIndex = MIN(m_nLedCount, (beginIndex + (nLength / m_nChannelsPerLed)));
-		break;
-	case 2:
-		beginIndex = m_nBeginIndexPortId2;
-		endIndex = MIN(m_nLedCount, (beginIndex + (nLength / m_nChannelsPerLed)));
-		break;
-	case 3:
-		beginIndex = m_nBeginIndexPortId3;
-		endIndex = MIN(m_nLedCount, (beginIndex + (nLength / m_nChannelsPerLed)));
-		break;
-	default:
-		__builtin_unreachable();
-		break;
-	}
-
-	uint32_t nOutIndex;
+	const uint32_t nOutIndex = nPortId / m_nPortsPerOutput;
+	const uint32_t nUniverse = nPortId - (nOutIndex * m_nPortsPerOutput);
 
-	if (m_tSrc == WS28XXDMXMULTI_SRC_E131) {
-		nOutIndex = nPortId / m_nUniverses;
-	} else {
-		nOutIndex = nPortId / 4;
+	if (__builtin_expect(((nOutIndex >= m_nActiveOutputs) || (nUniverse >= m_nUniverses)), 0)) {
+		return;
 	}
 
-	DEBUG_PRINTF("nPort=%d, nLength=%d, nOutIndex=%d, nPortId=%d, beginIndex=%d, endIndex=%d",
-			(int ) nPortId, (int ) nLength, (int ) nOutIndex,
-			(int )nPortId & ~m_nUniverses & 0x03, (int)beginIndex, (int)endIndex);
+	const uint32_t beginIndex = nUniverse * m_nLedsPerUniverse;
+	const uint32_t endIndex = MIN(m_nLedCount, (beginIndex + (nLength / m_nSlotsPerLed)));
+
+	DEBUG_PRINTF("nPort=%d, nLength=%d, nOutIndex=%d, nUniverse=%d, beginIndex=%d, endIndex=%d",
+			(int ) nPortId, (int ) nLength, (int ) nOutIndex, (int) nUniverse, (int)beginIndex, (int)endIndex);
+
+	// The pixels are staged row by row, and encoded for all outputs at once in Sync
+	const uint32_t nStride = m_nActiveOutputs * m_nSlotsPerLed;
+	uint8_t *pPixel = &m_pPixels[(beginIndex * nStride) + (nOutIndex * m_nSlotsPerLed)];
 
 	for (uint32_t j = beginIndex; j < endIndex; j++) {
-		__builtin_prefetch(&pData[i]);
-		if (m_tLedType == WS28XXMULTI_SK6812W) {
-			if (i + 3 > nLength) {
-				break;
-			}
-			m_pLEDStripe->SetLED(nOutIndex, j, pData[i], pData[i + 1], pData[i + 2], pData[i + 3]);
-			i = i + 4;
+		if (i + m_nSlotsPerLed > nLength) {
+			break;
+		}
+		memcpy(pPixel, &pData[i], m_nSlotsPerLed);
+		pPixel += nStride;
+		i = i + m_nSlotsPerLed;
+	}
+
+	if (beginIndex < endIndex) {
+		if (m_nRowFirst >= m_nRowLast) {
+			m_nRowFirst = beginIndex;
+			m_nRowLast = endIndex;
 		} else {
-			if (i + 2 > nLength) {
-				break;
-			}
-			m_pLEDStripe->SetLED(nOutIndex, j, pData[i], pData[i + 1], pData[i + 2]);
-			i = i + 3;
+			m_nRowFirst = MIN(m_nRowFirst, beginIndex);
+			m_nRowLast = (endIndex > m_nRowLast) ? endIndex : m_nRowLast;
 		}
 	}
 
-	if (nPortId == m_nPortIdLast) {
+	m_bIsSyncPending = true;
+}
+
+void WS28xxDmxMulti::Sync(void) {
+	if (!m_bIsSyncPending) {
+		return;
+	}
+
+	m_bIsSyncPending = false;
+
+	Encode();
+
+	if (!m_bBlackout) {
 		m_pLEDStripe->Update();
 	}
 }
 
+void WS28xxDmxMulti::Encode(void) {
+	const uint32_t nStride = m_nActiveOutputs * m_nSlotsPerLed;
+	const uint32_t nLedCount = m_pLEDStripe->GetLEDCount();
+	const uint32_t nRowLast = MIN(m_nRowLast, nLedCount);
+
+	if (m_pPixelPipeline != 0) {
+		// A row is m_nActiveOutputs pixels of the pipeline
+		if (m_nRowFirst < nRowLast) {
+			m_pPixelPipeline->Input(m_nRowFirst * m_nActiveOutputs, &m_pPixels[m_nRowFirst * nStride], (nRowLast - m_nRowFirst) * m_nActiveOutputs);
+		}
+
+		uint32_t nFirst = m_nRowFirst;
+		uint32_t nLast = nRowLast;
+
+		if (m_pPixelPipeline->IsDithering()) {
+			nFirst = 0;
+			nLast = nLedCount;
+		}
+
+		uint8_t aRow[WS28XXMULTI_ACTIVE_PORTS_MAX * 4];
+
+		for (uint32_t j = nFirst; j < nLast; j++) {
+			m_pPixelPipeline->Output(j * m_nActiveOutputs, aRow, m_nActiveOutputs);
+			m_pLEDStripe->SetLEDRow(j, aRow);
+		}
+	} else {
+		for (uint32_t j = m_nRowFirst; j < nRowLast; j++) {
+			m_pLEDStripe->SetLEDRow(j, &m_pPixels[j * nStride]);
+		}
+	}
+
+	m_nRowFirst = 0;
+	m_nRowLast = 0;
+}
+
 void WS28xxDmxMulti::Blackout(bool bBlackout) {
 	m_bBlackout = bBlackout;
 
 	if (bBlackout) {
 		m_pLEDStripe->Blackout();
 	} else {
+		Encode();
 		m_pLEDStripe->Update();
 	}
 }
@@ -183,11 +235,9 @@ void WS28xxDmxMulti::SetLEDType(TWS28xxMultiType tWS28xxMultiType) {
 	m_tLedType = tWS28xxMultiType;
 
 	if (tWS28xxMultiType == WS28XXMULTI_SK6812W) {
-		m_nBeginIndexPortId1 = 128;
-		m_nBeginIndexPortId2 = 256;
-		m_nBeginIndexPortId3 = 384;
-
 		m_nChannelsPerLed = 4;
+	} else {
+		m_nChannelsPerLed = 3;
 	}
 
 	UpdateMembers();
@@ -216,21 +266,73 @@ void WS28xxDmxMulti::SetActivePorts(uint8_t nActiveOutputs) {
 }
 
 void WS28xxDmxMulti::UpdateMembers(void) {
-	m_nUniverses = 1 + (m_nLedCount / (1 + m_nBeginIndexPortId1));
+	const uint32_t nLedCountMax = (m_tLedType == WS28XXMULTI_SK6812W) ? WS28XXMULTI_LEDCOUNT_RGBW_MAX : WS28XXMULTI_LEDCOUNT_RGB_MAX;
+
+	if (m_nLedCount > nLedCountMax) {
+		m_nLedCount = nLedCountMax;
+	}
+
+	if (m_nActiveOutputs > WS28XXMULTI_ACTIVE_PORTS_MAX) {
+		m_nActiveOutputs = WS28XXMULTI_ACTIVE_PORTS_MAX;
+	}
+
+	m_nSlotsPerLed = m_nChannelsPerLed;
+
+	if (m_pPixelPipeline != 0) {
+		m_nSlotsPerLed *= m_pPixelPipeline->GetSlotsPerChannel();
+	}
+
+	m_nLedsPerUniverse = DMX_UNIVERSE_SIZE / m_nSlotsPerLed;
+
+	m_nUniverses = (m_nLedCount + m_nLedsPerUniverse - 1) / m_nLedsPerUniverse;
+
+	if (m_nUniverses == 0) {
+		m_nUniverses = 1;
+	}
 
 	if (m_tSrc == WS28XXDMXMULTI_SRC_E131) {
-		m_nPortIdLast = (m_nActiveOutputs * m_nUniverses)  - 1;
+		m_nPortsPerOutput = m_nUniverses;
 	} else {
-		m_nPortIdLast = ((m_nActiveOutputs - 1) * 4) + m_nUniverses - 1;
+		// An Art-Net output takes whole pages of 4 ports
+		m_nPortsPerOutput = (m_nUniverses + 3) & ~3U;
+	}
+
+	DEBUG_PRINTF("m_tLedType=%d, m_nLedCount=%d, m_nUniverses=%d, m_nPortsPerOutput=%d", (int)m_tLedType, (int)m_nLedCount, (int)m_nUniverses, (int)m_nPortsPerOutput);
+}
+
+uint32_t WS28xxDmxMulti::GetOutputsFed(void) {
+	if (m_nPortsAvailable < m_nUniverses) {
+		return 0;
 	}
 
-	DEBUG_PRINTF("m_tLedType=%d, m_nLedCount=%d, m_nUniverses=%d, m_nPortIndexLast=%d", (int)m_tLedType, (int)m_nLedCount, (int)m_nUniverses, (int) m_nPortIdLast);
+	// The last output fed does not need the ports rounded up to a page
+	const uint32_t nOutputsFed = ((m_nPortsAvailable - m_nUniverses) / m_nPortsPerOutput) + 1;
+
+	return MIN(nOutputsFed, m_nActiveOutputs);
 }
 
 void WS28xxDmxMulti::Print(void) {
 	printf("Led parameters\n");
 	printf(" Type    : %s [%d]\n", WS28xx::GetLedTypeString((TWS28XXType)m_tLedType), m_tLedType);
 	printf(" Count   : %d\n", (int) m_nLedCount);
-	printf(" Outputs : %d\n", (int) m_nActiveOutputs);
+	printf(" Outputs : %d", (int) m_nActiveOutputs);
+
+	const uint32_t nOutputsFed = GetOutputsFed();
+
+	if (nOutputsFed < m_nActiveOutputs) {
+		printf(" -> only %d fed, %d ports available", (int) nOutputsFed, (int) m_nPortsAvailable);
+	}
+
+	printf("\n");
+	printf(" Universes : %d per output (%d ports)\n", (int) m_nUniverses, (int) m_nPortsPerOutput);
 	printf(" SI5351A : %c\n", m_bUseSI5351A ? 'Y' : 'N');
+
+	if (m_pLEDStripe != 0) {
+		const uint32_t nFrameTime = m_pLEDStripe->GetFrameTime();
+		printf(" Frame   : %d us -> max %d fps\n", (int) nFrameTime, (int) (1000000 / nFrameTime));
+	}
+
+	if (m_pPixelPipeline != 0) {
+		m_pPixelPipeline->Print();
+	}
 }
@@ -66,6 +66,10 @@ WS28xxDmxParams::WS28xxDmxParams(WS28xxDmxParamsStore *pWS28XXStripeParamsStore)
 	m_tWS28xxParams.nActiveOutputs = 1;
 	m_tWS28xxParams.bUseSI5351A = false;
 	m_tWS28xxParams.nLedGroupCount = DMX_UNIVERSE_SIZE;
+	m_tWS28xxParams.bInput16Bit = false;
+	m_tWS28xxParams.fGamma = 1.0f;
+	memset(m_tWS28xxParams.aCorrection, 0xFF, sizeof(m_tWS28xxParams.aCorrection));
+	m_tWS28xxParams.bDither = false;
 }
 
 WS28xxDmxParams::~WS28xxDmxParams(void) {
@@ -115,6 +119,7 @@ void WS28xxDmxParams::callbackFunction(const char *pLine) {
 	uint8_t value8;
 	uint16_t value16;
 	uint32_t value32;
+	float fValue;
 	uint8_t len;
 	char buffer[16];
 
@@ -177,6 +182,36 @@ void WS28xxDmxParams::callbackFunction(const char *pLine) {
 		return;
 	}
 
+	if (Sscan::Uint8(pLine, DevicesParamsConst::INPUT_16BIT, &value8) == SSCAN_OK) {
+		m_tWS28xxParams.bInput16Bit = (value8 != 0);
+		m_tWS28xxParams.nSetList |= WS28XXDMX_PARAMS_MASK_INPUT_16BIT;
+		return;
+	}
+
+	if (Sscan::Float(pLine, DevicesParamsConst::GAMMA, &fValue) == SSCAN_OK) {
+		if ((fValue >= 0.5f) && (fValue <= 4.0f)) {
+			m_tWS28xxParams.fGamma = fValue;
+			m_tWS28xxParams.nSetList |= WS28XXDMX_PARAMS_MASK_GAMMA;
+		}
+		return;
+	}
+
+	const char *aCorrection[4] = {DevicesParamsConst::CORRECTION_RED, DevicesParamsConst::CORRECTION_GREEN, DevicesParamsConst::CORRECTION_BLUE, DevicesParamsConst::CORRECTION_WHITE};
+
+	for (uint32_t i = 0; i < 4; i++) {
+		if (Sscan::Uint8(pLine, aCorrection[i], &value8) == SSCAN_OK) {
+			m_tWS28xxParams.aCorrection[i] = value8;
+			m_tWS28xxParams.nSetList |= WS28XXDMX_PARAMS_MASK_CORRECTION;
+			return;
+		}
+	}
+
+	if (Sscan::Uint8(pLine, DevicesParamsConst::DITHER, &value8) == SSCAN_OK) {
+		m_tWS28xxParams.bDither = (value8 != 0);
+		m_tWS28xxParams.nSetList |= WS28XXDMX_PARAMS_MASK_DITHER;
+		return;
+	}
+
 	if (Sscan::Uint16(pLine, LightSetConst::PARAMS_DMX_START_ADDRESS, &value16) == SSCAN_OK) {
 		if (value16 != 0 && value16 <= DMX_UNIVERSE_SIZE) {
 			m_tWS28xxParams.nDmxStartAddress = value16;
@@ -224,6 +259,25 @@ void WS28xxDmxParams::Dump(void) {
 	if (isMaskSet(WS28XXDMX_PARAMS_MASK_DMX_START_ADDRESS)) {
 		printf(" %s=%d\n", LightSetConst::PARAMS_DMX_START_ADDRESS, (int) m_tWS28xxParams.nDmxStartAddress);
 	}
+
+	if (isMaskSet(WS28XXDMX_PARAMS_MASK_INPUT_16BIT)) {
+		printf(" %s=%d [%s]\n", DevicesParamsConst::INPUT_16BIT, (int) m_tWS28xxParams.bInput16Bit, BOOL2STRING(m_tWS28xxParams.bInput16Bit));
+	}
+
+	if (isMaskSet(WS28XXDMX_PARAMS_MASK_GAMMA)) {
+		printf(" %s=%.1f\n", DevicesParamsConst::GAMMA, m_tWS28xxParams.fGamma);
+	}
+
+	if (isMaskSet(WS28XXDMX_PARAMS_MASK_CORRECTION)) {
+		printf(" %s=%d\n", DevicesParamsConst::CORRECTION_RED, (int) m_tWS28xxParams.aCorrection[0]);
+		printf(" %s=%d\n", DevicesParamsConst::CORRECTION_GREEN, (int) m_tWS28xxParams.aCorrection[1]);
+		printf(" %s=%d\n", DevicesParamsConst::CORRECTION_BLUE, (int) m_tWS28xxParams.aCorrection[2]);
+		printf(" %s=%d\n", DevicesParamsConst::CORRECTION_WHITE, (int) m_tWS28xxParams.aCorrection[3]);
+	}
+
+	if (isMaskSet(WS28XXDMX_PARAMS_MASK_DITHER)) {
+		printf(" %s=%d [%s]\n", DevicesParamsConst::DITHER, (int) m_tWS28xxParams.bDither, BOOL2STRING(m_tWS28xxParams.bDither));
+	}
 #endif
 }
 
@@ -235,3 +289,7 @@ void WS28xxDmxParams::staticCallbackFunction(void *p, const char *s) {
 }
 
 
+
+bool WS28xxDmxParams::isMaskSet(uint32_t nMask) const {
+	return (m_tWS28xxParams.nSetList & nMask) == nMask;
+}
@@ -64,6 +64,14 @@ void WS28xxDmxParams::Builder(const struct TWS28xxDmxParams *ptWS28xxParams, uin
 	builder.Add(DevicesParamsConst::ACTIVE_OUT, m_tWS28xxParams.nActiveOutputs, isMaskSet(WS28XXDMX_PARAMS_MASK_ACTIVE_OUT));
 	builder.Add(DevicesParamsConst::USE_SI5351A, m_tWS28xxParams.bUseSI5351A, isMaskSet(WS28XXDMX_PARAMS_MASK_USE_SI5351A));
 
+	builder.Add(DevicesParamsConst::INPUT_16BIT, m_tWS28xxParams.bInput16Bit, isMaskSet(WS28XXDMX_PARAMS_MASK_INPUT_16BIT));
+	builder.Add(DevicesParamsConst::GAMMA, m_tWS28xxParams.fGamma, isMaskSet(WS28XXDMX_PARAMS_MASK_GAMMA));
+	builder.Add(DevicesParamsConst::CORRECTION_RED, m_tWS28xxParams.aCorrection[0], isMaskSet(WS28XXDMX_PARAMS_MASK_CORRECTION));
+	builder.Add(DevicesParamsConst::CORRECTION_GREEN, m_tWS28xxParams.aCorrection[1], isMaskSet(WS28XXDMX_PARAMS_MASK_CORRECTION));
+	builder.Add(DevicesParamsConst::CORRECTION_BLUE, m_tWS28xxParams.aCorrection[2], isMaskSet(WS28XXDMX_PARAMS_MASK_CORRECTION));
+	builder.Add(DevicesParamsConst::CORRECTION_WHITE, m_tWS28xxParams.aCorrection[3], isMaskSet(WS28XXDMX_PARAMS_MASK_CORRECTION));
+	builder.Add(DevicesParamsConst::DITHER, m_tWS28xxParams.bDither, isMaskSet(WS28XXDMX_PARAMS_MASK_DITHER));
+
 	nSize = builder.GetSize();
 
 	DEBUG_PRINTF("nSize=%d", nSize);
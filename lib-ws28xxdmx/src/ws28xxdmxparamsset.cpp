@@ -27,6 +27,7 @@
 
 #include "ws28xxdmxparams.h"
 #include "ws28xxdmx.h"
+#include "pixelpipeline.h"
 
 void WS28xxDmxParams::Set(WS28xxDmx *pWS28xxDmx) {
 	assert(pWS28xxDmx != 0);
@@ -51,3 +52,25 @@ void WS28xxDmxParams::Set(WS28xxDmx *pWS28xxDmx) {
 		pWS28xxDmx->SetGlobalBrightness(m_tWS28xxParams.nGlobalBrightness);
 	}
 }
+
+void WS28xxDmxParams::Set(PixelPipeline *pPixelPipeline) {
+	assert(pPixelPipeline != 0);
+
+	if (isMaskSet(WS28XXDMX_PARAMS_MASK_INPUT_16BIT)) {
+		pPixelPipeline->SetInput16Bit(m_tWS28xxParams.bInput16Bit);
+	}
+
+	if (isMaskSet(WS28XXDMX_PARAMS_MASK_GAMMA)) {
+		pPixelPipeline->SetGamma(m_tWS28xxParams.fGamma);
+	}
+
+	if (isMaskSet(WS28XXDMX_PARAMS_MASK_CORRECTION)) {
+		for (uint32_t i = 0; i < 4; i++) {
+			pPixelPipeline->SetCorrection(i, m_tWS28xxParams.aCorrection[i]);
+		}
+	}
+
+	if (isMaskSet(WS28XXDMX_PARAMS_MASK_DITHER)) {
+		pPixelPipeline->SetDithering(m_tWS28xxParams.bDither);
+	}
+}
@@ -40,4 +40,10 @@ void WS28xxDmx::Print(void) {
 	if (m_tLedType == APA102) {
 		printf(" GlbBr : %d\n", (int) m_nGlobalBrightness);
 	}
+	if (m_pPixelMap != 0) {
+		m_pPixelMap->Print();
+	}
+	if (m_pPixelPipeline != 0) {
+		m_pPixelPipeline->Print();
+	}
 }
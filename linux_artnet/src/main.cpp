@@ -195,6 +195,7 @@ int main(int argc, char **argv) {
 	for (;;) {
 		node.Run();
 		identify.Run();
+		RdmResponder.Run();
 #if defined (RASPPI)
 		spiFlashStore.Flash();
 #endif
@@ -104,6 +104,7 @@ void notmain(void) {
 
 	nw.Init((NetworkParamsStore *)spiFlashStore.GetStoreNetwork());
 	nw.SetNetworkStore((NetworkStore *)spiFlashStore.GetStoreNetwork());
+	nw.SetRxIrq(true);
 	nw.SetNetworkDisplay((NetworkDisplay *)&displayUdfHandler);
 	nw.Print();
 
@@ -204,6 +205,7 @@ void notmain(void) {
 		spiFlashStore.Flash();
 		lb.Run();
 		display.Run();
+		display.ShowDmxStatistics(DmxSet::Get());
 	}
 }
 
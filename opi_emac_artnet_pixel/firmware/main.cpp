@@ -51,8 +51,11 @@
 #include "ws28xxdmxparams.h"
 #include "ws28xxdmx.h"
 #include "ws28xxdmxgrouping.h"
+#include "pixelpipeline.h"
 #include "ws28xx.h"
 #include "storews28xxdmx.h"
+#include "pixelmap.h"
+#include "pixelmapparams.h"
 // PWM Led
 #include "tlc59711dmxparams.h"
 #include "tlc59711dmx.h"
@@ -101,6 +104,7 @@ void notmain(void) {
 
 	nw.Init((NetworkParamsStore *)spiFlashStore.GetStoreNetwork());
 	nw.SetNetworkStore((NetworkStore *)spiFlashStore.GetStoreNetwork());
+	nw.SetRxIrq(true);
 	nw.SetNetworkDisplay((NetworkDisplay *)&displayUdfHandler);
 	nw.Print();
 
@@ -121,6 +125,7 @@ void notmain(void) {
 	node.SetUniverseSwitch(0, ARTNET_OUTPUT_PORT, nUniverse);
 
 	LightSet *pSpi;
+	WS28xxDmx *pDither = 0;
 
 	bool isLedTypeSet = false;
 
@@ -147,44 +152,51 @@ void notmain(void) {
 
 		const bool bIsLedGrouping = ws28xxparms.IsLedGrouping() && (ws28xxparms.GetLedGroupCount() > 1);
 
+		PixelPipeline *pPixelPipeline = 0;
+
+		if (ws28xxparms.IsPixelPipeline()) {
+			pPixelPipeline = new PixelPipeline;
+			assert(pPixelPipeline != 0);
+			ws28xxparms.Set(pPixelPipeline);
+		}
+
 		if (bIsLedGrouping) {
 			WS28xxDmxGrouping *pWS28xxDmxGrouping = new WS28xxDmxGrouping;
 			assert(pWS28xxDmxGrouping != 0);
+			pWS28xxDmxGrouping->SetPixelPipeline(pPixelPipeline);
 			ws28xxparms.Set(pWS28xxDmxGrouping);
 			pWS28xxDmxGrouping->SetLEDGroupCount(ws28xxparms.GetLedGroupCount());
 			pSpi = pWS28xxDmxGrouping;
+			pDither = pWS28xxDmxGrouping;
 			display.Printf(7, "%s:%d G%d", WS28xx::GetLedTypeString(pWS28xxDmxGrouping->GetLEDType()), pWS28xxDmxGrouping->GetLEDCount(), pWS28xxDmxGrouping->GetLEDGroupCount());
 		} else  {
 			WS28xxDmx *pWS28xxDmx = new WS28xxDmx;
 			assert(pWS28xxDmx != 0);
+			pWS28xxDmx->SetPixelPipeline(pPixelPipeline);
 			ws28xxparms.Set(pWS28xxDmx);
+
+			PixelMapParams pixelMapParams;
+
+			if (pixelMapParams.Load()) {
+				PixelMap *pPixelMap = new PixelMap;
+				assert(pPixelMap != 0);
+				pixelMapParams.Set(pPixelMap);
+				pixelMapParams.Dump();
+				pWS28xxDmx->SetPixelMap(pPixelMap);
+			}
+
 			pSpi = pWS28xxDmx;
+			pDither = pWS28xxDmx;
 			display.Printf(7, "%s:%d", WS28xx::GetLedTypeString(pWS28xxDmx->GetLEDType()), pWS28xxDmx->GetLEDCount());
 
-			const uint16_t nLedCount = pWS28xxDmx->GetLEDCount();
-
-			if (pWS28xxDmx->GetLEDType() == SK6812W) {
-				if (nLedCount > 128) {
-					node.SetDirectUpdate(true);
-					node.SetUniverseSwitch(1, ARTNET_OUTPUT_PORT, nUniverse + 1);
-				}
-				if (nLedCount > 256) {
-					node.SetUniverseSwitch(2, ARTNET_OUTPUT_PORT, nUniverse + 2);
-				}
-				if (nLedCount > 384) {
-					node.SetUniverseSwitch(3, ARTNET_OUTPUT_PORT, nUniverse + 3);
-				}
-			} else {
-				if (nLedCount > 170) {
-					node.SetDirectUpdate(true);
-					node.SetUniverseSwitch(1, ARTNET_OUTPUT_PORT, nUniverse + 1);
-				}
-				if (nLedCount > 340) {
-					node.SetUniverseSwitch(2, ARTNET_OUTPUT_PORT, nUniverse + 2);
-				}
-				if (nLedCount > 510) {
-					node.SetUniverseSwitch(3, ARTNET_OUTPUT_PORT, nUniverse + 3);
-				}
+			const uint32_t nUniverses = pWS28xxDmx->GetUniverses();
+
+			if (nUniverses > 1) {
+				node.SetDirectUpdate(true);
+			}
+
+			for (uint32_t nPort = 1; nPort < nUniverses; nPort++) {
+				node.SetUniverseSwitch(nPort, ARTNET_OUTPUT_PORT, nUniverse + nPort);
 			}
 		}
 	}
@@ -242,6 +254,9 @@ void notmain(void) {
 		spiFlashStore.Flash();
 		lb.Run();
 		display.Run();
+		if (pDither != 0) {
+			pDither->Dither();
+		}
 	}
 }
 
@@ -48,6 +48,7 @@
 
 #include "ws28xxdmxparams.h"
 #include "ws28xxdmxmulti.h"
+#include "pixelpipeline.h"
 #include "ws28xx.h"
 #include "storews28xxdmx.h"
 
@@ -91,6 +92,7 @@ void notmain(void) {
 
 	nw.Init((NetworkParamsStore *)spiFlashStore.GetStoreNetwork());
 	nw.SetNetworkStore((NetworkStore *)spiFlashStore.GetStoreNetwork());
+	nw.SetRxIrq(true);
 	nw.SetNetworkDisplay((NetworkDisplay *)&displayUdfHandler);
 	nw.Print();
 
@@ -101,6 +103,12 @@ void notmain(void) {
 	WS28xxDmxParams ws28xxparms((WS28xxDmxParamsStore *) &storeWS28xxDmx);
 
 	if (ws28xxparms.Load()) {
+		if (ws28xxparms.IsPixelPipeline()) {
+			PixelPipeline *pPixelPipeline = new PixelPipeline;
+			assert(pPixelPipeline != 0);
+			ws28xxparms.Set(pPixelPipeline);
+			ws28xxDmxMulti.SetPixelPipeline(pPixelPipeline);
+		}
 		ws28xxparms.Set(&ws28xxDmxMulti);
 		ws28xxparms.Dump();
 	}
@@ -108,8 +116,24 @@ void notmain(void) {
 	ws28xxDmxMulti.Start(0);
 
 	const uint8_t nActivePorts = ws28xxDmxMulti.GetActivePorts();
+	const uint32_t nUniverses = ws28xxDmxMulti.GetUniverses();
+	const uint32_t nPortsPerOutput = ws28xxDmxMulti.GetPortsPerOutput();
+
+	// Each output takes nPortsPerOutput ports, rounded up to whole pages
+	const uint32_t nPortsRequested = nActivePorts * nPortsPerOutput;
+	uint32_t nPages = (nPortsRequested + ARTNET_MAX_PORTS - 1) / ARTNET_MAX_PORTS;
+
+	if (nPages == 0) {
+		nPages = 1;
+	} else if (nPages > ARTNET_MAX_PAGES) {
+		nPages = ARTNET_MAX_PAGES;
+	}
+
+	if (nPortsRequested > (nPages * ARTNET_MAX_PORTS)) {
+		printf("Warning: %u universes requested, only %u are available\n", (unsigned) nPortsRequested, (unsigned) (nPages * ARTNET_MAX_PORTS));
+	}
 
-	ArtNet4Node node(nActivePorts);
+	ArtNet4Node node(static_cast<uint8_t>(nPages));
 	ArtNet4Params artnetparams((ArtNet4ParamsStore *)spiFlashStore.GetStoreArtNet4());
 
 	if (artnetparams.Load()) {
@@ -123,57 +147,38 @@ void notmain(void) {
 	node.SetArtNetDisplay((ArtNetDisplay *)&displayUdfHandler);
 	node.SetArtNetStore((ArtNetStore *)spiFlashStore.GetStoreArtNet());
 
-	const uint16_t nLedCount = ws28xxDmxMulti.GetLEDCount();
 	const uint8_t nUniverseStart = artnetparams.GetUniverse();
 
 	node.SetDirectUpdate(true);
 	node.SetOutput(&ws28xxDmxMulti);
 
-	uint8_t nPortIndex = 0;
-	uint8_t nPage = 1;
-
-	for (uint32_t i = 0; i < nActivePorts; i++) {
-		node.SetUniverseSwitch(nPortIndex, ARTNET_OUTPUT_PORT,  nUniverseStart);
+	for (uint32_t nPage = 1; nPage < node.GetPages(); nPage++) {
+		uint8_t nSubnetSwitch = node.GetSubnetSwitch(nPage - 1);
+		nSubnetSwitch = (nSubnetSwitch + 1) & 0x0F;
+		node.SetSubnetSwitch(nSubnetSwitch, nPage);
 
-		if (ws28xxDmxMulti.GetLEDType() == WS28XXMULTI_SK6812W) {
-			if (nLedCount > 128) {
-				node.SetUniverseSwitch(nPortIndex + 1, ARTNET_OUTPUT_PORT, nUniverseStart + 1);
-			}
+		if (nSubnetSwitch == 0) {
+			uint8_t nNetSwitch = node.GetNetSwitch(nPage);
+			nNetSwitch = (nNetSwitch + 1) & 0x0F;
+			node.SetNetSwitch(nNetSwitch, nPage);
+		}
+	}
 
-			if (nLedCount > 256) {
-				node.SetUniverseSwitch(nPortIndex + 2, ARTNET_OUTPUT_PORT, nUniverseStart + 2);
-			}
+	// Each output takes whole pages, the universe switches are the same for each page
+	const uint32_t nPorts = ARTNET_MAX_PORTS * node.GetPages();
 
-			if (nLedCount > 384) {
-				node.SetUniverseSwitch(nPortIndex + 3, ARTNET_OUTPUT_PORT, nUniverseStart + 3);
-			}
-		} else {
-			if (nLedCount > 170) {
-				node.SetUniverseSwitch(nPortIndex + 1, ARTNET_OUTPUT_PORT, nUniverseStart + 1);
-			}
+	ws28xxDmxMulti.SetPortsAvailable(nPorts);
 
-			if (nLedCount > 340) {
-				node.SetUniverseSwitch(nPortIndex + 2, ARTNET_OUTPUT_PORT, nUniverseStart + 2);
-			}
+	for (uint32_t i = 0; i < nActivePorts; i++) {
+		for (uint32_t nUniverse = 0; nUniverse < nUniverses; nUniverse++) {
+			const uint32_t nPortIndex = (i * nPortsPerOutput) + nUniverse;
 
-			if (nLedCount > 510) {
-				node.SetUniverseSwitch(nPortIndex + 3, ARTNET_OUTPUT_PORT, nUniverseStart + 3);
+			if (nPortIndex >= nPorts) {
+				break;
 			}
-		}
 
-		if (nPage < ARTNET_MAX_PAGES) {
-			uint8_t nSubnetSwitch = node.GetSubnetSwitch(nPage - 1);
-			nSubnetSwitch = (nSubnetSwitch + 1) & 0x0F;
-			node.SetSubnetSwitch(nSubnetSwitch, nPage);
-
-			if (nSubnetSwitch == 0) {
-				uint8_t nNetSwitch = node.GetNetSwitch(nPage);
-				nNetSwitch = (nNetSwitch + 1) & 0x0F;
-				node.SetNetSwitch(nNetSwitch, nPage);
-			}
-			nPage++;
+			node.SetUniverseSwitch(nPortIndex, ARTNET_OUTPUT_PORT, nUniverseStart + (nPortIndex & (ARTNET_MAX_PORTS - 1)));
 		}
-		nPortIndex += ARTNET_MAX_PORTS;
 	}
 
 	node.Print();
@@ -303,6 +303,7 @@ void notmain(void) {
 		nw.Run();
 		node.Run();
 		identify.Run();
+		RdmResponder.Run();
 #if defined (ORANGE_PI)
 		remoteConfig.Run();
 		spiFlashStore.Flash();
@@ -48,6 +48,7 @@
 #include "ws28xxdmxparams.h"
 #include "ws28xxdmx.h"
 #include "ws28xxdmxgrouping.h"
+#include "pixelpipeline.h"
 #include "ws28xx.h"
 #include "storews28xxdmx.h"
 // PWM Led
@@ -91,6 +92,7 @@ void notmain(void) {
 
 	nw.Init((NetworkParamsStore *)spiFlashStore.GetStoreNetwork());
 	nw.SetNetworkStore((NetworkStore *)spiFlashStore.GetStoreNetwork());
+	nw.SetRxIrq(true);
 	nw.Print();
 
 	console_status(CONSOLE_YELLOW, E131Const::MSG_BRIDGE_PARAMS);
@@ -109,6 +111,7 @@ void notmain(void) {
 	bridge.SetUniverse(0, E131_OUTPUT_PORT, nUniverse);
 
 	LightSet *pSpi;
+	WS28xxDmx *pDither = 0;
 
 	bool isLedTypeSet = false;
 
@@ -136,44 +139,42 @@ void notmain(void) {
 
 		const bool bIsLedGrouping = ws28xxparms.IsLedGrouping() && (ws28xxparms.GetLedGroupCount() > 1);
 
+		PixelPipeline *pPixelPipeline = 0;
+
+		if (ws28xxparms.IsPixelPipeline()) {
+			pPixelPipeline = new PixelPipeline;
+			assert(pPixelPipeline != 0);
+			ws28xxparms.Set(pPixelPipeline);
+		}
+
 		if (bIsLedGrouping) {
 			WS28xxDmxGrouping *pWS28xxDmxGrouping = new WS28xxDmxGrouping;
 			assert(pWS28xxDmxGrouping != 0);
+			pWS28xxDmxGrouping->SetPixelPipeline(pPixelPipeline);
 			ws28xxparms.Set(pWS28xxDmxGrouping);
 			pWS28xxDmxGrouping->SetLEDGroupCount(ws28xxparms.GetLedGroupCount());
 			pSpi = pWS28xxDmxGrouping;
+			pDither = pWS28xxDmxGrouping;
 			display.Printf(7, "%s:%d G%d", WS28xx::GetLedTypeString(pWS28xxDmxGrouping->GetLEDType()), pWS28xxDmxGrouping->GetLEDCount(), pWS28xxDmxGrouping->GetLEDGroupCount());
 		} else  {
 			WS28xxDmx *pWS28xxDmx = new WS28xxDmx;
 			assert(pWS28xxDmx != 0);
+			pWS28xxDmx->SetPixelPipeline(pPixelPipeline);
 			ws28xxparms.Set(pWS28xxDmx);
 			pSpi = pWS28xxDmx;
+			pDither = pWS28xxDmx;
 			display.Printf(7, "%s:%d", WS28xx::GetLedTypeString(pWS28xxDmx->GetLEDType()), pWS28xxDmx->GetLEDCount());
 
 			const uint16_t nLedCount = pWS28xxDmx->GetLEDCount();
 
-			if (pWS28xxDmx->GetLEDType() == SK6812W) {
-				if (nLedCount > 128) {
-					bridge.SetDirectUpdate(true);
-					bridge.SetUniverse(1, E131_OUTPUT_PORT, nUniverse + 1);
-				}
-				if (nLedCount > 256) {
-					bridge.SetUniverse(2, E131_OUTPUT_PORT, nUniverse + 2);
-				}
-				if (nLedCount > 384) {
-					bridge.SetUniverse(3, E131_OUTPUT_PORT, nUniverse + 3);
-				}
-			} else {
-				if (nLedCount > 170) {
-					bridge.SetDirectUpdate(true);
-					bridge.SetUniverse(1, E131_OUTPUT_PORT, nUniverse + 1);
-				}
-				if (nLedCount > 340) {
-					bridge.SetUniverse(2, E131_OUTPUT_PORT, nUniverse + 2);
-				}
-				if (nLedCount > 510) {
-					bridge.SetUniverse(3, E131_OUTPUT_PORT, nUniverse + 3);
-				}
+			const uint32_t nLedsPerUniverse = pWS28xxDmx->GetLEDsPerUniverse();
+
+			if (nLedCount > nLedsPerUniverse) {
+				bridge.SetDirectUpdate(true);
+			}
+
+			for (uint32_t nPort = 1; (nPort < 4) && (nLedCount > (nPort * nLedsPerUniverse)); nPort++) {
+				bridge.SetUniverse(nPort, E131_OUTPUT_PORT, nUniverse + nPort);
 			}
 		}
 	}
@@ -231,6 +232,9 @@ void notmain(void) {
 		spiFlashStore.Flash();
 		lb.Run();
 		display.Run();
+		if (pDither != 0) {
+			pDither->Dither();
+		}
 	}
 }
 
@@ -47,6 +47,7 @@
 
 #include "ws28xxdmxparams.h"
 #include "ws28xxdmxmulti.h"
+#include "pixelpipeline.h"
 #include "ws28xx.h"
 #include "storews28xxdmx.h"
 
@@ -89,6 +90,7 @@ void notmain(void) {
 
 	nw.Init((NetworkParamsStore *)spiFlashStore.GetStoreNetwork());
 	nw.SetNetworkStore((NetworkStore *)spiFlashStore.GetStoreNetwork());
+	nw.SetRxIrq(true);
 	nw.Print();
 
 	console_status(CONSOLE_YELLOW, E131Const::MSG_BRIDGE_PARAMS);
@@ -106,51 +108,41 @@ void notmain(void) {
 	WS28xxDmxParams ws28xxparms((WS28xxDmxParamsStore *) &storeWS28xxDmx);
 
 	if (ws28xxparms.Load()) {
+		if (ws28xxparms.IsPixelPipeline()) {
+			PixelPipeline *pPixelPipeline = new PixelPipeline;
+			assert(pPixelPipeline != 0);
+			ws28xxparms.Set(pPixelPipeline);
+			ws28xxDmxMulti.SetPixelPipeline(pPixelPipeline);
+		}
 		ws28xxparms.Set(&ws28xxDmxMulti);
 		ws28xxparms.Dump();
 	}
 
 	ws28xxDmxMulti.Start(0);
 
-	const uint16_t nLedCount = ws28xxDmxMulti.GetLEDCount();
 	const uint8_t nActivePorts = ws28xxDmxMulti.GetActivePorts();
+	const uint32_t nUniverses = ws28xxDmxMulti.GetUniverses();
 	const uint8_t nUniverseStart = e131params.GetUniverse();
 
 	bridge.SetDirectUpdate(true);
 	bridge.SetOutput(&ws28xxDmxMulti);
 
-	uint8_t nPortIndex = 0;
-
-	for (uint32_t i = 0; i < nActivePorts; i++) {
-		bridge.SetUniverse(nPortIndex, E131_OUTPUT_PORT, nPortIndex + nUniverseStart);
-
-		if (ws28xxDmxMulti.GetLEDType() == WS28XXMULTI_SK6812W) {
-			if (nLedCount > 128) {
-				bridge.SetUniverse(nPortIndex + 1, E131_OUTPUT_PORT, nUniverseStart + nPortIndex + 1);
-			}
+	ws28xxDmxMulti.SetPortsAvailable(E131_MAX_PORTS);
 
-			if (nLedCount > 256) {
-				bridge.SetUniverse(nPortIndex + 2, E131_OUTPUT_PORT, nUniverseStart + nPortIndex + 2);
-			}
+	if ((nActivePorts * nUniverses) > E131_MAX_PORTS) {
+		printf("Warning: %u universes requested, only %u are available\n", (unsigned) (nActivePorts * nUniverses), (unsigned) E131_MAX_PORTS);
+	}
 
-			if (nLedCount > 384) {
-				bridge.SetUniverse(nPortIndex + 3, E131_OUTPUT_PORT, nUniverseStart + nPortIndex + 3);
-			}
-		} else {
-			if (nLedCount > 170) {
-				bridge.SetUniverse(nPortIndex + 1, E131_OUTPUT_PORT, nUniverseStart + nPortIndex + 1);
-			}
+	for (uint32_t i = 0; i < nActivePorts; i++) {
+		for (uint32_t nUniverse = 0; nUniverse < nUniverses; nUniverse++) {
+			const uint32_t nPortIndex = (i * nUniverses) + nUniverse;
 
-			if (nLedCount > 340) {
-				bridge.SetUniverse(nPortIndex + 2, E131_OUTPUT_PORT, nUniverseStart + nPortIndex + 2);
+			if (nPortIndex >= E131_MAX_PORTS) {
+				break;
 			}
 
-			if (nLedCount > 510) {
-				bridge.SetUniverse(nPortIndex + 3, E131_OUTPUT_PORT, nUniverseStart + nPortIndex + 3);
-			}
+			bridge.SetUniverse(nPortIndex, E131_OUTPUT_PORT, nUniverseStart + nPortIndex);
 		}
-
-		nPortIndex += ws28xxDmxMulti.GetUniverses();
 	}
 
 	bridge.Print();